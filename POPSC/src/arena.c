@@ -0,0 +1,138 @@
+/*==============================================================================
+arena.c : resettable arena for per-structure and per-frame scratch memory
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "arena.h"
+
+/*____________________________________________________________________________*/
+/** round up to arena alignment */
+__inline__ static size_t align_size(size_t size)
+{
+	return ((size + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN;
+}
+
+/*____________________________________________________________________________*/
+/** add chunk of at least 'size' bytes */
+static void add_chunk(Arena *arena, size_t size)
+{
+	size_t header = align_size(sizeof(ArenaChunk));
+	ArenaChunk *chunk = safe_memalign(ARENA_ALIGN, header + size);
+
+	chunk->data = (char *)chunk + header;
+	chunk->size = size;
+	chunk->used = 0;
+	chunk->next = arena->chunk;
+
+	arena->chunk = chunk;
+	arena->total += size;
+	++ arena->nChunk;
+}
+
+/*____________________________________________________________________________*/
+/** initialise arena with a first chunk of 'size' bytes */
+void init_arena(Arena *arena, size_t size)
+{
+	arena->chunk = 0;
+	arena->total = 0;
+	arena->last = 0;
+	arena->lastSize = 0;
+	arena->nChunk = 0;
+
+	add_chunk(arena, align_size(size > 0 ? size : ARENA_SIZE));
+}
+
+/*____________________________________________________________________________*/
+/** allocate 'size' bytes; a full chunk is followed by one of twice its size */
+void *arena_alloc(Arena *arena, size_t size)
+{
+	void *ptr = 0;
+	size_t chunkSize;
+
+	size = align_size(size);
+
+	if (arena->chunk->used + size > arena->chunk->size) {
+		chunkSize = 2 * arena->chunk->size;
+		while (chunkSize < size)
+			chunkSize *= 2;
+		add_chunk(arena, chunkSize);
+	}
+
+	ptr = arena->chunk->data + arena->chunk->used;
+	arena->chunk->used += size;
+
+	arena->last = ptr;
+	arena->lastSize = size;
+
+	return ptr;
+}
+
+/*____________________________________________________________________________*/
+/** grow allocation 'ptr' to 'newSize' bytes, keeping 'oldSize' bytes content;
+	the last allocation grows in place if the chunk has space */
+void *arena_grow(Arena *arena, void *ptr, size_t oldSize, size_t newSize)
+{
+	void *newPtr = 0;
+
+	if ((ptr == arena->last) && \
+		(arena->chunk->used - arena->lastSize + align_size(newSize) <= arena->chunk->size)) {
+		arena->chunk->used += align_size(newSize) - arena->lastSize;
+		arena->lastSize = align_size(newSize);
+		return ptr;
+	}
+
+	newPtr = arena_alloc(arena, newSize);
+	memcpy(newPtr, ptr, oldSize);
+
+	return newPtr;
+}
+
+/*____________________________________________________________________________*/
+/** contiguous 2D matrix of 'x' rows of 'y' elements of 'size' bytes */
+void *arena_mat2D(Arena *arena, int x, int y, size_t size)
+{
+	return place_cmat2D(arena_alloc(arena, size_cmat2D(x, y, size)), x, y, size);
+}
+
+/*____________________________________________________________________________*/
+/** release all allocations; chunks are merged into one chunk
+	of the total size, so that the next structure or frame of similar size
+	runs without further chunk allocation */
+void reset_arena(Arena *arena)
+{
+	ArenaChunk *chunk = 0;
+	size_t total = arena->total;
+
+	if (arena->nChunk > 1) {
+		while (arena->chunk) {
+			chunk = arena->chunk->next;
+			free(arena->chunk);
+			arena->chunk = chunk;
+		}
+		arena->total = 0;
+		arena->nChunk = 0;
+		add_chunk(arena, total);
+	}
+
+	arena->chunk->used = 0;
+	arena->last = 0;
+	arena->lastSize = 0;
+}
+
+/*____________________________________________________________________________*/
+/** free arena */
+void free_arena(Arena *arena)
+{
+	ArenaChunk *chunk = 0;
+
+	while (arena->chunk) {
+		chunk = arena->chunk->next;
+		free(arena->chunk);
+		arena->chunk = chunk;
+	}
+	arena->total = 0;
+	arena->nChunk = 0;
+	arena->last = 0;
+}
+
@@ -0,0 +1,54 @@
+/*==============================================================================
+arena.h : resettable arena for per-structure and per-frame scratch memory
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "matrix.h"
+#include "safe.h"
+
+/*___________________________________________________________________________*/
+/* constants */
+#define ARENA_ALIGN 64 /* alignment of all allocations: cache line size */
+#define ARENA_SIZE 65536 /* size of first chunk */
+
+/*___________________________________________________________________________*/
+/* structures */
+/* memory chunk; chunks are added when the arena is full */
+typedef struct arenachunk
+{
+	struct arenachunk *next; /* previous (full) chunk */
+	char *data; /* usable memory */
+	size_t size; /* usable size */
+	size_t used; /* used size */
+} ArenaChunk;
+
+/* bump allocator: allocations are released together by 'reset_arena',
+	after which the memory is reused without calls to malloc/free */
+typedef struct
+{
+	ArenaChunk *chunk; /* current chunk */
+	size_t total; /* size of all chunks */
+	void *last; /* last allocation, can grow in place */
+	size_t lastSize;
+	int nChunk; /* number of chunks */
+} Arena;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+void init_arena(Arena *arena, size_t size);
+void *arena_alloc(Arena *arena, size_t size);
+void *arena_grow(Arena *arena, void *ptr, size_t oldSize, size_t newSize);
+void *arena_mat2D(Arena *arena, int x, int y, size_t size);
+void reset_arena(Arena *arena);
+void free_arena(Arena *arena);
+
+#endif
+
@@ -85,7 +85,12 @@ static void set_defaults(Arg *arg, Argpdb *argpdb)
 	argpdb->hydrogens = 0; /* read hydrogens [0,1] */
 	argpdb->multiModel = 0; /* read multiple models [0,1] */
 	argpdb->partOcc = 0; /* partial occupancy [0,1] */
+	argpdb->chains = 0; /* chains to read 'A,B', 0 for all */
+	argpdb->residues = 0; /* residue ranges to read 'A:10-25,...', 0 for all */
+	argpdb->noNucleic = 0; /* skip nucleic acid residues [0,1] */
 	arg->rProbe = 1.4; /* probe radius (in Angstrom) */
+	arg->nProbe = 1; /* probe radii */
+	arg->probe[0] = arg->rProbe;
 	arg->silent = 0; /* suppress stdout */
 	arg->outDirName = ".";
     arg->sasaOutFileName = "pops.out";
@@ -116,13 +121,64 @@ static void set_defaults(Arg *arg, Argpdb *argpdb)
 	arg->jsonOut = 0; /* JSON output */
 	arg->jsonOutFileName = "pops";
 	arg->jsonbOutFileName = "popsb";
+	arg->packDirName = 0; /* directory of structure packs */
+	arg->morton = 0; /* Morton-ordered cell grid for neighbour search */
+	arg->batchName = 0; /* batch directory or list file */
+	arg->nThread = 0; /* batch and POPSCOMP threads, 0 for all processors */
+	arg->manifestName = 0; /* manifest of current outputs */
+	arg->serveName = 0; /* socket of server mode */
+	arg->popscomp = 0; /* SASA of isolated chains and chain pairs */
+	arg->equivRmsd = 0.01; /* RMSD of equivalent chains in POPSCOMP, 0 for none */
+	arg->assembly = 0; /* biological assembly identifier */
+    arg->probeOutFileName = "popsprobe.out";
+	arg->dual = 0; /* atomic and coarse-grained SASA */
+	arg->incremental = 0; /* incremental SASA update of trajectory frames */
+	arg->scan = 0; /* mutant residue of the scan: ALA or GLY */
+	arg->scanResidues = 0; /* scanned residues 'chain:number,...', 0 for all */
+	arg->scanOutFileName = "popsscan.out";
+	arg->gradientOut = 0; /* gradients of molecular SASA and SFE */
+	arg->gradientOutFileName = "popsgradient.out";
+	arg->poseInFileName = 0; /* rigid-body poses of the partner chain */
+	arg->poseChain = 0; /* partner chain of the poses, 0 for the last chain */
+	arg->poseOutFileName = "popspose.out";
+	arg->fitName = 0; /* training list of the parameter fit */
+	arg->fitIterations = 200; /* iterations of the parameter fit */
+	arg->fitOutFileName = "popsfit.out";
+	arg->selection = 0; /* atoms of the selection SASA, 0 for all */
+	arg->selectOutFileName = "popsselect.out";
+	arg->interfaceMode = 0; /* interface mode with a coarse residue screen [0,1] */
+	arg->interfaceRadius = 12.; /* CA distance of interface residues (in Angstrom) */
+	arg->interfaceModeOutFileName = "popsinterface.out";
+}
+
+/*____________________________________________________________________________*/
+/** scanned residues: comma-separated list of 'chain:number' */
+static int valid_scan_residues(char *value)
+{
+	char list[1024];
+	char *token = 0;
+	char *save = 0;
+	char chain;
+	int residueNumber;
+
+	if (strlen(value) >= sizeof(list))
+		return 0;
+	strcpy(list, value);
+	for (token = strtok_r(list, ",", &save); token; token = strtok_r(0, ",", &save))
+		if (sscanf(token, "%c:%d", &chain, &residueNumber) != 2)
+			return 0;
+
+	return 1;
 }
 
 /*____________________________________________________________________________*/
 /** check input */
 static void check_input(Arg *arg, Argpdb *argpdb)
 {
-	if ((strlen(arg->mmcifInFileName) == 0) &&
+	ReadSelection readsel;
+
+	if ((arg->batchName == 0) && (arg->serveName == 0) && (arg->fitName == 0) &&
+		(strlen(arg->mmcifInFileName) == 0) &&
 	    (strlen(arg->pdbInFileName) == 0) &&
 		(strlen(arg->pdbmlInFileName) == 0))
 		Error("Invalid PDB file name");
@@ -135,6 +191,7 @@ static void check_input(Arg *arg, Argpdb *argpdb)
 	assert(argpdb->multiModel == 0 || argpdb->multiModel == 1);
 	assert(argpdb->partOcc == 0 || argpdb->partOcc == 1);
 	assert(arg->rProbe > 0);
+	assert(arg->nProbe > 0 && arg->nProbe <= MAXPROBE);
 	assert(strlen(arg->outDirName) > 0);
 	assert(strlen(arg->sasaOutFileName) > 0);
 	assert(strlen(arg->sasatrajOutFileName) > 0);
@@ -159,6 +216,150 @@ static void check_input(Arg *arg, Argpdb *argpdb)
 	assert(arg->rout == 0 || arg->rout == 1);
 	assert(strlen(arg->routPrefix) > 0);
 	assert(arg->jsonOut == 0 || arg->jsonOut == 1);
+	assert(arg->morton == 0 || arg->morton == 1);
+	assert(arg->nThread >= 0);
+	assert(arg->popscomp == 0 || arg->popscomp == 1);
+	assert(arg->equivRmsd >= 0);
+	assert(arg->dual == 0 || arg->dual == 1);
+	assert(arg->incremental == 0 || arg->incremental == 1);
+	if (arg->batchName && arg->trajInFileName)
+		Error("Option '--traj' is not available in batch mode");
+	if (arg->manifestName && arg->trajInFileName)
+		Error("Option '--traj' is not available with '--manifest'");
+	if (arg->serveName && arg->batchName)
+		Error("Options '--serve' and '--batch' are exclusive");
+	if (arg->popscomp && arg->batchName)
+		Error("Option '--popscomp' is not available in batch mode");
+	if (arg->popscomp && arg->serveName)
+		Error("Option '--popscomp' is not available in server mode");
+	if (arg->assembly && (arg->batchName || arg->serveName))
+		Error("Option '--assembly' is not available in batch and server mode");
+	if (arg->assembly && strlen(arg->pdbmlInFileName) > 0)
+		Error("Option '--assembly' requires '--pdb' or '--mmcif' input");
+	if (arg->assembly && (arg->trajInFileName || arg->packDirName || arg->popscomp))
+		Error("Option '--assembly' is not available with '--traj', '--packDir' or '--popscomp'");
+	if (arg->assembly && (arg->topologyOut || arg->neighbourOut ||
+			arg->parameterOut || arg->interfaceOut))
+		Error("Option '--assembly' is not available with topology outputs");
+	if ((arg->nProbe > 1) && (arg->batchName || arg->serveName))
+		Error("Several probe radii are not available in batch and server mode");
+	if ((arg->nProbe > 1) && (arg->trajInFileName || arg->popscomp || arg->assembly))
+		Error("Several probe radii are not available with '--traj', '--popscomp' or '--assembly'");
+	if ((arg->nProbe > 1) && (arg->topologyOut || arg->neighbourOut || arg->interfaceOut))
+		Error("Several probe radii are not available with topology outputs");
+	if (arg->dual && argpdb->coarse)
+		Error("Options '--dual' and '--coarse' are exclusive");
+	if (arg->dual && (arg->batchName || arg->serveName))
+		Error("Option '--dual' is not available in batch and server mode");
+	if (arg->dual && (arg->trajInFileName || arg->packDirName || arg->popscomp ||
+			arg->assembly || (arg->nProbe > 1)))
+		Error("Option '--dual' is not available with '--traj', '--packDir', '--popscomp', '--assembly' or several probe radii");
+	if (arg->dual && arg->jsonOut)
+		Error("Option '--dual' is not available with '--jsonOut'");
+	if (arg->incremental && ! arg->trajInFileName)
+		Error("Option '--incremental' requires '--traj'");
+	if (arg->incremental && (arg->topologyOut || arg->parameterOut || arg->interfaceOut))
+		Error("Option '--incremental' is not available with '--topologyOut', '--parameterOut' or '--interfaceOut'");
+	if (arg->scan && (strcmp(arg->scan, "ALA") != 0) && (strcmp(arg->scan, "GLY") != 0))
+		Error("Option '--scan' requires 'ALA' or 'GLY'");
+	if (arg->scanResidues && ! arg->scan)
+		Error("Option '--scanResidues' requires '--scan'");
+	if (arg->scanResidues && ! valid_scan_residues(arg->scanResidues))
+		Error("Option '--scanResidues' requires a list 'chain:number,...'");
+	if (arg->scan && argpdb->coarse)
+		Error("Option '--scan' is not available with '--coarse'");
+	if (arg->scan && (arg->batchName || arg->serveName))
+		Error("Option '--scan' is not available in batch and server mode");
+	if (arg->scan && (arg->trajInFileName || arg->popscomp || arg->assembly ||
+			arg->dual || (arg->nProbe > 1)))
+		Error("Option '--scan' is not available with '--traj', '--popscomp', '--assembly', '--dual' or several probe radii");
+	if (arg->gradientOut && (arg->batchName || arg->serveName))
+		Error("Option '--gradientOut' is not available in batch and server mode");
+	if (arg->gradientOut && (arg->trajInFileName || arg->dual || (arg->nProbe > 1) ||
+			arg->assembly))
+		Error("Option '--gradientOut' is not available with '--traj', '--dual', several probe radii or '--assembly'");
+	if (arg->poseChain && ! arg->poseInFileName)
+		Error("Option '--poseChain' requires '--poses'");
+	if (arg->poseInFileName && (arg->batchName || arg->serveName))
+		Error("Option '--poses' is not available in batch and server mode");
+	if (arg->poseInFileName && (arg->trajInFileName || arg->dual || (arg->nProbe > 1)))
+		Error("Option '--poses' is not available with '--traj', '--dual' or several probe radii");
+	if (arg->poseInFileName && (arg->assembly || arg->popscomp))
+		Error("Option '--poses' is not available with '--assembly' or '--popscomp'");
+	if (arg->fitName && (arg->batchName || arg->serveName))
+		Error("Option '--fit' is not available in batch and server mode");
+	if (arg->fitName && (arg->trajInFileName || arg->dual || (arg->nProbe > 1)))
+		Error("Option '--fit' is not available with '--traj', '--dual' or several probe radii");
+	if (arg->fitIterations < 0)
+		Error("Option '--fitIterations' requires a non-negative number");
+	if (arg->selection && (arg->batchName || arg->serveName || arg->fitName || arg->manifestName))
+		Error("Option '--select' is not available in batch, server and fit mode or with '--manifest'");
+	if (arg->selection && (arg->trajInFileName || arg->dual || (arg->nProbe > 1) ||
+			arg->assembly || arg->popscomp))
+		Error("Option '--select' is not available with '--traj', '--dual', several probe radii, '--assembly' or '--popscomp'");
+	if (arg->selection && (arg->scan || arg->gradientOut || arg->poseInFileName))
+		Error("Option '--select' is not available with '--scan', '--gradientOut' or '--poses'");
+	if (arg->interfaceRadius <= 0.)
+		Error("Option '--interfaceRadius' requires a positive radius");
+	if (arg->interfaceMode && argpdb->coarse)
+		Error("Option '--interfaceMode' is not available with '--coarse'");
+	if (arg->interfaceMode && (arg->batchName || arg->serveName || arg->fitName || arg->manifestName))
+		Error("Option '--interfaceMode' is not available in batch, server and fit mode or with '--manifest'");
+	if (arg->interfaceMode && (arg->trajInFileName || arg->dual || (arg->nProbe > 1) ||
+			arg->assembly || arg->popscomp))
+		Error("Option '--interfaceMode' is not available with '--traj', '--dual', several probe radii, '--assembly' or '--popscomp'");
+	if (arg->interfaceMode && (arg->scan || arg->gradientOut || arg->poseInFileName || arg->selection))
+		Error("Option '--interfaceMode' is not available with '--scan', '--gradientOut', '--poses' or '--select'");
+	if (init_read_selection(argpdb, &readsel) != 0)
+		Error("Options '--chains' and '--residues' require lists 'chain,...' and 'chain:first-last,...'");
+}
+
+/*____________________________________________________________________________*/
+/** probe radii: single value, range 'first:last:step' or list 'r1,r2,...' */
+static void parse_probe(Arg *arg, char *value)
+{
+	int i;
+	float first, last, step;
+	char *next;
+
+	arg->nProbe = 0;
+	if (strchr(value, ':')) {
+		if ((sscanf(value, "%f:%f:%f", &first, &last, &step) != 3) ||
+			(first <= 0.) || (step <= 0.) || (last < first))
+			Error("Invalid probe radius range, expected '<first>:<last>:<step>'");
+		/* small tolerance for decimal steps not representable in binary */
+		arg->nProbe = (int)floor((last - first) / step + 1e-3) + 1;
+		if (arg->nProbe > MAXPROBE)
+			Error("Too many probe radii");
+		for (i = 0; i < arg->nProbe; ++ i)
+			arg->probe[i] = first + i * step;
+	} else {
+		do {
+			if (arg->nProbe == MAXPROBE)
+				Error("Too many probe radii");
+			arg->probe[arg->nProbe] = strtof(value, &next);
+			if ((next == value) || (arg->probe[arg->nProbe] <= 0.))
+				Error("Invalid probe radius");
+			++ arg->nProbe;
+			value = next + 1;
+		} while (*next == ',');
+	}
+	arg->rProbe = arg->probe[0];
+}
+
+/*____________________________________________________________________________*/
+/** largest probe radius, which sets the neighbour cutoff;
+	the first radius is 'rProbe' */
+float probe_max(Arg *arg)
+{
+	int i;
+	float rProbe = arg->rProbe;
+
+	for (i = 1; i < arg->nProbe; ++ i)
+		if (arg->probe[i] > rProbe)
+			rProbe = arg->probe[i];
+
+	return rProbe;
 }
 
 /*____________________________________________________________________________*/
@@ -169,9 +370,12 @@ static void print_args(Arg *arg, Argpdb *argpdb)
     time(&now);
 
     if (! arg->silent) fprintf(stdout, "date: %s", ctime(&now));
-    fprintf(stdout, "%s%s%s\n",
+    fprintf(stdout, "%s%s%s%s\n",
 					arg->mmcifInFileName,
-					arg->pdbInFileName, arg->pdbmlInFileName);
+					arg->pdbInFileName, arg->pdbmlInFileName,
+					arg->batchName ? arg->batchName :
+					arg->serveName ? arg->serveName :
+					arg->fitName ? arg->fitName : "");
     if (! arg->silent) fprintf(stdout, \
 					"zipped: %d\n"
                     "traj: %s\n"
@@ -185,6 +389,18 @@ static void print_args(Arg *arg, Argpdb *argpdb)
     fflush(stdout);
 }
 
+/*____________________________________________________________________________*/
+/** name of input structure file */
+char *input_file_name(Arg *arg)
+{
+	if (arg->mmcif)
+		return arg->mmcifInFileName;
+	else if (arg->pdbml)
+		return arg->pdbmlInFileName;
+	else
+		return arg->pdbInFileName;
+}
+
 /*____________________________________________________________________________*/
 /** parse command line long_options */
 int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
@@ -201,14 +417,38 @@ int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
 	   --pdbml <PDBML input>\t(type: char  , default: void)\n\
 	   --traj <trajectory input>\t(type: char  , default: void)\n\
 	   --zipped\t\t\t(type: no_arg, default: off)\n\
+	   --chains <chain,...>\t\t(type: char  , default: all)\n\
+	   --residues <chain:first-last,...>\t(type: char  , default: all)\n\
+	   --noNucleic\t\t\t(type: no_arg, default: off)\n\
        \n\
 	 MODE OPTIONS\n\
 	   --coarse\t\t\t(type: no_arg, default: off)\n\
+	   --dual\t\t\t(type: no_arg, default: off)\n\
+	   --incremental\t\t(type: no_arg, default: off)\n\
+	   --scan <ALA | GLY>\t\t(type: char  , default: void)\n\
+	   --scanResidues <chain:number,...>\t(type: char  , default: all)\n\
+	   --poses <pose file | ->\t(type: char  , default: void)\n\
+	   --poseChain <chain>\t\t(type: char  , default: last chain)\n\
+	   --fit <training list>\t(type: char  , default: void)\n\
+	   --fitIterations <iterations>\t(type: int   , default: 200)\n\
+	   --select <chain[:residues],@atoms,...>\t(type: char  , default: all)\n\
+	   --interfaceMode\t\t(type: no_arg, default: off)\n\
+	   --interfaceRadius <radius [A]>\t(type: float , default: 12.0)\n\
 	   --hydrogens\t\t\t(type: no_arg, default: off)\n\
 	   --multiModel\t\t\t(type: no_arg, default: off)\n\
 	   --partOcc\t\t\t(type: no_arg, default: off)\n\
 	   --rProbe <probe radius [A]>\t(type: float , default: 1.4)\n\
+	     several radii as range <first:last:step> or list <r1,r2,...>\n\
 	   --silent\t\t\t(type: no_arg, default: off)\n\
+	   --packDir <pack dir>\t\t(type: char  , default: void)\n\
+	   --morton\t\t\t(type: no_arg, default: off)\n\
+	   --batch <dir | list file>\t(type: char  , default: void)\n\
+	   --nThread <threads>\t\t(type: int   , default: 0 = all CPUs)\n\
+	   --manifest <manifest file>\t(type: char  , default: void)\n\
+	   --serve <socket>\t\t(type: char  , default: void)\n\
+	   --popscomp\t\t\t(type: no_arg, default: off)\n\
+	   --equivRmsd <RMSD [A]>\t(type: float , default: 0.01)\n\
+	   --assembly <assembly ID>\t(type: char  , default: void)\n\
        \n\
 	 OUTPUT OPTIONS\n\
 	   --outDirName <output dir>\t(type: char  , default: NULL)\n\
@@ -218,6 +458,13 @@ int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
 	   --popsbtrajOut <POPSb output>(type: char  , default: popsbtraj.out)\n\
 	   --sigmaOut <SFE output>\t(type: char  , default: sigma.out)\n\
 	   --sigmatrajOut <SFE output>\t(type: char  , default: sigmatraj.out)\n\
+	   --popsprobeOut <probe output>(type: char  , default: popsprobe.out)\n\
+	   --popsscanOut <scan output>\t(type: char  , default: popsscan.out)\n\
+	   --popsgradientOut <gradient output>\t(type: char  , default: popsgradient.out)\n\
+	   --popsposeOut <pose output>\t(type: char  , default: popspose.out)\n\
+	   --popsfitOut <fit output>\t(type: char  , default: popsfit.out)\n\
+	   --popsselectOut <selection output>\t(type: char  , default: popsselect.out)\n\
+	   --popsinterfaceOut <interface output>\t(type: char  , default: popsinterface.out)\n\
 	   --distMatCAOut <distmat output>\t(type: char  , default: distMatCA.out)\n\
 	   --interfaceOut\t\t(type: no_arg, default: off)\n\
 	   --compositionOut\t\t(type: no_arg, default: off)\n\
@@ -228,6 +475,7 @@ int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
 	   --chainOut\t\t\t(type: no_arg, default: off)\n\
 	   --neighbourOut\t\t(type: no_arg, default: off)\n\
 	   --parameterOut\t\t(type: no_arg, default: off)\n\
+	   --gradientOut\t\t(type: no_arg, default: off)\n\
 	   --noTotalOut\t\t\t(type: no_arg, default: off)\n\
 	   --noHeaderOut\t\t(type: no_arg, default: off)\n\
 	   --padding\t\t\t(type: no_arg, default: off)\n\
@@ -285,6 +533,37 @@ int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
         {"outDirName", required_argument, 0, 32},
         {"mmcif", required_argument, 0, 33},
         {"distMatCAOut", required_argument, 0, 34},
+        {"packDir", required_argument, 0, 35},
+        {"morton", no_argument, 0, 36},
+        {"batch", required_argument, 0, 37},
+        {"nThread", required_argument, 0, 38},
+        {"manifest", required_argument, 0, 39},
+        {"serve", required_argument, 0, 43},
+        {"popscomp", no_argument, 0, 44},
+        {"equivRmsd", required_argument, 0, 45},
+        {"assembly", required_argument, 0, 46},
+        {"popsprobeOut", required_argument, 0, 47},
+        {"dual", no_argument, 0, 48},
+        {"incremental", no_argument, 0, 49},
+        {"scan", required_argument, 0, 50},
+        {"scanResidues", required_argument, 0, 51},
+        {"popsscanOut", required_argument, 0, 52},
+        {"gradientOut", no_argument, 0, 53},
+        {"popsgradientOut", required_argument, 0, 54},
+        {"poses", required_argument, 0, 55},
+        {"poseChain", required_argument, 0, 56},
+        {"popsposeOut", required_argument, 0, 57},
+        {"fit", required_argument, 0, 58},
+        {"fitIterations", required_argument, 0, 59},
+        {"popsfitOut", required_argument, 0, 60},
+        {"select", required_argument, 0, 61},
+        {"popsselectOut", required_argument, 0, 62},
+        {"chains", required_argument, 0, 63},
+        {"residues", required_argument, 0, 64},
+        {"noNucleic", no_argument, 0, 65},
+        {"interfaceMode", no_argument, 0, 66},
+        {"interfaceRadius", required_argument, 0, 67},
+        {"popsinterfaceOut", required_argument, 0, 68},
         {"cite", no_argument, 0, 40},
         {"version", no_argument, 0, 41},
         {"help", no_argument, 0, 42},
@@ -292,7 +571,7 @@ int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
     };
 
     /** assign parameters to long options */
-    while ((c = getopt_long(argc, argv, "1:2:3 4 5:6:7:8:9:10:11:12 13 14 15 16 17 18 19 20 21 22 23 24 25 26:27 28 29 30:31 32:33:34:40 41", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "1:2:3 4 5:6:7:8:9:10:11:12 13 14 15 16 17 18 19 20 21 22 23 24 25 26:27 28 29 30:31 32:33:34:35:36 40 41", long_options, NULL)) != -1) {
         switch(c) {
             case 1:
                 arg->pdbInFileName = optarg;
@@ -309,7 +588,7 @@ int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
                 argpdb->multiModel = 1;
                 break;
             case 5:
-                arg->rProbe = atof(optarg);
+                parse_probe(arg, optarg);
                 break;
             case 6:
                 arg->sasaOutFileName = optarg;
@@ -401,6 +680,99 @@ int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb)
             case 34:
                 arg->distMatCAOutFileName = optarg;
 				break;
+            case 35:
+                arg->packDirName = optarg;
+				break;
+            case 36:
+                arg->morton = 1;
+				break;
+            case 37:
+                arg->batchName = optarg;
+				break;
+            case 38:
+                arg->nThread = atoi(optarg);
+				break;
+            case 39:
+                arg->manifestName = optarg;
+				break;
+            case 43:
+                arg->serveName = optarg;
+				break;
+            case 44:
+                arg->popscomp = 1;
+				break;
+            case 45:
+                arg->equivRmsd = atof(optarg);
+				break;
+            case 46:
+                arg->assembly = optarg;
+				break;
+            case 47:
+                arg->probeOutFileName = optarg;
+				break;
+            case 48:
+                arg->dual = 1;
+				break;
+            case 49:
+                arg->incremental = 1;
+				break;
+            case 50:
+                arg->scan = optarg;
+				break;
+            case 51:
+                arg->scanResidues = optarg;
+				break;
+            case 52:
+                arg->scanOutFileName = optarg;
+				break;
+            case 53:
+                arg->gradientOut = 1;
+				break;
+            case 54:
+                arg->gradientOutFileName = optarg;
+				break;
+            case 55:
+                arg->poseInFileName = optarg;
+				break;
+            case 56:
+                arg->poseChain = optarg;
+				break;
+            case 57:
+                arg->poseOutFileName = optarg;
+				break;
+            case 58:
+                arg->fitName = optarg;
+				break;
+            case 59:
+                arg->fitIterations = atoi(optarg);
+				break;
+            case 60:
+                arg->fitOutFileName = optarg;
+				break;
+            case 61:
+                arg->selection = optarg;
+				break;
+            case 62:
+                arg->selectOutFileName = optarg;
+				break;
+            case 63:
+                argpdb->chains = optarg;
+				break;
+            case 64:
+                argpdb->residues = optarg;
+				break;
+            case 65:
+                argpdb->noNucleic = 1;
+				break;
+            case 66:
+                arg->interfaceMode = 1;
+				break;
+            case 67:
+                arg->interfaceRadius = atof(optarg);
+				break;
+            case 68:
+                arg->interfaceModeOutFileName = optarg;
+				break;
             case 40:
 				print_citation();
                 exit(0);
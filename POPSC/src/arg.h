@@ -10,14 +10,20 @@ Read the COPYING file for license information.
 #include <assert.h>
 #include <getopt.h>
 #include <libgen.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
 #include "argpdb.h"
+#include "readsel.h"
 #include "error.h"
 
+/*____________________________________________________________________________*/
+/* constants */
+#define MAXPROBE 64 /* probe radii of one run */
+
 /*____________________________________________________________________________*/
 /* structures */
 
@@ -36,6 +42,8 @@ typedef struct
     FILE *trajInFile;
 	char *trajInFileName;
     float rProbe;
+	int nProbe; /* probe radii: 'rProbe' is the first */
+	float probe[MAXPROBE];
 	int silent;
 	char *outDirName;
     FILE *sasaOutFile;
@@ -77,10 +85,47 @@ typedef struct
 	char *jsonOutFileName;
 	FILE *jsonbOutFile;
 	char *jsonbOutFileName;
+	char *packDirName;
+	int morton;
+	char *batchName;
+	int nThread;
+	char *manifestName;
+	char *serveName;
+	int popscomp;
+	float equivRmsd;
+	char *assembly;
+    FILE *probeOutFile;
+    char *probeOutFileName;
+	int dual;
+	int incremental;
+	char *scan;
+	char *scanResidues;
+	FILE *scanOutFile;
+	char *scanOutFileName;
+	int gradientOut;
+	FILE *gradientOutFile;
+	char *gradientOutFileName;
+	char *poseInFileName;
+	char *poseChain;
+	FILE *poseOutFile;
+	char *poseOutFileName;
+	char *fitName;
+	int fitIterations;
+	FILE *fitOutFile;
+	char *fitOutFileName;
+	char *selection;
+	FILE *selectOutFile;
+	char *selectOutFileName;
+	int interfaceMode;
+	float interfaceRadius;
+	FILE *interfaceModeOutFile;
+	char *interfaceModeOutFileName;
 } Arg;
 
 /*____________________________________________________________________________*/
 /* prototypes */
+char *input_file_name(Arg *arg);
+float probe_max(Arg *arg);
 int parse_args(int argc, char **argv, Arg *arg, Argpdb *argpdb);
 
 #endif
@@ -15,6 +15,9 @@ typedef struct
 	int hydrogens; /* read hydrogen atoms */
 	int multiModel; /* read multiple models */
 	int partOcc; /* partial occupancy */
+	char *chains; /* chains to read 'A,B', 0 for all */
+	char *residues; /* residue ranges to read 'A:10-25,...', 0 for all */
+	int noNucleic; /* skip nucleic acid residues */
 } Argpdb;
 
 #endif
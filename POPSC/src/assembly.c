@@ -0,0 +1,648 @@
+/*==============================================================================
+assembly.c : biological assembly from symmetry operations
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "assembly.h"
+
+/*____________________________________________________________________________*/
+/* The operations of a biological assembly, from '_pdbx_struct_oper_list'
+	and '_pdbx_struct_assembly_gen' of mmCIF files or from the BIOMT
+	records of REMARK 350 of PDB files, generate copies of atoms of the
+	asymmetric unit. The operations are rotations plus translations,
+	therefore an atom has the same SASA in all copies with the same
+	environment, i.e. with the same neighbouring copies relative to
+	the copy. Copies are classed by their environment; only one copy
+	per class is evaluated, together with the atoms of its neighbouring
+	copies within overlap distance, and the other copies of the class
+	receive its atom SASAs. A point-group assembly such as a capsid costs
+	one copy plus its interfaces; the copies at the ends of a finite
+	filament form classes of their own. */
+
+/* copies of the assembly */
+typedef struct {
+	int nCopy;
+	int *oper; /* operation of each copy */
+	int *maskId; /* first copy transforming the same atoms */
+	double (*centre)[3]; /* bounding sphere of each copy */
+	double *radius;
+	int *nbFirst; /* first neighbouring copy of each copy */
+	int *nbCount; /* number of neighbouring copies */
+	int *nb; /* neighbouring copies */
+	double (*rel)[12]; /* neighbouring operations relative to the copy */
+	int *rep; /* representative copy of the class of each copy */
+} Copies;
+
+/* scratch of the assembly evaluation */
+typedef struct {
+	Copies copies;
+	Type auType; /* types of the asymmetric unit */
+	Str env; /* evaluated atoms */
+	PopsResult envResult;
+	char *include; /* nCopy x nAtom: atom of the copy in a structure */
+	int *envIndex; /* nCopy x nAtom: index of the atom in 'env' */
+} AssemblyWork;
+
+/* chain names of generated copies, in order of appearance; the
+	single-character chain identifiers limit an assembly to 62 chains */
+static const char chainName[] = \
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+#define MAXASSEMBLYCHAIN ((int)sizeof(chainName) - 1)
+
+/*____________________________________________________________________________*/
+/** initialise assembly of a structure of 'nAtom' atoms */
+void init_assembly(Assembly *assembly, int nAtom)
+{
+	memset(assembly, 0, sizeof(Assembly));
+	assembly->nAtom = nAtom;
+}
+
+/*____________________________________________________________________________*/
+/** append operation 'oper' (3x4 matrix, see 'Assembly') without atoms;
+	returns the operation index */
+int add_assembly_oper(Assembly *assembly, double *oper)
+{
+	if (assembly->nOper == assembly->allocatedOper) {
+		assembly->allocatedOper = assembly->allocatedOper ? 2 * assembly->allocatedOper : 16;
+		assembly->oper = safe_realloc(assembly->oper, \
+			assembly->allocatedOper * sizeof(*(assembly->oper)));
+		assembly->member = safe_realloc(assembly->member, \
+			(size_t)assembly->allocatedOper * assembly->nAtom * sizeof(char));
+	}
+
+	memcpy(assembly->oper[assembly->nOper], oper, 12 * sizeof(double));
+	memset(&(assembly->member[(size_t)assembly->nOper * assembly->nAtom]), 0, \
+		assembly->nAtom * sizeof(char));
+
+	return assembly->nOper ++;
+}
+
+/*____________________________________________________________________________*/
+/** free assembly */
+void free_assembly(Assembly *assembly)
+{
+	free(assembly->oper);
+	free(assembly->member);
+	assembly->oper = 0;
+	assembly->member = 0;
+	assembly->nOper = assembly->allocatedOper = 0;
+}
+
+/*____________________________________________________________________________*/
+/** append chain identifiers listed after 'CHAINS:' to 'chains' */
+static void remark_chains(char *line, char *chains)
+{
+	char *p = strstr(line, "CHAINS:") + 7;
+	int n = strlen(chains);
+
+	for (; *p != '\0' && *p != '\n' && *p != '\r'; ++ p)
+		if (*p != ' ' && *p != ',' && n < 255)
+			chains[n ++] = *p;
+	chains[n] = '\0';
+}
+
+/*____________________________________________________________________________*/
+/** operations of biomolecule 'arg->assembly' from the REMARK 350 BIOMT
+	records of the PDB input file */
+int read_assembly_pdb(Arg *arg, Str *pdb, Assembly *assembly)
+{
+	gzFile pdbInFile;
+	char line[256];
+	char id[64];
+	char chains[256] = "";
+	double oper[12];
+	double value[4];
+	int selected = 0;
+	int row, serial;
+	int k = -1;
+	unsigned int i;
+	char *p;
+
+	init_assembly(assembly, pdb->nAtom);
+
+	/* 'gzopen' reads uncompressed files as well */
+	if ((pdbInFile = gzopen(arg->pdbInFileName, "r")) == NULL) {
+		ErrorSpecNoexit("Failed accessing file", arg->pdbInFileName);
+		return POPS_ERR_INPUT;
+	}
+
+	while (gzgets(pdbInFile, line, sizeof(line)) != NULL) {
+		if (strncmp(line, "REMARK 350", 10) != 0)
+			continue;
+		for (p = &(line[10]); *p == ' '; ++ p);
+
+		if (strncmp(p, "BIOMOLECULE:", 12) == 0) {
+			selected = (sscanf(p + 12, "%63s", id) == 1) && (strcmp(id, arg->assembly) == 0);
+			chains[0] = '\0';
+		} else if (! selected) {
+			continue;
+		} else if (strncmp(p, "APPLY THE FOLLOWING TO CHAINS:", 30) == 0) {
+			chains[0] = '\0';
+			remark_chains(p, chains);
+		} else if (strncmp(p, "AND CHAINS:", 11) == 0) {
+			remark_chains(p, chains);
+		} else if ((strncmp(p, "BIOMT", 5) == 0) &&
+			(sscanf(p + 5, "%d %d %lf %lf %lf %lf", &row, &serial,
+				&value[0], &value[1], &value[2], &value[3]) == 6) &&
+			(row >= 1) && (row <= 3)) {
+			memcpy(&(oper[4 * (row - 1)]), value, 4 * sizeof(double));
+			/* the third row completes the operation */
+			if (row < 3)
+				continue;
+			k = add_assembly_oper(assembly, oper);
+			for (i = 0; i < pdb->nAtom; ++ i)
+				if (strchr(chains, pdb->atom[i].chainIdentifier[0]) != 0)
+					assembly->member[(size_t)k * pdb->nAtom + i] = 1;
+		}
+	}
+	gzclose(pdbInFile);
+
+	if (assembly->nOper == 0) {
+		ErrorSpecNoexit("No BIOMT operations of biomolecule", arg->assembly);
+		return POPS_ERR_INPUT;
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** transform position 'pos' by operation 'oper' */
+__inline__ static void transform(double *oper, Vec *pos, double *x)
+{
+	x[0] = oper[0] * pos->x + oper[1] * pos->y + oper[2] * pos->z + oper[3];
+	x[1] = oper[4] * pos->x + oper[5] * pos->y + oper[6] * pos->z + oper[7];
+	x[2] = oper[8] * pos->x + oper[9] * pos->y + oper[10] * pos->z + oper[11];
+}
+
+/*____________________________________________________________________________*/
+/** 1 if the rotation of 'oper' is orthogonal, i.e. the operation
+	preserves distances */
+static int orthogonal(double *oper)
+{
+	int r, c, k;
+	double dot;
+
+	for (r = 0; r < 3; ++ r)
+		for (c = 0; c < 3; ++ c) {
+			for (k = 0, dot = 0.; k < 3; ++ k)
+				dot += oper[4 * r + k] * oper[4 * c + k];
+			if (fabs(dot - (r == c ? 1. : 0.)) > 1e-3)
+				return 0;
+		}
+
+	return 1;
+}
+
+/*____________________________________________________________________________*/
+/** operation 'b' relative to operation 'a': inverse(a) * b */
+static void relative_oper(double *a, double *b, double *rel)
+{
+	int r, c, k;
+
+	for (r = 0; r < 3; ++ r) {
+		for (c = 0; c < 3; ++ c)
+			for (k = 0, rel[4 * r + c] = 0.; k < 3; ++ k)
+				rel[4 * r + c] += a[4 * k + r] * b[4 * k + c];
+		for (k = 0, rel[4 * r + 3] = 0.; k < 3; ++ k)
+			rel[4 * r + 3] += a[4 * k + r] * (b[4 * k + 3] - a[4 * k + 3]);
+	}
+}
+
+/*____________________________________________________________________________*/
+/** 1 if operations are the same within the precision of the input */
+static int same_oper(double *a, double *b)
+{
+	int r, c;
+
+	for (r = 0; r < 3; ++ r) {
+		for (c = 0; c < 3; ++ c)
+			if (fabs(a[4 * r + c] - b[4 * r + c]) > 1e-3)
+				return 0;
+		if (fabs(a[4 * r + 3] - b[4 * r + 3]) > 1e-2)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*____________________________________________________________________________*/
+/** 1 if copies 'c' and 'e' transform the same atoms and have the same
+	neighbouring copies relative to themselves */
+static int same_environment(Copies *copies, int c, int e, char *used)
+{
+	unsigned int k, l;
+	int d, f;
+
+	if ((copies->maskId[c] != copies->maskId[e]) ||
+		(copies->nbCount[c] != copies->nbCount[e]))
+		return 0;
+
+	memset(used, 0, copies->nbCount[e] * sizeof(char));
+	for (k = 0; k < copies->nbCount[c]; ++ k) {
+		d = copies->nbFirst[c] + k;
+		for (l = 0; l < copies->nbCount[e]; ++ l) {
+			f = copies->nbFirst[e] + l;
+			if (! used[l] &&
+				(copies->maskId[copies->nb[d]] == copies->maskId[copies->nb[f]]) &&
+				same_oper(copies->rel[d], copies->rel[f])) {
+				used[l] = 1;
+				break;
+			}
+		}
+		if (l == copies->nbCount[e])
+			return 0;
+	}
+
+	return 1;
+}
+
+/*____________________________________________________________________________*/
+/** copies, their bounding spheres, neighbours and environment classes;
+	'cutoff' is the largest overlap distance of two atoms */
+static int assembly_copies(Arg *arg, Assembly *assembly, Str *pdb, Copies *copies, \
+	double cutoff)
+{
+	unsigned int c, d, i;
+	int m;
+	int allocated = 64;
+	int nNb = 0;
+	double dist;
+	double (*auCentre)[3] = 0;
+	double *auRadius = 0;
+	int nMember;
+	char *member = 0;
+	char *used = 0;
+	Vec centre;
+	size_t nAtom = pdb->nAtom;
+
+	/* copies: operations transforming atoms */
+	copies->oper = safe_malloc(assembly->nOper * sizeof(int));
+	for (c = 0, copies->nCopy = 0; c < assembly->nOper; ++ c) {
+		if (memchr(&(assembly->member[c * nAtom]), 1, nAtom) == 0)
+			continue;
+		if (! orthogonal(assembly->oper[c])) {
+			ErrorSpecNoexit("Assembly operation is not a rotation", arg->assembly);
+			return POPS_ERR_INPUT;
+		}
+		copies->oper[copies->nCopy ++] = c;
+	}
+	if (copies->nCopy == 0) {
+		ErrorSpecNoexit("Assembly operations select no atoms", arg->assembly);
+		return POPS_ERR_INPUT;
+	}
+
+	copies->maskId = safe_malloc(copies->nCopy * sizeof(int));
+	copies->centre = safe_malloc(copies->nCopy * sizeof(*(copies->centre)));
+	copies->radius = safe_malloc(copies->nCopy * sizeof(double));
+	copies->nbFirst = safe_malloc(copies->nCopy * sizeof(int));
+	copies->nbCount = safe_malloc(copies->nCopy * sizeof(int));
+	copies->rep = safe_malloc(copies->nCopy * sizeof(int));
+	copies->nb = safe_malloc(allocated * sizeof(int));
+	copies->rel = safe_malloc(allocated * sizeof(*(copies->rel)));
+	auCentre = safe_malloc(copies->nCopy * sizeof(*auCentre));
+	auRadius = safe_malloc(copies->nCopy * sizeof(double));
+
+	/*____________________________________________________________________________*/
+	/* bounding spheres: centroid and extent of the atoms in the asymmetric
+		unit, the centroid transformed by the operation of the copy */
+	for (c = 0; c < copies->nCopy; ++ c) {
+		member = &(assembly->member[copies->oper[c] * nAtom]);
+		for (d = 0; d < c; ++ d)
+			if (memcmp(member, &(assembly->member[copies->oper[d] * nAtom]), nAtom) == 0)
+				break;
+		copies->maskId[c] = d;
+
+		if (d == c) {
+			auCentre[c][0] = auCentre[c][1] = auCentre[c][2] = 0.;
+			for (i = 0, nMember = 0; i < nAtom; ++ i) {
+				if (! member[i])
+					continue;
+				auCentre[c][0] += pdb->atom[i].pos.x;
+				auCentre[c][1] += pdb->atom[i].pos.y;
+				auCentre[c][2] += pdb->atom[i].pos.z;
+				++ nMember;
+			}
+			for (m = 0; m < 3; ++ m)
+				auCentre[c][m] /= nMember;
+			for (i = 0, auRadius[c] = 0.; i < nAtom; ++ i) {
+				if (! member[i])
+					continue;
+				dist = sqrt(pow(pdb->atom[i].pos.x - auCentre[c][0], 2) +
+							pow(pdb->atom[i].pos.y - auCentre[c][1], 2) +
+							pow(pdb->atom[i].pos.z - auCentre[c][2], 2));
+				if (dist > auRadius[c])
+					auRadius[c] = dist;
+			}
+		}
+
+		centre.x = auCentre[d][0];
+		centre.y = auCentre[d][1];
+		centre.z = auCentre[d][2];
+		transform(assembly->oper[copies->oper[c]], &centre, copies->centre[c]);
+		/* margin for the float coordinates */
+		copies->radius[c] = auRadius[d] + 1e-3;
+	}
+
+	/*____________________________________________________________________________*/
+	/* neighbouring copies: bounding spheres within the overlap distance */
+	for (c = 0; c < copies->nCopy; ++ c) {
+		copies->nbFirst[c] = nNb;
+		for (d = 0; d < copies->nCopy; ++ d) {
+			if (d == c)
+				continue;
+			dist = sqrt(pow(copies->centre[c][0] - copies->centre[d][0], 2) +
+						pow(copies->centre[c][1] - copies->centre[d][1], 2) +
+						pow(copies->centre[c][2] - copies->centre[d][2], 2));
+			if (dist >= copies->radius[c] + copies->radius[d] + cutoff)
+				continue;
+			if (nNb == allocated) {
+				allocated *= 2;
+				copies->nb = safe_realloc(copies->nb, allocated * sizeof(int));
+				copies->rel = safe_realloc(copies->rel, allocated * sizeof(*(copies->rel)));
+			}
+			copies->nb[nNb] = d;
+			relative_oper(assembly->oper[copies->oper[c]],
+				assembly->oper[copies->oper[d]], copies->rel[nNb]);
+			++ nNb;
+		}
+		copies->nbCount[c] = nNb - copies->nbFirst[c];
+	}
+
+	/*____________________________________________________________________________*/
+	/* environment classes, represented by their first copy */
+	used = safe_malloc((copies->nCopy + 1) * sizeof(char));
+	for (c = 0, assembly->nClass = 0; c < copies->nCopy; ++ c) {
+		copies->rep[c] = c;
+		for (d = 0; d < c; ++ d)
+			if ((copies->rep[d] == d) && same_environment(copies, c, d, used)) {
+				copies->rep[c] = d;
+				break;
+			}
+		if (copies->rep[c] == c)
+			++ assembly->nClass;
+	}
+	assembly->nCopy = copies->nCopy;
+
+	free(used);
+	free(auCentre);
+	free(auRadius);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** free copies */
+static void free_copies(Copies *copies)
+{
+	free(copies->oper);
+	free(copies->maskId);
+	free(copies->centre);
+	free(copies->radius);
+	free(copies->nbFirst);
+	free(copies->nbCount);
+	free(copies->nb);
+	free(copies->rel);
+	free(copies->rep);
+}
+
+/*____________________________________________________________________________*/
+/** atoms of the copies flagged in 'include' (nCopy x nAtom), in order
+	of copies; chains are named in order of appearance; 'index' is 0 or
+	receives the index of each included atom; 0 if the copies have more
+	chains than chain names */
+static Atom *copy_atoms(Assembly *assembly, Str *pdb, Copies *copies, \
+	char *include, int *index, int *nCopyAtom, int verbose)
+{
+	unsigned int c, i;
+	size_t nAtom = pdb->nAtom;
+	int n = 0;
+	int nChain = -1;
+	int prevCopy = -1;
+	char prevChain = '\0';
+	double x[3];
+	Atom *atom = 0;
+
+	for (i = 0; i < copies->nCopy * nAtom; ++ i)
+		n += include[i];
+	atom = safe_malloc((n > 0 ? n : 1) * sizeof(Atom));
+
+	for (c = 0, n = 0; c < copies->nCopy; ++ c) {
+		for (i = 0; i < nAtom; ++ i) {
+			if (! include[c * nAtom + i]) {
+				if (index) index[c * nAtom + i] = -1;
+				continue;
+			}
+			/* new chain at each copy and each chain of the asymmetric unit */
+			if (c != prevCopy || pdb->atom[i].chainIdentifier[0] != prevChain) {
+				if (++ nChain == MAXASSEMBLYCHAIN) {
+					free(atom);
+					return 0;
+				}
+				prevCopy = c;
+				prevChain = pdb->atom[i].chainIdentifier[0];
+				if (verbose)
+					fprintf(stdout, "\t\tchain %c: chain %s, operation %d\n",
+						chainName[nChain],
+						pdb->atom[i].chainIdentifier, copies->oper[c] + 1);
+			}
+
+			atom[n] = pdb->atom[i];
+			atom[n].next = 0;
+			transform(assembly->oper[copies->oper[c]], &(pdb->atom[i].pos), x);
+			atom[n].pos.x = x[0];
+			atom[n].pos.y = x[1];
+			atom[n].pos.z = x[2];
+			atom[n].chainIdentifier[0] = chainName[nChain];
+			atom[n].chainIdentifier[1] = '\0';
+
+			if (index) index[c * nAtom + i] = n;
+			++ n;
+		}
+	}
+	*nCopyAtom = n;
+
+	return atom;
+}
+
+/*____________________________________________________________________________*/
+/** evaluated atoms: the representative copies and the atoms of their
+	neighbouring copies within overlap distance of the representative */
+static void evaluated_atoms(Assembly *assembly, Str *pdb, Copies *copies, \
+	double cutoff, char *include)
+{
+	unsigned int c, i, k;
+	int d;
+	size_t nAtom = pdb->nAtom;
+	double reach;
+	double x[3];
+
+	memset(include, 0, copies->nCopy * nAtom * sizeof(char));
+
+	for (c = 0; c < copies->nCopy; ++ c) {
+		if (copies->rep[c] != c)
+			continue;
+		memcpy(&(include[c * nAtom]), &(assembly->member[copies->oper[c] * nAtom]), nAtom);
+
+		reach = copies->radius[c] + cutoff;
+		for (k = 0; k < copies->nbCount[c]; ++ k) {
+			d = copies->nb[copies->nbFirst[c] + k];
+			for (i = 0; i < nAtom; ++ i) {
+				if (! assembly->member[copies->oper[d] * nAtom + i] || include[d * nAtom + i])
+					continue;
+				transform(assembly->oper[copies->oper[d]], &(pdb->atom[i].pos), x);
+				if ((pow(x[0] - copies->centre[c][0], 2) +
+					 pow(x[1] - copies->centre[c][1], 2) +
+					 pow(x[2] - copies->centre[c][2], 2)) < (reach * reach))
+					include[d * nAtom + i] = 1;
+			}
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** results of the assembly structure 'full': types of the asymmetric unit
+	and atom SASAs of the representative copy of each copy */
+static void assembly_result(PopsContext *ctx, Arg *arg, Assembly *assembly, \
+	Str *pdb, Str *full, AssemblyWork *work, PopsResult *result)
+{
+	unsigned int c, i;
+	int f;
+	size_t nAtom = pdb->nAtom;
+	Copies *copies = &(work->copies);
+
+	if (! result->packed) {
+		free(result->type.atomType);
+		free(result->type.residueType);
+	}
+	result->packed = 0;
+	free_view(&(result->view));
+	reset_arena(&(result->arena));
+
+	result->type.atomType = safe_malloc(full->nAtom * sizeof(int));
+	result->type.residueType = safe_malloc(full->nAtom * sizeof(int));
+	for (c = 0, f = 0; c < copies->nCopy; ++ c)
+		for (i = 0; i < nAtom; ++ i)
+			if (assembly->member[copies->oper[c] * nAtom + i]) {
+				result->type.atomType[f] = work->auType.atomType[i];
+				result->type.residueType[f] = work->auType.residueType[i];
+				++ f;
+			}
+	init_view(full, &(result->type), ctx->constant_sasa, &(result->view));
+
+	/* no topology of the assembly, except the Calpha distances of chain pairs */
+	memset(&(result->topol), 0, sizeof(Topol));
+	result->topol.arena = &(result->arena);
+	if (full->nChain > 1)
+		calpha_distances(arg, full, &(result->topol), ctx->res_sasa, arg->nThread);
+
+	init_sasa(full, &(result->view), &(result->molSasa), arg, &(result->arena));
+	for (c = 0, f = 0; c < copies->nCopy; ++ c)
+		for (i = 0; i < nAtom; ++ i)
+			if (assembly->member[copies->oper[c] * nAtom + i])
+				result->molSasa.atomSasa[f ++] = work->envResult.molSasa.atomSasa[
+					work->envIndex[copies->rep[c] * nAtom + i]];
+	compute_res_chain_mol_sasa(full, &(result->view), &(result->type),
+		&(result->molSasa), ctx->res_sasa);
+
+	init_sfe(full, &(result->type), &(result->molSFE), ctx->constant_sigma, arg, &(result->arena));
+	compute_sfe(full, &(result->view), &(result->type), &(result->molSasa), \
+		&(result->molSFE), ctx->constant_sigma, arg);
+}
+
+/*____________________________________________________________________________*/
+/** evaluation of the assembly in the scratch 'work' */
+static int assembly_sasa(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	Assembly *assembly, Str *full, PopsResult *result, AssemblyWork *work)
+{
+	unsigned int c, i;
+	int ret;
+	size_t nAtom = pdb->nAtom;
+	double cutoff, maxRadius = 0.;
+	View auView;
+	Arg envArg = *arg;
+	Atom *atom = 0;
+	int nCopyAtom;
+
+	/* types and radii of the asymmetric unit; the overlap distance
+		of two atoms is at most twice the largest radius plus probe */
+	if ((ret = get_types(pdb, &(work->auType), &(ctx->typeHash))) != POPS_OK)
+		return ret;
+	init_view(pdb, &(work->auType), ctx->constant_sasa, &auView);
+	for (i = 0; i < nAtom; ++ i)
+		if (auView.radius[i] > maxRadius)
+			maxRadius = auView.radius[i];
+	free_view(&auView);
+	cutoff = 2. * (maxRadius + arg->rProbe);
+
+	if ((ret = assembly_copies(arg, assembly, pdb, &(work->copies), cutoff)) != POPS_OK)
+		return ret;
+
+	/* SASA of the evaluated atoms; their structure is not printed */
+	work->include = safe_malloc(work->copies.nCopy * nAtom * sizeof(char));
+	work->envIndex = safe_malloc(work->copies.nCopy * nAtom * sizeof(int));
+	evaluated_atoms(assembly, pdb, &(work->copies), cutoff, work->include);
+
+	if ((atom = copy_atoms(assembly, pdb, &(work->copies), work->include, work->envIndex, \
+			&nCopyAtom, 0)) == 0) {
+		ErrorSpecNoexit("Assembly has more than 62 chains", arg->assembly);
+		return POPS_ERR_INPUT;
+	}
+	assembly->nEvaluated = nCopyAtom;
+	ret = pops_structure(&(work->env), pdb->pdbID, atom, nCopyAtom);
+	free(atom);
+	if (ret != POPS_OK)
+		return ret;
+
+	envArg.silent = 1;
+	if ((ret = pops_compute(ctx, &envArg, argpdb, &(work->env), 0, &(work->envResult))) != POPS_OK)
+		return ret;
+
+	/* assembly structure: all copies */
+	for (c = 0; c < work->copies.nCopy; ++ c)
+		memcpy(&(work->include[c * nAtom]),
+			&(assembly->member[work->copies.oper[c] * nAtom]), nAtom);
+	if (! arg->silent)
+		fprintf(stdout, "\tAssembly %s\n", arg->assembly);
+	if ((atom = copy_atoms(assembly, pdb, &(work->copies), work->include, 0, \
+			&nCopyAtom, ! arg->silent)) == 0) {
+		ErrorSpecNoexit("Assembly has more than 62 chains", arg->assembly);
+		return POPS_ERR_INPUT;
+	}
+	ret = pops_structure(full, pdb->pdbID, atom, nCopyAtom);
+	free(atom);
+	if (ret != POPS_OK)
+		return ret;
+
+	assembly_result(ctx, arg, assembly, pdb, full, work, result);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** SASA and SFE of the biological assembly generated from the asymmetric
+	unit 'pdb' by the operations of 'assembly'; the assembly structure
+	is returned in 'full', its results in 'result' */
+int pops_assembly(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	Assembly *assembly, Str *full, PopsResult *result)
+{
+	int ret;
+	AssemblyWork work;
+
+	memset(&work, 0, sizeof(AssemblyWork));
+	memset(full, 0, sizeof(Str));
+	pops_init_result(&(work.envResult));
+
+	ret = assembly_sasa(ctx, arg, argpdb, pdb, assembly, full, result, &work);
+
+	free(work.auType.atomType);
+	free(work.auType.residueType);
+	free(work.include);
+	free(work.envIndex);
+	free_copies(&(work.copies));
+	pops_free_structure(&(work.env));
+	pops_free_result(&(work.envResult));
+
+	return ret;
+}
@@ -0,0 +1,49 @@
+/*==============================================================================
+assembly.h : biological assembly from symmetry operations
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef ASSEMBLY_H
+#define ASSEMBLY_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "safe.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* operations of a biological assembly; each operation transforms
+	a set of atoms of the asymmetric unit into one copy of the assembly */
+typedef struct {
+	int nAtom; /* atoms of the asymmetric unit */
+	int nOper; /* operations */
+	int allocatedOper;
+	double (*oper)[12]; /* rotation rows with translation: r11 r12 r13 t1 r21 ... */
+	char *member; /* nOper x nAtom: atom transformed by the operation */
+	int nCopy; /* copies: operations transforming atoms */
+	int nClass; /* classes of copies with the same environment */
+	int nEvaluated; /* atoms of the SASA evaluation */
+} Assembly;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+void init_assembly(Assembly *assembly, int nAtom);
+int add_assembly_oper(Assembly *assembly, double *oper);
+void free_assembly(Assembly *assembly);
+int read_assembly_pdb(Arg *arg, Str *pdb, Assembly *assembly);
+int pops_assembly(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	Assembly *assembly, Str *full, PopsResult *result);
+
+#endif
+
@@ -27,9 +27,5 @@ typedef struct {
 	AtomdataGroup atomDataGroup[64][64]; /* atom-specific data */
 } Atomgroup;
 
-/*____________________________________________________________________________*/
-/* prototypes */
-int get_atomgroup(Str *str, Atomgroup *atomgroup);
-
 #endif
 
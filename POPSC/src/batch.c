@@ -0,0 +1,402 @@
+/*==============================================================================
+batch.c : multi-structure batch mode on a work-stealing thread pool
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+/* All entries of a batch are computed in one process: the parameter tables
+	are shared, each thread reuses the arena of its result for one entry
+	after the other, and each entry writes its own output files.
+	Entries are dealt largest-first to the thread queues; a thread with an
+	empty queue steals from the tail of the other queues, so that all
+	threads stay busy until the last entries. */
+
+#include "batch.h"
+
+/*____________________________________________________________________________*/
+/** add entry of input file with optional output directory */
+static void add_entry(Batch *batch, int *allocated, char *fileName, char *outDirName)
+{
+	struct stat fileStat;
+	BatchEntry *entry = 0;
+
+	if (batch->nEntry == *allocated) {
+		*allocated += 64;
+		batch->entry = safe_realloc(batch->entry, *allocated * sizeof(BatchEntry));
+	}
+
+	entry = &(batch->entry[batch->nEntry ++]);
+	entry->fileName = safe_malloc(strlen(fileName) + 1);
+	strcpy(entry->fileName, fileName);
+	entry->outDirName = 0;
+	if (outDirName) {
+		entry->outDirName = safe_malloc(strlen(outDirName) + 1);
+		strcpy(entry->outDirName, outDirName);
+	}
+	entry->format = pops_input_format(fileName, &(entry->id), &(entry->zipped));
+	entry->size = (stat(fileName, &fileStat) == 0) ? fileStat.st_size : 0;
+	entry->status = POPS_OK;
+	entry->current = 0;
+}
+
+/*____________________________________________________________________________*/
+/** read entries: structure files of a directory or lines of a list file */
+static int read_entries(Batch *batch, char *batchName)
+{
+	int allocated = 0;
+	unsigned int n;
+	char fileName[1024];
+	char line[1024];
+	char *outDirName = 0;
+	struct stat batchStat;
+	struct dirent *dirEntry = 0;
+	DIR *dir = 0;
+	FILE *listFile = 0;
+	int zipped;
+
+	batch->entry = 0;
+	batch->nEntry = 0;
+
+	if (stat(batchName, &batchStat) != 0) {
+		ErrorSpecNoexit("Cannot access batch", batchName);
+		return POPS_ERR_INPUT;
+	}
+
+	if (S_ISDIR(batchStat.st_mode)) {
+		/* directory: files of known input formats */
+		if ((dir = opendir(batchName)) == 0) {
+			ErrorSpecNoexit("Cannot read batch directory", batchName);
+			return POPS_ERR_INPUT;
+		}
+		while ((dirEntry = readdir(dir)) != 0) {
+			if (dirEntry->d_name[0] == '.')
+				continue;
+			if (pops_input_format(dirEntry->d_name, 0, &zipped) >= 0) {
+				snprintf(fileName, sizeof(fileName), "%s/%s", batchName, dirEntry->d_name);
+				add_entry(batch, &allocated, fileName, 0);
+			}
+		}
+		closedir(dir);
+	} else {
+		/* list file: one input file per line, optionally followed by
+			the output directory of the entry; '#' for comments */
+		listFile = safe_open(batchName, "r");
+		while (fgets(line, sizeof(line), listFile) != 0) {
+			for (n = strlen(line); n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r' || line[n - 1] == ' '); -- n)
+				line[n - 1] = '\0';
+			if ((line[0] == '\0') || (line[0] == '#'))
+				continue;
+			outDirName = strpbrk(line, " \t");
+			if (outDirName) {
+				*(outDirName ++) = '\0';
+				outDirName += strspn(outDirName, " \t");
+				if (*outDirName == '\0')
+					outDirName = 0;
+			}
+			add_entry(batch, &allocated, line, outDirName);
+		}
+		fclose(listFile);
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** compare entries by decreasing size, then by file name */
+static int compare_entry_size(const void *a, const void *b)
+{
+	const BatchEntry *ea = (const BatchEntry *)a;
+	const BatchEntry *eb = (const BatchEntry *)b;
+
+	if (ea->size != eb->size)
+		return (ea->size > eb->size) ? -1 : 1;
+	return strcmp(ea->fileName, eb->fileName);
+}
+
+/*____________________________________________________________________________*/
+/** output file name of entry: '<outDirName>/<id>.<name>' in 'buffer'
+	of 1024 bytes; NULL if the name is too long */
+static char *entry_file_name(char *buffer, Arg *arg, BatchEntry *entry, char *name)
+{
+	char *base = strrchr(name, '/');
+
+	if (snprintf(buffer, 1024, "%s/%s.%s", arg->outDirName, entry->id,
+			base ? base + 1 : name) >= 1024) {
+		fprintf(stderr, "Error: Output file name too long: '%s/%s.%s'\n",
+			arg->outDirName, entry->id, base ? base + 1 : name);
+		return NULL;
+	}
+
+	return buffer;
+}
+
+/*____________________________________________________________________________*/
+/** compute one entry with its own copy of the options */
+static int compute_entry(Batch *batch, BatchEntry *entry, PopsResult *result)
+{
+	Arg arg = *(batch->arg);
+	Argpdb argpdb = *(batch->argpdb);
+	Str pdb;
+	Pack pack = {0, 0, 0, 0, 0, 0};
+	int ret = POPS_OK;
+	char sasaOutFileName[1024], bsasaOutFileName[1024], sigmaOutFileName[1024];
+	char interfaceOutFileName[1024], distMatCAOutFileName[1024];
+	char neighbourOutFileName[1024], parameterOutFileName[1024];
+	char jsonFileName[1024];
+	char outputName[1024];
+	FILE *jsonFile = 0;
+	ManifestRecord key;
+
+	/*____________________________________________________________________________*/
+	/* input and per-entry output files; entries run concurrently,
+		each on one thread */
+	arg.silent = 1;
+	arg.nThread = 1;
+	if (entry->outDirName)
+		arg.outDirName = entry->outDirName;
+	arg.pdbIn = entry->id;
+	if (pops_set_input(&arg, entry->fileName, entry->format, entry->zipped) != POPS_OK) {
+		fprintf(stderr, "Unknown input format: %s\n", entry->fileName);
+		return POPS_ERR_INPUT;
+	}
+
+	arg.sasaOutFileName = entry_file_name(sasaOutFileName, &arg, entry, batch->arg->sasaOutFileName);
+	arg.bsasaOutFileName = entry_file_name(bsasaOutFileName, &arg, entry, batch->arg->bsasaOutFileName);
+	arg.sigmaOutFileName = entry_file_name(sigmaOutFileName, &arg, entry, batch->arg->sigmaOutFileName);
+	arg.interfaceOutFileName = entry_file_name(interfaceOutFileName, &arg, entry, batch->arg->interfaceOutFileName);
+	arg.distMatCAOutFileName = entry_file_name(distMatCAOutFileName, &arg, entry, batch->arg->distMatCAOutFileName);
+	arg.neighbourOutFileName = entry_file_name(neighbourOutFileName, &arg, entry, batch->arg->neighbourOutFileName);
+	arg.parameterOutFileName = entry_file_name(parameterOutFileName, &arg, entry, batch->arg->parameterOutFileName);
+	arg.routPrefix = entry->id;
+	if (! arg.sasaOutFileName || ! arg.bsasaOutFileName || ! arg.sigmaOutFileName ||
+		! arg.interfaceOutFileName || ! arg.distMatCAOutFileName ||
+		! arg.neighbourOutFileName || ! arg.parameterOutFileName)
+		return POPS_ERR_OUTPUT;
+
+	/*____________________________________________________________________________*/
+	/* skip entry with current output */
+	if (batch->manifest) {
+		if ((ret = manifest_key(batch->ctx, &arg, &argpdb, &key)) != POPS_OK)
+			return ret;
+		if (manifest_current(batch->manifest, &key)) {
+			entry->current = 1;
+			return POPS_OK;
+		}
+	}
+
+	/*____________________________________________________________________________*/
+	/* read structure */
+	strcpy(pdb.pdbID, "");
+	if (arg.packDirName && (load_pack(&arg, &argpdb, &pack, &pdb, &(result->type)) == 0)) {
+		/* parsed and typed structure plus bonded topology from pack */
+	} else {
+		ret = pops_read(&arg, &argpdb, &pdb);
+	}
+	if (ret != POPS_OK) {
+		free_pack(&pack);
+		return ret;
+	}
+
+	/* PDB files carry no identifier: JSON output is named by entry */
+	if (strlen(pdb.pdbID) == 0)
+		snprintf(pdb.pdbID, sizeof(pdb.pdbID), "%s", entry->id);
+
+	/*____________________________________________________________________________*/
+	/* compute and print */
+	if ((ret = pops_compute(batch->ctx, &arg, &argpdb, &pdb, &pack, result)) == POPS_OK) {
+		ret = pops_print(batch->ctx, &arg, &argpdb, &pdb, result);
+		if ((ret == POPS_OK) && batch->manifest)
+			manifest_record(batch->manifest, &key, manifest_output(outputName, &arg, &pdb));
+	} else if (ret != POPS_ERR_TYPE) {
+		/* empty JSON file for structures without computable surface */
+		if (snprintf(jsonFileName, sizeof(jsonFileName), "%s/%s.json",
+				arg.outDirName, pdb.pdbID) < sizeof(jsonFileName)) {
+			if ((jsonFile = fopen(jsonFileName, "a")) != 0)
+				fclose(jsonFile);
+			if (batch->manifest)
+				manifest_record(batch->manifest, &key, jsonFileName);
+		}
+	}
+
+	/*____________________________________________________________________________*/
+	/* free structure */
+	pops_free_input(&arg, &pdb, &pack, result);
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** next entry of thread: own queue head first, then steal from other tails */
+static int next_entry(Batch *batch, int thread)
+{
+	int i, t;
+	int next = -1;
+	BatchQueue *queue = 0;
+
+	for (i = 0; i < batch->nThread && next < 0; ++ i) {
+		t = (thread + i) % batch->nThread;
+		queue = &(batch->queue[t]);
+
+		pthread_mutex_lock(&(queue->lock));
+		if (queue->head < queue->tail) {
+			if (i == 0)
+				next = queue->entry[queue->head ++];
+			else
+				next = queue->entry[-- queue->tail];
+		}
+		pthread_mutex_unlock(&(queue->lock));
+	}
+
+	return next;
+}
+
+/*____________________________________________________________________________*/
+/* thread argument */
+typedef struct {
+	Batch *batch;
+	int thread;
+} BatchThread;
+
+/*____________________________________________________________________________*/
+/** thread: compute entries until all queues are empty;
+	entries are never added, so one empty pass over all queues ends the thread */
+static void *batch_thread(void *threadArg)
+{
+	BatchThread *bt = (BatchThread *)threadArg;
+	Batch *batch = bt->batch;
+	PopsResult result;
+	int e;
+
+	pops_init_result(&result);
+
+	while ((e = next_entry(batch, bt->thread)) >= 0) {
+		batch->entry[e].status = compute_entry(batch, &(batch->entry[e]), &result);
+		if (! batch->arg->silent && (batch->entry[e].status != POPS_OK))
+			fprintf(stderr, "\t%s: %s\n", batch->entry[e].fileName,
+				pops_strerror(batch->entry[e].status));
+	}
+
+	pops_free_result(&result);
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** compute all entries of a batch (directory or list file);
+	returns the number of failed entries */
+int run_batch(PopsContext *ctx, Arg *arg, Argpdb *argpdb)
+{
+	unsigned int i;
+	int nThread;
+	int nStarted;
+	int nFailed = 0;
+	int nEmpty = 0;
+	int nCurrent = 0;
+	Batch batch;
+	Manifest manifest;
+	BatchThread *bt = 0;
+	pthread_t *thread = 0;
+
+	batch.ctx = ctx;
+	batch.arg = arg;
+	batch.argpdb = argpdb;
+	batch.manifest = 0;
+
+	if (read_entries(&batch, arg->batchName) != POPS_OK)
+		return 1;
+
+	if (arg->manifestName) {
+		if (open_manifest(&manifest, arg->manifestName) != POPS_OK)
+			return 1;
+		batch.manifest = &manifest;
+	}
+
+	/*____________________________________________________________________________*/
+	/* largest first, dealt round-robin to the thread queues */
+	qsort(batch.entry, batch.nEntry, sizeof(BatchEntry), compare_entry_size);
+
+	nThread = (arg->nThread > 0) ? arg->nThread : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThread > batch.nEntry)
+		nThread = batch.nEntry;
+	if (nThread < 1)
+		nThread = 1;
+	batch.nThread = nThread;
+
+	batch.queue = safe_malloc(nThread * sizeof(BatchQueue));
+	for (i = 0; i < nThread; ++ i) {
+		batch.queue[i].entry = safe_malloc((batch.nEntry / nThread + 1) * sizeof(int));
+		batch.queue[i].head = 0;
+		batch.queue[i].tail = 0;
+		pthread_mutex_init(&(batch.queue[i].lock), 0);
+	}
+	for (i = 0; i < batch.nEntry; ++ i)
+		batch.queue[i % nThread].entry[batch.queue[i % nThread].tail ++] = i;
+
+	if (! arg->silent)
+		fprintf(stdout, "Batch: %d entries on %d threads\n", batch.nEntry, nThread);
+
+	/*____________________________________________________________________________*/
+	/* thread pool */
+	thread = safe_malloc(nThread * sizeof(pthread_t));
+	bt = safe_malloc(nThread * sizeof(BatchThread));
+	for (i = 0; i < nThread; ++ i) {
+		bt[i].batch = &batch;
+		bt[i].thread = i;
+	}
+	/* the queues of threads that cannot be started are stolen by the others;
+		without any started thread the calling thread computes all entries */
+	for (nStarted = 0; nStarted < nThread; ++ nStarted)
+		if (pthread_create(&(thread[nStarted]), 0, batch_thread, &(bt[nStarted])) != 0)
+			break;
+	if (nStarted == 0)
+		batch_thread(&(bt[0]));
+	for (i = 0; i < nStarted; ++ i)
+		pthread_join(thread[i], 0);
+
+	/*____________________________________________________________________________*/
+	/* summary: structures without computable surface have empty output,
+		as in single-structure mode; unreadable or unparametrised ones fail */
+	for (i = 0; i < batch.nEntry; ++ i) {
+		if (batch.entry[i].current)
+			++ nCurrent;
+		if (batch.entry[i].status == POPS_OK)
+			continue;
+		if ((batch.entry[i].status == POPS_ERR_INPUT) ||
+			(batch.entry[i].status == POPS_ERR_TYPE) ||
+			(batch.entry[i].status == POPS_ERR_OUTPUT))
+			++ nFailed;
+		else
+			++ nEmpty;
+	}
+
+	fprintf(stdout, "Batch summary: %d entries, %d computed, %d current, %d empty, %d failed\n",
+		batch.nEntry, batch.nEntry - nCurrent - nEmpty - nFailed, nCurrent, nEmpty, nFailed);
+	for (i = 0; i < batch.nEntry; ++ i) {
+		if (batch.entry[i].status != POPS_OK)
+			fprintf(stdout, "\t%s\t%s\n", batch.entry[i].fileName,
+				pops_strerror(batch.entry[i].status));
+	}
+
+	/* the manifest keeps the last record of each input */
+	if (batch.manifest)
+		close_manifest(&manifest, 1);
+
+	/*____________________________________________________________________________*/
+	/* free memory */
+	for (i = 0; i < nThread; ++ i) {
+		free(batch.queue[i].entry);
+		pthread_mutex_destroy(&(batch.queue[i].lock));
+	}
+	free(batch.queue);
+	free(thread);
+	free(bt);
+	for (i = 0; i < batch.nEntry; ++ i) {
+		free(batch.entry[i].fileName);
+		free(batch.entry[i].id);
+		free(batch.entry[i].outDirName);
+	}
+	free(batch.entry);
+
+	return nFailed;
+}
+
@@ -0,0 +1,67 @@
+/*==============================================================================
+batch.h : multi-structure batch mode on a work-stealing thread pool
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "manifest.h"
+#include "pack.h"
+#include "safe.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* batch entry */
+typedef struct {
+	char *fileName; /* input file */
+	char *id; /* output prefix: file name without extensions */
+	char *outDirName; /* output directory, 0 for the '--outDirName' default */
+	int format; /* input format: 0 pdb, 1 pdbml, 2 mmcif */
+	int zipped; /* gzip compressed */
+	off_t size; /* file size, for largest-first scheduling */
+	int status; /* return code */
+	int current; /* output current according to manifest, not computed */
+} BatchEntry;
+
+/* entry queue of one thread: the owner takes entries from the head,
+	idle threads steal from the tail */
+typedef struct {
+	int *entry; /* entry indices, largest first */
+	int head; /* next entry of owner */
+	int tail; /* end of queue */
+	pthread_mutex_t lock;
+} BatchQueue;
+
+/* batch shared by all threads */
+typedef struct {
+	BatchEntry *entry;
+	int nEntry;
+	BatchQueue *queue;
+	int nThread;
+	PopsContext *ctx; /* parameter tables, read-only */
+	Arg *arg; /* options, copied per entry */
+	Argpdb *argpdb;
+	Manifest *manifest; /* manifest of current outputs, 0 if none */
+} Batch;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int run_batch(PopsContext *ctx, Arg *arg, Argpdb *argpdb);
+
+#endif
+
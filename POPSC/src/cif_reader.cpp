@@ -62,7 +62,62 @@ static std::string gunzip_to_temp_file(const char* filename) {
 }
 
 /*___________________________________________________________________________*/
-Structure* read_cif(const char* filename) {
+/* operations of biological assembly 'assembly' from
+   '_pdbx_struct_assembly_gen' and '_pdbx_struct_oper_list';
+   'gemmi' expands the operator expressions of the generators */
+static bool read_assembly(const gemmi::Structure& st, const gemmi::Model& model,
+                          const char* assembly, Structure* s) {
+    const gemmi::Assembly* as = nullptr;
+
+    for (const gemmi::Assembly& a : st.assemblies)
+        if (a.name == assembly)
+            as = &a;
+    if (!as)
+        return false;
+
+    int n = 0;
+    for (const gemmi::Assembly::Gen& gen : as->generators)
+        n += (int) gen.operators.size();
+
+    s->noper = n;
+    s->oper = (double*) std::malloc(sizeof(double) * 12 * (n > 0 ? n : 1));
+    s->oper_atom = (char*) std::calloc((size_t) n * s->natom + 1, sizeof(char));
+    if (!s->oper || !s->oper_atom)
+        return false;
+
+    int k = 0;
+    for (const gemmi::Assembly::Gen& gen : as->generators) {
+        for (const gemmi::Assembly::Operator& op : gen.operators) {
+            const gemmi::Transform& tr = op.transform;
+
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 3; ++c)
+                    s->oper[12*k + 4*r + c] = tr.mat.a[r][c];
+                s->oper[12*k + 4*r + 3] = tr.vec.at(r);
+            }
+
+            /* atoms of the listed subchains (label_asym_id) or chains */
+            int i = 0;
+            for (const gemmi::Chain& chain : model.chains) {
+                for (const gemmi::Residue& res : chain.residues) {
+                    bool member =
+                        gemmi::in_vector(res.subchain, gen.subchains) ||
+                        gemmi::in_vector(chain.name, gen.chains);
+
+                    for (size_t a = 0; a < res.atoms.size(); ++a, ++i)
+                        s->oper_atom[(size_t) k * s->natom + i] = member;
+                }
+            }
+
+            ++k;
+        }
+    }
+
+    return true;
+}
+
+/*___________________________________________________________________________*/
+Structure* read_cif(const char* filename, const char* assembly) {
     Structure* s = nullptr;
 
     try {
@@ -172,6 +227,12 @@ Structure* read_cif(const char* filename) {
             ++s->chain_number;
         }
 
+        if (assembly && !read_assembly(st, model, assembly, s)) {
+            fprintf(stderr, "Assembly %s not found\n", assembly);
+            free_structure(s);
+            return nullptr;
+        }
+
         return s;
     }
 
@@ -218,6 +279,8 @@ void free_structure(Structure* s) {
     std::free(s->chain_name);
     std::free(s->element);
     std::free(s->record_type);
+    std::free(s->oper);
+    std::free(s->oper_atom);
     std::free(s);
 }
 
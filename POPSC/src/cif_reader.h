@@ -5,6 +5,9 @@ Copyright (C) 2026 Jens Kleinjung
 Read the COPYING file for license information.
 ==============================================================================*/
 
+#ifndef CIF_READER_H
+#define CIF_READER_H
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,10 +34,15 @@ typedef struct {
 	char** element;
 
 	char* record_type;
+
+	/* operations of the selected biological assembly */
+	int noper;
+	double* oper; /* 3x4 matrix per operation: rotation rows with translation */
+	char* oper_atom; /* noper x natom: atom transformed by the operation */
 } Structure;
 
 /*___________________________________________________________________________*/
-Structure* read_cif(const char* filename);
+Structure* read_cif(const char* filename, const char* assembly);
 void free_structure(Structure* s);
 
 /*___________________________________________________________________________*/
@@ -42,3 +50,4 @@ void free_structure(Structure* s);
 }
 #endif
 
+#endif
@@ -0,0 +1,165 @@
+/*==============================================================================
+dual.c : atomic and coarse-grained SASA of one structure in one run
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "dual.h"
+
+/*____________________________________________________________________________*/
+/* The coarse-grained model consists of the CA and N3 atoms that the readers
+	record under '--coarse'. The atomic structure lists these atoms as
+	residue atoms ('resAtom'), so the coarse-grained structure is copied
+	from the atomic structure instead of parsing the input a second time.
+	Both structures are computed concurrently with their own parameter
+	tables and results; the coarse-grained outputs carry the prefix
+	'coarse.' in their file names. */
+
+/*____________________________________________________________________________*/
+/** coarse-grained structure: the residue atoms of the atomic structure */
+static void coarse_structure(Str *pdb, Str *coarse)
+{
+	unsigned int k;
+	Atom *atom = 0;
+
+	memset(coarse, 0, sizeof(Str));
+	strcpy(coarse->pdbID, pdb->pdbID);
+	coarse->atom = safe_malloc((pdb->nResidue > 0 ? pdb->nResidue : 1) * sizeof(Atom));
+	coarse->atomMap = safe_malloc((pdb->nResidue > 0 ? pdb->nResidue : 1) * sizeof(int));
+	coarse->resAtom = safe_malloc((pdb->nResidue > 0 ? pdb->nResidue : 1) * sizeof(int));
+	coarse->sequence.res = safe_malloc((pdb->nResidue + 1) * sizeof(char));
+
+	for (k = 0; k < pdb->nResidue; ++ k) {
+		atom = &(coarse->atom[k]);
+		*atom = pdb->atom[pdb->resAtom[k]];
+		coarse->atomMap[k] = pdb->atomMap[pdb->resAtom[k]];
+		coarse->resAtom[k] = k;
+		coarse->sequence.res[k] = pdb->sequence.res[k];
+
+		/* residues and chains counted as by the readers */
+		if ((k == 0) || (atom->residueNumber != (atom - 1)->residueNumber) ||
+				(strcmp(atom->icode, (atom - 1)->icode) != 0))
+			++ coarse->nAllResidue;
+		if ((k == 0) || (atom->chainIdentifier[0] != (atom - 1)->chainIdentifier[0]))
+			++ coarse->nChain;
+	}
+	coarse->sequence.res[k] = '\0';
+	coarse->nAtom = coarse->nResidue = pdb->nResidue;
+	coarse->nAllAtom = pdb->nAllAtom;
+}
+
+/*____________________________________________________________________________*/
+/** coarse-grained output name: 'coarse.' before the base name, in
+	'buffer' of 1024 bytes; NULL if the name is too long */
+static char *coarse_name(char *buffer, char *name)
+{
+	char *base = strrchr(name, '/');
+	int length;
+
+	if (base)
+		length = snprintf(buffer, 1024, "%.*s/coarse.%s", (int)(base - name), name, base + 1);
+	else
+		length = snprintf(buffer, 1024, "coarse.%s", name);
+	if (length >= 1024) {
+		fprintf(stderr, "Error: Output file name too long: coarse.%s\n", base ? base + 1 : name);
+		return NULL;
+	}
+
+	return buffer;
+}
+
+/*____________________________________________________________________________*/
+/** coarse-grained options: silent, output names with prefix;
+	POPS_ERR_OUTPUT if an output name is too long */
+static int coarse_arg(Arg *arg, Argpdb *argpdb, PopsDual *dual)
+{
+	dual->arg = *arg;
+	dual->argpdb = *argpdb;
+	dual->argpdb.coarse = 1;
+
+	/* the atomic computation reports progress */
+	dual->arg.silent = 1;
+
+	dual->arg.sasaOutFileName = coarse_name(dual->outName[0], arg->sasaOutFileName);
+	dual->arg.bsasaOutFileName = coarse_name(dual->outName[1], arg->bsasaOutFileName);
+	dual->arg.sigmaOutFileName = coarse_name(dual->outName[2], arg->sigmaOutFileName);
+	dual->arg.interfaceOutFileName = coarse_name(dual->outName[3], arg->interfaceOutFileName);
+	dual->arg.distMatCAOutFileName = coarse_name(dual->outName[4], arg->distMatCAOutFileName);
+	dual->arg.neighbourOutFileName = coarse_name(dual->outName[5], arg->neighbourOutFileName);
+	dual->arg.parameterOutFileName = coarse_name(dual->outName[6], arg->parameterOutFileName);
+	dual->arg.routPrefix = coarse_name(dual->outName[7], arg->routPrefix);
+
+	if (! dual->arg.sasaOutFileName || ! dual->arg.bsasaOutFileName ||
+		! dual->arg.sigmaOutFileName || ! dual->arg.interfaceOutFileName ||
+		! dual->arg.distMatCAOutFileName || ! dual->arg.neighbourOutFileName ||
+		! dual->arg.parameterOutFileName || ! dual->arg.routPrefix)
+		return POPS_ERR_OUTPUT;
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** thread: coarse-grained computation */
+static void *compute_coarse(void *data)
+{
+	PopsDual *dual = (PopsDual *)data;
+
+	dual->ret = pops_compute(&(dual->ctx), &(dual->arg), &(dual->argpdb), \
+		&(dual->pdb), 0, &(dual->result));
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** atomic computation of 'pdb' into 'result' and, concurrently,
+	coarse-grained computation of its CA and N3 atoms into 'dual';
+	returns the code of the atomic computation, 'dual->ret' holds
+	the code of the coarse-grained computation */
+int pops_dual(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result, PopsDual *dual)
+{
+	int ret;
+	pthread_t thread;
+	int threaded;
+
+	pops_init(&(dual->ctx), 1);
+	pops_init_result(&(dual->result));
+	coarse_structure(pdb, &(dual->pdb));
+	/* without valid coarse-grained output names, the atomic computation only */
+	if ((dual->ret = coarse_arg(arg, argpdb, dual)) != POPS_OK)
+		return pops_compute(ctx, arg, argpdb, pdb, 0, result);
+
+	/* without a second thread, compute one after the other */
+	threaded = (pthread_create(&thread, 0, compute_coarse, dual) == 0);
+
+	ret = pops_compute(ctx, arg, argpdb, pdb, 0, result);
+
+	if (threaded)
+		pthread_join(thread, 0);
+	else
+		compute_coarse(dual);
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** print coarse-grained SASA, bSASA and Calpha distances */
+int pops_print_dual(PopsDual *dual)
+{
+	return pops_print(&(dual->ctx), &(dual->arg), &(dual->argpdb), \
+		&(dual->pdb), &(dual->result));
+}
+
+/*____________________________________________________________________________*/
+/** free coarse-grained structure, result and parameter tables */
+void pops_free_dual(PopsDual *dual)
+{
+	pops_free_result(&(dual->result));
+	pops_free(&(dual->ctx));
+	free(dual->pdb.atom);
+	free(dual->pdb.atomMap);
+	free(dual->pdb.resAtom);
+	free(dual->pdb.sequence.res);
+}
+
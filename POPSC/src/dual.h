@@ -0,0 +1,43 @@
+/*==============================================================================
+dual.h : atomic and coarse-grained SASA of one structure in one run
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "pdb_structure.h"
+#include "safe.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* coarse-grained computation alongside the atomic computation */
+typedef struct {
+	PopsContext ctx; /* coarse-grained parameter tables */
+	Arg arg; /* options with the coarse-grained output names */
+	Argpdb argpdb;
+	Str pdb; /* CA and N3 atoms of the atomic structure */
+	PopsResult result;
+	int ret; /* return code of the coarse-grained computation */
+	char outName[8][1024]; /* storage of the output names */
+} PopsDual;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_dual(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result, PopsDual *dual);
+int pops_print_dual(PopsDual *dual);
+void pops_free_dual(PopsDual *dual);
+
+#endif
+
@@ -6,22 +6,19 @@ Read the COPYING file for license information.
 
 #include "error.h"
 
-int status = 0;
+/* The routines keep no state: they are called from the worker threads
+	of the batch, server, POPSCOMP and dual modes. */
 
 /*____________________________________________________________________________*/
 /** print warning message */
 void Warning(char *message) {
-	extern int status;
     fprintf(stderr, "Warning: %s\n", message);
-	status = -1;
 }
 
 /*____________________________________________________________________________*/
 /** print warning message with specification */
 void WarningSpec(char *message, char *spec) {
-	extern int status;
     fprintf(stderr, "Warning: %s (%s)\n", message, spec);
-	status = -1;
 }
 
 /*____________________________________________________________________________*/
@@ -41,9 +38,7 @@ void ErrorSpec(char *message, char *spec) {
 /*____________________________________________________________________________*/
 /** print error message with specification, don't exit */
 void ErrorSpecNoexit(char *message, char *spec) {
-	extern int status;
     fprintf(stderr, "Error: %s (%s)\n", message, spec);
-	status = 0;
 }
 
 /*____________________________________________________________________________*/
@@ -10,6 +10,21 @@ Read the COPYING file for license information.
 #include <stdio.h>
 #include <stdlib.h>
 
+/*____________________________________________________________________________*/
+/* return codes of the computation routines, which return to the caller
+	instead of terminating the program */
+enum {
+	POPS_OK = 0, /* success */
+	POPS_ERR_INPUT, /* input structure not readable or without atoms */
+	POPS_ERR_TYPE, /* atom without parametrisation */
+	POPS_ERR_ATOM, /* less than 2 atoms */
+	POPS_ERR_BOND, /* less than 2 bonds */
+	POPS_ERR_ANGLE, /* less than 2 angles */
+	POPS_ERR_TORSION, /* less than 2 torsions */
+	POPS_ERR_CONTACT, /* self-contact or too short atom distance */
+	POPS_ERR_OUTPUT /* output not writable */
+};
+
 /*____________________________________________________________________________*/
 /* prototypes */
 void Warning(char *message);
@@ -0,0 +1,513 @@
+/*==============================================================================
+fit.c : re-fitting of SASA parameters from cached pair geometry
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "fit.h"
+
+/*____________________________________________________________________________*/
+/* 'mod_atom_sasa' scales the SASA of atom a by 1 - p_c * b_al * P_a / S_a
+	per overlap with atom l: the overlap term b_al and the surface S_a
+	depend on the radii and the coordinates only, the connectivity
+	parameter p_c and the atom parameter P_a are the fitted parameters.
+	The terms g_al = b_al / S_a of all training atoms are computed once;
+	a parameter vector is then evaluated in one linear pass over the terms,
+	together with the analytical gradient of the squared deviation from
+	the reference SASA:
+		dSASA_a / dP_a = -SASA_a * sum_l p_c g_al / f_al
+		dSASA_a / dp_c = -SASA_a * sum_l(c) P_a g_al / f_al
+	A factor f_al of exactly 0 contributes no gradient.
+	The radii are not fitted, they define the cached geometry. */
+
+/* number of steps kept by the L-BFGS optimiser */
+#define FITHISTORY 5
+
+/* atom number and index, for the reference lookup */
+typedef struct {
+	int atomNumber;
+	int atom;
+} FitAtom;
+
+/*____________________________________________________________________________*/
+/** compare atoms by atom number */
+static int compare_fit_atom(const void *a, const void *b)
+{
+	return ((const FitAtom *)a)->atomNumber - ((const FitAtom *)b)->atomNumber;
+}
+
+/*____________________________________________________________________________*/
+/** reference SASA of the atoms of 'pdb': lines of atom number and SASA,
+	other lines are skipped; atoms without reference are NAN;
+	returns the number of atoms with a reference or -1 */
+static int read_reference(char *referenceFileName, Str *pdb, double *reference)
+{
+	FILE *referenceFile = 0;
+	char line[1024];
+	FitAtom *sorted = 0;
+	FitAtom key;
+	FitAtom *found = 0;
+	double sasa;
+	unsigned int i;
+	int nReference = 0;
+
+	if ((referenceFile = fopen(referenceFileName, "r")) == 0) {
+		ErrorSpecNoexit("Cannot read reference SASA", referenceFileName);
+		return -1;
+	}
+
+	sorted = safe_malloc((pdb->nAtom + 1) * sizeof(FitAtom));
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		sorted[i].atomNumber = pdb->atom[i].atomNumber;
+		sorted[i].atom = i;
+		reference[i] = NAN;
+	}
+	qsort(sorted, pdb->nAtom, sizeof(FitAtom), compare_fit_atom);
+
+	while (fgets(line, sizeof(line), referenceFile) != 0) {
+		if (sscanf(line, "%d %lf", &(key.atomNumber), &sasa) != 2)
+			continue;
+		if ((found = bsearch(&key, sorted, pdb->nAtom, sizeof(FitAtom), compare_fit_atom)) == 0)
+			continue;
+		if (isnan(reference[found->atom]))
+			++ nReference;
+		reference[found->atom] = sasa;
+	}
+
+	fclose(referenceFile);
+	free(sorted);
+
+	return nReference;
+}
+
+/*____________________________________________________________________________*/
+/** append the pair terms of the atoms with a reference SASA ('reference'
+	not NAN) of a computed result to the cache */
+int fit_cache_structure(FitCache *cache, PopsContext *ctx, Arg *arg, Str *pdb, \
+	PopsResult *result, double *reference)
+{
+	View *view = &(result->view);
+	Topol *topol = &(result->topol);
+	Type *type = &(result->type);
+	MolSasa *molSasa = &(result->molSasa);
+	int nInteraction = topol->nBond + topol->nAngle + topol->nTorsion + topol->nNonBonded;
+	int *global = 0; /* cache index of each atom, -1 if not trained */
+	int *next = 0; /* next term of each atom */
+	double geometry_i, geometry_j;
+	int nNewAtom = 0;
+	int nNewTerm = 0;
+	int connect;
+	int key;
+	unsigned int k;
+	int i, j, a;
+
+	global = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	next = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+
+	/*____________________________________________________________________________*/
+	/* training atoms and their parameters */
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		global[i] = -1;
+		next[i] = 0;
+		/* only atoms with a parameter in the SASA table, which also bounds 'typeIndex' */
+		if (isnan(reference[i]) || (type->residueType[i] < 0) || (type->atomType[i] < 0) || \
+			(type->residueType[i] >= ctx->constant_sasa->nResidueType) || \
+			(type->atomType[i] >= ctx->constant_sasa->nAtomResidue[type->residueType[i]]))
+			continue;
+		global[i] = cache->nAtom + nNewAtom ++;
+		key = type->residueType[i] * 64 + type->atomType[i];
+		if (cache->typeIndex[key] < 0) {
+			cache->typeKey = safe_realloc(cache->typeKey, (cache->nType + 1) * sizeof(int));
+			cache->typeCount = safe_realloc(cache->typeCount, (cache->nType + 1) * sizeof(int));
+			cache->typeKey[cache->nType] = key;
+			cache->typeCount[cache->nType] = 0;
+			cache->typeIndex[key] = cache->nType ++;
+		}
+	}
+
+	/*____________________________________________________________________________*/
+	/* terms per training atom */
+	for (k = 0; k < nInteraction; ++ k) {
+		topol_interaction(topol, k, &i, &j);
+		if (! overlap_geometry(view, molSasa, i, j, arg->rProbe, &geometry_i, &geometry_j))
+			continue;
+		if (global[i] >= 0) ++ next[i];
+		if (global[j] >= 0) ++ next[j];
+	}
+
+	if (cache->nAtom + nNewAtom + 1 > cache->allocatedAtom) {
+		cache->allocatedAtom = 2 * (cache->nAtom + nNewAtom + 1);
+		cache->surface = safe_realloc(cache->surface, cache->allocatedAtom * sizeof(double));
+		cache->reference = safe_realloc(cache->reference, cache->allocatedAtom * sizeof(double));
+		cache->type = safe_realloc(cache->type, cache->allocatedAtom * sizeof(int));
+		cache->first = safe_realloc(cache->first, cache->allocatedAtom * sizeof(int));
+	}
+
+	/* first term of each new atom; 'next' becomes the fill position */
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		if ((a = global[i]) < 0)
+			continue;
+		cache->surface[a] = molSasa->atomSasa[i].surface;
+		cache->reference[a] = reference[i];
+		cache->type[a] = cache->typeIndex[type->residueType[i] * 64 + type->atomType[i]];
+		++ cache->typeCount[cache->type[a]];
+		cache->first[a] = cache->nTerm + nNewTerm;
+		nNewTerm += next[i];
+		next[i] = cache->first[a];
+	}
+	cache->first[cache->nAtom + nNewAtom] = cache->nTerm + nNewTerm;
+
+	if (cache->nTerm + nNewTerm > cache->allocatedTerm) {
+		cache->allocatedTerm = 2 * (cache->nTerm + nNewTerm);
+		cache->geometry = safe_realloc(cache->geometry, cache->allocatedTerm * sizeof(double));
+		cache->connect = safe_realloc(cache->connect, cache->allocatedTerm * sizeof(char));
+	}
+
+	/*____________________________________________________________________________*/
+	/* terms in the order of the interactions */
+	for (k = 0; k < nInteraction; ++ k) {
+		connect = topol_interaction(topol, k, &i, &j) - 2;
+		if (! overlap_geometry(view, molSasa, i, j, arg->rProbe, &geometry_i, &geometry_j))
+			continue;
+		if (global[i] >= 0) {
+			cache->geometry[next[i]] = geometry_i;
+			cache->connect[next[i] ++] = connect;
+		}
+		if (global[j] >= 0) {
+			cache->geometry[next[j]] = geometry_j;
+			cache->connect[next[j] ++] = connect;
+		}
+	}
+
+	cache->nAtom += nNewAtom;
+	cache->nTerm += nNewTerm;
+	++ cache->nStructure;
+
+	free(global);
+	free(next);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** sum of squared deviations of the SASA at 'parameter' from the reference;
+	'gradient', if not 0, receives its derivatives with respect to the
+	parameters (atom parameters, then connectivity parameters) */
+double fit_evaluate(FitCache *cache, double *parameter, double *gradient)
+{
+	double *connectivity = parameter + cache->nType;
+	double atomParameter;
+	double sasa, factor, deviation, weight;
+	double sum = 0.;
+	unsigned int a;
+	int l;
+
+	if (gradient)
+		memset(gradient, 0, (cache->nType + 4) * sizeof(double));
+
+	for (a = 0; a < cache->nAtom; ++ a) {
+		atomParameter = parameter[cache->type[a]];
+		sasa = cache->surface[a];
+		for (l = cache->first[a]; l < cache->first[a + 1]; ++ l)
+			sasa *= 1. - connectivity[(int)cache->connect[l]] * atomParameter * cache->geometry[l];
+
+		deviation = sasa - cache->reference[a];
+		sum += deviation * deviation;
+
+		if (! gradient)
+			continue;
+		for (l = cache->first[a]; l < cache->first[a + 1]; ++ l) {
+			factor = 1. - connectivity[(int)cache->connect[l]] * atomParameter * cache->geometry[l];
+			if (factor == 0.)
+				continue;
+			weight = 2. * deviation * sasa / factor * cache->geometry[l];
+			gradient[cache->type[a]] -= weight * connectivity[(int)cache->connect[l]];
+			gradient[cache->nType + cache->connect[l]] -= weight * atomParameter;
+		}
+	}
+
+	return sum;
+}
+
+/*____________________________________________________________________________*/
+/** scalar product */
+__inline__ static double dot(double *u, double *v, int n)
+{
+	double sum = 0.;
+	int i;
+
+	for (i = 0; i < n; ++ i)
+		sum += u[i] * v[i];
+
+	return sum;
+}
+
+/*____________________________________________________________________________*/
+/** minimise 'fit_evaluate' from 'fit->parameter' by L-BFGS
+	with a backtracking (Armijo) line search */
+static void fit_lbfgs(PopsFit *fit, int maxIteration)
+{
+	FitCache *cache = &(fit->cache);
+	int n = fit->nParameter;
+	double *x = fit->parameter;
+	double *g = 0, *d = 0, *xNew = 0, *gNew = 0;
+	double *s = 0, *y = 0; /* history of steps and gradient changes */
+	double rho[FITHISTORY], alpha[FITHISTORY];
+	double f, fNew, dg, sy, scale, step;
+	int nHistory = 0;
+	int newest = -1;
+	int iteration, search, h, m, i;
+
+	g = safe_malloc(4 * n * sizeof(double));
+	d = g + n;
+	xNew = d + n;
+	gNew = xNew + n;
+	s = safe_malloc(2 * FITHISTORY * n * sizeof(double));
+	y = s + FITHISTORY * n;
+
+	f = fit_evaluate(cache, x, g);
+	fit->initialRmsd = sqrt(f / cache->nAtom);
+	fit->nIteration = 0;
+
+	for (iteration = 0; iteration < maxIteration; ++ iteration) {
+		if ((dg = dot(g, g, n)) == 0.)
+			break;
+
+		/*____________________________________________________________________________*/
+		/* direction by the two-loop recursion; without history a step
+			that changes the parameters by 0.01 */
+		memcpy(d, g, n * sizeof(double));
+		for (m = 0; m < nHistory; ++ m) {
+			h = (newest - m + FITHISTORY) % FITHISTORY;
+			alpha[h] = rho[h] * dot(&(s[h * n]), d, n);
+			for (i = 0; i < n; ++ i)
+				d[i] -= alpha[h] * y[h * n + i];
+		}
+		if (nHistory > 0)
+			scale = dot(&(s[newest * n]), &(y[newest * n]), n) / \
+				dot(&(y[newest * n]), &(y[newest * n]), n);
+		else
+			scale = 0.01 / sqrt(dg);
+		for (i = 0; i < n; ++ i)
+			d[i] *= scale;
+		for (m = nHistory - 1; m >= 0; -- m) {
+			h = (newest - m + FITHISTORY) % FITHISTORY;
+			sy = rho[h] * dot(&(y[h * n]), d, n);
+			for (i = 0; i < n; ++ i)
+				d[i] += (alpha[h] - sy) * s[h * n + i];
+		}
+		for (i = 0; i < n; ++ i)
+			d[i] = -d[i];
+
+		/* restart along the gradient if the direction does not descend */
+		if ((dg = dot(d, g, n)) >= 0.) {
+			nHistory = 0;
+			scale = 0.01 / sqrt(dot(g, g, n));
+			for (i = 0; i < n; ++ i)
+				d[i] = -scale * g[i];
+			dg = dot(d, g, n);
+		}
+
+		/*____________________________________________________________________________*/
+		/* backtracking line search */
+		for (search = 0, step = 1.; search < 40; ++ search, step *= 0.5) {
+			for (i = 0; i < n; ++ i)
+				xNew[i] = x[i] + step * d[i];
+			fNew = fit_evaluate(cache, xNew, gNew);
+			if (fNew <= f + 1e-4 * step * dg)
+				break;
+		}
+		if (search == 40)
+			break;
+
+		/* history */
+		newest = (newest + 1) % FITHISTORY;
+		for (i = 0; i < n; ++ i) {
+			s[newest * n + i] = xNew[i] - x[i];
+			y[newest * n + i] = gNew[i] - g[i];
+		}
+		if ((sy = dot(&(s[newest * n]), &(y[newest * n]), n)) > 1e-12) {
+			rho[newest] = 1. / sy;
+			if (nHistory < FITHISTORY)
+				++ nHistory;
+		} else {
+			newest = (newest - 1 + FITHISTORY) % FITHISTORY;
+		}
+
+		memcpy(x, xNew, n * sizeof(double));
+		memcpy(g, gNew, n * sizeof(double));
+		++ fit->nIteration;
+		if ((f - fNew) <= 1e-10 * f) {
+			f = fNew;
+			break;
+		}
+		f = fNew;
+	}
+
+	fit->rmsd = sqrt(f / cache->nAtom);
+
+	free(g);
+	free(s);
+}
+
+/*____________________________________________________________________________*/
+/** cache the structures of the training list '--fit' and fit the atom
+	and connectivity parameters to their reference SASA; each line of the
+	list holds a structure file and its reference file */
+int pops_fit(PopsContext *ctx, Arg *arg, Argpdb *argpdb, PopsFit *fit)
+{
+	FitCache *cache = &(fit->cache);
+	FILE *listFile = 0;
+	char line[2048];
+	char structureFileName[1024];
+	char referenceFileName[1024];
+	char *id = 0;
+	double *reference = 0;
+	PopsResult result;
+	Arg entryArg;
+	Argpdb entryArgpdb;
+	Str pdb;
+	Pack pack = {0, 0, 0, 0, 0, 0};
+	int format, zipped;
+	unsigned int i;
+	int ret;
+
+	memset(fit, 0, sizeof(PopsFit));
+	for (i = 0; i < 64 * 64; ++ i)
+		cache->typeIndex[i] = -1;
+
+	pops_init_result(&result);
+
+	/*____________________________________________________________________________*/
+	/* pair terms of all training structures */
+	listFile = safe_open(arg->fitName, "r");
+	while (fgets(line, sizeof(line), listFile) != 0) {
+		if ((line[0] == '#') || \
+			(sscanf(line, "%1023s %1023s", structureFileName, referenceFileName) != 2))
+			continue;
+
+		entryArg = *arg;
+		entryArgpdb = *argpdb;
+		entryArg.silent = 1;
+		if ((format = pops_input_format(structureFileName, &id, &zipped)) < 0) {
+			fprintf(stderr, "\t%s: unknown input format\n", structureFileName);
+			free(id);
+			continue;
+		}
+		entryArg.pdbIn = id;
+		pops_set_input(&entryArg, structureFileName, format, zipped);
+		strcpy(pdb.pdbID, "");
+
+		if ((ret = pops_read(&entryArg, &entryArgpdb, &pdb)) != POPS_OK) {
+			fprintf(stderr, "\t%s: %s\n", structureFileName, pops_strerror(ret));
+			free(id);
+			continue;
+		}
+		if ((ret = pops_compute(ctx, &entryArg, &entryArgpdb, &pdb, &pack, &result)) != POPS_OK) {
+			fprintf(stderr, "\t%s: %s\n", structureFileName, pops_strerror(ret));
+		} else {
+			reference = safe_realloc(reference, (pdb.nAtom + 1) * sizeof(double));
+			if (read_reference(referenceFileName, &pdb, reference) >= 0)
+				fit_cache_structure(cache, ctx, &entryArg, &pdb, &result, reference);
+		}
+
+		pops_free_input(&entryArg, &pdb, &pack, &result);
+		free(id);
+	}
+	fclose(listFile);
+
+	free(reference);
+	pops_free_result(&result);
+
+	if (cache->nAtom == 0)
+		return POPS_ERR_INPUT;
+
+	/*____________________________________________________________________________*/
+	/* parameters of the tables as starting point */
+	fit->nParameter = cache->nType + 4;
+	fit->initial = safe_malloc(fit->nParameter * sizeof(double));
+	fit->parameter = safe_malloc(fit->nParameter * sizeof(double));
+	for (i = 0; i < cache->nType; ++ i)
+		fit->initial[i] = ctx->constant_sasa->atomDataSasa[cache->typeKey[i] / 64][cache->typeKey[i] % 64].parameter;
+	fit->initial[cache->nType] = ctx->constant_sasa->connect_12_parameter;
+	fit->initial[cache->nType + 1] = ctx->constant_sasa->connect_13_parameter;
+	fit->initial[cache->nType + 2] = ctx->constant_sasa->connect_14_parameter;
+	fit->initial[cache->nType + 3] = ctx->constant_sasa->connect_15_parameter;
+	memcpy(fit->parameter, fit->initial, fit->nParameter * sizeof(double));
+
+	fit_lbfgs(fit, arg->fitIterations);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** print the initial and fitted parameters: '--popsfitOut' or,
+	with '--rout', '<routPrefix>.rpopsFit' in the output directory */
+int pops_print_fit(PopsContext *ctx, Arg *arg, PopsFit *fit)
+{
+	char fitOutFileName[1024];
+	const char *connectName[4] = {"1-2", "1-3", "1-4", ">1-4"};
+	FitCache *cache = &(fit->cache);
+	AtomdataSasa *atomData = 0;
+	int connectCount[4] = {0, 0, 0, 0};
+	unsigned int i;
+
+	if (arg->rout)
+		snprintf(fitOutFileName, sizeof(fitOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, "rpopsFit");
+	else
+		snprintf(fitOutFileName, sizeof(fitOutFileName), "%s", arg->fitOutFileName);
+
+	if (! arg->silent)
+		fprintf(stdout, "\t%d structures, %d atoms, %d pair terms, RMSD %.4f -> %.4f A^2: %s\n",
+			cache->nStructure, cache->nAtom, cache->nTerm,
+			fit->initialRmsd, fit->rmsd, fitOutFileName);
+
+	arg->fitOutFile = safe_open(fitOutFileName, "w");
+
+	if (! arg->noHeaderOut && ! arg->rout)
+		fprintf(arg->fitOutFile, "\n=== PARAMETER FIT ===\n"
+			"Structures: %d\nAtoms: %d\nPair terms: %d\nIterations: %d\n"
+			"RMSD/A^2 initial: %.4f\nRMSD/A^2 fitted: %.4f\n\n",
+			cache->nStructure, cache->nAtom, cache->nTerm, fit->nIteration,
+			fit->initialRmsd, fit->rmsd);
+	if (! arg->noHeaderOut || arg->rout)
+		fprintf(arg->fitOutFile, "ResidNe\tAtomNe\tN(atom)\tInitial\tFitted\n");
+
+	for (i = 0; i < cache->nType; ++ i) {
+		atomData = &(ctx->constant_sasa->atomDataSasa[cache->typeKey[i] / 64][cache->typeKey[i] % 64]);
+		fprintf(arg->fitOutFile, "%8s\t%4s\t%8d\t%10.4f\t%10.4f\n",
+			atomData->residueName, atomData->atomName, cache->typeCount[i],
+			fit->initial[i], fit->parameter[i]);
+	}
+	for (i = 0; i < cache->nTerm; ++ i)
+		++ connectCount[(int)cache->connect[i]];
+	for (i = 0; i < 4; ++ i)
+		fprintf(arg->fitOutFile, "%8s\t%4s\t%8d\t%10.4f\t%10.4f\n",
+			"CONNECT", connectName[i], connectCount[i],
+			fit->initial[cache->nType + i], fit->parameter[cache->nType + i]);
+
+	fclose(arg->fitOutFile);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** free cache and parameters */
+void pops_free_fit(PopsFit *fit)
+{
+	FitCache *cache = &(fit->cache);
+
+	free(cache->surface);
+	free(cache->reference);
+	free(cache->type);
+	free(cache->first);
+	free(cache->geometry);
+	free(cache->connect);
+	free(cache->typeKey);
+	free(cache->typeCount);
+	free(fit->initial);
+	free(fit->parameter);
+}
+
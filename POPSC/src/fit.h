@@ -0,0 +1,68 @@
+/*==============================================================================
+fit.h : re-fitting of SASA parameters from cached pair geometry
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef FIT_H
+#define FIT_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "pack.h"
+#include "safe.h"
+#include "sasa.h"
+#include "topol.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* parameter-free pair terms of the training atoms with a reference SASA:
+	the SASA of atom a is S_a * prod_l (1 - p_c(l) * P_t(a) * g_al),
+	the terms of each atom are contiguous */
+typedef struct {
+	int nStructure;
+	int nAtom; /* training atoms */
+	int allocatedAtom;
+	double *surface; /* surface S_a of the isolated atom */
+	double *reference; /* reference SASA */
+	int *type; /* parameter index t(a) */
+	int *first; /* first term of each atom, nAtom + 1 */
+	int nTerm;
+	int allocatedTerm;
+	double *geometry; /* g_al = b_al / S_a */
+	char *connect; /* connectivity of the term: 0 for 1-2, ..., 3 for >(1-4) */
+	int nType; /* atom parameters */
+	int typeIndex[64 * 64]; /* parameter index of (residue type, atom type), -1 if unused */
+	int *typeKey; /* residue type * 64 + atom type of each parameter */
+	int *typeCount; /* training atoms of each parameter */
+} FitCache;
+
+/* fit of the atom parameters and the four connectivity parameters */
+typedef struct {
+	FitCache cache;
+	int nParameter; /* atom parameters, then the 1-2, 1-3, 1-4 and >(1-4) parameters */
+	double *initial; /* parameters of the tables */
+	double *parameter; /* fitted parameters */
+	double initialRmsd; /* RMSD from the reference SASA, A^2 */
+	double rmsd;
+	int nIteration;
+} PopsFit;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int fit_cache_structure(FitCache *cache, PopsContext *ctx, Arg *arg, Str *pdb, \
+	PopsResult *result, double *reference);
+double fit_evaluate(FitCache *cache, double *parameter, double *gradient);
+int pops_fit(PopsContext *ctx, Arg *arg, Argpdb *argpdb, PopsFit *fit);
+int pops_print_fit(PopsContext *ctx, Arg *arg, PopsFit *fit);
+void pops_free_fit(PopsFit *fit);
+
+#endif
+
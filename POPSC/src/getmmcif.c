@@ -63,12 +63,12 @@ __inline__ static int standardise_name(char *residueName, char *atomName)
 
 /*____________________________________________________________________________*/
 /** process HET residues */
-__inline__ static int process_het(Str *str, char *line, regex_t *regexPattern, char (*hetAtomNewname)[32], int nHetAtom)
+__inline__ static int process_het(Str *str, char *line)
 {
 	int hetAtomNr = -1;
 
 	/* atom name: assign only allowed atom elements, otherwise atom is skipped */
-	if ((hetAtomNr = match_patterns(regexPattern, nHetAtom, &(str->atom[str->nAtom].atomName[0]))) >= 0) {
+	if ((hetAtomNr = classify_het_atom(&(str->atom[str->nAtom].atomName[0]))) >= 0) {
 		/* store original atom name in 'Het' and overwrite with new name
 			that is a generic name for the SASA parameters */
 		sprintf(str->atom[str->nAtom].atomNameHet, "%s", &(str->atom[str->nAtom].atomName[0]));
@@ -96,12 +96,8 @@ int map_structure_mmcif(Arg *arg, Argpdb *argpdb, Str *str, Structure *s) {
 
 	char resbuf;
 	int ca_p = 0;
-	/* for HETATM entries */
-	regex_t *regexPattern = 0; /* regular atom patterns */
-	/* allowed HETATM atom types (standard N,CA,C,O) and elements (any N,C,O,P,S) */
-	const int nHetAtom = 9;
-
-	char hetAtomPattern[9][32] = {{"N"},{"CA"},{"C"},{"O"},{".{1}C[[:print:]]{1,3}"},{".{1}N[[:print:]]{1,3}"},{".{1}O[[:print:]]{1,3}"},{".{1}P[[:print:]]{1,3}"},{".{1}S[[:print:]]{1,3}"}};
+	int ret;
+	ReadSelection readsel;
 
 	/*____________________________________________________________________________*/
 	/* initialise/allocate memory for set of (64) selected (CA) atom entries */
@@ -111,9 +107,16 @@ int map_structure_mmcif(Arg *arg, Argpdb *argpdb, Str *str, Structure *s) {
 	str->nAllResidue = 0;
 	str->nChain = 0;
 
+	/* read-time selection of chains, residue ranges and residue classes;
+		an invalid selection reads no atoms */
+	ret = init_read_selection(argpdb, &readsel);
+
 	/*____________________________________________________________________________*/
-	/* number of atoms */
-	str->nAtom = s->natom;
+	/* number of atoms: only the selected ones are allocated */
+	if (ret == 0)
+		for (x = 0; x < s->natom; ++ x)
+			if (read_selected(&readsel, s->chain_name[x], s->res_number[x], s->res_name[x]))
+				++ str->nAtom;
 
 	/* number of residues */
 	str->nResidue = s->nresidue; 
@@ -127,8 +130,8 @@ int map_structure_mmcif(Arg *arg, Argpdb *argpdb, Str *str, Structure *s) {
 
 	/*____________________________________________________________________________*/
 	/* allocate memory for structure */
-	str->atom = safe_malloc(str->nAtom * sizeof(Atom));
-	str->atomMap = safe_malloc(str->nAtom * sizeof(int));
+	str->atom = safe_malloc((str->nAtom + 1) * sizeof(Atom));
+	str->atomMap = safe_malloc((str->nAtom + 1) * sizeof(int));
 
 	/* array of residue-centric atom indices */
 	str->resAtom = safe_malloc((str->nResidue + 1) * sizeof(int));
@@ -136,10 +139,6 @@ int map_structure_mmcif(Arg *arg, Argpdb *argpdb, Str *str, Structure *s) {
 	/* allocate memory for sequence residues */
 	str->sequence.res = safe_malloc((str->nResidue + 1) * sizeof(char));
 
-	/* compile allowed HETATM element patterns */
-	regexPattern = safe_malloc(nHetAtom * sizeof(regex_t));
-	compile_patterns(regexPattern, &(hetAtomPattern[0]), nHetAtom);
-
 	/*____________________________________________________________________________*/
 	/* Map entries from MMCIF structure 's' to PDB structure 'str'. */
 	/* That could be mapped directly in the MMCIF reader,
@@ -168,6 +167,13 @@ int map_structure_mmcif(Arg *arg, Argpdb *argpdb, Str *str, Structure *s) {
     		}
 		}
 
+		/* skip atoms outside the read-time selection before copying */
+		if ((ret != 0) ||
+			! read_selected(&readsel, s->chain_name[x], s->res_number[x], s->res_name[x])) {
+			++str->nAllAtom;
+			continue;
+		}
+
 		/* atoms */
 		str->atom[i].atomNumber = s->atom_number[x];
 		strcpy(str->atom[i].atomName, s->atom_name[x]);
@@ -259,14 +265,32 @@ int map_structure_mmcif(Arg *arg, Argpdb *argpdb, Str *str, Structure *s) {
 	str->nResidue = k;
 	str->sequence.res[k] = '\0';
 
-	/*____________________________________________________________________________*/
-	/* free the compiled regular expressions */
-	free_patterns(regexPattern, nHetAtom);
-	free(regexPattern);
-    free_structure(s);
+    return ret;
+}
 
+/*____________________________________________________________________________*/
+/* map operations of the MMCIF biological assembly to the atoms of 'str' */
+int map_assembly_mmcif(Arg *arg, Str *str, Structure *s, Assembly *assembly) {
+
+	unsigned int i;
+	int k, o;
+
+	init_assembly(assembly, str->nAtom);
+
+	if (s->noper == 0) {
+		ErrorSpecNoexit("No operations of assembly", arg->assembly);
+		return POPS_ERR_INPUT;
+	}
+
+	for (o = 0; o < s->noper; ++ o) {
+		k = add_assembly_oper(assembly, &(s->oper[12 * o]));
+		/* 'atomMap' holds the MMCIF atom index of each copied atom */
+		for (i = 0; i < str->nAtom; ++ i)
+			assembly->member[(size_t)k * str->nAtom + i] =
+				s->oper_atom[(size_t)o * s->natom + str->atomMap[i]];
+	}
 
-    return 0;
+	return POPS_OK;
 }
 
 
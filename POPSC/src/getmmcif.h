@@ -12,6 +12,7 @@ Read the COPYING file for license information.
 
 #include "arg.h"
 #include "argpdb.h"
+#include "assembly.h"
 #include "getpdb.h"
 #include "pdb_structure.h" 
 #include "safe.h"
@@ -19,6 +20,7 @@ Read the COPYING file for license information.
 /*____________________________________________________________________________*/
 /* prototypes */
 int map_structure_mmcif(Arg *arg, Argpdb *argpdb, Str *str, Structure *s);
+int map_assembly_mmcif(Arg *arg, Str *str, Structure *s, Assembly *assembly);
 /* the function header for 'read_cif()' is defined
       in the C++ wrapper 'cif_header.h' */
 
@@ -78,12 +78,12 @@ __inline__ static int standardise_name(char *residueName, char *atomName)
 
 /*____________________________________________________________________________*/
 /** process HET residues */
-__inline__ static int process_het(Str *str, char *line, regex_t *regexPattern, char (*hetAtomNewname)[32], int nHetAtom)
+__inline__ static int process_het(Str *str, char *line)
 {
 	int hetAtomNr = -1;
 
 	/* atom name: assign only allowed atom elements, otherwise atom is skipped */
-	if ((hetAtomNr = match_patterns(regexPattern, nHetAtom, &(str->atom[str->nAtom].atomName[0]))) >= 0) {
+	if ((hetAtomNr = classify_het_atom(&(str->atom[str->nAtom].atomName[0]))) >= 0) {
 		/* store original atom name in 'Het' and overwrite with new name
 			that is a generic name for the SASA parameters */
 		sprintf(str->atom[str->nAtom].atomNameHet, "%s", &(str->atom[str->nAtom].atomName[0]));
@@ -104,11 +104,11 @@ __inline__ static int process_het(Str *str, char *line, regex_t *regexPattern, c
 /*____________________________________________________________________________*/
 /** process HET residues */
 /*
-__inline__ static int process_het(Str *str, char *line, regex_t *regexPattern, char (*hetAtomNewname)[32], int nHetAtom)
+__inline__ static int process_het(Str *str, char *line)
 {
 	int hetAtomNr = -1;
 
-	if ((hetAtomNr = match_patterns(regexPattern, nHetAtom, &(str->atom[str->nAtom].atomName[0]))) >= 0) {
+	if ((hetAtomNr = classify_het_atom(&(str->atom[str->nAtom].atomName[0]))) >= 0) {
 		sprintf(str->atom[str->nAtom].atomName, "%s", &(hetAtomNewname[hetAtomNr][0]));
 		sprintf(str->atom[str->nAtom].residueName, "%s", "HET");
 		fprintf(stderr, "Setting atom %d name %s to %s of residue HET\n",
@@ -167,11 +167,7 @@ int read_pdb(FILE *pdbInFile, gzFile *pdbgzInFile, Arg *arg, Argpdb *argpdb, Str
 	char atomName[] = "    ";
 	char resbuf;
 	int ca_p = 0;
-	/* for HETATM entries */
-	regex_t *regexPattern = 0; /* regular atom patterns */
-	/* allowed HETATM atom types (standard N,CA,C,O) and elements (any N,C,O,P,S) */
-	const int nHetAtom = 9;
-	char hetAtomPattern[9][32] = {{"N"},{"CA"},{"C"},{"O"},{".{1}C[[:print:]]{1,3}"},{".{1}N[[:print:]]{1,3}"},{".{1}O[[:print:]]{1,3}"},{".{1}P[[:print:]]{1,3}"},{".{1}S[[:print:]]{1,3}"}};
+	ReadSelection readsel;
 
 	/*____________________________________________________________________________*/
 	/* initialise/allocate memory for set of (64) selected (CA) atom entries */
@@ -190,9 +186,9 @@ int read_pdb(FILE *pdbInFile, gzFile *pdbgzInFile, Arg *arg, Argpdb *argpdb, Str
 	/* allocate memory for sequence residues */
 	str->sequence.res = safe_malloc(allocated_residue * sizeof(char));
 
-	/* compile allowed HETATM element patterns */
-	regexPattern = safe_malloc(nHetAtom * sizeof(regex_t));
-	compile_patterns(regexPattern, &(hetAtomPattern[0]), nHetAtom);
+	/* read-time selection of chains, residue ranges and residue classes */
+	if (init_read_selection(argpdb, &readsel) != 0)
+		return 1;
 
 	/*____________________________________________________________________________*/
     /* count the number of models */
@@ -277,7 +273,9 @@ int read_pdb(FILE *pdbInFile, gzFile *pdbgzInFile, Arg *arg, Argpdb *argpdb, Str
 			str->atom[str->nAtom].recordName[j++] = line[i++];
 		}
 		str->atom[str->nAtom].recordName[j] = '\0';
-		
+		/* HETATM entries are marked by 'process_het' */
+		str->atom[str->nAtom].het = 0;
+
 
 		/* atom name */
 		for (i = 12, j = 0; i < 16; ) {
@@ -377,16 +375,24 @@ int read_pdb(FILE *pdbInFile, gzFile *pdbgzInFile, Arg *arg, Argpdb *argpdb, Str
 		/* process HETATM entries */
 		if (strncmp(line, "HETATM", 6) == 0) {
 			/* HETATM disabled
-			if (process_het(str, &(line[0]), regexPattern, &(hetAtomNewname[0]), nHetAtom) != 0) {
+			if (process_het(str, &(line[0])) != 0) {
 				continue;
 			}
 			*/
 			continue;
 		}
 
-		/* detect CA and N3 atoms of standard residues for residue allocation */
-		if ((strncmp(str->atom[str->nAtom].atomName, " CA ", 4) == 0) ||
-		(strncmp(str->atom[str->nAtom].atomName, " N3 ", 4) == 0)) {
+		/* skip atoms outside the read-time selection */
+		if (! read_selected(&readsel, str->atom[str->nAtom].chainIdentifier,
+				str->atom[str->nAtom].residueNumber, str->atom[str->nAtom].residueName)) {
+			++ str->nAllAtom;
+			continue;
+		}
+
+		/* detect CA and N3 atoms of standard residues for residue allocation;
+			atom names are without spaces */
+		if ((strcmp(str->atom[str->nAtom].atomName, "CA") == 0) ||
+		(strcmp(str->atom[str->nAtom].atomName, "N3") == 0)) {
 			str->resAtom[k] = str->nAtom;
 			str->sequence.res[k ++] = aacode(str->atom[str->nAtom].residueName);
 			if (k == allocated_residue) {
@@ -437,11 +443,6 @@ int read_pdb(FILE *pdbInFile, gzFile *pdbgzInFile, Arg *arg, Argpdb *argpdb, Str
 	str->sequence.res[k] = '\0';
 	str->nResidue = k;
 
-	/*____________________________________________________________________________*/
-	/* free the compiled regular expressions */
-	free_patterns(regexPattern, nHetAtom);
-	free(regexPattern);
-
 	/*____________________________________________________________________________*/
 	return 0;
 }
@@ -454,7 +455,7 @@ int read_conect(FILE *pdbInFile)
 
 	if (fseek(pdbInFile, 0L, SEEK_SET) != 0) {
 		fprintf(stderr, "File pointer repositioning error\n");
-		exit(1);
+		return 1;
 	}
 	
     while(fgets(line, 80, pdbInFile) != 0) {
@@ -467,8 +468,9 @@ int read_conect(FILE *pdbInFile)
 }
 
 /*_____________________________________________________________________________*/
-/** read PDB structure */
-void read_structure(Arg *arg, Argpdb *argpdb, Str *pdb)
+/** read PDB structure; returns POPS_ERR_INPUT if the file is not readable
+	or has no atoms */
+int read_structure(Arg *arg, Argpdb *argpdb, Str *pdb)
 {
 	FILE *pdbInFile = 0;
 	gzFile pdbgzInFile;
@@ -484,29 +486,38 @@ void read_structure(Arg *arg, Argpdb *argpdb, Str *pdb)
     gzopen returns NULL if the file could not be opened or if there was insufficient memory to allocate the (de)compression state ; errno can be checked to distinguish the two cases (if errno is zero, the zlib error is Z_MEM_ERROR).
 */
 
-    pdb->sequence.name = safe_malloc((strlen(basename(arg->pdbInFileName)) + 1) * sizeof(char));
-    strcpy(pdb->sequence.name, basename(arg->pdbInFileName));
+    pdb->sequence.name = copy_basename(arg->pdbInFileName);
 
 	/* gzipped or raw input file */
 	/* passing both types of file pointers to read_pdb, but only one will be used */
 	if (arg->zipped) {
-		pdbgzInFile = gzopen(arg->pdbInFileName, "r");
+		if ((pdbgzInFile = gzopen(arg->pdbInFileName, "r")) == NULL) {
+			ErrorSpecNoexit("Failed accessing file", arg->pdbInFileName);
+			free(pdb->sequence.name);
+			return POPS_ERR_INPUT;
+		}
 		read_pdb(pdbInFile, &pdbgzInFile, arg, argpdb, pdb);
 		gzclose(pdbgzInFile);
 	} else {
-		pdbInFile = safe_open(arg->pdbInFileName, "r");
+		if ((pdbInFile = fopen(arg->pdbInFileName, "r")) == NULL) {
+			ErrorSpecNoexit("Failed accessing file", arg->pdbInFileName);
+			free(pdb->sequence.name);
+			return POPS_ERR_INPUT;
+		}
 		read_pdb(pdbInFile, &pdbgzInFile, arg, argpdb, pdb);
 		fclose(pdbInFile);
 	}
 
-    /* check for empty pdb structure and exit */
+    /* check for empty pdb structure */
     if (pdb->nAtom == 0) {
         ErrorSpecNoexit("Could not find atoms in input file. Please check input parameters:\nformat (--pdb or --pdbml), compression (--zipped or not) and file name",
 			arg->pdbInFileName);
         free(pdb->atom);
+        free(pdb->atomMap);
+        free(pdb->resAtom);
         free(pdb->sequence.res);
         free(pdb->sequence.name);
-        exit(1);
+        return POPS_ERR_INPUT;
     }
 
     if (! arg->silent) fprintf(stdout, "\tPDB file: %s\n"
@@ -517,5 +528,7 @@ void read_structure(Arg *arg, Argpdb *argpdb, Str *pdb)
 										"\t\tchains = %d\n",
 							arg->pdbInFileName, pdb->nAllAtom,
 							pdb->nAtom, pdb->nResidue, pdb->nChain);
+
+	return POPS_OK;
 }
 
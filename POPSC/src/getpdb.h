@@ -7,7 +7,6 @@ Read the COPYING file for license information.
 #ifndef GETPDB_H
 #define GETPDB_H
 
-#include <libgen.h>
 #include <regex.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -20,7 +19,8 @@ Read the COPYING file for license information.
 #include "error.h"
 #include "modstring.h"
 #include "pdb_structure.h"
-#include "pattern.h"
+#include "readsel.h"
+#include "hetatom.h"
 #include "safe.h"
 #include "seq.h"
 #include "vector.h"
@@ -29,6 +29,6 @@ Read the COPYING file for license information.
 /* prototypes */
 void remove_spaces(char *s);
 int read_pdb(FILE *pdbfile, gzFile *pdbgzInFile, Arg *arg, Argpdb *argpdb, Str *str);
-void read_structure(Arg *arg, Argpdb *argpdb, Str *pdb);
+int read_structure(Arg *arg, Argpdb *argpdb, Str *pdb);
 
 #endif
@@ -62,16 +62,16 @@ __inline__ static int standardise_name(char *residueName, char *atomName)
 
 /*____________________________________________________________________________*/
 /** process HET residues */
-__inline__ static int process_het(Str *str, char *line, regex_t *regexPattern, char (*hetAtomNewname)[32], int nHetAtom)
+__inline__ static int process_het(Str *str, char *line)
 {
 	int hetAtomNr = -1;
 
 	/* atom name: assign only allowed atom elements, otherwise atom is skipped */
-	if ((hetAtomNr = match_patterns(regexPattern, nHetAtom, &(str->atom[str->nAtom].atomName[0]))) >= 0) {
+	if ((hetAtomNr = classify_het_atom_xml(&(str->atom[str->nAtom].atomName[0]))) >= 0) {
 		/* store original atom name in 'Het' and overwrite with new name
 			that is a generic name for the SASA parameters */
 		sprintf(str->atom[str->nAtom].atomNameHet, "%s", &(str->atom[str->nAtom].atomName[0]));
-		sprintf(str->atom[str->nAtom].atomName, "%s", &(hetAtomNewname[hetAtomNr][0]));
+		sprintf(str->atom[str->nAtom].atomName, "%s", &(hetAtomNewnameXml[hetAtomNr][0]));
 
 		sprintf(str->atom[str->nAtom].residueNameHet, "%s", &(str->atom[str->nAtom].residueName[0]));
 		sprintf(str->atom[str->nAtom].residueName, "%s", "HET");
@@ -117,7 +117,7 @@ __inline__ static void init_atom(Str *pdb)
 /* The XML library transparently handles compression when doing
      file-based accesses. That is different from the 'read_structure' routine
      in 'getpdb', where the 'gz' library is being invoked explicitly. */
-int parseXML(const char *filename, Str *pdb) {
+int parseXML(const char *filename, Argpdb *argpdb, Str *pdb) {
     xmlDoc *doc; /* the resulting document tree */
     xmlNode *root_node = 0;
 	xmlNode *cur_node = 0;
@@ -131,18 +131,18 @@ int parseXML(const char *filename, Str *pdb) {
 	unsigned int k = 0;
 	int ca_p = 0;
 	char resbuf;
+	ReadSelection readsel;
 	/*char line[80];*/
-	regex_t *regexPattern = 0; /* regular atom patterns */
-	/* allowed HETATM atom types (standard N,CA,C,O) and elements (any N,C,O,P,S) */
-	const int nHetAtom = 6;
-	char hetAtomPattern[6][32] = {{"N"},{"CA"},{"C"},{"O"},{"P"},{"S"}};
-	/*char hetAtomNewname[6][32] = {{"N_"},{"CA"},{"C_"},{"O_"},{"P_"},{"S_"}};*/
+
+	/* read-time selection of chains, residue ranges and residue classes */
+	if (init_read_selection(argpdb, &readsel) != 0)
+		return POPS_ERR_INPUT;
 
 	/*____________________________________________________________________________*/
     /* parse the file and get the document (DOM) */
 	if ((doc = xmlReadFile(filename, NULL, 0)) == NULL) {
         fprintf(stderr, "XML Parser: Failed to read %s\n", filename);
-		exit(1);
+		return POPS_ERR_INPUT;
 	}
 
 	/*____________________________________________________________________________*/
@@ -179,10 +179,6 @@ int parseXML(const char *filename, Str *pdb) {
 	pdb->nAllResidue = 0;
 	pdb->nChain = 0;
 
-	/* compile allowed HETATM element patterns */
-	regexPattern = safe_malloc(nHetAtom * sizeof(regex_t));
-	compile_patterns(regexPattern, &(hetAtomPattern[0]), nHetAtom);
-
 	/*____________________________________________________________________________*/
 	/* traverse XML tree: atom sites */
 	for (atom_node = site_node->children; atom_node; atom_node = atom_node->next) {
@@ -307,14 +303,20 @@ int parseXML(const char *filename, Str *pdb) {
 			/* process HETATM entries */
 			if (strcmp(pdb->atom[pdb->nAtom].recordName, "HETATM") == 0) {
 				/* HETATM disabled
-				if (process_het(pdb, &(line[0]), regexPattern,
-						&(hetAtomNewname[0]), nHetAtom) != 0) {
+				if (process_het(pdb, &(line[0])) != 0) {
 					continue;
 				}
 				*/
 				continue;
 			}
 
+			/* skip atoms outside the read-time selection */
+			if (! read_selected(&readsel, pdb->atom[pdb->nAtom].chainIdentifier,
+					pdb->atom[pdb->nAtom].residueNumber, pdb->atom[pdb->nAtom].residueName)) {
+				++ pdb->nAllAtom;
+				continue;
+			}
+
 			/* detect CA and N3 atoms for residue allocation */
 			if ((strcmp(pdb->atom[pdb->nAtom].atomName, "CA") == 0) ||
 				(strcmp(pdb->atom[pdb->nAtom].atomName, "N3") == 0)) {
@@ -373,35 +375,35 @@ int parseXML(const char *filename, Str *pdb) {
 	/* free global variables */
     xmlFreeDoc(doc);
 
-	/*____________________________________________________________________________*/
-	/* free the compiled regular expressions */
-	free_patterns(regexPattern, nHetAtom);
-	free(regexPattern);
-
 	return 0;
 }
 
 /*____________________________________________________________________________*/
-/* parse PDB file in XML format */
-void read_structure_xml(Arg *arg, Argpdb *argpdb, Str *pdb)
+/* parse PDB file in XML format; returns POPS_ERR_INPUT if the file is not
+	readable or has no atoms */
+int read_structure_xml(Arg *arg, Argpdb *argpdb, Str *pdb)
 {
     LIBXML_TEST_VERSION;
 
-    pdb->sequence.name = safe_malloc((strlen(basename(arg->pdbmlInFileName)) + 1) * sizeof(char));
-    strcpy(pdb->sequence.name, basename(arg->pdbmlInFileName));
+    pdb->sequence.name = copy_basename(arg->pdbmlInFileName);
 
-    parseXML(arg->pdbmlInFileName, pdb);
-    xmlCleanupParser();
-    xmlMemoryDump();
+    /* the parser state is global and shared with concurrent readers:
+        'xmlCleanupParser' is called once by the program at termination */
+    if (parseXML(arg->pdbmlInFileName, argpdb, pdb) != 0) {
+        free(pdb->sequence.name);
+        return POPS_ERR_INPUT;
+    }
 
-    /* check for empty pdb structure and exit */
+    /* check for empty pdb structure */
     if (pdb->nAtom == 0)
     {
         ErrorSpecNoexit("Invalid PDB file", arg->pdbmlInFileName);
         free(pdb->atom);
+        free(pdb->atomMap);
+        free(pdb->resAtom);
         free(pdb->sequence.res);
         free(pdb->sequence.name);
-        exit(1);
+        return POPS_ERR_INPUT;
     }
 
     if (! arg->silent) fprintf(stdout, "\tPDB file: %s\n"
@@ -413,5 +415,7 @@ void read_structure_xml(Arg *arg, Argpdb *argpdb, Str *pdb)
 										"\t\tchains = %d\n",
 							arg->pdbmlInFileName, pdb->pdbID, pdb->nAllAtom,
 							pdb->nAtom, pdb->nResidue, pdb->nChain);
+
+	return POPS_OK;
 }
 
@@ -7,7 +7,6 @@ Read the COPYING file for license information.
 #ifndef GETPDBML_H
 #define GETPDBML_H
 
-#include <libgen.h>
 #include <regex.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -23,13 +22,14 @@ Read the COPYING file for license information.
 #include "error.h"
 #include "modstring.h"
 #include "pdb_structure.h"
-#include "pattern.h"
+#include "readsel.h"
+#include "hetatom.h"
 #include "safe.h"
 #include "seq.h"
 #include "vector.h"
 
 /*____________________________________________________________________________*/
 /* prototypes */
-void read_structure_xml(Arg *arg, Argpdb *argpdb, Str *pdb);
+int read_structure_xml(Arg *arg, Argpdb *argpdb, Str *pdb);
 
 #endif
@@ -14,6 +14,7 @@ Read the COPYING file for license information.
 #include <string.h>
 
 #include "getpdb.h"
+#include "pattern.h"
 #include "pdb_structure.h"
 #include "safe.h"
 #include "vector.h"
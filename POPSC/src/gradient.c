@@ -0,0 +1,146 @@
+/*==============================================================================
+gradient.c : analytical gradients of SASA and SFE
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "gradient.h"
+
+/*____________________________________________________________________________*/
+/* The SASA of atom k is its surface S_k scaled by one factor
+	f_kl = 1 - p_c b_kl(r_kl) P_k / S_k per overlapping partner l, with b_kl
+	the overlap term of 'mod_atom_sasa' at the distance r_kl. Only b_kl
+	depends on the coordinates, hence
+		dSASA_k / dr_kl = SASA_k / f_kl * df_kl / dr_kl
+	and the chain rule over dr_kl / dx_k = (x_k - x_l) / r_kl gives the
+	gradient. The SFE of an atom is its SASA times a constant sigma.
+	The gradient is continuous at the cutoff, where b_kl vanishes;
+	a factor f_kl of exactly 0 contributes no gradient. */
+
+/*____________________________________________________________________________*/
+/** add the gradient 'dE/dr' of the pair 'i'-'j' along their distance vector */
+__inline__ static void add_pair(double *gradient_i, double *gradient_j, \
+	double dEdr, double *unit)
+{
+	int d;
+
+	for (d = 0; d < 3; ++ d) {
+		gradient_i[d] += dEdr * unit[d];
+		gradient_j[d] -= dEdr * unit[d];
+	}
+}
+
+/*____________________________________________________________________________*/
+/** gradients of the molecular SASA and SFE of a computed result
+	with respect to all atom coordinates */
+int pops_gradient(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsGradient *gradient)
+{
+	View *view = &(result->view);
+	Topol *topol = &(result->topol);
+	Type *type = &(result->type);
+	AtomSasa *atomSasa = result->molSasa.atomSasa;
+	ConstantSasa *constant_sasa = ctx->constant_sasa;
+	ConstantSigma *constant_sigma = ctx->constant_sigma;
+	int nInteraction = topol->nBond + topol->nAngle + topol->nTorsion + topol->nNonBonded;
+	double connectivityParameter;
+	double factor_i, factor_j, dfactor_i, dfactor_j;
+	double distance;
+	double dSasa_i, dSasa_j; /* atom SASA derivatives along the distance */
+	double sigma_i, sigma_j;
+	double unit[3];
+	int i, j, k;
+
+	gradient->nAtom = pdb->nAtom;
+	gradient->atomGradient = arena_alloc(&(result->arena), (pdb->nAtom + 1) * sizeof(AtomGradient));
+	memset(gradient->atomGradient, 0, (pdb->nAtom + 1) * sizeof(AtomGradient));
+
+	for (k = 0; k < nInteraction; ++ k) {
+		switch (topol_interaction(topol, k, &i, &j)) {
+			case 2: connectivityParameter = constant_sasa->connect_12_parameter; break;
+			case 3: connectivityParameter = constant_sasa->connect_13_parameter; break;
+			case 4: connectivityParameter = constant_sasa->connect_14_parameter; break;
+			default: connectivityParameter = constant_sasa->connect_15_parameter; break;
+		}
+
+		if (! overlap_derivatives(view, &(result->molSasa), connectivityParameter,
+				i, j, arg->rProbe, &factor_i, &factor_j, &dfactor_i, &dfactor_j, &distance))
+			continue;
+		if (distance < .74)
+			return POPS_ERR_CONTACT;
+
+		dSasa_i = (factor_i != 0.) ? atomSasa[i].sasa / factor_i * dfactor_i : 0.;
+		dSasa_j = (factor_j != 0.) ? atomSasa[j].sasa / factor_j * dfactor_j : 0.;
+
+		unit[0] = (view->x[i] - view->x[j]) / distance;
+		unit[1] = (view->y[i] - view->y[j]) / distance;
+		unit[2] = (view->z[i] - view->z[j]) / distance;
+
+		add_pair(gradient->atomGradient[i].sasa, gradient->atomGradient[j].sasa,
+			dSasa_i + dSasa_j, unit);
+
+		/* SFE: SASA scaled from Angstrom to nm (factor 1/100), as in 'sigma' */
+		sigma_i = constant_sigma->atomDataSigma[type->residueType[i]][type->atomType[i]].sigma_type / 100;
+		sigma_j = constant_sigma->atomDataSigma[type->residueType[j]][type->atomType[j]].sigma_type / 100;
+		add_pair(gradient->atomGradient[i].sfe_type, gradient->atomGradient[j].sfe_type,
+			sigma_i * dSasa_i + sigma_j * dSasa_j, unit);
+
+		sigma_i = constant_sigma->atomDataSigma[type->residueType[i]][type->atomType[i]].sigma_group / 100;
+		sigma_j = constant_sigma->atomDataSigma[type->residueType[j]][type->atomType[j]].sigma_group / 100;
+		add_pair(gradient->atomGradient[i].sfe_group, gradient->atomGradient[j].sfe_group,
+			sigma_i * dSasa_i + sigma_j * dSasa_j, unit);
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** print the gradients of all atoms: '--popsgradientOut' or,
+	with '--rout', '<routPrefix>.rpopsGradient' in the output directory */
+int pops_print_gradient(Arg *arg, Str *pdb, PopsResult *result, \
+	PopsGradient *gradient)
+{
+	char gradientOutFileName[1024];
+	unsigned int i;
+	AtomGradient *atomGradient = 0;
+
+	if (arg->rout)
+		snprintf(gradientOutFileName, sizeof(gradientOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, "rpopsGradient");
+	else
+		snprintf(gradientOutFileName, sizeof(gradientOutFileName), "%s", arg->gradientOutFileName);
+
+	if (! arg->silent)
+		fprintf(stdout, "\tgradients of %d atoms: %s\n", gradient->nAtom, gradientOutFileName);
+
+	arg->gradientOutFile = safe_open(gradientOutFileName, "w");
+
+	if (! arg->noHeaderOut && ! arg->rout)
+		fprintf(arg->gradientOutFile, "\n=== ATOM GRADIENTS OF MOLECULAR SASA AND SFE ===\n");
+	if (! arg->noHeaderOut || arg->rout)
+		fprintf(arg->gradientOutFile, "AtomNr\tAtomNe\tResidNe\tChain\tResidNr\tiCode"
+			"\tdSASA/dx\tdSASA/dy\tdSASA/dz/(A^2/A)"
+			"\tdSFEt/dx\tdSFEt/dy\tdSFEt/dz/(kJ/(mol A))"
+			"\tdSFEg/dx\tdSFEg/dy\tdSFEg/dz/(kJ/(mol A))\n");
+
+	for (i = 0; i < gradient->nAtom; ++ i) {
+		atomGradient = &(gradient->atomGradient[i]);
+		fprintf(arg->gradientOutFile, "%8d\t%3s\t%3s\t%1s\t%6d\t%1s"
+			"\t%10.4f\t%10.4f\t%10.4f\t%10.4f\t%10.4f\t%10.4f\t%10.4f\t%10.4f\t%10.4f\n",
+			pdb->atom[i].atomNumber,
+			pdb->atom[i].atomName,
+			pdb->atom[i].residueName,
+			chain_identifier(&(pdb->atom[i])),
+			pdb->atom[i].residueNumber,
+			pdb->atom[i].icode,
+			atomGradient->sasa[0], atomGradient->sasa[1], atomGradient->sasa[2],
+			atomGradient->sfe_type[0], atomGradient->sfe_type[1], atomGradient->sfe_type[2],
+			atomGradient->sfe_group[0], atomGradient->sfe_group[1], atomGradient->sfe_group[2]);
+	}
+
+	fclose(arg->gradientOutFile);
+
+	return POPS_OK;
+}
+
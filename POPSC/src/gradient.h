@@ -0,0 +1,50 @@
+/*==============================================================================
+gradient.h : analytical gradients of SASA and SFE
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef GRADIENT_H
+#define GRADIENT_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "error.h"
+#include "libpops.h"
+#include "modstring.h"
+#include "putsasa.h"
+#include "safe.h"
+#include "sasa.h"
+#include "sigma.h"
+#include "topol.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* gradients of the molecular SASA and SFE with respect to the coordinates
+	of one atom; the solvation force on the atom is the negative SFE gradient */
+typedef struct {
+	double sasa[3]; /* A^2/A */
+	double sfe_type[3]; /* kJ/(mol A), atom type sigmas */
+	double sfe_group[3]; /* kJ/(mol A), atom group sigmas */
+} AtomGradient;
+
+/* gradients of a structure; the array is in the arena of the result */
+typedef struct {
+	int nAtom;
+	AtomGradient *atomGradient;
+} PopsGradient;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_gradient(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsGradient *gradient);
+int pops_print_gradient(Arg *arg, Str *pdb, PopsResult *result, \
+	PopsGradient *gradient);
+
+#endif
+
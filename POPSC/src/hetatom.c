@@ -0,0 +1,111 @@
+/*==============================================================================
+hetatom.c : classification of HETATM atom names
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "hetatom.h"
+
+/*____________________________________________________________________________*/
+/* The classifier replaces the regular expression lists that the readers
+	compiled on every call. A constant character table maps each byte
+	to its element bit and a single pass over the atom name collects
+	the bit mask of matching classes. The class with the lowest index
+	wins, which is the precedence order of the former pattern lists:
+	PDB/mmCIF: "N","CA","C","O",".{1}C[[:print:]]{1,3}",...,".{1}S[[:print:]]{1,3}"
+	PDBML:     "N","CA","C","O","P","S" */
+
+/* element bits */
+enum { HET_C = 1, HET_N = 2, HET_O = 4, HET_P = 8, HET_S = 16, HET_A = 32 };
+
+static const unsigned char hetElement[256] = {
+	['A'] = HET_A, ['C'] = HET_C, ['N'] = HET_N,
+	['O'] = HET_O, ['P'] = HET_P, ['S'] = HET_S
+};
+
+/* class bit of the element-at-second-position patterns (PDB/mmCIF set) */
+static const unsigned short hetElementClass[17] = {
+	[HET_C] = 1 << 4, [HET_N] = 1 << 5, [HET_O] = 1 << 6,
+	[HET_P] = 1 << 7, [HET_S] = 1 << 8
+};
+
+const char hetAtomNewname[NHETATOM][4] = {
+	{"N"},{"CA"},{"C"},{"O"},{"C_"},{"N_"},{"O_"},{"P_"},{"S_"}};
+
+const char hetAtomNewnameXml[NHETATOMXML][4] = {
+	{"N_"},{"CA"},{"C_"},{"O_"},{"P_"},{"S_"}};
+
+/*____________________________________________________________________________*/
+/** index of lowest set bit, -1 if none */
+__inline__ static int lowest_class(unsigned int mask)
+{
+	int i;
+
+	for (i = 0; mask != 0; ++ i, mask >>= 1)
+		if (mask & 1)
+			return i;
+
+	return -1;
+}
+
+/*____________________________________________________________________________*/
+/** collect element bits of the whole name and the class bits of elements
+	at a position > 0 that are followed by a printable character */
+__inline__ static unsigned int scan_name(const char *atomName,
+	unsigned int *elements, unsigned int *caFlag)
+{
+	unsigned int i;
+	unsigned int posClass = 0;
+	unsigned char c, prev = 0;
+
+	*elements = 0;
+	*caFlag = 0;
+
+	for (i = 0; atomName[i] != '\0'; ++ i) {
+		c = (unsigned char)atomName[i];
+		*elements |= hetElement[c];
+		if ((prev == 'C') && (c == 'A'))
+			*caFlag = 1;
+		if ((i > 0) && (hetElement[c] & (HET_C | HET_N | HET_O | HET_P | HET_S)) &&
+			isprint((unsigned char)atomName[i + 1]))
+			posClass |= hetElementClass[hetElement[c]];
+		prev = c;
+	}
+
+	return posClass;
+}
+
+/*____________________________________________________________________________*/
+/** HETATM class of PDB/mmCIF atom name, -1 if the atom is not allowed */
+int classify_het_atom(const char *atomName)
+{
+	unsigned int elements, caFlag;
+	unsigned int mask = scan_name(atomName, &elements, &caFlag);
+
+	if (elements & HET_N) mask |= 1;
+	if (caFlag) mask |= 2;
+	if (elements & HET_C) mask |= 4;
+	if (elements & HET_O) mask |= 8;
+
+	return lowest_class(mask);
+}
+
+/*____________________________________________________________________________*/
+/** HETATM class of PDBML atom name, -1 if the atom is not allowed */
+int classify_het_atom_xml(const char *atomName)
+{
+	unsigned int elements, caFlag;
+	unsigned int mask = 0;
+
+	scan_name(atomName, &elements, &caFlag);
+
+	if (elements & HET_N) mask |= 1;
+	if (caFlag) mask |= 2;
+	if (elements & HET_C) mask |= 4;
+	if (elements & HET_O) mask |= 8;
+	if (elements & HET_P) mask |= 16;
+	if (elements & HET_S) mask |= 32;
+
+	return lowest_class(mask);
+}
+
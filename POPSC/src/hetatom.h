@@ -0,0 +1,31 @@
+/*==============================================================================
+hetatom.h : classification of HETATM atom names
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef HETATOM_H
+#define HETATOM_H
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*___________________________________________________________________________*/
+/* HETATM atom classes of the PDB and mmCIF readers:
+	standard atom types N,CA,C,O and elements C,N,O,P,S */
+#define NHETATOM 9
+/* HETATM atom classes of the PDBML reader: N,CA,C,O,P,S */
+#define NHETATOMXML 6
+
+/* generic atom names of the 'HET' residue for each class */
+extern const char hetAtomNewname[NHETATOM][4];
+extern const char hetAtomNewnameXml[NHETATOMXML][4];
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int classify_het_atom(const char *atomName);
+int classify_het_atom_xml(const char *atomName);
+
+#endif
+
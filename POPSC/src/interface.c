@@ -0,0 +1,516 @@
+/*==============================================================================
+interface.c : hierarchical interface mode with a coarse residue screen
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "interface.h"
+
+/*____________________________________________________________________________*/
+/* The interface mode computes atomic SASA only where chains meet.
+	1. Coarse screen: the CA (or N3) atoms of residues of different chains
+		are scored with the residue-size-weighted soft distance of
+		'calpha_distances', 1 / (1 + exp((d - R) / 0.5)) * sqrt(r_i r_j) / 4.35,
+		with the interface radius R ('--interfaceRadius') and the coarse
+		residue radii r; a residue with a score of at least 0.5 to any
+		residue of another chain is an interface residue. The pairs are
+		found by a sweep over the atoms sorted along x.
+	2. Atomic SASA: the atoms of the interface residues and their
+		environment, the atoms of the cells next to an interface atom on a
+		grid with the non-bonded cutoff as cell size, form the region that
+		is typed and enters the topology. The SASA of each interface atom is
+		computed with 'compute_sasa_atom' twice, with all interactions
+		(complex) and with the interactions within its chain (isolated
+		chain), in the order of a full computation; the difference is the
+		SASA buried at the interface, as in POPSCOMP. */
+
+/* coarse screen: representative atom of a residue */
+typedef struct {
+	float x; /* sweep coordinate */
+	int atom; /* CA or N3 atom */
+	int chain; /* chain index */
+	float radius; /* coarse residue radius */
+} ScreenResidue;
+
+/* scratch of the interface computation */
+typedef struct {
+	int *chain; /* chain index of each structure atom */
+	char *interfaceAtom; /* atom of an interface residue */
+	Atom *atom; /* atoms of the region */
+	int *regionChain; /* chain index of each region atom */
+	int *regionIndex; /* region index of each interface atom */
+	int *partner; /* non-bonded partners of one atom */
+	Str region; /* structure of the region atoms */
+	PopsResult result; /* types, topology and SASA of the region */
+	PopsUpdate update; /* bonded interactions and cell grid of the region */
+} InterfaceWork;
+
+/*____________________________________________________________________________*/
+/** compare residues along the sweep coordinate */
+static int compare_screen(const void *a, const void *b)
+{
+	float xa = ((const ScreenResidue *)a)->x;
+	float xb = ((const ScreenResidue *)b)->x;
+
+	return (xa > xb) - (xa < xb);
+}
+
+/*____________________________________________________________________________*/
+/** compare atom indices */
+static int compare_index(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+/*____________________________________________________________________________*/
+/** coarse residue radius of the residue name, the mean radius if unknown */
+static float residue_radius(ConstantSasa *res_sasa, char *residueName)
+{
+	int k;
+
+	for (k = 0; k < res_sasa->nResidueType; ++ k)
+		if (strcmp(residueName, res_sasa->atomDataSasa[k][0].residueName) == 0)
+			return res_sasa->atomDataSasa[k][0].radius;
+
+	/* the mean radius across 20 amino acids is 4.35 */
+	return 4.35;
+}
+
+/*____________________________________________________________________________*/
+/** coarse screen: mark the atoms of residues within the interface radius
+	of a residue of another chain; returns the number of contacts */
+static int screen_residues(PopsContext *ctx, Arg *arg, Str *pdb, \
+	PopsInterface *interface, InterfaceWork *work)
+{
+	unsigned int i;
+	int r, s, t, nScreen = 0;
+	float dx, dy, dz, distance, score;
+	/* soft distance below 0.5 beyond R + 2 for all coarse radii */
+	float reach = arg->interfaceRadius + 2.;
+	char *contact = 0;
+	ScreenResidue *screen = safe_malloc((pdb->nResidue + 1) * sizeof(ScreenResidue));
+	Atom *atom_s = 0, *atom_t = 0;
+
+	for (r = 0; r < pdb->nResidue; ++ r) {
+		i = pdb->resAtom[r];
+		screen[nScreen].x = pdb->atom[i].pos.x;
+		screen[nScreen].atom = i;
+		screen[nScreen].chain = work->chain[i];
+		screen[nScreen].radius = residue_radius(ctx->res_sasa, pdb->atom[i].residueName);
+		++ nScreen;
+	}
+	qsort(screen, nScreen, sizeof(ScreenResidue), compare_screen);
+
+	contact = safe_malloc((nScreen + 1) * sizeof(char));
+	memset(contact, 0, (nScreen + 1) * sizeof(char));
+	for (s = 0; s < nScreen; ++ s) {
+		atom_s = &(pdb->atom[screen[s].atom]);
+		for (t = s + 1; (t < nScreen) && (screen[t].x - screen[s].x <= reach); ++ t) {
+			if (screen[t].chain == screen[s].chain)
+				continue;
+			atom_t = &(pdb->atom[screen[t].atom]);
+			dx = atom_t->pos.x - atom_s->pos.x;
+			dy = atom_t->pos.y - atom_s->pos.y;
+			dz = atom_t->pos.z - atom_s->pos.z;
+			if ((fabs(dy) > reach) || (fabs(dz) > reach))
+				continue;
+			distance = sqrt(dx * dx + dy * dy + dz * dz);
+			score = 1. / (1. + exp((distance - arg->interfaceRadius) / 0.5)) * \
+				sqrt(screen[s].radius * screen[t].radius) / 4.35;
+			if (score >= 0.5) {
+				contact[s] = contact[t] = 1;
+				++ interface->nContact;
+			}
+		}
+	}
+
+	/* interface residues: all atoms of the residue of a marked representative */
+	for (s = 0; s < nScreen; ++ s)
+		if (contact[s]) {
+			work->interfaceAtom[screen[s].atom] = 1;
+			++ interface->nResidue;
+		}
+	for (i = 1; i < pdb->nAtom; ++ i)
+		if (work->interfaceAtom[i - 1] && ! work->interfaceAtom[i] &&
+			(pdb->atom[i].residueNumber == pdb->atom[i - 1].residueNumber) &&
+			(strcmp(pdb->atom[i].icode, pdb->atom[i - 1].icode) == 0) &&
+			(work->chain[i] == work->chain[i - 1]))
+			work->interfaceAtom[i] = 1;
+	for (i = pdb->nAtom - 1; i > 0; -- i)
+		if (work->interfaceAtom[i] && ! work->interfaceAtom[i - 1] &&
+			(pdb->atom[i].residueNumber == pdb->atom[i - 1].residueNumber) &&
+			(strcmp(pdb->atom[i].icode, pdb->atom[i - 1].icode) == 0) &&
+			(work->chain[i] == work->chain[i - 1]))
+			work->interfaceAtom[i - 1] = 1;
+
+	free(screen);
+	free(contact);
+
+	return interface->nContact;
+}
+
+/*____________________________________________________________________________*/
+/** grid cell of an atom */
+__inline__ static size_t grid_cell(Atom *atom, float *low, float cellSize, int *nCell, int *cell)
+{
+	cell[0] = (int)((atom->pos.x - low[0]) / cellSize);
+	cell[1] = (int)((atom->pos.y - low[1]) / cellSize);
+	cell[2] = (int)((atom->pos.z - low[2]) / cellSize);
+
+	return ((size_t)cell[0] * nCell[1] + cell[1]) * nCell[2] + cell[2];
+}
+
+/*____________________________________________________________________________*/
+/** region: interface atoms and the atoms of the grid cells around them */
+static void interface_region(Str *pdb, float cutoff, PopsInterface *interface, \
+	InterfaceWork *work)
+{
+	unsigned int i;
+	int d, c, s;
+	int nCell[3], cell[3], next[3];
+	float low[3], high[3], pos[3];
+	char *regionCell = 0;
+	size_t nGrid;
+
+	for (d = 0; d < 3; ++ d) {
+		low[d] = FLT_MAX;
+		high[d] = -FLT_MAX;
+	}
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		pos[0] = pdb->atom[i].pos.x; pos[1] = pdb->atom[i].pos.y; pos[2] = pdb->atom[i].pos.z;
+		for (d = 0; d < 3; ++ d) {
+			if (pos[d] < low[d]) low[d] = pos[d];
+			if (pos[d] > high[d]) high[d] = pos[d];
+		}
+	}
+	for (d = 0; d < 3; ++ d)
+		nCell[d] = (int)((high[d] - low[d]) / cutoff) + 1;
+	nGrid = (size_t)nCell[0] * nCell[1] * nCell[2];
+
+	/* cells of the interface atoms and their 26 neighbour cells */
+	regionCell = safe_malloc(nGrid * sizeof(char));
+	memset(regionCell, 0, nGrid * sizeof(char));
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		if (! work->interfaceAtom[i])
+			continue;
+		grid_cell(&(pdb->atom[i]), low, cutoff, nCell, cell);
+		for (c = 0; c < 27; ++ c) {
+			next[0] = cell[0] + c / 9 - 1;
+			next[1] = cell[1] + (c / 3) % 3 - 1;
+			next[2] = cell[2] + c % 3 - 1;
+			if ((next[0] < 0) || (next[0] >= nCell[0]) ||
+				(next[1] < 0) || (next[1] >= nCell[1]) ||
+				(next[2] < 0) || (next[2] >= nCell[2]))
+				continue;
+			regionCell[((size_t)next[0] * nCell[1] + next[1]) * nCell[2] + next[2]] = 1;
+		}
+	}
+
+	/* region atoms in structure order */
+	work->atom = safe_malloc((pdb->nAtom + 1) * sizeof(Atom));
+	work->regionChain = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	work->regionIndex = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	interface->atom = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	for (i = 0, s = 0; i < pdb->nAtom; ++ i) {
+		if (! regionCell[grid_cell(&(pdb->atom[i]), low, cutoff, nCell, cell)])
+			continue;
+		if (work->interfaceAtom[i]) {
+			interface->atom[s] = i;
+			work->regionIndex[s ++] = interface->nRegion;
+		}
+		work->regionChain[interface->nRegion] = work->chain[i];
+		work->atom[interface->nRegion ++] = pdb->atom[i];
+	}
+	interface->nAtom = s;
+
+	free(regionCell);
+}
+
+/*____________________________________________________________________________*/
+/** interactions of region atom 'a' in the order of 'compute_sasa':
+	all (complex) or those within its chain (isolated chain) */
+static int atom_interactions(Arg *arg, InterfaceWork *work, int a, int isolated)
+{
+	int k, j;
+	int nCandidate, nPartner = 0, nInteraction = 0;
+	View *view = &(work->result.view);
+	PopsUpdate *update = &(work->update);
+	AtomInteraction *interaction = update->interaction;
+
+	for (k = update->bondedFirst[a]; k < update->bondedFirst[a + 1]; ++ k)
+		if (! isolated || (work->regionChain[update->bonded[k].partner] == work->regionChain[a]))
+			interaction[nInteraction ++] = update->bonded[k];
+
+	nCandidate = update_neighbours(update, a, update->candidate);
+	for (k = 0; k < nCandidate; ++ k) {
+		j = update->candidate[k];
+		if (isolated && (work->regionChain[j] != work->regionChain[a]))
+			continue;
+		if ((j != a) && (view_distance(view, a, j) < cutoff_radius(view, a, j, arg->rProbe)) && \
+			! topol_bonded(&(work->result.topol), a, j))
+			work->partner[nPartner ++] = j;
+	}
+	qsort(work->partner, nPartner, sizeof(int), compare_index);
+	assert(nPartner < 1024);
+	for (k = 0; k < nPartner; ++ k) {
+		interaction[nInteraction].partner = work->partner[k];
+		interaction[nInteraction].connect = 5;
+		interaction[nInteraction].first = (a < work->partner[k]);
+		++ nInteraction;
+	}
+
+	return nInteraction;
+}
+
+/*____________________________________________________________________________*/
+/** SASA of the interface atoms in the scratch 'work' */
+static int interface_sasa(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsInterface *interface, InterfaceWork *work)
+{
+	unsigned int i;
+	int k, a, s, c, nInteraction;
+	int ret;
+	float maxRadius = 0.;
+	float cutoff;
+	double bSasa;
+	Arg regionArg = *arg;
+	View *view = &(work->result.view);
+	Topol *topol = &(work->result.topol);
+	MolSasa *molSasa = &(work->result.molSasa);
+
+	/*____________________________________________________________________________*/
+	/* chain index of each atom */
+	work->chain = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	for (i = 0, c = 0; i < pdb->nAtom; ++ i) {
+		if ((i > 0) && (pdb->atom[i].chainIdentifier[0] != pdb->atom[i - 1].chainIdentifier[0]))
+			++ c;
+		work->chain[i] = c;
+	}
+	if (c == 0) {
+		fprintf(stderr, "Interface mode requires at least two chains\n");
+		return POPS_ERR_INPUT;
+	}
+
+	/*____________________________________________________________________________*/
+	/* coarse screen */
+	work->interfaceAtom = safe_malloc((pdb->nAtom + 1) * sizeof(char));
+	memset(work->interfaceAtom, 0, (pdb->nAtom + 1) * sizeof(char));
+	if (screen_residues(ctx, arg, pdb, interface, work) == 0) {
+		if (! arg->silent)
+			fprintf(stdout, "\tNo interface residues within %.2f A\n", arg->interfaceRadius);
+		return POPS_OK;
+	}
+
+	/*____________________________________________________________________________*/
+	/* region: interface atoms and their environment */
+	for (i = 0; i < 64; ++ i)
+		for (k = 0; k < 64; ++ k)
+			if (ctx->constant_sasa->atomDataSasa[i][k].radius > maxRadius)
+				maxRadius = ctx->constant_sasa->atomDataSasa[i][k].radius;
+	cutoff = 2. * (maxRadius + arg->rProbe) + 0.01;
+
+	interface_region(pdb, cutoff, interface, work);
+
+	if ((ret = pops_structure(&(work->region), pdb->pdbID, work->atom, interface->nRegion)) != POPS_OK)
+		return ret;
+
+	/*____________________________________________________________________________*/
+	/* types, cell grid and bonded topology of the region */
+	if ((ret = get_types(&(work->region), &(work->result.type), &(ctx->typeHash))) != POPS_OK)
+		return ret;
+	init_view(&(work->region), &(work->result.type), ctx->constant_sasa, view);
+	morton_view(view, arg->rProbe);
+
+	regionArg.silent = 1;
+	init_topology(&regionArg, &(work->region), topol, &(work->result.arena));
+	if ((ret = get_bonded_topology(&(work->region), view, topol, argpdb)) != POPS_OK)
+		return ret;
+
+	init_sasa(&(work->region), view, molSasa, arg, &(work->result.arena));
+	pops_init_update(arg, &(work->region), &(work->result), &(work->update));
+	work->partner = safe_malloc((interface->nRegion + 1) * sizeof(int));
+
+	/*____________________________________________________________________________*/
+	/* SASA of the interface atoms in the complex and in the isolated chain */
+	interface->sasa = safe_malloc((interface->nAtom + 1) * sizeof(double));
+	interface->isoSasa = safe_malloc((interface->nAtom + 1) * sizeof(double));
+	interface->surface = safe_malloc((interface->nAtom + 1) * sizeof(double));
+	interface->polarity = safe_malloc((interface->nAtom + 1) * sizeof(char));
+	for (s = 0; s < interface->nAtom; ++ s) {
+		a = work->regionIndex[s];
+
+		nInteraction = atom_interactions(arg, work, a, 0);
+		if ((ret = compute_sasa_atom(view, &(work->result.type), molSasa, ctx->constant_sasa, \
+				arg->rProbe, a, work->update.interaction, nInteraction)) != POPS_OK)
+			return ret;
+		interface->sasa[s] = molSasa->atomSasa[a].sasa;
+
+		nInteraction = atom_interactions(arg, work, a, 1);
+		if ((ret = compute_sasa_atom(view, &(work->result.type), molSasa, ctx->constant_sasa, \
+				arg->rProbe, a, work->update.interaction, nInteraction)) != POPS_OK)
+			return ret;
+		interface->isoSasa[s] = molSasa->atomSasa[a].sasa;
+
+		interface->surface[s] = molSasa->atomSasa[a].surface;
+		interface->polarity[s] = view->polarity[a];
+		bSasa = interface->isoSasa[s] - interface->sasa[s];
+		if (view->polarity[a] == 0)
+			interface->phobicbSasa += bSasa;
+		else
+			interface->philicbSasa += bSasa;
+		interface->bSasa += bSasa;
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** SASA and bSASA of the interface residues found by a coarse screen,
+	computed at atomic resolution from their environment only */
+int pops_interface(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsInterface *interface)
+{
+	int ret;
+	InterfaceWork work;
+
+	memset(interface, 0, sizeof(PopsInterface));
+	memset(&work, 0, sizeof(InterfaceWork));
+	pops_init_result(&(work.result));
+
+	ret = interface_sasa(ctx, arg, argpdb, pdb, interface, &work);
+
+	free(work.chain);
+	free(work.interfaceAtom);
+	free(work.atom);
+	free(work.regionChain);
+	free(work.regionIndex);
+	free(work.partner);
+	pops_free_update(&(work.update));
+	pops_free_result(&(work.result));
+	pops_free_structure(&(work.region));
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** print the SASA of the interface atoms, residues and the buried SASA:
+	'--popsinterfaceOut' or, with '--rout', the atom SASAs to
+	'<routPrefix>.rpopsInterface' in the output directory */
+int pops_print_interface(Arg *arg, Str *pdb, PopsInterface *interface)
+{
+	char interfaceOutFileName[1024];
+	int s, t;
+	int nResAtom;
+	double sasa, isoSasa, phobicbSasa, philicbSasa;
+	Atom *atom = 0;
+
+	if (arg->rout)
+		snprintf(interfaceOutFileName, sizeof(interfaceOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, "rpopsInterface");
+	else
+		snprintf(interfaceOutFileName, sizeof(interfaceOutFileName), "%s",
+			arg->interfaceModeOutFileName);
+
+	if (! arg->silent)
+		fprintf(stdout, "\t%d interface residues, %d interface atoms, %d atoms in region,"
+			" %d atoms in structure: %s\n",
+			interface->nResidue, interface->nAtom, interface->nRegion, pdb->nAtom,
+			interfaceOutFileName);
+
+	arg->interfaceModeOutFile = safe_open(interfaceOutFileName, "w");
+
+	/*____________________________________________________________________________*/
+	/* atoms */
+	if (! arg->noHeaderOut && ! arg->rout)
+		fprintf(arg->interfaceModeOutFile, "\n=== INTERFACE ATOM SASAs ===\n");
+	if (! arg->noHeaderOut || arg->rout)
+		fprintf(arg->interfaceModeOutFile, "AtomNr\tAtomNe\tResidNe\tChain\tResidNr\tiCode"
+			"\tSASA/A^2\tisoSASA/A^2\tbSASA/A^2\tSurf/A^2\n");
+
+	for (s = 0; s < interface->nAtom; ++ s) {
+		atom = &(pdb->atom[interface->atom[s]]);
+		fprintf(arg->interfaceModeOutFile, "%8d\t%3s\t%3s\t%1s\t%6d\t%1s\t%10.2f\t%10.2f\t%10.2f\t%10.2f\n",
+			atom->atomNumber,
+			atom->atomName,
+			atom->residueName,
+			chain_identifier(atom),
+			atom->residueNumber,
+			atom->icode,
+			interface->sasa[s],
+			interface->isoSasa[s],
+			interface->isoSasa[s] - interface->sasa[s],
+			interface->surface[s]);
+	}
+
+	if (arg->rout) {
+		fclose(arg->interfaceModeOutFile);
+		return POPS_OK;
+	}
+
+	/*____________________________________________________________________________*/
+	/* interface residues */
+	if (! arg->noHeaderOut)
+		fprintf(arg->interfaceModeOutFile, "\n=== INTERFACE RESIDUE SASAs ===\n"
+			"ResidNe\tChain\tResidNr\tiCode\tSASA/A^2\tisoSASA/A^2\tbPhob/A^2\tbPhil/A^2\tbSASA/A^2\n");
+
+	for (s = 0; s < interface->nAtom; s = t) {
+		atom = &(pdb->atom[interface->atom[s]]);
+		sasa = isoSasa = phobicbSasa = philicbSasa = 0.;
+		for (t = s, nResAtom = 0; t < interface->nAtom; ++ t, ++ nResAtom) {
+			if ((pdb->atom[interface->atom[t]].residueNumber != atom->residueNumber) || \
+				(strcmp(pdb->atom[interface->atom[t]].icode, atom->icode) != 0) || \
+				(pdb->atom[interface->atom[t]].chainIdentifier[0] != atom->chainIdentifier[0]))
+				break;
+			sasa += interface->sasa[t];
+			isoSasa += interface->isoSasa[t];
+			if (interface->polarity[t] == 0)
+				phobicbSasa += interface->isoSasa[t] - interface->sasa[t];
+			else
+				philicbSasa += interface->isoSasa[t] - interface->sasa[t];
+		}
+		fprintf(arg->interfaceModeOutFile, "%8s\t%3s\t%8d\t%1s\t%10.2f\t%10.2f\t%10.2f\t%10.2f\t%10.2f\n",
+			atom->residueName,
+			chain_identifier(atom),
+			atom->residueNumber,
+			atom->icode,
+			sasa,
+			isoSasa,
+			phobicbSasa,
+			philicbSasa,
+			phobicbSasa + philicbSasa);
+	}
+
+	/*____________________________________________________________________________*/
+	/* buried SASA of the interface */
+	if (! arg->noHeaderOut)
+		fprintf(arg->interfaceModeOutFile, "\n=== INTERFACE bSASA ===\n"
+			"bPhob/A^2\tbPhil/A^2\tbSASA/A^2\tN(residue)\tN(atom)\tN(region)\n");
+	fprintf(arg->interfaceModeOutFile, "%10.2f\t%10.2f\t%10.2f\t%8d\t%8d\t%8d\n",
+		interface->phobicbSasa,
+		interface->philicbSasa,
+		interface->bSasa,
+		interface->nResidue,
+		interface->nAtom,
+		interface->nRegion);
+
+	fclose(arg->interfaceModeOutFile);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** free interface */
+void pops_free_interface(PopsInterface *interface)
+{
+	free(interface->atom);
+	free(interface->sasa);
+	free(interface->isoSasa);
+	free(interface->surface);
+	free(interface->polarity);
+	interface->atom = 0;
+	interface->sasa = 0;
+	interface->isoSasa = 0;
+	interface->surface = 0;
+	interface->polarity = 0;
+}
+
@@ -0,0 +1,55 @@
+/*==============================================================================
+interface.h : hierarchical interface mode with a coarse residue screen
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "putsasa.h"
+#include "safe.h"
+#include "sasa.h"
+#include "topol.h"
+#include "type.h"
+#include "update.h"
+#include "view.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* SASA of the interface atoms in the complex and in their isolated chain */
+typedef struct {
+	int nContact; /* residue pairs of different chains in contact (coarse) */
+	int nResidue; /* interface residues (coarse) */
+	int nAtom; /* atoms of the interface residues */
+	int nRegion; /* atoms of the region: interface and environment */
+	int *atom; /* structure index of each interface atom */
+	double *sasa; /* SASA in the complex */
+	double *isoSasa; /* SASA in the isolated chain */
+	double *surface; /* surface of the isolated atom */
+	char *polarity; /* hydrophobic = 0, hydrophilic = 1 */
+	double phobicbSasa; /* hydrophobic SASA buried at the interface */
+	double philicbSasa; /* hydrophilic SASA buried at the interface */
+	double bSasa; /* SASA buried at the interface */
+} PopsInterface;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_interface(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsInterface *interface);
+int pops_print_interface(Arg *arg, Str *pdb, PopsInterface *interface);
+void pops_free_interface(PopsInterface *interface);
+
+#endif
+
@@ -10,9 +10,10 @@ Read the COPYING file for license information.
 #include "cJSON.h"
 
 /*____________________________________________________________________________*/
-void print_json(Arg *arg, Str *pdb, cJSON *json)
+/** print JSON object; POPS_ERR_OUTPUT if the output file is not writable */
+int print_json(Arg *arg, Str *pdb, cJSON *json)
 {
-	char outpath[256];
+	char outpath[1024];
 	/* print JSON object to string */
 	char *popsOutJson = cJSON_Print(json);
 	char *idOut;
@@ -25,15 +26,20 @@ void print_json(Arg *arg, Str *pdb, cJSON *json)
 
 	/* print string to file */
 	if (arg->outDirName) {
-		sprintf(outpath, "%s/%s.json", arg->outDirName, idOut);
+		snprintf(outpath, sizeof(outpath), "%s/%s.json", arg->outDirName, idOut);
 	} else {
-		sprintf(outpath, "%s.json", idOut);
+		snprintf(outpath, sizeof(outpath), "%s.json", idOut);
+	}
+	if ((arg->jsonOutFile = safe_open_noexit(outpath, "w")) == NULL) {
+		free(popsOutJson);
+		return POPS_ERR_OUTPUT;
 	}
-	arg->jsonOutFile = safe_open(outpath, "w");
 	fprintf(arg->jsonOutFile, "%s", popsOutJson);
 	fclose(arg->jsonOutFile);
 
 	free(popsOutJson);
+
+	return POPS_OK;
 }
 
 /*____________________________________________________________________________*/
@@ -19,7 +19,7 @@ Read the COPYING file for license information.
 #include "type.h"
 
 void make_resSasaJson(Arg *arg, Str *pdb, ResSasa *resSasa, cJSON *json);
-void print_json(Arg *arg, Str *pdb, cJSON *json);
+int print_json(Arg *arg, Str *pdb, cJSON *json);
 void make_resbSasaJson(Arg *arg, Str *pdb, ResSasa *resSasa, cJSON *jsonb);
 void print_jsonb(Arg *arg, Str *pdb, cJSON *jsonb);
 
@@ -0,0 +1,426 @@
+/*==============================================================================
+libpops.c : POPS library interface
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+/* The library routines return error codes instead of terminating
+	the calling program; the 'pops' program is a client of this library. */
+
+#include "libpops.h"
+#include "cif_reader.h"
+#include "getmmcif.h"
+#include "getpdb.h"
+#include "getpdbml.h"
+#include "json.h"
+#include "putbsasa.h"
+#include "putDistMatCA.h"
+#include "putsasa.h"
+#include "putsigma.h"
+#include "atomgroup_data.h"
+#include "sasa_data.h"
+#include "sigma_data.h"
+
+/*____________________________________________________________________________*/
+/** select parameter tables, hash their (residue, atom) names
+	and checksum their content */
+int pops_init(PopsContext *ctx, int coarse)
+{
+	ctx->coarse = coarse;
+
+	/* data array element 0: atomic; element 1: coarse-grained */
+	ctx->constant_sasa = &(constant_sasa_data[coarse ? 1 : 0]);
+	ctx->res_sasa = &(constant_sasa_data[1]);
+	ctx->constant_sigma = &(constant_sigma_data[coarse ? 1 : 0]);
+	ctx->atomGroup = &(constAtomGroup[0]); /* group array element 0: POPS grouping */
+
+	/* parameter set identity, e.g. for the rerun manifest */
+	ctx->paramHash = crc32(0L, Z_NULL, 0);
+	ctx->paramHash = crc32(ctx->paramHash, (const Bytef *)ctx->constant_sasa, sizeof(ConstantSasa));
+	ctx->paramHash = crc32(ctx->paramHash, (const Bytef *)ctx->res_sasa, sizeof(ConstantSasa));
+	ctx->paramHash = crc32(ctx->paramHash, (const Bytef *)ctx->constant_sigma, sizeof(ConstantSigma));
+	ctx->paramHash = crc32(ctx->paramHash, (const Bytef *)ctx->atomGroup, sizeof(Atomgroup));
+
+	return init_typehash(&(ctx->typeHash), ctx->constant_sasa, ctx->atomGroup);
+}
+
+/*____________________________________________________________________________*/
+/** free parameter hash */
+void pops_free(PopsContext *ctx)
+{
+	free_typehash(&(ctx->typeHash));
+}
+
+/*____________________________________________________________________________*/
+/** structure from atoms in memory, e.g. coordinates of another program;
+	atom and residue names without spaces, as returned by the readers;
+	the atoms are copied */
+int pops_structure(Str *pdb, char *name, Atom *atom, int nAtom)
+{
+	unsigned int i;
+	int k = 0;
+
+	memset(pdb, 0, sizeof(Str));
+
+	if (nAtom < 1)
+		return POPS_ERR_INPUT;
+
+	strncpy(pdb->pdbID, name, sizeof(pdb->pdbID) - 1);
+	pdb->sequence.name = safe_malloc((strlen(name) + 1) * sizeof(char));
+	strcpy(pdb->sequence.name, name);
+
+	pdb->atom = safe_malloc(nAtom * sizeof(Atom));
+	memcpy(pdb->atom, atom, nAtom * sizeof(Atom));
+	pdb->atomMap = safe_malloc(nAtom * sizeof(int));
+	pdb->resAtom = safe_malloc((nAtom + 1) * sizeof(int));
+	pdb->sequence.res = safe_malloc((nAtom + 1) * sizeof(char));
+
+	for (i = 0; i < nAtom; ++ i) {
+		/* avoid space character in icode, as the readers do */
+		if ((pdb->atom[i].icode[0] == '\0') || (pdb->atom[i].icode[0] == ' '))
+			strcpy(pdb->atom[i].icode, "-");
+
+		/* CA and N3 atoms of residues; residues are not classified */
+		if ((strcmp(pdb->atom[i].atomName, "CA") == 0) ||
+			(strcmp(pdb->atom[i].atomName, "N3") == 0)) {
+			pdb->resAtom[k] = i;
+			pdb->sequence.res[k ++] = 'X';
+		}
+
+		if (i == 0 ||
+			pdb->atom[i].residueNumber != pdb->atom[i - 1].residueNumber ||
+			strcmp(pdb->atom[i].icode, pdb->atom[i - 1].icode) != 0)
+			++ pdb->nAllResidue;
+
+		if (i == 0 ||
+			pdb->atom[i].chainIdentifier[0] != pdb->atom[i - 1].chainIdentifier[0])
+			++ pdb->nChain;
+
+		pdb->atomMap[i] = i;
+	}
+	pdb->sequence.res[k] = '\0';
+
+	pdb->nAtom = nAtom;
+	pdb->nAllAtom = nAtom;
+	pdb->nResidue = k;
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** free structure of 'pops_structure' or of the readers */
+void pops_free_structure(Str *pdb)
+{
+	free(pdb->atom);
+	free(pdb->atomMap);
+	free(pdb->resAtom);
+	free(pdb->sequence.res);
+	free(pdb->sequence.name);
+	pdb->atom = 0;
+	pdb->atomMap = pdb->resAtom = 0;
+	pdb->sequence.res = pdb->sequence.name = 0;
+}
+
+/*____________________________________________________________________________*/
+/** input format of file name (0 pdb, 1 pdbml, 2 mmcif), -1 if unknown;
+	sets 'zipped' and, if 'id' is not 0, the allocated base name
+	without extensions */
+int pops_input_format(char *fileName, char **id, int *zipped)
+{
+	char *name = 0;
+	char *ext = 0;
+	int format = -1;
+
+	name = safe_malloc(strlen(fileName) + 1);
+	strcpy(name, strrchr(fileName, '/') ? strrchr(fileName, '/') + 1 : fileName);
+
+	/* compression */
+	*zipped = 0;
+	if (((ext = strrchr(name, '.')) != 0) && (strcmp(ext, ".gz") == 0)) {
+		*zipped = 1;
+		*ext = '\0';
+	}
+
+	/* format */
+	if ((ext = strrchr(name, '.')) != 0) {
+		if ((strcmp(ext, ".pdb") == 0) || (strcmp(ext, ".ent") == 0))
+			format = 0;
+		else if (strcmp(ext, ".xml") == 0)
+			format = 1;
+		else if (strcmp(ext, ".cif") == 0)
+			format = 2;
+		*ext = '\0';
+	}
+
+	if (id)
+		*id = name;
+	else
+		free(name);
+
+	return format;
+}
+
+/*____________________________________________________________________________*/
+/** set input file of format 'format' (see 'pops_input_format') in 'arg' */
+int pops_set_input(Arg *arg, char *fileName, int format, int zipped)
+{
+	arg->mmcif = arg->pdb = arg->pdbml = 0;
+	arg->mmcifInFileName = arg->pdbInFileName = arg->pdbmlInFileName = "";
+	arg->zipped = zipped;
+
+	switch (format) {
+		case 0: arg->pdb = 1; arg->pdbInFileName = fileName; break;
+		case 1: arg->pdbml = 1; arg->pdbmlInFileName = fileName; break;
+		case 2: arg->mmcif = 1; arg->mmcifInFileName = fileName; break;
+		default: return POPS_ERR_INPUT;
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** read structure of the input file named in 'arg' */
+int pops_read(Arg *arg, Argpdb *argpdb, Str *pdb)
+{
+	Structure *s = NULL;
+
+	if (arg->mmcif) {
+		/* 'gemmi' library function to read PDB entries */
+		if ((s = read_cif(arg->mmcifInFileName, 0)) == NULL) {
+			ErrorSpecNoexit("Cannot read MMCIF file", arg->mmcifInFileName);
+			return POPS_ERR_INPUT;
+		}
+		map_structure_mmcif(arg, argpdb, pdb, s);
+		free_structure(s);
+		return POPS_OK;
+	} else if (arg->pdbml) {
+		return read_structure_xml(arg, argpdb, pdb);
+	} else if (arg->pdb) {
+		return read_structure(arg, argpdb, pdb);
+	}
+
+	return POPS_ERR_INPUT;
+}
+
+/*____________________________________________________________________________*/
+/** free structure of 'pops_read' or of a loaded pack and unmap the pack;
+	types of a pack are in the mapped file and are detached from 'result' */
+void pops_free_input(Arg *arg, Str *pdb, Pack *pack, PopsResult *result)
+{
+	if (! pack->map) {
+		free(pdb->atom);
+		free(pdb->resAtom);
+		free(pdb->atomMap);
+		free(pdb->sequence.res);
+	}
+	if (arg->pdb || arg->pdbml)
+		free(pdb->sequence.name);
+	if (result->packed) {
+		result->type.atomType = result->type.residueType = 0;
+		result->packed = 0;
+	}
+	free_pack(pack);
+}
+
+/*____________________________________________________________________________*/
+/** initialise result; a result can be reused for any number of structures */
+void pops_init_result(PopsResult *result)
+{
+	memset(result, 0, sizeof(PopsResult));
+	init_arena(&(result->arena), 0);
+}
+
+/*____________________________________________________________________________*/
+/** topology, SASA and SFE of the current coordinates */
+static int compute_surface(PopsContext *ctx, Arg *arg, Argpdb *argpdb, \
+	Str *pdb, Pack *pack, PopsResult *result, int verbose)
+{
+	int ret;
+	Arg probeArg;
+	Arg *topolArg = arg; /* neighbour cutoff of the topology */
+
+	/* several probe radii: neighbours at the largest radius,
+		the SASA of each radius filters this neighbour list */
+	if (arg->nProbe > 1) {
+		probeArg = *arg;
+		probeArg.rProbe = probe_max(arg);
+		topolArg = &probeArg;
+	}
+
+	if (arg->morton)
+		morton_view(&(result->view), topolArg->rProbe);
+
+	/*____________________________________________________________________________*/
+	/* molecular topology */
+	if (verbose) fprintf(stdout, "Topology\n");
+	init_topology(arg, pdb, &(result->topol), &(result->arena));
+	if (pack && pack->map) {
+		unpack_topology(pack, pdb, &(result->topol));
+		nonbonded_overlaps(pdb, &(result->view), &(result->topol), topolArg);
+	} else {
+		if ((ret = get_topology(pdb, &(result->view), &(result->topol), argpdb, topolArg)) != POPS_OK)
+			return ret;
+		/* a pack that cannot be written is reported and only costs the cache */
+		if (pack && arg->packDirName)
+			(void)write_pack(arg, argpdb, pack, pdb, &(result->type), &(result->topol));
+	}
+
+	/*____________________________________________________________________________*/
+	/* SASA: atoms, residues, chains, molecule */
+	if (verbose) fprintf(stdout, "Solvent Accessible Surface Area\n");
+	init_sasa(pdb, &(result->view), &(result->molSasa), arg, &(result->arena));
+	if ((ret = compute_sasa(pdb, &(result->view), &(result->topol), &(result->type), \
+			&(result->molSasa), ctx->constant_sasa, ctx->res_sasa, arg)) != POPS_OK)
+		return ret;
+
+	/*____________________________________________________________________________*/
+	/* Solvation Free Energy: atoms, residues, chains, molecule */
+	if (verbose) fprintf(stdout, "Solvation Free Energy\n");
+	init_sfe(pdb, &(result->type), &(result->molSFE), ctx->constant_sigma, arg, &(result->arena));
+	compute_sfe(pdb, &(result->view), &(result->type), &(result->molSasa), \
+		&(result->molSFE), ctx->constant_sigma, arg);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** types, topology, SASA and SFE of a structure;
+	'pack' is 0 or the structure pack of the input: if loaded, its types
+	are already in 'result->type' and its bonded topology is used,
+	otherwise the pack is written if 'arg->packDirName' is set */
+int pops_compute(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	Pack *pack, PopsResult *result)
+{
+	int ret;
+
+	/* release the previous structure of this result;
+		types of a loaded pack are in place already */
+	if (! result->packed && ! (pack && pack->map)) {
+		free(result->type.atomType);
+		free(result->type.residueType);
+		result->type.atomType = result->type.residueType = 0;
+	}
+	free_view(&(result->view));
+	reset_arena(&(result->arena));
+
+	/*____________________________________________________________________________*/
+	/* atom and residue types and atom group ID numbers */
+	if (! arg->silent) fprintf(stdout, "Types\n");
+	result->packed = (pack && pack->map);
+	if (! result->packed) {
+		if ((ret = get_types(pdb, &(result->type), &(ctx->typeHash))) != POPS_OK)
+			return ret;
+	}
+
+	/* compact coordinates and parameters for the compute kernels */
+	init_view(pdb, &(result->type), ctx->constant_sasa, &(result->view));
+
+	if ((ret = compute_surface(ctx, arg, argpdb, pdb, pack, result, ! arg->silent)) != POPS_OK)
+		return ret;
+
+	/*____________________________________________________________________________*/
+	/* sparse Calpha distances between all chain pairs */
+	if (pdb->nChain > 1)
+		calpha_distances(arg, pdb, &(result->topol), ctx->res_sasa, arg->nThread);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** topology, SASA and SFE of new coordinates of the structure of the last
+	'pops_compute' call, e.g. of a trajectory frame */
+int pops_compute_frame(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result)
+{
+	reset_arena(&(result->arena));
+
+	view_coordinates(pdb, &(result->view));
+
+	/* no pack: its bonded topology holds for the input coordinates only */
+	return compute_surface(ctx, arg, argpdb, pdb, 0, result, 0);
+}
+
+/*____________________________________________________________________________*/
+/** print SASA, bSASA, SFE and Calpha distances of a structure
+	to the output files named in 'arg'; POPS_ERR_OUTPUT if an output
+	file is not writable */
+int pops_print(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, PopsResult *result)
+{
+	cJSON *resSasaJson = 0;
+	int ret = POPS_OK;
+
+	/*____________________________________________________________________________*/
+	/* SASA output, bSASA is buried area */
+	if (arg->jsonOut) {
+		/** print JSON output */
+		if ((resSasaJson = cJSON_CreateObject()) == NULL) {
+			ErrorSpecNoexit("Exiting", "JSON object returned NULL");
+			return POPS_ERR_OUTPUT;
+		}
+		if (! arg->silent) fprintf(stdout, "SASA Output:\n");
+		make_resSasaJson(arg, pdb, result->molSasa.resSasa, resSasaJson);
+		if (print_json(arg, pdb, resSasaJson) != POPS_OK)
+			ret = POPS_ERR_OUTPUT;
+		if (! arg->silent) fprintf(stdout, "bSASA Output:\n");
+		/* disabled, because not validated against PDBe server */
+		/* make_resbSasaJson(arg, pdb, result->molSasa.resSasa, resSasaJsonb);
+		   print_jsonb(arg, resSasaJsonb); */
+		cJSON_Delete(resSasaJson);
+	} else {
+		/** print tabulated output */
+		if (! arg->silent) fprintf(stdout, "SASA Output:\n");
+		if (print_sasa(arg, argpdb, pdb, &(result->type), &(result->topol), &(result->molSasa), ctx->constant_sasa, -1) != POPS_OK)
+			ret = POPS_ERR_OUTPUT;
+		if (! arg->silent && ! arg->rout) fprintf(stdout, "bSASA Output:\n");
+		if (! arg->rout && (print_bsasa(arg, argpdb, pdb, &(result->type), &(result->topol), &(result->molSasa), ctx->constant_sasa, -1) != POPS_OK))
+			ret = POPS_ERR_OUTPUT;
+	}
+
+	/*____________________________________________________________________________*/
+	/** print Solvation Free Energy */
+	if (! arg->silent && ! argpdb->coarse && ! arg->jsonOut && ! arg->rout)
+		fprintf(stdout, "SFE Output:\n");
+	/* we don't have SFEs for residues yet */
+	if (! argpdb->coarse && ! arg->jsonOut && ! arg->rout &&
+		(print_sfe(arg, argpdb, pdb, &(result->type), &(result->topol), &(result->molSFE), ctx->constant_sigma, -1) != POPS_OK))
+		ret = POPS_ERR_OUTPUT;
+
+	/*____________________________________________________________________________*/
+	/** print sparse Calpha distances between all chain pairs */
+	if ((pdb->nChain > 1) && (print_distMatCA(arg, pdb, &(result->topol)) != POPS_OK))
+		ret = POPS_ERR_OUTPUT;
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** free result */
+void pops_free_result(PopsResult *result)
+{
+	if (! result->packed) {
+		free(result->type.atomType);
+		free(result->type.residueType);
+	}
+	result->type.atomType = result->type.residueType = 0;
+	free_view(&(result->view));
+	free_arena(&(result->arena));
+}
+
+/*____________________________________________________________________________*/
+/** error message of return code */
+const char *pops_strerror(int code)
+{
+	switch (code) {
+		case POPS_OK: return "success";
+		case POPS_ERR_INPUT: return "input structure not readable or without atoms";
+		case POPS_ERR_TYPE: return "atom without parametrisation";
+		case POPS_ERR_ATOM: return "less than 2 atoms";
+		case POPS_ERR_BOND: return "less than 2 bonds";
+		case POPS_ERR_ANGLE: return "less than 2 angles";
+		case POPS_ERR_TORSION: return "less than 2 torsions";
+		case POPS_ERR_CONTACT: return "self-contact or too short atom distance";
+		case POPS_ERR_OUTPUT: return "output not writable";
+		default: return "unknown error";
+	}
+}
+
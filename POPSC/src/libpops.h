@@ -0,0 +1,76 @@
+/*==============================================================================
+libpops.h : POPS library interface
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef LIBPOPS_H
+#define LIBPOPS_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "argpdb.h"
+#include "atomgroup.h"
+#include "error.h"
+#include "pack.h"
+#include "pdb_structure.h"
+#include "sasa.h"
+#include "sasa_const.h"
+#include "sigma.h"
+#include "sigma_const.h"
+#include "topol.h"
+#include "type.h"
+#include "typehash.h"
+#include "view.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* parameter tables of one parametrisation (atomic or coarse-grained);
+	read-only after 'pops_init', therefore shareable between threads */
+typedef struct {
+	int coarse; /* coarse-grained parametrisation */
+	ConstantSasa *constant_sasa; /* selected SASA constants */
+	ConstantSasa *res_sasa; /* residue SASA constants */
+	ConstantSigma *constant_sigma; /* SIGMA constants */
+	Atomgroup *atomGroup; /* atom group constants */
+	TypeHash typeHash; /* perfect hash of parameter types */
+	uint32_t paramHash; /* CRC-32 of the parameter tables */
+} PopsContext;
+
+/* results of one structure; except for the types, all arrays are allocated
+	in 'arena' and remain valid until the next computation on this result */
+typedef struct {
+	Type type; /* atom and residue types */
+	View view; /* compute view of atoms */
+	Topol topol; /* molecular topology */
+	MolSasa molSasa; /* SASA of atoms, residues, chains and molecule */
+	MolSFE molSFE; /* SFE of atoms, residues, chains and molecule */
+	Arena arena; /* memory of topology, SASA and SFE */
+	int packed; /* types and bonded topology from structure pack */
+} PopsResult;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_init(PopsContext *ctx, int coarse);
+void pops_free(PopsContext *ctx);
+int pops_structure(Str *pdb, char *name, Atom *atom, int nAtom);
+void pops_free_structure(Str *pdb);
+int pops_input_format(char *fileName, char **id, int *zipped);
+int pops_set_input(Arg *arg, char *fileName, int format, int zipped);
+int pops_read(Arg *arg, Argpdb *argpdb, Str *pdb);
+void pops_free_input(Arg *arg, Str *pdb, Pack *pack, PopsResult *result);
+void pops_init_result(PopsResult *result);
+int pops_compute(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	Pack *pack, PopsResult *result);
+int pops_compute_frame(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result);
+int pops_print(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, PopsResult *result);
+void pops_free_result(PopsResult *result);
+const char *pops_strerror(int code);
+
+#endif
+
@@ -0,0 +1,337 @@
+/*==============================================================================
+manifest.c : manifest of current outputs for incremental reruns
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "manifest.h"
+
+/*____________________________________________________________________________*/
+/* The manifest records for each input file the keys its output was
+	computed with: CRC-32 and size of the input content, POPS version,
+	parameter set and the options that change the output. An input whose
+	keys match and whose output file exists is not recomputed, independent
+	of file time stamps.
+	A record is appended with a single 'write' after its output is complete,
+	so that an interrupted run loses at most the records of unfinished
+	entries; the last record of an input wins. Batch runs compact the file
+	at the end, writing it under a temporary name and renaming it.
+	Line format (tab-separated):
+	path checksum size version paramHash optionHash output */
+
+#define MANIFEST_HEADER "# POPS manifest: path checksum size version paramHash optionHash output\n"
+
+/*____________________________________________________________________________*/
+/** compare records by path, then by line */
+static int compare_record(const void *a, const void *b)
+{
+	const ManifestRecord *ra = (const ManifestRecord *)a;
+	const ManifestRecord *rb = (const ManifestRecord *)b;
+	int c = strcmp(ra->path, rb->path);
+
+	if (c != 0)
+		return c;
+	return ra->line - rb->line;
+}
+
+/*____________________________________________________________________________*/
+/** compare record by path only, for lookup */
+static int compare_path(const void *a, const void *b)
+{
+	return strcmp(((const ManifestRecord *)a)->path, ((const ManifestRecord *)b)->path);
+}
+
+/*____________________________________________________________________________*/
+/** parse manifest line into record; returns 0 on success */
+static int parse_record(char *line, ManifestRecord *record)
+{
+	char *field[7];
+	char *save = 0;
+	unsigned int i;
+	unsigned long long inputSize;
+
+	for (i = 0; i < 7; ++ i) {
+		if ((field[i] = strtok_r(i == 0 ? line : 0, "\t\n", &save)) == 0)
+			return 1;
+	}
+
+	record->path = safe_malloc(strlen(field[0]) + 1);
+	strcpy(record->path, field[0]);
+	record->checksum = (uint32_t)strtoul(field[1], 0, 16);
+	sscanf(field[2], "%llu", &inputSize);
+	record->inputSize = (uint64_t)inputSize;
+	memset(record->version, 0, sizeof(record->version));
+	strncpy(record->version, field[3], sizeof(record->version) - 1);
+	record->paramHash = (uint32_t)strtoul(field[4], 0, 16);
+	record->optionHash = (uint32_t)strtoul(field[5], 0, 16);
+	record->output = safe_malloc(strlen(field[6]) + 1);
+	strcpy(record->output, field[6]);
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** format record as manifest line */
+static int format_record(char *line, size_t size, ManifestRecord *record)
+{
+	return snprintf(line, size, "%s\t%08x\t%llu\t%s\t%08x\t%08x\t%s\n",
+		record->path, record->checksum, (unsigned long long)record->inputSize,
+		record->version, record->paramHash, record->optionHash, record->output);
+}
+
+/*____________________________________________________________________________*/
+/** read records of manifest file, sorted by path with the last record
+	of each path only */
+static void read_records(Manifest *manifest)
+{
+	FILE *manifestFile = 0;
+	char line[4096];
+	int allocated = 0;
+	int nLine = 0;
+	unsigned int i, k;
+
+	manifest->record = 0;
+	manifest->nRecord = 0;
+
+	if ((manifestFile = fopen(manifest->fileName, "r")) == 0)
+		return;
+
+	while (fgets(line, sizeof(line), manifestFile) != 0) {
+		++ nLine;
+		if ((line[0] == '#') || (line[0] == '\n'))
+			continue;
+		if (manifest->nRecord == allocated) {
+			allocated += 1024;
+			manifest->record = safe_realloc(manifest->record, allocated * sizeof(ManifestRecord));
+		}
+		if (parse_record(line, &(manifest->record[manifest->nRecord])) == 0) {
+			manifest->record[manifest->nRecord].line = nLine;
+			++ manifest->nRecord;
+		}
+	}
+	fclose(manifestFile);
+
+	/* last record of each path */
+	qsort(manifest->record, manifest->nRecord, sizeof(ManifestRecord), compare_record);
+	for (i = 0, k = 0; i < manifest->nRecord; ++ i) {
+		if ((i + 1 < manifest->nRecord) &&
+			(strcmp(manifest->record[i].path, manifest->record[i + 1].path) == 0)) {
+			free(manifest->record[i].path);
+			free(manifest->record[i].output);
+			continue;
+		}
+		manifest->record[k ++] = manifest->record[i];
+	}
+	manifest->nRecord = k;
+}
+
+/*____________________________________________________________________________*/
+/** free records */
+static void free_records(Manifest *manifest)
+{
+	unsigned int i;
+
+	for (i = 0; i < manifest->nRecord; ++ i) {
+		free(manifest->record[i].path);
+		free(manifest->record[i].output);
+	}
+	free(manifest->record);
+	manifest->record = 0;
+	manifest->nRecord = 0;
+}
+
+/*____________________________________________________________________________*/
+/** read manifest and open it for appending records */
+int open_manifest(Manifest *manifest, char *fileName)
+{
+	struct stat manifestStat;
+
+	manifest->fileName = fileName;
+	read_records(manifest);
+
+	if ((manifest->fd = open(fileName, O_WRONLY | O_APPEND | O_CREAT, 0644)) < 0) {
+		ErrorSpecNoexit("Cannot write manifest", fileName);
+		free_records(manifest);
+		return POPS_ERR_OUTPUT;
+	}
+	if ((fstat(manifest->fd, &manifestStat) == 0) && (manifestStat.st_size == 0))
+		if (write(manifest->fd, MANIFEST_HEADER, strlen(MANIFEST_HEADER)) < 0)
+			WarningSpec("Cannot write manifest", fileName);
+
+	pthread_mutex_init(&(manifest->lock), 0);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** options that change the output */
+static uint32_t option_hash(Arg *arg, Argpdb *argpdb)
+{
+	char options[512];
+	uLong hash;
+	uint32_t poseChecksum;
+	uint64_t poseSize;
+
+	snprintf(options, sizeof(options),
+		"%g %d%d%d%d %d%d%d%d %d%d%d%d%d%d%d%d%d%d%d%d%d%d%d %g %s%s%s",
+		arg->rProbe,
+		argpdb->coarse, argpdb->hydrogens, argpdb->multiModel, argpdb->partOcc,
+		arg->pdb, arg->pdbml, arg->mmcif, arg->zipped,
+		arg->interfaceOut, arg->compositionOut, arg->typeOut, arg->topologyOut,
+		arg->atomOut, arg->residueOut, arg->chainOut, arg->neighbourOut,
+		arg->parameterOut, arg->noTotalOut, arg->noHeaderOut, arg->padding,
+		arg->rout, arg->jsonOut, arg->popscomp, arg->popscomp ? arg->equivRmsd : 0.,
+		arg->assembly ? arg->assembly : "", arg->dual ? " dual" : "",
+		arg->gradientOut ? " gradient" : "");
+
+	hash = crc32(crc32(0L, Z_NULL, 0), (const Bytef *)options, strlen(options));
+	/* radii of a run with several probe radii */
+	if (arg->nProbe > 1)
+		hash = crc32(hash, (const Bytef *)arg->probe, arg->nProbe * sizeof(float));
+	/* read-time selection */
+	if (argpdb->chains)
+		hash = crc32(hash, (const Bytef *)argpdb->chains, strlen(argpdb->chains));
+	if (argpdb->residues)
+		hash = crc32(hash, (const Bytef *)argpdb->residues, strlen(argpdb->residues));
+	if (argpdb->noNucleic)
+		hash = crc32(hash, (const Bytef *)" noNucleic", 10);
+	/* mutant and residues of a scan */
+	if (arg->scan)
+		hash = crc32(hash, (const Bytef *)arg->scan, strlen(arg->scan));
+	if (arg->scanResidues)
+		hash = crc32(hash, (const Bytef *)arg->scanResidues, strlen(arg->scanResidues));
+	/* content of the pose file and partner chain */
+	if (arg->poseInFileName && (input_checksum(arg->poseInFileName, &poseChecksum, &poseSize) == 0))
+		hash = crc32(hash, (const Bytef *)&poseChecksum, sizeof(uint32_t));
+	if (arg->poseChain)
+		hash = crc32(hash, (const Bytef *)arg->poseChain, strlen(arg->poseChain));
+
+	return (uint32_t)hash;
+}
+
+/*____________________________________________________________________________*/
+/** keys of the input structure named in 'arg';
+	the key path points into 'arg' */
+int manifest_key(PopsContext *ctx, Arg *arg, Argpdb *argpdb, ManifestRecord *key)
+{
+	key->path = input_file_name(arg);
+	if (input_checksum(key->path, &(key->checksum), &(key->inputSize)) != 0)
+		return POPS_ERR_INPUT;
+	memset(key->version, 0, sizeof(key->version));
+	strncpy(key->version, VERSION, sizeof(key->version) - 1);
+	key->paramHash = ctx->paramHash;
+	key->optionHash = option_hash(arg, argpdb);
+	key->output = 0;
+	key->line = 0;
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** 1 if the manifest holds a matching record with existing output */
+int manifest_current(Manifest *manifest, ManifestRecord *key)
+{
+	ManifestRecord *record = 0;
+	struct stat outputStat;
+
+	/* records read at opening are not modified: no lock needed */
+	if ((record = bsearch(key, manifest->record, manifest->nRecord,
+			sizeof(ManifestRecord), compare_path)) == 0)
+		return 0;
+
+	if ((record->checksum != key->checksum) ||
+		(record->inputSize != key->inputSize) ||
+		(strcmp(record->version, key->version) != 0) ||
+		(record->paramHash != key->paramHash) ||
+		(record->optionHash != key->optionHash))
+		return 0;
+
+	if ((strcmp(record->output, "-") != 0) && (stat(record->output, &outputStat) != 0))
+		return 0;
+
+	return 1;
+}
+
+/*____________________________________________________________________________*/
+/** append record of completed output */
+int manifest_record(Manifest *manifest, ManifestRecord *key, char *output)
+{
+	char line[4096];
+	int length;
+	int ret = POPS_OK;
+
+	key->output = (output && strlen(output) > 0) ? output : "-";
+	if ((length = format_record(line, sizeof(line), key)) >= sizeof(line))
+		return POPS_ERR_OUTPUT;
+
+	/* one 'write' per record: concurrent appends do not interleave */
+	pthread_mutex_lock(&(manifest->lock));
+	if (write(manifest->fd, line, length) != length) {
+		WarningSpec("Cannot write manifest", manifest->fileName);
+		ret = POPS_ERR_OUTPUT;
+	}
+	pthread_mutex_unlock(&(manifest->lock));
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** output file that shows the computation of an entry as complete */
+char *manifest_output(char *buffer, Arg *arg, Str *pdb)
+{
+	if (arg->jsonOut)
+		sprintf(buffer, "%s/%s.json", arg->outDirName, pdb->pdbID);
+	else if (arg->rout && ! arg->noTotalOut)
+		sprintf(buffer, "%s/%s.rpopsMolecule", arg->outDirName, arg->routPrefix);
+	else if (arg->rout)
+		strcpy(buffer, "-");
+	else
+		strcpy(buffer, arg->sasaOutFileName);
+
+	return buffer;
+}
+
+/*____________________________________________________________________________*/
+/** close manifest; 'compact' rewrites it with the last record of each input */
+void close_manifest(Manifest *manifest, int compact)
+{
+	unsigned int i;
+	char line[4096];
+	char *tmpFileName = 0;
+	FILE *manifestFile = 0;
+
+	close(manifest->fd);
+	pthread_mutex_destroy(&(manifest->lock));
+	free_records(manifest);
+
+	if (! compact)
+		return;
+
+	/* records of this and earlier runs */
+	read_records(manifest);
+
+	tmpFileName = safe_malloc(strlen(manifest->fileName) + 32);
+	sprintf(tmpFileName, "%s.%d.tmp", manifest->fileName, (int)getpid());
+	if ((manifestFile = fopen(tmpFileName, "w")) == 0) {
+		WarningSpec("Cannot compact manifest", tmpFileName);
+		free(tmpFileName);
+		free_records(manifest);
+		return;
+	}
+
+	fputs(MANIFEST_HEADER, manifestFile);
+	for (i = 0; i < manifest->nRecord; ++ i) {
+		format_record(line, sizeof(line), &(manifest->record[i]));
+		fputs(line, manifestFile);
+	}
+
+	if ((fclose(manifestFile) != 0) || (rename(tmpFileName, manifest->fileName) != 0)) {
+		WarningSpec("Cannot compact manifest", manifest->fileName);
+		remove(tmpFileName);
+	}
+
+	free(tmpFileName);
+	free_records(manifest);
+}
+
@@ -0,0 +1,62 @@
+/*==============================================================================
+manifest.h : manifest of current outputs for incremental reruns
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "pack.h"
+#include "safe.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* record of one input: the output is current if all keys match */
+typedef struct {
+	char *path; /* input file */
+	uint32_t checksum; /* CRC-32 of input file */
+	uint64_t inputSize; /* size of input file */
+	char version[16]; /* POPS version */
+	uint32_t paramHash; /* CRC-32 of parameter tables */
+	uint32_t optionHash; /* CRC-32 of options that change the output */
+	char *output; /* output file, "-" if none is checked */
+	int line; /* line in manifest file, the last record of a path wins */
+} ManifestRecord;
+
+/* manifest file and its records, sorted by path */
+typedef struct {
+	char *fileName;
+	ManifestRecord *record;
+	int nRecord;
+	int fd; /* manifest file, opened for appending */
+	pthread_mutex_t lock;
+} Manifest;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int open_manifest(Manifest *manifest, char *fileName);
+int manifest_key(PopsContext *ctx, Arg *arg, Argpdb *argpdb, ManifestRecord *key);
+int manifest_current(Manifest *manifest, ManifestRecord *key);
+int manifest_record(Manifest *manifest, ManifestRecord *key, char *output);
+char *manifest_output(char *buffer, Arg *arg, Str *pdb);
+void close_manifest(Manifest *manifest, int compact);
+
+#endif
+
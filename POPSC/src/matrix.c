@@ -1,5 +1,6 @@
 /*=============================================================================
 matrix.c : allocate matrices with dicontinuous memory allocation
+	and contiguous matrices (one aligned block with row pointers)
 Copyright (C) Jens Kleinjung 2007
 Read the COPYING file for license information.
 ==============================================================================*/
@@ -428,3 +429,29 @@ void free_mat4D_vec(Vec ****mat4D_vec, int w, int x, int y)
 	free(mat4D_vec);
 }
 
+/*___________________________________________________________________________*/
+/** contiguous 2D matrix */
+/** one block: row pointer array, then 'x' rows of 'y' elements
+	of 'size' bytes; the row stride is padded to MATRIX_ALIGN bytes */
+/** block size */
+size_t size_cmat2D(int x, int y, size_t size)
+{
+	size_t header = ((x * sizeof(void *) + MATRIX_ALIGN - 1) / MATRIX_ALIGN) * MATRIX_ALIGN;
+	size_t stride = ((y * size + MATRIX_ALIGN - 1) / MATRIX_ALIGN) * MATRIX_ALIGN;
+
+	return header + x * stride;
+}
+
+/** set row pointers of a MATRIX_ALIGN aligned block */
+void *place_cmat2D(void *block, int x, int y, size_t size)
+{
+	unsigned int i;
+	size_t header = ((x * sizeof(void *) + MATRIX_ALIGN - 1) / MATRIX_ALIGN) * MATRIX_ALIGN;
+	size_t stride = ((y * size + MATRIX_ALIGN - 1) / MATRIX_ALIGN) * MATRIX_ALIGN;
+
+	for (i = 0; i < x; ++ i)
+		((char **)block)[i] = (char *)block + header + i * stride;
+
+	return block;
+}
+
@@ -1,5 +1,6 @@
 /*=============================================================================
 matrix.h : allocate matrices (with dicontinuous memory allocation)
+	and contiguous matrices (one aligned block with row pointers)
 Copyright (C) Jens Kleinjung 2007
 Read the COPYING file for license information.
 =============================================================================*/
@@ -12,6 +13,10 @@ Read the COPYING file for license information.
 #include "safe.h"
 #include "vector.h"
 
+/*___________________________________________________________________________*/
+/* alignment of contiguous matrix rows: cache line size */
+#define MATRIX_ALIGN 64
+
 /*___________________________________________________________________________*/
 /* prototypes */
 /* integer */
@@ -56,5 +61,11 @@ Vec ****alloc_mat4D_vec(Vec ****mat4D_vec, int w, int x, int y, int z);
 void init__mat4D_vec(Vec ****mat4D_vec, int w, int x, int y, int z, Vec val);
 void free_mat4D_vec(Vec ****mat4D_vec, int w, int x, int y);
 
+/* contiguous: row pointers and rows in one block, rows cache-line aligned,
+	placed in an arena by 'arena_mat2D'; initialise, print, divide with
+	the 'mat2D' routines above */
+size_t size_cmat2D(int x, int y, size_t size);
+void *place_cmat2D(void *block, int x, int y, size_t size);
+
 #endif
 
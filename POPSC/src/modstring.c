@@ -18,6 +18,21 @@ void strip_char(const char *s, char *t)
 			j++;
 }
 
+/*___________________________________________________________________________*/
+/** allocated copy of the last component of 'path'; reentrant, unlike
+	'basename', which may return static storage or modify its argument */
+char *copy_basename(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	const char *name = slash ? slash + 1 : path;
+	char *copy = malloc(strlen(name) + 1);
+
+	assert(copy != 0);
+	strcpy(copy, name);
+
+	return copy;
+}
+
 /*___________________________________________________________________________*/
 /** position (min = 0) of substring in string */
 int strpos0(char *string, char *substring)
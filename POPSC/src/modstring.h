@@ -15,6 +15,7 @@ Read the COPYING file for license information.
 
 /*___________________________________________________________________________*/
 void strip_char(const char *s, char *t); 
+char *copy_basename(const char *path);
 int strpos0(char *string, char *substring);
 int strpos1(char *string, char *substring);
 
@@ -0,0 +1,380 @@
+/*==============================================================================
+pack.c : binary cache of pre-parsed structures ('pops pack')
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "pack.h"
+
+/*____________________________________________________________________________*/
+/* A pack holds the parsed and typed atom records and the bonded topology
+	of one input file. It is keyed by the CRC-32 and size of the input file,
+	the POPS version and the reader options, so that a changed input,
+	program or option set never reuses a stale pack. Packs are mapped
+	copy-on-write, which makes loading independent of structure size. */
+
+/*____________________________________________________________________________*/
+/** input format and reader options that change the parsed structure;
+	the read-time selection of chains and residue ranges is folded in
+	as CRC-32 above the option bits */
+__inline__ static uint32_t pack_options(Arg *arg, Argpdb *argpdb)
+{
+	uLong selection = crc32(0L, Z_NULL, 0);
+
+	if (argpdb->chains)
+		selection = crc32(selection, (const Bytef *)argpdb->chains, strlen(argpdb->chains));
+	if (argpdb->residues) {
+		selection = crc32(selection, (const Bytef *)":", 1);
+		selection = crc32(selection, (const Bytef *)argpdb->residues, strlen(argpdb->residues));
+	}
+
+	return (argpdb->coarse) | (argpdb->hydrogens << 1) |
+		(argpdb->multiModel << 2) | (argpdb->partOcc << 3) |
+		(arg->pdb << 4) | (arg->pdbml << 5) | (arg->mmcif << 6) |
+		(arg->zipped << 7) | (argpdb->noNucleic << 8) |
+		((argpdb->chains || argpdb->residues) ? ((uint32_t)selection << 9) : 0);
+}
+
+/*____________________________________________________________________________*/
+/** CRC-32 and size of input file */
+int input_checksum(char *fileName, uint32_t *checksum, uint64_t *size)
+{
+	FILE *inFile = 0;
+	unsigned char buffer[65536];
+	size_t nRead;
+	uLong crc = crc32(0L, Z_NULL, 0);
+
+	*size = 0;
+	if ((inFile = fopen(fileName, "rb")) == 0)
+		return 1;
+
+	while ((nRead = fread(buffer, 1, sizeof(buffer), inFile)) > 0) {
+		crc = crc32(crc, buffer, (uInt)nRead);
+		*size += nRead;
+	}
+	fclose(inFile);
+
+	*checksum = (uint32_t)crc;
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** 64-byte aligned offset */
+__inline__ static uint64_t pack_align(uint64_t offset)
+{
+	return (offset + 63) & ~((uint64_t)63);
+}
+
+/*____________________________________________________________________________*/
+/** size of each section */
+static void section_sizes(PackHeader *header, uint64_t *size)
+{
+	size[PACK_ATOM] = (uint64_t)header->nAtom * sizeof(Atom);
+	size[PACK_ATOMMAP] = (uint64_t)header->nAtom * sizeof(int);
+	size[PACK_RESATOM] = (uint64_t)header->nResidue * sizeof(int);
+	size[PACK_SEQUENCE] = (uint64_t)header->nResidue + 1;
+	size[PACK_ATOMTYPE] = (uint64_t)header->nAtom * sizeof(int);
+	size[PACK_RESIDUETYPE] = (uint64_t)header->nAtom * sizeof(int);
+	size[PACK_BOND] = (uint64_t)header->nBond * 2 * sizeof(int);
+	size[PACK_ANGLE] = (uint64_t)header->nAngle * 3 * sizeof(int);
+	size[PACK_TORSION] = (uint64_t)header->nTorsion * 4 * sizeof(int);
+	size[PACK_BONDSTATE] = ((uint64_t)header->nAtom + 1 + header->nBondState) * sizeof(int);
+}
+
+/*____________________________________________________________________________*/
+/** checksum input file and set pack file name */
+static int pack_name(Arg *arg, Argpdb *argpdb, Pack *pack)
+{
+	if (input_checksum(input_file_name(arg), &(pack->checksum), &(pack->inputSize)) != 0)
+		return 1;
+
+	pack->fileName = safe_malloc(strlen(arg->packDirName) + 64);
+	sprintf(pack->fileName, "%s/%08x-%llx-%02x.popspack", arg->packDirName,
+		pack->checksum, (unsigned long long)pack->inputSize, pack_options(arg, argpdb));
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** unmap pack file */
+static void unmap_pack(Pack *pack)
+{
+	if (pack->map)
+		munmap(pack->map, pack->mapSize);
+	pack->map = 0;
+	pack->mapSize = 0;
+	pack->header = 0;
+}
+
+/*____________________________________________________________________________*/
+/** map pack file of input structure and assign structure and types;
+	returns 0 if the pack was loaded, 1 otherwise */
+int load_pack(Arg *arg, Argpdb *argpdb, Pack *pack, Str *pdb, Type *type)
+{
+	int fd;
+	unsigned int i;
+	struct stat packStat;
+	uint64_t size[PACK_NSECTION];
+	PackHeader *header = 0;
+	char *base = 0;
+	char *inFileName = input_file_name(arg);
+
+	pack->fileName = 0;
+	pack->map = 0;
+	pack->mapSize = 0;
+	pack->header = 0;
+
+	if (pack_name(arg, argpdb, pack) != 0)
+		return 1;
+
+	/*____________________________________________________________________________*/
+	/* map pack file */
+	if ((fd = open(pack->fileName, O_RDONLY)) < 0)
+		return 1;
+	if ((fstat(fd, &packStat) != 0) || (packStat.st_size < sizeof(PackHeader))) {
+		close(fd);
+		return 1;
+	}
+	base = mmap(0, packStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return 1;
+
+	pack->map = base;
+	pack->mapSize = packStat.st_size;
+	pack->header = header = (PackHeader *)base;
+
+	/*____________________________________________________________________________*/
+	/* validate key and layout */
+	if ((memcmp(header->magic, PACK_MAGIC, 8) != 0) ||
+		(header->format != PACK_FORMAT) ||
+		(strncmp(header->version, VERSION, sizeof(header->version)) != 0) ||
+		(header->atomSize != sizeof(Atom)) ||
+		(header->checksum != pack->checksum) ||
+		(header->inputSize != pack->inputSize) ||
+		(header->options != pack_options(arg, argpdb))) {
+		unmap_pack(pack);
+		return 1;
+	}
+
+	section_sizes(header, size);
+	for (i = 0; i < PACK_NSECTION; ++ i) {
+		if ((header->offset[i] % 64 != 0) || (header->offset[i] + size[i] > pack->mapSize)) {
+			WarningSpec("Corrupt structure pack", pack->fileName);
+			unmap_pack(pack);
+			return 1;
+		}
+	}
+
+	/*____________________________________________________________________________*/
+	/* structure */
+	strcpy(pdb->pdbID, header->pdbID);
+	pdb->nAtom = header->nAtom;
+	pdb->nAllAtom = header->nAllAtom;
+	pdb->nResidue = header->nResidue;
+	pdb->nAllResidue = header->nAllResidue;
+	pdb->nChain = header->nChain;
+	pdb->multiModel = header->multiModel;
+	pdb->modelNumber = header->modelNumber;
+	pdb->atom = (Atom *)(base + header->offset[PACK_ATOM]);
+	pdb->atomMap = (int *)(base + header->offset[PACK_ATOMMAP]);
+	pdb->resAtom = (int *)(base + header->offset[PACK_RESATOM]);
+	pdb->sequence.res = base + header->offset[PACK_SEQUENCE];
+	if (arg->pdb || arg->pdbml) {
+		pdb->sequence.name = copy_basename(inFileName);
+	}
+
+	/* types */
+	type->atomType = (int *)(base + header->offset[PACK_ATOMTYPE]);
+	type->residueType = (int *)(base + header->offset[PACK_RESIDUETYPE]);
+
+	if (! arg->silent) fprintf(stdout, "\tStructure pack: %s\n"
+										"\tPDB file content:\n"
+										"\t\tall atoms = %d\n"
+										"\t\tprocessed atoms (C,N,O,S,P) = %d\n"
+										"\t\tresidues (CA||N3) = %d\n"
+										"\t\tchains = %d\n",
+							pack->fileName, pdb->nAllAtom,
+							pdb->nAtom, pdb->nResidue, pdb->nChain);
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** copy bonded topology from pack into initialised topology */
+void unpack_topology(Pack *pack, Str *pdb, Topol *topol)
+{
+	unsigned int i;
+	PackHeader *header = pack->header;
+	char *base = (char *)pack->map;
+	int *bond = (int *)(base + header->offset[PACK_BOND]);
+	int *angle = (int *)(base + header->offset[PACK_ANGLE]);
+	int *torsion = (int *)(base + header->offset[PACK_TORSION]);
+	int *stateOffset = (int *)(base + header->offset[PACK_BONDSTATE]);
+	int *state = stateOffset + header->nAtom + 1;
+
+	/* the topology arrays are allocated in the topology arena */
+	topol->nBond = header->nBond;
+	topol->ib = arena_alloc(topol->arena, (topol->nBond + 1) * sizeof(int));
+	topol->jb = arena_alloc(topol->arena, (topol->nBond + 1) * sizeof(int));
+	memcpy(topol->ib, bond, topol->nBond * sizeof(int));
+	memcpy(topol->jb, bond + topol->nBond, topol->nBond * sizeof(int));
+
+	topol->nAngle = header->nAngle;
+	topol->it = arena_alloc(topol->arena, (topol->nAngle + 1) * sizeof(int));
+	topol->jt = arena_alloc(topol->arena, (topol->nAngle + 1) * sizeof(int));
+	topol->kt = arena_alloc(topol->arena, (topol->nAngle + 1) * sizeof(int));
+	memcpy(topol->it, angle, topol->nAngle * sizeof(int));
+	memcpy(topol->jt, angle + topol->nAngle, topol->nAngle * sizeof(int));
+	memcpy(topol->kt, angle + 2 * topol->nAngle, topol->nAngle * sizeof(int));
+
+	topol->nTorsion = header->nTorsion;
+	topol->ip = arena_alloc(topol->arena, (topol->nTorsion + 1) * sizeof(int));
+	topol->jp = arena_alloc(topol->arena, (topol->nTorsion + 1) * sizeof(int));
+	topol->kp = arena_alloc(topol->arena, (topol->nTorsion + 1) * sizeof(int));
+	topol->lp = arena_alloc(topol->arena, (topol->nTorsion + 1) * sizeof(int));
+	memcpy(topol->ip, torsion, topol->nTorsion * sizeof(int));
+	memcpy(topol->jp, torsion + topol->nTorsion, topol->nTorsion * sizeof(int));
+	memcpy(topol->kp, torsion + 2 * topol->nTorsion, topol->nTorsion * sizeof(int));
+	memcpy(topol->lp, torsion + 3 * topol->nTorsion, topol->nTorsion * sizeof(int));
+
+	/* bond state rows, element 0 is the number of bonded atoms */
+	for (i = 0; i < pdb->nAtom; ++ i)
+		memcpy(topol->bondState[i], &(state[stateOffset[i]]),
+			(stateOffset[i + 1] - stateOffset[i]) * sizeof(int));
+}
+
+/*____________________________________________________________________________*/
+/** write section at aligned offset */
+__inline__ static void write_section(FILE *packFile, uint64_t offset, const void *data, size_t size)
+{
+	fseek(packFile, (long)offset, SEEK_SET);
+	if (size > 0)
+		fwrite(data, 1, size, packFile);
+}
+
+/*____________________________________________________________________________*/
+/** write pack of typed structure and bonded topology;
+	the file is written under a temporary name and renamed when complete */
+int write_pack(Arg *arg, Argpdb *argpdb, Pack *pack, Str *pdb, Type *type, Topol *topol)
+{
+	unsigned int i;
+	uint64_t size[PACK_NSECTION];
+	uint64_t offset = 0;
+	PackHeader header;
+	FILE *packFile = 0;
+	char *tmpFileName = 0;
+	int *stateOffset = 0;
+	int writeError = 0;
+	int ret = 0;
+	Atom atom;
+
+	if ((pack->fileName == 0) && (pack_name(arg, argpdb, pack) != 0))
+		return 1;
+
+	/*____________________________________________________________________________*/
+	/* header */
+	memset(&header, 0, sizeof(PackHeader));
+	memcpy(header.magic, PACK_MAGIC, 8);
+	strncpy(header.version, VERSION, sizeof(header.version) - 1);
+	header.format = PACK_FORMAT;
+	header.atomSize = sizeof(Atom);
+	header.checksum = pack->checksum;
+	header.options = pack_options(arg, argpdb);
+	header.inputSize = pack->inputSize;
+	memcpy(header.pdbID, pdb->pdbID, sizeof(header.pdbID));
+	header.pdbID[sizeof(header.pdbID) - 1] = '\0';
+	header.nAtom = pdb->nAtom;
+	header.nAllAtom = pdb->nAllAtom;
+	header.nResidue = pdb->nResidue;
+	header.nAllResidue = pdb->nAllResidue;
+	header.nChain = pdb->nChain;
+	header.multiModel = pdb->multiModel;
+	header.modelNumber = pdb->modelNumber;
+	header.nBond = topol->nBond;
+	header.nAngle = topol->nAngle;
+	header.nTorsion = topol->nTorsion;
+
+	/* bond state row offsets */
+	stateOffset = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	for (i = 0, stateOffset[0] = 0; i < pdb->nAtom; ++ i)
+		stateOffset[i + 1] = stateOffset[i] + topol->bondState[i][0] + 1;
+	header.nBondState = stateOffset[pdb->nAtom];
+
+	/* section layout */
+	section_sizes(&header, size);
+	offset = pack_align(sizeof(PackHeader));
+	for (i = 0; i < PACK_NSECTION; ++ i) {
+		header.offset[i] = offset;
+		offset = pack_align(offset + size[i]);
+	}
+
+	/*____________________________________________________________________________*/
+	tmpFileName = safe_malloc(strlen(pack->fileName) + 32);
+	/* process and pack address: unique among concurrent batch threads */
+	sprintf(tmpFileName, "%s.%d.%lx.tmp", pack->fileName, (int)getpid(), (unsigned long)pack);
+	if ((packFile = fopen(tmpFileName, "wb")) == 0) {
+		WarningSpec("Cannot write structure pack", tmpFileName);
+		free(tmpFileName);
+		free(stateOffset);
+		return 1;
+	}
+
+	write_section(packFile, 0, &header, sizeof(PackHeader));
+
+	/* atom records without list pointer */
+	fseek(packFile, (long)header.offset[PACK_ATOM], SEEK_SET);
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		atom = pdb->atom[i];
+		atom.next = 0;
+		fwrite(&atom, sizeof(Atom), 1, packFile);
+	}
+	write_section(packFile, header.offset[PACK_ATOMMAP], pdb->atomMap, size[PACK_ATOMMAP]);
+	write_section(packFile, header.offset[PACK_RESATOM], pdb->resAtom, size[PACK_RESATOM]);
+	write_section(packFile, header.offset[PACK_SEQUENCE], pdb->sequence.res, size[PACK_SEQUENCE]);
+	write_section(packFile, header.offset[PACK_ATOMTYPE], type->atomType, size[PACK_ATOMTYPE]);
+	write_section(packFile, header.offset[PACK_RESIDUETYPE], type->residueType, size[PACK_RESIDUETYPE]);
+
+	/* bonded topology */
+	write_section(packFile, header.offset[PACK_BOND], topol->ib, topol->nBond * sizeof(int));
+	fwrite(topol->jb, sizeof(int), topol->nBond, packFile);
+	write_section(packFile, header.offset[PACK_ANGLE], topol->it, topol->nAngle * sizeof(int));
+	fwrite(topol->jt, sizeof(int), topol->nAngle, packFile);
+	fwrite(topol->kt, sizeof(int), topol->nAngle, packFile);
+	write_section(packFile, header.offset[PACK_TORSION], topol->ip, topol->nTorsion * sizeof(int));
+	fwrite(topol->jp, sizeof(int), topol->nTorsion, packFile);
+	fwrite(topol->kp, sizeof(int), topol->nTorsion, packFile);
+	fwrite(topol->lp, sizeof(int), topol->nTorsion, packFile);
+	write_section(packFile, header.offset[PACK_BONDSTATE], stateOffset, (pdb->nAtom + 1) * sizeof(int));
+	for (i = 0; i < pdb->nAtom; ++ i)
+		fwrite(topol->bondState[i], sizeof(int), topol->bondState[i][0] + 1, packFile);
+
+	/* pad to end of last section */
+	fseek(packFile, (long)offset - 1, SEEK_SET);
+	fputc(0, packFile);
+
+	/* a short write, a failed close or a failed rename leave no pack behind */
+	writeError = ferror(packFile);
+	if ((fclose(packFile) != 0) || writeError || (rename(tmpFileName, pack->fileName) != 0)) {
+		WarningSpec("Cannot write structure pack", pack->fileName);
+		unlink(tmpFileName);
+		ret = 1;
+	}
+
+	free(tmpFileName);
+	free(stateOffset);
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** unmap pack and free pack file name */
+void free_pack(Pack *pack)
+{
+	unmap_pack(pack);
+	free(pack->fileName);
+	pack->fileName = 0;
+}
+
@@ -0,0 +1,91 @@
+/*==============================================================================
+pack.h : binary cache of pre-parsed structures ('pops pack')
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef PACK_H
+#define PACK_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "pdb_structure.h"
+#include "safe.h"
+#include "topol.h"
+#include "type.h"
+
+/*___________________________________________________________________________*/
+/* pack file layout: header followed by 64-byte aligned sections */
+#define PACK_MAGIC "POPSPACK"
+#define PACK_FORMAT 1
+
+enum {
+	PACK_ATOM = 0, /* Atom records */
+	PACK_ATOMMAP, /* map of selected to original atom count */
+	PACK_RESATOM, /* atom indices of CA and P atoms */
+	PACK_SEQUENCE, /* residue sequence */
+	PACK_ATOMTYPE, /* SASA/SIGMA atom types */
+	PACK_RESIDUETYPE, /* SASA/SIGMA residue types */
+	PACK_BOND, /* ib, jb */
+	PACK_ANGLE, /* it, jt, kt */
+	PACK_TORSION, /* ip, jp, kp, lp */
+	PACK_BONDSTATE, /* bond state rows: offsets, then entries */
+	PACK_NSECTION
+};
+
+typedef struct {
+	char magic[8]; /* PACK_MAGIC */
+	char version[16]; /* POPS version */
+	uint32_t format; /* PACK_FORMAT */
+	uint32_t atomSize; /* size of Atom record */
+	uint32_t checksum; /* CRC-32 of input file */
+	uint32_t options; /* input format and reader options */
+	uint64_t inputSize; /* size of input file */
+	char pdbID[16]; /* PDB identifier */
+	int32_t nAtom;
+	int32_t nAllAtom;
+	int32_t nResidue;
+	int32_t nAllResidue;
+	int32_t nChain;
+	int32_t multiModel;
+	int32_t modelNumber;
+	int32_t nBond;
+	int32_t nAngle;
+	int32_t nTorsion;
+	int32_t nBondState; /* number of bond state entries */
+	int32_t padding;
+	uint64_t offset[PACK_NSECTION]; /* section offsets from file start */
+} PackHeader;
+
+/* mapped pack */
+typedef struct {
+	char *fileName; /* pack file name, derived from input checksum */
+	uint32_t checksum; /* CRC-32 of input file */
+	uint64_t inputSize; /* size of input file */
+	void *map; /* mapped file, 0 if not loaded */
+	size_t mapSize;
+	PackHeader *header;
+} Pack;
+
+/*____________________________________________________________________________*/
+/* prototypes */
+int input_checksum(char *fileName, uint32_t *checksum, uint64_t *size);
+int load_pack(Arg *arg, Argpdb *argpdb, Pack *pack, Str *pdb, Type *type);
+void unpack_topology(Pack *pack, Str *pdb, Topol *topol);
+int write_pack(Arg *arg, Argpdb *argpdb, Pack *pack, Str *pdb, Type *type, Topol *topol);
+void free_pack(Pack *pack);
+
+#endif
+
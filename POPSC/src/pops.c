@@ -33,10 +33,23 @@ Kleinjung, J. and Fraternali, F.
 #include "config.h"
 #include "pops.h"
 
+/*____________________________________________________________________________*/
+/** empty JSON output of structures without computable surface,
+	as expected by the server pipeline */
+static void empty_json(Str *pdb, char *jsonFileName)
+{
+	FILE *jsonFile = 0;
+
+	sprintf(jsonFileName, "%s.json", pdb->pdbID);
+	if ((jsonFile = fopen(jsonFileName, "a")) != 0)
+		fclose(jsonFile);
+}
+
 /*____________________________________________________________________________*/
 int main(int argc, char *argv[])
 {
 	int i;
+	int ret;
 
     /*____________________________________________________________________________*/
 	/* data structures and variables */
@@ -45,70 +58,120 @@ int main(int argc, char *argv[])
 	Str pdb; /** data structure for input PDB molecule */
 	Structure *s = NULL; /* structure pointer returned from MMCIF reader */
 	Traj traj; /** data structure for trajectory */
-	MolSasa molSasa; /* data structure for molecular SASA values,
-					invoking structures for residuic and atomic SASA values */
-	MolSFE molSFE; /* data structure for molecular SFE values,
-					invoking structures for residuic and atomic SFE values */
-	Topol topol; /* molecular topology */
-	Type type; /* atom and residue types */
-	ConstantSasa *constant_sasa; /* selected SASA constants */ 
-	ConstantSasa *res_sasa; /* residue SASA constants */ 
-	ConstantSigma *constant_sigma; /* SIGMA constants */ 
-	Atomgroup *atomGroup; /* atom group constants */
-	extern int status; /* program status from 'error' library */
-
-	/* create JSON object */
-	cJSON *resSasaJson = cJSON_CreateObject();
-    if (resSasaJson == NULL) {
-		cJSON_Delete(resSasaJson);
-		ErrorSpec("Exiting", "JSON object returned NULL");
-    }
-
-	/* create JSONb object */
-	cJSON *resSasaJsonb = cJSON_CreateObject();
-    if (resSasaJsonb == NULL) {
-		cJSON_Delete(resSasaJsonb);
-		ErrorSpec("Exiting", "JSONb object returned NULL");
-    }
+	PopsContext ctx; /* parameter tables */
+	PopsResult result; /* types, topology, SASA and SFE of structure */
+	PopsComp comp; /* isolated chains and chain pairs */
+	PopsProbe probe; /* SASA at several probe radii */
+	PopsDual dual; /* coarse-grained SASA alongside the atomic SASA */
+	PopsUpdate update; /* incremental SASA update of trajectory frames */
+	PopsScan scan; /* SASA and SFE changes of truncated residues */
+	PopsGradient gradient; /* gradients of molecular SASA and SFE */
+	PopsPose pose; /* rigid-body poses of a partner chain */
+	PopsFit fit; /* SASA parameters fitted to reference SASA */
+	PopsSelection selection; /* SASA of selected atoms */
+	PopsInterface interface; /* SASA of interface atoms */
+	Assembly assembly; /* operations of the biological assembly */
+	Str full; /* biological assembly */
+	Pack pack = {0, 0, 0, 0, 0, 0}; /* structure pack */
+	Manifest manifest; /* manifest of current outputs */
+	ManifestRecord key; /* manifest keys of input structure */
+	char outputName[1024]; /* output file recorded in manifest */
 
     /*____________________________________________________________________________*/
     /** parse command line arguments */
     parse_args(argc, &(argv[0]), &arg, &argpdb);
 
+	/* XML parser state, shared by batch and server threads */
+	xmlInitParser();
+
     /*____________________________________________________________________________*/
-	/** select SASA parameters */
-	if (! argpdb.coarse) {
-		constant_sasa = &(constant_sasa_data[0]); /* data array element 0: atomic */
-	} else {
-		constant_sasa = &(constant_sasa_data[1]); /* data array element 1: coarse-grained */
+    /** server mode: requests on a Unix socket, parameter tables resident */
+	if (arg.serveName) {
+		ret = run_server(&arg, &argpdb);
+		xmlCleanupParser();
+		return ret;
 	}
-	res_sasa = &(constant_sasa_data[1]);
 
     /*____________________________________________________________________________*/
-	/** select SIGMA parameters */
-	if (! argpdb.coarse) {
-		constant_sigma = &(constant_sigma_data[0]); /* data array element 0: atomic */
-	} else {
-		constant_sigma = &(constant_sigma_data[1]); /* data array element 1: coarse-grained */
+	/** select SASA and SIGMA parameters, hash (residue, atom) names */
+	pops_init(&ctx, argpdb.coarse);
+	pops_init_result(&result);
+
+    /*____________________________________________________________________________*/
+    /** batch mode: all entries of a directory or list file in this process */
+	if (arg.batchName) {
+		ret = run_batch(&ctx, &arg, &argpdb);
+		pops_free_result(&result);
+		pops_free(&ctx);
+		xmlCleanupParser();
+		if (! arg.silent) fprintf(stdout, "\nClean termination\n\n");
+		return (ret == 0) ? 0 : 1;
+	}
+
+    /*____________________________________________________________________________*/
+    /** parameter fit: SASA parameters fitted to the reference SASA of a training set */
+	if (arg.fitName) {
+		if (! arg.silent) fprintf(stdout, "Parameter fit\n");
+		if ((ret = pops_fit(&ctx, &arg, &argpdb, &fit)) == POPS_OK)
+			pops_print_fit(&ctx, &arg, &fit);
+		else
+			fprintf(stderr, "Parameter fit: %s\n", pops_strerror(ret));
+		pops_free_fit(&fit);
+		pops_free_result(&result);
+		pops_free(&ctx);
+		xmlCleanupParser();
+		if (! arg.silent) fprintf(stdout, "\nClean termination\n\n");
+		return (ret == POPS_OK) ? 0 : 1;
 	}
 
     /*____________________________________________________________________________*/
-    /** read input structure: mmcif, xml or pdb format */
+    /** manifest: skip the computation if the output is current */
+	if (arg.manifestName) {
+		if (open_manifest(&manifest, arg.manifestName) != POPS_OK)
+			exit(1);
+		if ((manifest_key(&ctx, &arg, &argpdb, &key) == POPS_OK) &&
+			manifest_current(&manifest, &key)) {
+			if (! arg.silent) fprintf(stdout, "Output is current: %s\n", key.path);
+			close_manifest(&manifest, 0);
+			pops_free_result(&result);
+			pops_free(&ctx);
+			return 0;
+		}
+	}
+
+    /*____________________________________________________________________________*/
+    /** read input structure: structure pack, mmcif, xml or pdb format */
 	if (! arg.silent) fprintf(stdout, "Input structure\n");
 	strcpy(pdb.pdbID, "");
-
-	if (arg.mmcif) {
+	pdb.sequence.name = 0; /* set by the PDB and PDBML readers and packs */
+
+	if (arg.packDirName && (load_pack(&arg, &argpdb, &pack, &pdb, &(result.type)) == 0)) {
+		/* parsed and typed structure plus bonded topology from pack;
+			'load_pack' prints the structure content;
+			the types are in the mapped file, also for selection and interface mode */
+		result.packed = 1;
+	} else if (arg.mmcif) {
 		printf("Reading MMCIF file\n");
 		/* 'gemmi' library function to read PDB entries */
-		s = read_cif(arg.mmcifInFileName);
+		if ((s = read_cif(arg.mmcifInFileName, arg.assembly)) == NULL) {
+			ErrorSpecNoexit("Cannot read MMCIF file", arg.mmcifInFileName);
+			exit(1);
+		}
 		/* map function to copy PDB entries to C structure */
 		map_structure_mmcif(&arg, &argpdb, &pdb, s);
+		if (arg.assembly && (map_assembly_mmcif(&arg, &pdb, s, &assembly) != POPS_OK))
+			exit(1);
+		free_structure(s);
 	} else if (arg.pdbml) {
 		printf("Reading PDBML file\n");
-		read_structure_xml(&arg, &argpdb, &pdb);
+		if (read_structure_xml(&arg, &argpdb, &pdb) != POPS_OK)
+			exit(1);
 	} else if (arg.pdb) {
 		printf("Reading PDB file\n");
-		read_structure(&arg, &argpdb, &pdb);
+		if (read_structure(&arg, &argpdb, &pdb) != POPS_OK)
+			exit(1);
+		if (arg.assembly && (read_assembly_pdb(&arg, &pdb, &assembly) != POPS_OK))
+			exit(1);
 	} else {
 		printf("Failed to read an input structure!\n");
 		exit(EXIT_FAILURE);
@@ -121,75 +184,137 @@ int main(int argc, char *argv[])
 		read_gromos_traj(&traj, &arg, pdb.nAllAtom);
 	}
 
-    /*___________________________________________________________________________*/
-    /* assign atom group ID number */
-    atomGroup = &(constAtomGroup[0]); /* group array element 0: POPS grouping */
-	if (! arg.silent) fprintf(stdout, "Groups\n");
-    get_atomgroup(&pdb, atomGroup); /* assign atom grouping */
-
-	/*____________________________________________________________________________*/
-    /** define atom and residue types */
-	if (! arg.silent) fprintf(stdout, "Types\n");
-    get_types(&pdb, &type, constant_sasa);
+    /*____________________________________________________________________________*/
+    /** biological assembly: SASA of the copies of the asymmetric unit
+		with distinct environments, the assembly replaces the input */
+	if (arg.assembly) {
+		if ((ret = pops_assembly(&ctx, &arg, &argpdb, &pdb, &assembly, &full, &result)) != POPS_OK) {
+			fprintf(stderr, "Assembly: %s\n", pops_strerror(ret));
+			exit(1);
+		}
+		if (! arg.silent)
+			fprintf(stdout, "\tAssembly %s: %d copies in %d environment classes,"
+				" %d atoms, %d atoms evaluated\n",
+				arg.assembly, assembly.nCopy, assembly.nClass,
+				full.nAtom, assembly.nEvaluated);
+		free_assembly(&assembly);
+		free(pdb.atom);
+		free(pdb.resAtom);
+		free(pdb.atomMap);
+		free(pdb.sequence.res);
+		free(pdb.sequence.name);
+		pdb = full;
+	}
 
     /*____________________________________________________________________________*/
-    /** compute molecular topology */
-	if (! arg.silent) fprintf(stdout, "Topology\n");
-	init_topology(&arg, &pdb, &topol);
-    get_topology(&pdb, &type, &topol, constant_sasa, &argpdb, &arg);
+    /** compute types, topology, SASA and SFE */
+	if (arg.assembly) {
+		/* computed by 'pops_assembly' */
+		ret = POPS_OK;
+	} else if (arg.dual) {
+		/* atomic and, concurrently, coarse-grained */
+		ret = pops_dual(&ctx, &arg, &argpdb, &pdb, &result, &dual);
+	} else if (arg.selection) {
+		/* selected atoms in their environment only */
+		if ((ret = pops_selection(&ctx, &arg, &argpdb, &pdb, &selection)) != POPS_OK) {
+			fprintf(stderr, "Selection: %s\n", pops_strerror(ret));
+			exit(1);
+		}
+	} else if (arg.interfaceMode) {
+		/* interface residues of a coarse screen in their environment only */
+		if ((ret = pops_interface(&ctx, &arg, &argpdb, &pdb, &interface)) != POPS_OK) {
+			fprintf(stderr, "Interface: %s\n", pops_strerror(ret));
+			exit(1);
+		}
+	} else {
+		ret = pops_compute(&ctx, &arg, &argpdb, &pdb, &pack, &result);
+	}
+	if (ret != POPS_OK) {
+		if (ret == POPS_ERR_TYPE)
+			exit(1);
+		empty_json(&pdb, outputName);
+		if (arg.manifestName) {
+			manifest_record(&manifest, &key, outputName);
+			close_manifest(&manifest, 0);
+		}
+		exit(0);
+	}
 
     /*____________________________________________________________________________*/
-    /** compute SASA: atoms, residues, chains, molecule */
-	if (! arg.silent) fprintf(stdout, "Solvent Accessible Surface Area\n");
-    init_sasa(&pdb, &type, &molSasa, constant_sasa, &arg);
-    compute_sasa(&pdb, &topol, &type, &molSasa, constant_sasa, res_sasa, &arg);
-    
+	/** print SASA, bSASA, SFE and Calpha distances */
+	if (arg.selection)
+		pops_print_selection(&arg, &pdb, &selection);
+	else if (arg.interfaceMode)
+		pops_print_interface(&arg, &pdb, &interface);
+	else if ((ret = pops_print(&ctx, &arg, &argpdb, &pdb, &result)) != POPS_OK) {
+		fprintf(stderr, "Output: %s\n", pops_strerror(ret));
+		exit(1);
+	}
+
+	/** coarse-grained outputs, prefixed 'coarse.' */
+	if (arg.dual) {
+		if (! arg.silent) fprintf(stdout, "Coarse-grained SASA Output:\n");
+		if (dual.ret == POPS_OK)
+			pops_print_dual(&dual);
+		else
+			fprintf(stderr, "Coarse-grained: %s\n", pops_strerror(dual.ret));
+	}
+
     /*____________________________________________________________________________*/
-	/* SASA output, bSASA is buried area */
-	if (arg.jsonOut) {
-		/** print JSON output */
-		if (! arg.silent) fprintf(stdout, "SASA Output:\n");
-		make_resSasaJson(&arg, &pdb, molSasa.resSasa, resSasaJson);
-		print_json(&arg, &pdb, resSasaJson);
-		if (! arg.silent) fprintf(stdout, "bSASA Output:\n");
-		/* disabled, because not validated against PDBe server */
-		/* make_resbSasaJson(&arg, &pdb, molSasa.resSasa, resSasaJsonb);
-		   print_jsonb(&arg, resSasaJsonb); */
-	} else {
-		/** print tabulated output */
-		if (! arg.silent) fprintf(stdout, "SASA Output:\n");
-		print_sasa(&arg, &argpdb, &pdb, &type, &topol, &molSasa, constant_sasa, -1);
-		if (! arg.silent && ! arg.rout) fprintf(stdout, "bSASA Output:\n");
-		if (! arg.rout)
-			print_bsasa(&arg, &argpdb, &pdb, &type, &topol, &molSasa, constant_sasa, -1);
+	/** SASA at several probe radii from the topology of the largest radius */
+	if (arg.nProbe > 1) {
+		if (! arg.silent) fprintf(stdout, "Probe radii\n");
+		if ((ret = pops_probe(&ctx, &arg, &pdb, &result, &probe)) == POPS_OK)
+			pops_print_probe(&arg, &argpdb, &pdb, &probe);
+		else
+			fprintf(stderr, "Probe radii: %s\n", pops_strerror(ret));
 	}
 
     /*____________________________________________________________________________*/
-    /** compute Solvation Free Energy: atoms, residues, chains, molecule */
-	if (! arg.silent) fprintf(stdout, "Solvation Free Energy\n");
-    init_sfe(&pdb, &type, &molSFE, constant_sigma, &arg);
-    compute_sfe(&pdb, &type, &molSasa, &molSFE, constant_sigma, &arg);
-    
+	/** analytical gradients of molecular SASA and SFE */
+	if (arg.gradientOut) {
+		if (! arg.silent) fprintf(stdout, "Gradients\n");
+		if ((ret = pops_gradient(&ctx, &arg, &pdb, &result, &gradient)) == POPS_OK)
+			pops_print_gradient(&arg, &pdb, &result, &gradient);
+		else
+			fprintf(stderr, "Gradients: %s\n", pops_strerror(ret));
+	}
+
     /*____________________________________________________________________________*/
-	/** print Solvation Free Energy */
-	if (! arg.silent && ! argpdb.coarse && ! arg.jsonOut && ! arg.rout)
-		fprintf(stdout, "SFE Output:\n");
-	/* we don't have SFEs for residues yet */
-	if (! argpdb.coarse && ! arg.jsonOut && ! arg.rout)
-		print_sfe(&arg, &argpdb, &pdb, &type, &topol, &molSFE, constant_sigma, -1);
+	/** rigid-body poses of the partner chain against the receptor */
+	if (arg.poseInFileName) {
+		if (! arg.silent) fprintf(stdout, "Poses\n");
+		if ((ret = pops_pose(&ctx, &arg, &pdb, &result, &pose)) == POPS_OK)
+			pops_print_pose(&arg, &pdb, &result, &pose);
+		else
+			fprintf(stderr, "Poses: %s\n", pops_strerror(ret));
+	}
 
     /*____________________________________________________________________________*/
-	/** compute and print Calpha distance matrix between 2 chains*/
-	if (pdb.nChain == 2) {
-		calpha_distances(&arg, &pdb, &topol, res_sasa);
-		print_distMatCA(&arg, &topol);
+	/** alanine or glycine scan from the wild-type topology */
+	if (arg.scan) {
+		if (! arg.silent) fprintf(stdout, "Scan\n");
+		if ((ret = pops_scan(&ctx, &arg, &pdb, &result, &scan)) == POPS_OK)
+			pops_print_scan(&arg, &pdb, &result, &scan);
+		else
+			fprintf(stderr, "Scan: %s\n", pops_strerror(ret));
 	}
 
     /*____________________________________________________________________________*/
-	/** free memory */
-	free_topology(&pdb, &topol);
-	free_sasa(&molSasa);
-	free_sfe(&molSFE);
+	/** POPSCOMP: SASA of isolated chains and SASA buried in chain pairs */
+	if (arg.popscomp) {
+		if (! arg.silent) fprintf(stdout, "POPSCOMP\n");
+		if ((ret = pops_popscomp(&ctx, &arg, &pdb, &result, &comp)) == POPS_OK)
+			ret = pops_print_popscomp(&ctx, &arg, &argpdb, &pdb, &result, &comp);
+		if (ret != POPS_OK)
+			fprintf(stderr, "POPSCOMP: %s\n", pops_strerror(ret));
+	}
+
+	/** record output as current */
+	if (arg.manifestName) {
+		manifest_record(&manifest, &key, manifest_output(outputName, &arg, &pdb));
+		close_manifest(&manifest, 0);
+	}
 
     /*____________________________________________________________________________*/
 	/** GROMOS trajectory */
@@ -198,6 +323,10 @@ int main(int argc, char *argv[])
 			fprintf(stdout, "SASA Output of trajectory frames: %s.*.out\n\t",
 				arg.sasatrajOutFileName);
 
+		/* frames with few moved atoms are updated from the previous frame */
+		if (arg.incremental)
+			pops_init_update(&arg, &pdb, &result, &update);
+
 		for (i = 0; i < traj.nFrame; ++ i) {
 			if (! arg.silent) {
 				(((i+1) % 50) != 0) ? fprintf(stdout, ".") : fprintf(stdout, "%d\n\t", (i + 1));
@@ -205,34 +334,37 @@ int main(int argc, char *argv[])
 			}
 			assert(traj.frame[i].nAtom == pdb.nAllAtom);
 			copy_coordinates(&pdb, &traj, i);
-			/* topology */
-			init_topology(&arg, &pdb, &topol);
-			get_topology(&pdb, &type, &topol, constant_sasa, &argpdb, &arg);
-			/* SASA */
-			init_sasa(&pdb, &type, &molSasa, constant_sasa, &arg);
-			compute_sasa(&pdb, &topol, &type, &molSasa, constant_sasa, res_sasa, &arg);
-			print_sasa(&arg, &argpdb, &pdb, &type, &topol, &molSasa, constant_sasa, i);
-			/* SFE */
-			init_sfe(&pdb, &type, &molSFE, constant_sigma, &arg);
-			compute_sfe(&pdb, &type, &molSasa, &molSFE, constant_sigma, &arg);
-			/*print_sfe(&arg, &argpdb, &pdb, &type, &topol, &molSFE, constant_sigma, i);*/
-			/* free memory */
-			free_topology(&pdb, &topol);
-			free_sasa(&molSasa);
-			free_sfe(&molSFE);
+			if (arg.incremental)
+				ret = pops_update_frame(&ctx, &arg, &argpdb, &pdb, &result, &update);
+			else
+				ret = pops_compute_frame(&ctx, &arg, &argpdb, &pdb, &result);
+			if (ret != POPS_OK) {
+				empty_json(&pdb, outputName);
+				exit(0);
+			}
+			if (print_sasa(&arg, &argpdb, &pdb, &(result.type), &(result.topol), &(result.molSasa), ctx.constant_sasa, i) != POPS_OK)
+				Error("Output not writable");
+			/*print_sfe(&arg, &argpdb, &pdb, &(result.type), &(result.topol), &(result.molSFE), ctx.constant_sigma, i);*/
+		}
+
+		if (arg.incremental) {
+			if (! arg.silent)
+				fprintf(stdout, "\n\tFrames updated incrementally: %d, computed anew: %d\n",
+					update.nUpdate, update.nFull);
+			pops_free_update(&update);
 		}
 	}
 
     /*____________________________________________________________________________*/
 	/** free memory */
 	/* structure */
-	free(pdb.atom);
-	free(pdb.resAtom);
-	free(pdb.atomMap);
-	free(pdb.sequence.res);
-	if (arg.pdb) {
-		free(pdb.sequence.name);
+	if (! pack.map) {
+		free(pdb.atom);
+		free(pdb.resAtom);
+		free(pdb.atomMap);
+		free(pdb.sequence.res);
 	}
+	free(pdb.sequence.name);
 
 	/* trajectory */
 	if (arg.trajInFileName) {
@@ -241,19 +373,25 @@ int main(int argc, char *argv[])
 		free(traj.frame);
 	}
 
-	/* type */
-	free(type.atomType);
-	free(type.residueType);
+	/* types, topology, SASA, SFE and parameter hash */
+	pops_free_result(&result);
+	pops_free(&ctx);
+	if (arg.dual)
+		pops_free_dual(&dual);
+	if (arg.selection)
+		pops_free_selection(&selection);
+	if (arg.interfaceMode)
+		pops_free_interface(&interface);
+
+	/* structure pack */
+	free_pack(&pack);
 
-	/* JSON object */
-	cJSON_Delete(resSasaJson);
-	cJSON_Delete(resSasaJsonb);
+	/* XML parser state */
+	xmlCleanupParser();
 
     /*____________________________________________________________________________*/
 	/* terminate */
 	if (! arg.silent) fprintf(stdout, "\nClean termination\n\n");
 
-	status = 0;
-
-    return status;
+    return 0;
 }
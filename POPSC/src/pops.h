@@ -23,29 +23,43 @@ POPS : Parameter OPtimised Surfaces at atomic resolution.
 
 #include "arg.h"
 #include "argpdb.h"
+#include "assembly.h"
 #include "atomgroup.h"
-#include "atomgroup_data.h"
+#include "batch.h"
 #include "cif_reader.h"
 #include "cJSON.h"
+#include "dual.h"
+#include "fit.h"
 #include "fs.h"
 #include "getmmcif.h"
 #include "getpdb.h"
 #include "getpdbml.h"
 #include "gettraj.h"
+#include "gradient.h"
 #include "json.h"
+#include "libpops.h"
+#include "manifest.h"
 #include "matrix.h"
+#include "pack.h"
+#include "popscomp.h"
+#include "pose.h"
+#include "probe.h"
 #include "putsasa.h"
 #include "putbsasa.h"
 #include "putsigma.h"
 #include "putDistMatCA.h"
 #include "safe.h"
+#include "scan.h"
+#include "selection.h"
+#include "interface.h"
+#include "serve.h"
 #include "sasa.h"
 #include "sasa_const.h"
-#include "sasa_data.h"
 #include "sigma.h"
 #include "sigma_const.h"
-#include "sigma_data.h"
 #include "topol.h"
 #include "type.h"
+#include "update.h"
+#include "view.h"
 
 #endif
@@ -0,0 +1,718 @@
+/*==============================================================================
+popscomp.c : complex decomposition into isolated chains and chain pairs
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "popscomp.h"
+#include "putsasa.h"
+
+/*____________________________________________________________________________*/
+/* POPSCOMP derives the SASA buried between the chains of a complex from
+	the topology of the complex, without splitting the structure:
+	- the SASA of an isolated chain results from the intra-chain
+		interactions only; bonds, angles and torsions are intra-chain,
+		the inter-chain non-bonded overlaps are masked;
+	- the SASA of a chain pair adds the overlaps between its two chains;
+		POPS scales the SASA of an atom by a factor per overlap, therefore
+		the SASA of an atom in the pair is its isolated-chain SASA times
+		the product of its factors from the partner chain.
+	Each chain and each chain pair in contact is one work item; the items
+	run on a thread pool and write disjoint atoms and pairs.
+	Copies of a chain, as in homo-oligomers and symmetric assemblies,
+	have the same isolated-chain SASA: a chain with the types, the
+	intra-chain topology and, after superposition, the coordinates of
+	an earlier chain within '--equivRmsd' is not computed but receives
+	the atom SASAs of that chain. */
+
+/* work items: interactions of each chain and each chain pair */
+typedef struct {
+	PopsContext *ctx;
+	Arg *arg;
+	Str *pdb;
+	PopsResult *result;
+	PopsComp *comp;
+	int *interaction; /* interactions, bucketed by item */
+	int *first; /* first interaction of each item */
+	int *count; /* number of interactions of each item */
+	int *order; /* items to compute, most interactions first */
+	int nItem;
+	int nOrder; /* items in 'order' */
+	int next; /* next item in 'order' */
+	int ret; /* first error */
+	pthread_mutex_t lock;
+} CompWork;
+
+/* item and its number of interactions, for sorting */
+typedef struct {
+	int item;
+	int count;
+} CompItem;
+
+/* scratch of one thread */
+typedef struct {
+	CompWork *work;
+	double *factor; /* product of overlap factors per atom */
+	int *mark; /* item that last touched the atom */
+	int *touched; /* atoms touched by the current item */
+} CompThread;
+
+/*____________________________________________________________________________*/
+/** compare integers */
+static int compare_int(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+/*____________________________________________________________________________*/
+/** buried fraction of the isolated-chain SASA of the atoms of a chain pair */
+static void pair_factors(CompThread *ct, int item, ChainPair *pair)
+{
+	CompWork *work = ct->work;
+	View *view = &(work->result->view);
+	unsigned int k;
+	int i, j;
+	int nTouched = 0;
+	double factor_i, factor_j;
+
+	for (k = 0; k < work->count[item]; ++ k) {
+		topol_interaction(&(work->result->topol),
+			work->interaction[work->first[item] + k], &i, &j);
+		if (! overlap_factors(view, &(work->comp->isoSasa),
+				work->ctx->constant_sasa->connect_15_parameter,
+				i, j, work->arg->rProbe, &factor_i, &factor_j))
+			continue;
+		if (ct->mark[i] != item) {
+			ct->mark[i] = item;
+			ct->factor[i] = 1.;
+			ct->touched[nTouched ++] = i;
+		}
+		if (ct->mark[j] != item) {
+			ct->mark[j] = item;
+			ct->factor[j] = 1.;
+			ct->touched[nTouched ++] = j;
+		}
+		ct->factor[i] *= factor_i;
+		ct->factor[j] *= factor_j;
+	}
+
+	qsort(ct->touched, nTouched, sizeof(int), compare_int);
+	for (k = 0; k < nTouched; ++ k) {
+		pair->atom[k] = ct->touched[k];
+		pair->exposed[k] = ct->factor[ct->touched[k]];
+	}
+	pair->nAtom = nTouched;
+}
+
+/*____________________________________________________________________________*/
+/** thread: take items until all are done */
+static void *comp_thread(void *data)
+{
+	CompThread *ct = (CompThread *)data;
+	CompWork *work = ct->work;
+	PopsResult *result = work->result;
+	int item;
+	int ret;
+
+	for (;;) {
+		pthread_mutex_lock(&(work->lock));
+		item = (work->next < work->nOrder) ? work->order[work->next ++] : -1;
+		pthread_mutex_unlock(&(work->lock));
+		if (item < 0)
+			break;
+
+		if (item < work->pdb->nChain) {
+			/* isolated chain: writes only the atoms of this chain */
+			if ((ret = compute_sasa_subset(work->pdb, &(result->view), &(result->topol),
+					&(result->type), &(work->comp->isoSasa), work->ctx->constant_sasa,
+					work->arg, &(work->interaction[work->first[item]]),
+					work->count[item])) != POPS_OK) {
+				pthread_mutex_lock(&(work->lock));
+				if (work->ret == POPS_OK)
+					work->ret = ret;
+				pthread_mutex_unlock(&(work->lock));
+			}
+		} else {
+			pair_factors(ct, item, &(work->comp->pair[item - work->pdb->nChain]));
+		}
+	}
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** RMSD of the 'n' atoms from 'a' and from 'b' after optimal superposition;
+	largest eigenvalue of the quaternion key matrix by Newton iteration
+	on its characteristic polynomial (Theobald, Acta Cryst. A61, 2005) */
+static double superposition_rmsd(View *view, int a, int b, int n)
+{
+	unsigned int i, m;
+	double ca[3] = {0., 0., 0.};
+	double cb[3] = {0., 0., 0.};
+	double pa[3], pb[3];
+	double S[3][3];
+	double K[4][4];
+	double G = 0.;
+	double c0, c1, c2;
+	double lambda, lambda2, p, dp;
+	double det3;
+
+	if (n < 1)
+		return 0.;
+
+	/* centroids */
+	for (i = 0; i < n; ++ i) {
+		ca[0] += view->x[a + i]; ca[1] += view->y[a + i]; ca[2] += view->z[a + i];
+		cb[0] += view->x[b + i]; cb[1] += view->y[b + i]; cb[2] += view->z[b + i];
+	}
+	for (m = 0; m < 3; ++ m) {
+		ca[m] /= n;
+		cb[m] /= n;
+	}
+
+	/* correlation matrix and inner products of the centred coordinates */
+	memset(S, 0, sizeof(S));
+	for (i = 0; i < n; ++ i) {
+		pa[0] = view->x[a + i] - ca[0]; pa[1] = view->y[a + i] - ca[1]; pa[2] = view->z[a + i] - ca[2];
+		pb[0] = view->x[b + i] - cb[0]; pb[1] = view->y[b + i] - cb[1]; pb[2] = view->z[b + i] - cb[2];
+		for (m = 0; m < 3; ++ m) {
+			S[m][0] += pa[m] * pb[0];
+			S[m][1] += pa[m] * pb[1];
+			S[m][2] += pa[m] * pb[2];
+			G += pa[m] * pa[m] + pb[m] * pb[m];
+		}
+	}
+
+	/* key matrix */
+	K[0][0] = S[0][0] + S[1][1] + S[2][2];
+	K[1][1] = S[0][0] - S[1][1] - S[2][2];
+	K[2][2] = - S[0][0] + S[1][1] - S[2][2];
+	K[3][3] = - S[0][0] - S[1][1] + S[2][2];
+	K[0][1] = K[1][0] = S[1][2] - S[2][1];
+	K[0][2] = K[2][0] = S[2][0] - S[0][2];
+	K[0][3] = K[3][0] = S[0][1] - S[1][0];
+	K[1][2] = K[2][1] = S[0][1] + S[1][0];
+	K[1][3] = K[3][1] = S[2][0] + S[0][2];
+	K[2][3] = K[3][2] = S[1][2] + S[2][1];
+
+	/* characteristic polynomial lambda^4 + c2 lambda^2 + c1 lambda + c0 */
+	c2 = 0.;
+	for (i = 0; i < 3; ++ i)
+		for (m = 0; m < 3; ++ m)
+			c2 += S[i][m] * S[i][m];
+	c2 *= -2.;
+	det3 = S[0][0] * (S[1][1] * S[2][2] - S[1][2] * S[2][1])
+		- S[0][1] * (S[1][0] * S[2][2] - S[1][2] * S[2][0])
+		+ S[0][2] * (S[1][0] * S[2][1] - S[1][1] * S[2][0]);
+	c1 = -8. * det3;
+	c0 = (K[0][0] * K[1][1] - K[0][1] * K[1][0]) * (K[2][2] * K[3][3] - K[2][3] * K[3][2])
+		- (K[0][0] * K[1][2] - K[0][2] * K[1][0]) * (K[2][1] * K[3][3] - K[2][3] * K[3][1])
+		+ (K[0][0] * K[1][3] - K[0][3] * K[1][0]) * (K[2][1] * K[3][2] - K[2][2] * K[3][1])
+		+ (K[0][1] * K[1][2] - K[0][2] * K[1][1]) * (K[2][0] * K[3][3] - K[2][3] * K[3][0])
+		- (K[0][1] * K[1][3] - K[0][3] * K[1][1]) * (K[2][0] * K[3][2] - K[2][2] * K[3][0])
+		+ (K[0][2] * K[1][3] - K[0][3] * K[1][2]) * (K[2][0] * K[3][1] - K[2][1] * K[3][0]);
+
+	/* the largest eigenvalue is at most G/2 */
+	lambda = G / 2.;
+	for (i = 0; i < 50; ++ i) {
+		lambda2 = lambda * lambda;
+		p = lambda2 * lambda2 + c2 * lambda2 + c1 * lambda + c0;
+		dp = 4. * lambda2 * lambda + 2. * c2 * lambda + c1;
+		if (dp == 0.)
+			break;
+		lambda -= p / dp;
+		if (fabs(p / dp) < 1.e-11 * fabs(lambda))
+			break;
+	}
+
+	return ((G - 2. * lambda) > 0.) ? sqrt((G - 2. * lambda) / n) : 0.;
+}
+
+/*____________________________________________________________________________*/
+/** 1 if chain 'b' is a copy of chain 'a': same types, same intra-chain
+	interactions relative to the first chain atom and superposition RMSD
+	within 'rmsd' */
+static int equivalent_chain(CompWork *work, int *chainFirst, int *chainSize, \
+	int a, int b, float rmsd)
+{
+	View *view = &(work->result->view);
+	Type *type = &(work->result->type);
+	unsigned int k;
+	int ia, ja, ib, jb;
+	int fa = chainFirst[a];
+	int fb = chainFirst[b];
+
+	if ((chainSize[a] != chainSize[b]) || (work->count[a] != work->count[b]))
+		return 0;
+
+	for (k = 0; k < chainSize[a]; ++ k)
+		if ((type->atomType[fa + k] != type->atomType[fb + k]) ||
+			(type->residueType[fa + k] != type->residueType[fb + k]))
+			return 0;
+
+	for (k = 0; k < work->count[a]; ++ k) {
+		if (topol_interaction(&(work->result->topol), work->interaction[work->first[a] + k], &ia, &ja) !=
+			topol_interaction(&(work->result->topol), work->interaction[work->first[b] + k], &ib, &jb))
+			return 0;
+		if ((ia - fa != ib - fb) || (ja - fa != jb - fb))
+			return 0;
+	}
+
+	return (superposition_rmsd(view, fa, fb, chainSize[a]) <= rmsd);
+}
+
+/*____________________________________________________________________________*/
+/** class of each chain: index of the first equivalent chain */
+static int chain_classes(CompWork *work, int *chainFirst, int *chainSize, \
+	float rmsd, int *chainClass)
+{
+	Type *type = &(work->result->type);
+	int nChain = work->pdb->nChain;
+	uint32_t *fingerprint = 0;
+	int c, r;
+	int nClass = 0;
+
+	/* fingerprint: types of the atoms and number of interactions */
+	fingerprint = safe_malloc(nChain * sizeof(uint32_t));
+	for (c = 0; c < nChain; ++ c) {
+		fingerprint[c] = crc32(crc32(0L, Z_NULL, 0),
+			(const Bytef *)&(type->residueType[chainFirst[c]]), chainSize[c] * sizeof(int));
+		fingerprint[c] = crc32(fingerprint[c],
+			(const Bytef *)&(type->atomType[chainFirst[c]]), chainSize[c] * sizeof(int));
+		fingerprint[c] = crc32(fingerprint[c],
+			(const Bytef *)&(work->count[c]), sizeof(int));
+	}
+
+	for (c = 0; c < nChain; ++ c) {
+		chainClass[c] = c;
+		if (rmsd > 0.) {
+			for (r = 0; r < c; ++ r) {
+				if ((chainClass[r] == r) && (fingerprint[r] == fingerprint[c]) &&
+					equivalent_chain(work, chainFirst, chainSize, r, c, rmsd)) {
+					chainClass[c] = r;
+					break;
+				}
+			}
+		}
+		if (chainClass[c] == c)
+			++ nClass;
+	}
+
+	free(fingerprint);
+
+	return nClass;
+}
+
+/*____________________________________________________________________________*/
+/** compare items by number of interactions, descending */
+static int compare_item(const void *a, const void *b)
+{
+	return ((const CompItem *)b)->count - ((const CompItem *)a)->count;
+}
+
+/*____________________________________________________________________________*/
+/** SASA of the isolated chains and SASA buried in each chain pair
+	of the structure of the last 'pops_compute' call on 'result' */
+int pops_popscomp(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsComp *comp)
+{
+	Topol *topol = &(result->topol);
+	View *view = &(result->view);
+	Arena *arena = &(result->arena);
+	CompWork work;
+	CompItem *sortItem = 0;
+	CompThread *ct = 0;
+	pthread_t *thread = 0;
+	ChainPair *pair = 0;
+	int *pairIndex = 0; /* pair index of chain pairs, -1 if not in contact */
+	int *item = 0; /* item of each interaction */
+	int *chainFirst = 0; /* first atom of each chain */
+	int *chainSize = 0; /* number of atoms of each chain */
+	int nChain = pdb->nChain;
+	int nInteraction = topol->nBond + topol->nAngle + topol->nTorsion + topol->nNonBonded;
+	int nThread;
+	unsigned int i, k;
+	int a, b, c;
+	int ci, cj;
+
+	memset(&work, 0, sizeof(CompWork));
+	work.ctx = ctx;
+	work.arg = arg;
+	work.pdb = pdb;
+	work.result = result;
+	work.comp = comp;
+	comp->nPair = 0;
+
+	/*____________________________________________________________________________*/
+	/* item of each interaction: its chain or its chain pair */
+	pairIndex = arena_alloc(arena, nChain * nChain * sizeof(int));
+	for (i = 0; i < nChain * nChain; ++ i)
+		pairIndex[i] = -1;
+	item = arena_alloc(arena, (nInteraction + 1) * sizeof(int));
+
+	for (k = 0; k < nInteraction; ++ k) {
+		topol_interaction(topol, k, &a, &b);
+		ci = view->chainIndex[a];
+		cj = view->chainIndex[b];
+		if (ci == cj) {
+			item[k] = ci;
+		} else {
+			c = (ci < cj) ? (ci * nChain + cj) : (cj * nChain + ci);
+			if (pairIndex[c] < 0)
+				pairIndex[c] = comp->nPair ++;
+			item[k] = nChain + pairIndex[c];
+		}
+	}
+
+	/*____________________________________________________________________________*/
+	/* bucket the interactions by item, keeping their order within an item */
+	work.nItem = nChain + comp->nPair;
+	work.first = arena_alloc(arena, work.nItem * sizeof(int));
+	work.count = arena_alloc(arena, work.nItem * sizeof(int));
+	work.order = arena_alloc(arena, work.nItem * sizeof(int));
+	work.interaction = arena_alloc(arena, (nInteraction + 1) * sizeof(int));
+	memset(work.count, 0, work.nItem * sizeof(int));
+	for (k = 0; k < nInteraction; ++ k)
+		++ work.count[item[k]];
+	for (i = 0, k = 0; i < work.nItem; ++ i) {
+		work.first[i] = k;
+		k += work.count[i];
+		work.count[i] = 0;
+	}
+	for (k = 0; k < nInteraction; ++ k)
+		work.interaction[work.first[item[k]] + work.count[item[k]] ++] = k;
+
+	/*____________________________________________________________________________*/
+	/* classes of equivalent chains */
+	chainFirst = arena_alloc(arena, nChain * sizeof(int));
+	chainSize = arena_alloc(arena, nChain * sizeof(int));
+	memset(chainSize, 0, nChain * sizeof(int));
+	for (i = pdb->nAtom; i > 0; -- i) {
+		chainFirst[view->chainIndex[i - 1]] = i - 1;
+		++ chainSize[view->chainIndex[i - 1]];
+	}
+	comp->chainClass = arena_alloc(arena, nChain * sizeof(int));
+	comp->nClass = chain_classes(&work, chainFirst, chainSize, arg->equivRmsd, comp->chainClass);
+
+	/* one chain per class and all pairs, largest items first */
+	sortItem = arena_alloc(arena, work.nItem * sizeof(CompItem));
+	for (i = 0, work.nOrder = 0; i < work.nItem; ++ i) {
+		if ((i < nChain) && (comp->chainClass[i] != i))
+			continue;
+		sortItem[work.nOrder].item = i;
+		sortItem[work.nOrder ++].count = work.count[i];
+	}
+	qsort(sortItem, work.nOrder, sizeof(CompItem), compare_item);
+	for (i = 0; i < work.nOrder; ++ i)
+		work.order[i] = sortItem[i].item;
+
+	/*____________________________________________________________________________*/
+	/* chain pairs: atoms of a pair are bounded by twice its overlaps */
+	comp->pair = pair = arena_alloc(arena, (comp->nPair + 1) * sizeof(ChainPair));
+	for (c = 0; c < nChain * nChain; ++ c) {
+		if (pairIndex[c] < 0)
+			continue;
+		i = pairIndex[c];
+		pair[i].chain[0] = c / nChain;
+		pair[i].chain[1] = c % nChain;
+		pair[i].nAtom = 0;
+		pair[i].atom = arena_alloc(arena, 2 * work.count[nChain + i] * sizeof(int));
+		pair[i].exposed = arena_alloc(arena, 2 * work.count[nChain + i] * sizeof(double));
+	}
+
+	/*____________________________________________________________________________*/
+	/* isolated chains and chain pairs on a thread pool */
+	init_sasa(pdb, view, &(comp->isoSasa), arg, arena);
+
+	nThread = (arg->nThread > 0) ? arg->nThread : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThread > work.nOrder)
+		nThread = work.nOrder;
+	if (nThread < 1)
+		nThread = 1;
+
+	/* scratch memory is allocated before the threads start:
+		the arena is not shared between threads */
+	ct = arena_alloc(arena, nThread * sizeof(CompThread));
+	for (i = 0; i < nThread; ++ i) {
+		ct[i].work = &work;
+		ct[i].factor = arena_alloc(arena, pdb->nAtom * sizeof(double));
+		ct[i].mark = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		ct[i].touched = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		for (k = 0; k < pdb->nAtom; ++ k)
+			ct[i].mark[k] = -1;
+	}
+
+	work.ret = POPS_OK;
+	pthread_mutex_init(&(work.lock), 0);
+	if (nThread == 1) {
+		comp_thread(&(ct[0]));
+	} else {
+		thread = safe_malloc(nThread * sizeof(pthread_t));
+		for (i = 0; i < nThread; ++ i)
+			pthread_create(&(thread[i]), 0, comp_thread, &(ct[i]));
+		for (i = 0; i < nThread; ++ i)
+			pthread_join(thread[i], 0);
+		free(thread);
+	}
+	pthread_mutex_destroy(&(work.lock));
+
+	if (work.ret != POPS_OK)
+		return work.ret;
+
+	/* copies of a chain receive the atom SASAs of their class */
+	for (c = 0; c < nChain; ++ c)
+		if (comp->chainClass[c] != c)
+			memcpy(&(comp->isoSasa.atomSasa[chainFirst[c]]),
+				&(comp->isoSasa.atomSasa[chainFirst[comp->chainClass[c]]]),
+				chainSize[c] * sizeof(AtomSasa));
+
+	/*____________________________________________________________________________*/
+	/* residue, chain and molecule SASA of the isolated chains */
+	compute_res_chain_mol_sasa(pdb, view, &(result->type), &(comp->isoSasa), ctx->res_sasa);
+
+	/* SASA buried in each pair */
+	for (i = 0; i < comp->nPair; ++ i) {
+		pair[i].phobicbSasa = pair[i].philicbSasa = pair[i].bSasa = 0.;
+		for (k = 0; k < pair[i].nAtom; ++ k) {
+			a = pair[i].atom[k];
+			if (view->polarity[a] == 0)
+				pair[i].phobicbSasa += comp->isoSasa.atomSasa[a].sasa * (1. - pair[i].exposed[k]);
+			else
+				pair[i].philicbSasa += comp->isoSasa.atomSasa[a].sasa * (1. - pair[i].exposed[k]);
+		}
+		pair[i].bSasa = pair[i].phobicbSasa + pair[i].philicbSasa;
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** chain identifier of chain 'c', '-' for an empty identifier */
+static char *chain_id(Str *pdb, MolSasa *molSasa, int c)
+{
+	char *chainIdentifier = pdb->atom[molSasa->chainSasa[c].first].chainIdentifier;
+
+	/* for compatibility with POPSR Shiny, as in 'putsasa.c' */
+	if (strcmp(chainIdentifier, " ") == 0)
+		strcpy(chainIdentifier, "-");
+
+	return chainIdentifier;
+}
+
+/*____________________________________________________________________________*/
+/** open table of SASA differences; NULL if the name is too long or the
+	file is not writable */
+static FILE *open_delta(Arg *arg, char *level)
+{
+	char deltaOutFileName[1024];
+
+	if (snprintf(deltaOutFileName, sizeof(deltaOutFileName), "%s/deltaSASA.%s",
+			arg->outDirName, level) >= sizeof(deltaOutFileName)) {
+		fprintf(stderr, "Error: Output file name too long: '%s/deltaSASA.%s'\n",
+			arg->outDirName, level);
+		return NULL;
+	}
+
+	return safe_open_noexit(deltaOutFileName, "w");
+}
+
+/*____________________________________________________________________________*/
+/** print atom SASA buried in each chain pair */
+static void print_atom_delta(FILE *deltaOutFile, Str *pdb, PopsComp *comp)
+{
+	ChainPair *pair = 0;
+	unsigned int i, k;
+	int a;
+
+	fprintf(deltaOutFile, "Pair\tAtomNr\tAtomNe\tResidNe\tChain\tResidNr\tiCode\tD_SASA/A^2\tAtomTp\tAtomGp\n");
+
+	for (i = 0; i < comp->nPair; ++ i) {
+		pair = &(comp->pair[i]);
+		for (k = 0; k < pair->nAtom; ++ k) {
+			a = pair->atom[k];
+			fprintf(deltaOutFile, "%s-%s\t%8d\t%3s\t%3s\t%1s\t%6d\t%1s\t%10.2f\t%2d\t%2d\n",
+				chain_id(pdb, &(comp->isoSasa), pair->chain[0]),
+				chain_id(pdb, &(comp->isoSasa), pair->chain[1]),
+				pdb->atom[a].atomNumber,
+				pdb->atom[a].atomName,
+				pdb->atom[a].residueName,
+				pdb->atom[a].chainIdentifier,
+				pdb->atom[a].residueNumber,
+				pdb->atom[a].icode,
+				comp->isoSasa.atomSasa[a].sasa * (1. - pair->exposed[k]),
+				pdb->atom[a].atomType,
+				pdb->atom[a].groupID);
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** print residue SASA buried in each chain pair */
+static void print_residue_delta(FILE *deltaOutFile, Str *pdb, View *view, PopsComp *comp)
+{
+	ChainPair *pair = 0;
+	unsigned int i, k;
+	int a, r;
+	double bSasa;
+	double phobicbSasa = 0.;
+	double philicbSasa = 0.;
+
+	fprintf(deltaOutFile, "Pair\tResidNe\tChain\tResidNr\tiCode\tD_Phob/A^2\tD_Phil/A^2\tD_SASA/A^2\n");
+
+	for (i = 0; i < comp->nPair; ++ i) {
+		pair = &(comp->pair[i]);
+		for (k = 0; k < pair->nAtom; ++ k) {
+			a = pair->atom[k];
+			bSasa = comp->isoSasa.atomSasa[a].sasa * (1. - pair->exposed[k]);
+			if (view->polarity[a] == 0)
+				phobicbSasa += bSasa;
+			else
+				philicbSasa += bSasa;
+
+			/* atoms are in ascending order: print after the last atom of a residue */
+			if ((k + 1 < pair->nAtom) &&
+				(view->residueIndex[pair->atom[k + 1]] == view->residueIndex[a]))
+				continue;
+
+			r = comp->isoSasa.resSasa[view->residueIndex[a]].atomRef;
+			fprintf(deltaOutFile, "%s-%s\t%8s\t%3s\t%8d\t%1s\t%10.2f\t%10.2f\t%10.2f\n",
+				chain_id(pdb, &(comp->isoSasa), pair->chain[0]),
+				chain_id(pdb, &(comp->isoSasa), pair->chain[1]),
+				pdb->atom[r].residueName,
+				pdb->atom[r].chainIdentifier,
+				pdb->atom[r].residueNumber,
+				pdb->atom[r].icode,
+				phobicbSasa,
+				philicbSasa,
+				phobicbSasa + philicbSasa);
+			phobicbSasa = philicbSasa = 0.;
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** print chain SASA buried in each chain pair */
+static void print_chain_delta(FILE *deltaOutFile, Str *pdb, View *view, PopsComp *comp)
+{
+	ChainSasa *chainSasa = 0;
+	ChainPair *pair = 0;
+	unsigned int i, k, m;
+	int a;
+	double bSasa;
+	double phobicbSasa, philicbSasa;
+
+	fprintf(deltaOutFile, "Pair\tChain\tId\tAtomRange\tResidRange\tD_Phob/A^2\tD_Phil/A^2\tD_SASA/A^2\n");
+
+	for (i = 0; i < comp->nPair; ++ i) {
+		pair = &(comp->pair[i]);
+		for (m = 0; m < 2; ++ m) {
+			phobicbSasa = philicbSasa = 0.;
+			for (k = 0; k < pair->nAtom; ++ k) {
+				a = pair->atom[k];
+				if (view->chainIndex[a] != pair->chain[m])
+					continue;
+				bSasa = comp->isoSasa.atomSasa[a].sasa * (1. - pair->exposed[k]);
+				if (view->polarity[a] == 0)
+					phobicbSasa += bSasa;
+				else
+					philicbSasa += bSasa;
+			}
+
+			chainSasa = &(comp->isoSasa.chainSasa[pair->chain[m]]);
+			fprintf(deltaOutFile, "%s-%s\t%3d\t%3s\t%6d->%-6d\t%5d->%-5d\t%10.2f\t%10.2f\t%10.2f\n",
+				chain_id(pdb, &(comp->isoSasa), pair->chain[0]),
+				chain_id(pdb, &(comp->isoSasa), pair->chain[1]),
+				pair->chain[m],
+				chain_id(pdb, &(comp->isoSasa), pair->chain[m]),
+				pdb->atom[chainSasa->first].atomNumber,
+				pdb->atom[chainSasa->last].atomNumber,
+				pdb->atom[chainSasa->first].residueNumber,
+				pdb->atom[chainSasa->last].residueNumber,
+				phobicbSasa,
+				philicbSasa,
+				phobicbSasa + philicbSasa);
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** print molecule SASA buried in each chain pair */
+static void print_mol_delta(FILE *deltaOutFile, Str *pdb, PopsComp *comp)
+{
+	unsigned int i;
+
+	fprintf(deltaOutFile, "Pair\tD_Phob/A^2\tD_Phil/A^2\tD_SASA/A^2\n");
+
+	for (i = 0; i < comp->nPair; ++ i)
+		fprintf(deltaOutFile, "%s-%s\t%10.2f\t%10.2f\t%10.2f\n",
+			chain_id(pdb, &(comp->isoSasa), comp->pair[i].chain[0]),
+			chain_id(pdb, &(comp->isoSasa), comp->pair[i].chain[1]),
+			comp->pair[i].phobicbSasa,
+			comp->pair[i].philicbSasa,
+			comp->pair[i].bSasa);
+}
+
+/*____________________________________________________________________________*/
+/** print SASA of the isolated chains to 'isoSASA.rpops*' and SASA buried
+	in each chain pair to 'deltaSASA.rpops*' in the output directory;
+	the levels follow the '--atomOut', '--residueOut', '--chainOut'
+	and '--noTotalOut' options */
+int pops_print_popscomp(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result, PopsComp *comp)
+{
+	Arg isoArg = *arg;
+	FILE *deltaOutFile = 0;
+	int ret = POPS_OK;
+
+	/* isolated chains: tables as those of '--rout' */
+	isoArg.rout = 1;
+	isoArg.routPrefix = "isoSASA";
+	isoArg.silent = 1;
+	isoArg.compositionOut = isoArg.typeOut = isoArg.topologyOut = 0;
+	isoArg.neighbourOut = isoArg.parameterOut = isoArg.interfaceOut = 0;
+	if (print_sasa(&isoArg, argpdb, pdb, &(result->type), &(result->topol), \
+			&(comp->isoSasa), ctx->constant_sasa, -1) != POPS_OK)
+		return POPS_ERR_OUTPUT;
+
+	/* chain pairs */
+	if (arg->atomOut && ! argpdb->coarse) {
+		if ((deltaOutFile = open_delta(arg, "rpopsAtom"))) {
+			print_atom_delta(deltaOutFile, pdb, comp);
+			fclose(deltaOutFile);
+		} else {
+			ret = POPS_ERR_OUTPUT;
+		}
+	}
+	if (arg->residueOut) {
+		if ((deltaOutFile = open_delta(arg, "rpopsResidue"))) {
+			print_residue_delta(deltaOutFile, pdb, &(result->view), comp);
+			fclose(deltaOutFile);
+		} else {
+			ret = POPS_ERR_OUTPUT;
+		}
+	}
+	if (arg->chainOut) {
+		if ((deltaOutFile = open_delta(arg, "rpopsChain"))) {
+			print_chain_delta(deltaOutFile, pdb, &(result->view), comp);
+			fclose(deltaOutFile);
+		} else {
+			ret = POPS_ERR_OUTPUT;
+		}
+	}
+	if (! arg->noTotalOut) {
+		if ((deltaOutFile = open_delta(arg, "rpopsMolecule"))) {
+			print_mol_delta(deltaOutFile, pdb, comp);
+			fclose(deltaOutFile);
+		} else {
+			ret = POPS_ERR_OUTPUT;
+		}
+	}
+
+	if (! arg->silent)
+		fprintf(stdout, "\tPOPSCOMP: %d chains in %d classes, %d chain pairs in contact: %s/deltaSASA.*\n",
+			pdb->nChain, comp->nClass, comp->nPair, arg->outDirName);
+
+	return ret;
+}
+
@@ -0,0 +1,59 @@
+/*==============================================================================
+popscomp.h : complex decomposition into isolated chains and chain pairs
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef POPSCOMP_H
+#define POPSCOMP_H
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "safe.h"
+#include "sasa.h"
+#include "topol.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* chain pair in contact: atoms buried by the partner chain */
+typedef struct {
+	int chain[2]; /* chain indices, chain[0] < chain[1] */
+	int nAtom; /* atoms with an overlap to the partner chain */
+	int *atom; /* atom indices, ascending */
+	double *exposed; /* fraction of isolated-chain SASA exposed in the pair */
+	double phobicbSasa; /* hydrophobic SASA buried in the pair */
+	double philicbSasa; /* hydrophilic SASA buried in the pair */
+	double bSasa; /* SASA buried in the pair */
+} ChainPair;
+
+/* decomposition of a complex; all arrays are in the arena of the result */
+typedef struct {
+	MolSasa isoSasa; /* SASA of the isolated chains */
+	int nClass; /* classes of equivalent chains */
+	int *chainClass; /* first chain of the class of each chain */
+	int nPair; /* chain pairs in contact */
+	ChainPair *pair;
+} PopsComp;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_popscomp(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsComp *comp);
+int pops_print_popscomp(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result, PopsComp *comp);
+
+#endif
+
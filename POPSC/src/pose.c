@@ -0,0 +1,459 @@
+/*==============================================================================
+pose.c : rigid-body pose rescoring of a partner chain against a receptor
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "pose.h"
+
+/*____________________________________________________________________________*/
+/* A rigid-body pose moves the partner chain as a whole: the interactions
+	within the receptor and within the partner do not change, only the
+	overlaps across the interface do. The SASA of the isolated receptor
+	and partner are computed once from their own interactions; as in
+	POPSCOMP, the SASA of an atom in the complex is its isolated SASA
+	times the product of its overlap factors from the other side.
+	Receptor atoms are binned once on a cell grid; each pose transforms
+	the partner atoms (x' = R x + t) and looks up their receptor
+	neighbours. Poses run on a thread pool, each thread with its own
+	coordinates of the partner. */
+
+/* cell grid of the receptor atoms */
+typedef struct {
+	int nCell[3]; /* grid dimensions */
+	float origin[3]; /* grid origin */
+	float cellSize; /* cell edge length, at least the non-bonded cutoff */
+	int *cellFirst; /* first atom of each cell in 'atom', nCell + 1 */
+	int *atom; /* receptor atoms, bucketed by cell */
+} PoseGrid;
+
+/* work of all threads */
+typedef struct {
+	PopsContext *ctx;
+	Arg *arg;
+	PopsResult *result;
+	PopsPose *pose;
+	MolSasa isoSasa; /* SASA of the isolated receptor and partner */
+	PoseGrid grid;
+	int *partnerAtom; /* atoms of the partner */
+	int nPartnerAtom;
+	int next; /* next pose */
+	pthread_mutex_t lock;
+} PoseWork;
+
+/* scratch of one thread */
+typedef struct {
+	PoseWork *work;
+	View view; /* view with its own coordinates */
+	double *factor; /* product of overlap factors per atom */
+	int *mark; /* pose that last touched the atom */
+	int *touched; /* atoms touched by the current pose */
+} PoseThread;
+
+/*____________________________________________________________________________*/
+/** poses: 12 numbers per line, the rotation matrix row by row and the
+	translation; '#' starts a comment line; '-' reads standard input */
+static int read_poses(char *poseInFileName, PopsPose *pose, Arena *arena)
+{
+	FILE *poseInFile = 0;
+	char line[1024];
+	float (*matrix)[12] = 0;
+	float *m = 0;
+	int allocatedPose = 0;
+	int nPose = 0;
+	int ret = POPS_OK;
+
+	if (strcmp(poseInFileName, "-") == 0)
+		poseInFile = stdin;
+	else
+		poseInFile = safe_open(poseInFileName, "r");
+
+	while (fgets(line, sizeof(line), poseInFile) != 0) {
+		if ((line[0] == '#') || (strspn(line, " \t\r\n") == strlen(line)))
+			continue;
+		if (nPose == allocatedPose) {
+			allocatedPose += 1024;
+			matrix = safe_realloc(matrix, allocatedPose * sizeof(*matrix));
+		}
+		m = matrix[nPose];
+		if (sscanf(line, "%f %f %f %f %f %f %f %f %f %f %f %f",
+				&m[0], &m[1], &m[2], &m[3], &m[4], &m[5],
+				&m[6], &m[7], &m[8], &m[9], &m[10], &m[11]) != 12) {
+			ErrorSpecNoexit("Pose requires 12 numbers", line);
+			ret = POPS_ERR_INPUT;
+			break;
+		}
+		++ nPose;
+	}
+
+	if (poseInFile != stdin)
+		fclose(poseInFile);
+
+	pose->nPose = nPose;
+	pose->matrix = arena_alloc(arena, (nPose + 1) * sizeof(*matrix));
+	if (nPose > 0)
+		memcpy(pose->matrix, matrix, nPose * sizeof(*matrix));
+	free(matrix);
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** grid cell of coordinate 'v' in dimension 'd', may lie outside the grid */
+__inline__ static int pose_cell(PoseGrid *grid, float v, int d)
+{
+	return (int)floor((v - grid->origin[d]) / grid->cellSize);
+}
+
+/*____________________________________________________________________________*/
+/** cell grid of the receptor atoms */
+static void receptor_grid(PoseGrid *grid, View *view, char *inPartner, \
+	float rProbe, Arena *arena)
+{
+	unsigned int i;
+	int d, c, cell;
+	int nReceptor = 0;
+	int nCellTotal;
+	float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+	float maxRadius = 0.;
+	float pos[3];
+	int *count = 0;
+
+	for (i = 0; i < view->nAtom; ++ i) {
+		if (view->radius[i] > maxRadius)
+			maxRadius = view->radius[i];
+		if (inPartner[i])
+			continue;
+		pos[0] = view->x[i]; pos[1] = view->y[i]; pos[2] = view->z[i];
+		for (d = 0; d < 3; ++ d) {
+			if (pos[d] < min[d]) min[d] = pos[d];
+			if (pos[d] > max[d]) max[d] = pos[d];
+		}
+		++ nReceptor;
+	}
+	if (nReceptor == 0) {
+		for (d = 0; d < 3; ++ d)
+			min[d] = max[d] = 0.;
+	}
+
+	/* the cutoff of the largest atom pair, with the margin of 'morton_view' */
+	grid->cellSize = 2. * maxRadius + 2. * rProbe + 0.01;
+	/* limit the number of (mostly empty) cells of sparse structures */
+	do {
+		for (d = 0, nCellTotal = 1; d < 3; ++ d) {
+			grid->origin[d] = min[d];
+			grid->nCell[d] = (int)((max[d] - min[d]) / grid->cellSize) + 1;
+			nCellTotal *= grid->nCell[d];
+		}
+		if (nCellTotal > (8 * nReceptor + 64))
+			grid->cellSize *= 1.25;
+	} while (nCellTotal > (8 * nReceptor + 64));
+
+	/* counting sort of the receptor atoms by cell */
+	grid->cellFirst = arena_alloc(arena, (nCellTotal + 1) * sizeof(int));
+	grid->atom = arena_alloc(arena, (nReceptor + 1) * sizeof(int));
+	count = arena_alloc(arena, nCellTotal * sizeof(int));
+	memset(count, 0, nCellTotal * sizeof(int));
+	for (i = 0; i < view->nAtom; ++ i) {
+		if (inPartner[i])
+			continue;
+		cell = (pose_cell(grid, view->z[i], 2) * grid->nCell[1] + \
+				pose_cell(grid, view->y[i], 1)) * grid->nCell[0] + \
+				pose_cell(grid, view->x[i], 0);
+		++ count[cell];
+	}
+	for (c = 0, grid->cellFirst[0] = 0; c < nCellTotal; ++ c) {
+		grid->cellFirst[c + 1] = grid->cellFirst[c] + count[c];
+		count[c] = 0;
+	}
+	for (i = 0; i < view->nAtom; ++ i) {
+		if (inPartner[i])
+			continue;
+		cell = (pose_cell(grid, view->z[i], 2) * grid->nCell[1] + \
+				pose_cell(grid, view->y[i], 1)) * grid->nCell[0] + \
+				pose_cell(grid, view->x[i], 0);
+		grid->atom[grid->cellFirst[cell] + count[cell] ++] = i;
+	}
+}
+
+/*____________________________________________________________________________*/
+/** overlap factors of partner atom 'a' from the receptor atoms around it */
+static void partner_overlaps(PoseThread *pt, int p, int a, PoseScore *score)
+{
+	PoseWork *work = pt->work;
+	PoseGrid *grid = &(work->grid);
+	View *view = &(pt->view);
+	double factor_r, factor_a;
+	int c[3], cx, cy, cz, cell;
+	int k, r;
+
+	c[0] = pose_cell(grid, view->x[a], 0);
+	c[1] = pose_cell(grid, view->y[a], 1);
+	c[2] = pose_cell(grid, view->z[a], 2);
+
+	for (cz = c[2] - 1; cz <= c[2] + 1; ++ cz) {
+		if (cz < 0 || cz >= grid->nCell[2]) continue;
+		for (cy = c[1] - 1; cy <= c[1] + 1; ++ cy) {
+			if (cy < 0 || cy >= grid->nCell[1]) continue;
+			for (cx = c[0] - 1; cx <= c[0] + 1; ++ cx) {
+				if (cx < 0 || cx >= grid->nCell[0]) continue;
+				cell = (cz * grid->nCell[1] + cy) * grid->nCell[0] + cx;
+
+				for (k = grid->cellFirst[cell]; k < grid->cellFirst[cell + 1]; ++ k) {
+					r = grid->atom[k];
+					if (! overlap_factors(view, &(work->isoSasa),
+							work->ctx->constant_sasa->connect_15_parameter,
+							r, a, work->arg->rProbe, &factor_r, &factor_a))
+						continue;
+					if (view_distance(view, r, a) < .74)
+						++ score->nClash;
+					if (pt->mark[r] != p) {
+						pt->mark[r] = p;
+						pt->factor[r] = 1.;
+						pt->touched[score->nContact ++] = r;
+					}
+					if (pt->mark[a] != p) {
+						pt->mark[a] = p;
+						pt->factor[a] = 1.;
+						pt->touched[score->nContact ++] = a;
+					}
+					pt->factor[r] *= factor_r;
+					pt->factor[a] *= factor_a;
+				}
+			}
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** SASA buried and SFE change of pose 'p' */
+static void score_pose(PoseThread *pt, int p)
+{
+	PoseWork *work = pt->work;
+	View *view = &(work->result->view);
+	Type *type = &(work->result->type);
+	ConstantSigma *constant_sigma = work->ctx->constant_sigma;
+	PoseScore *score = &(work->pose->score[p]);
+	float *m = work->pose->matrix[p];
+	double buried;
+	unsigned int k;
+	int a;
+
+	memset(score, 0, sizeof(PoseScore));
+
+	/* partner coordinates of this pose */
+	for (k = 0; k < work->nPartnerAtom; ++ k) {
+		a = work->partnerAtom[k];
+		pt->view.x[a] = m[0] * view->x[a] + m[1] * view->y[a] + m[2] * view->z[a] + m[9];
+		pt->view.y[a] = m[3] * view->x[a] + m[4] * view->y[a] + m[5] * view->z[a] + m[10];
+		pt->view.z[a] = m[6] * view->x[a] + m[7] * view->y[a] + m[8] * view->z[a] + m[11];
+	}
+
+	for (k = 0; k < work->nPartnerAtom; ++ k)
+		partner_overlaps(pt, p, work->partnerAtom[k], score);
+
+	/* buried SASA of the contact atoms; SFE scaled from A^2 to nm^2 */
+	for (k = 0; k < score->nContact; ++ k) {
+		a = pt->touched[k];
+		buried = work->isoSasa.atomSasa[a].sasa * (1. - pt->factor[a]);
+		if (view->polarity[a] == 0)
+			score->phobicbSasa += buried;
+		else
+			score->philicbSasa += buried;
+		score->sfe_type -= buried / 100 * \
+			constant_sigma->atomDataSigma[type->residueType[a]][type->atomType[a]].sigma_type;
+		score->sfe_group -= buried / 100 * \
+			constant_sigma->atomDataSigma[type->residueType[a]][type->atomType[a]].sigma_group;
+	}
+	score->bSasa = score->phobicbSasa + score->philicbSasa;
+}
+
+/*____________________________________________________________________________*/
+/** thread: take poses until all are done */
+static void *pose_thread(void *data)
+{
+	PoseThread *pt = (PoseThread *)data;
+	PoseWork *work = pt->work;
+	int p;
+
+	for (;;) {
+		pthread_mutex_lock(&(work->lock));
+		p = (work->next < work->pose->nPose) ? work->next ++ : -1;
+		pthread_mutex_unlock(&(work->lock));
+		if (p < 0)
+			break;
+		score_pose(pt, p);
+	}
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** scores of the poses in '--poses' of the partner chain '--poseChain'
+	(default: the last chain) against the other chains of the structure
+	of the last 'pops_compute' call on 'result' */
+int pops_pose(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsPose *pose)
+{
+	Topol *topol = &(result->topol);
+	View *view = &(result->view);
+	Arena *arena = &(result->arena);
+	PoseWork work;
+	PoseThread *pt = 0;
+	pthread_t *thread = 0;
+	char *inPartner = 0; /* atom of the partner chain */
+	char chainId;
+	int *interaction = 0; /* interactions within the receptor or the partner */
+	int nInteraction = topol->nBond + topol->nAngle + topol->nTorsion + topol->nNonBonded;
+	int nIso = 0;
+	int nThread;
+	unsigned int i, k;
+	int a, b;
+	int ret;
+
+	memset(&work, 0, sizeof(PoseWork));
+	work.ctx = ctx;
+	work.arg = arg;
+	work.result = result;
+	work.pose = pose;
+	pose->nPose = 0;
+	pose->receptorSasa = pose->partnerSasa = 0.;
+
+	if (pdb->nAtom == 0)
+		return POPS_ERR_INPUT;
+	if ((ret = read_poses(arg->poseInFileName, pose, arena)) != POPS_OK)
+		return ret;
+
+	/*____________________________________________________________________________*/
+	/* partner atoms: chain identifier '--poseChain' ('-' for blank)
+		or that of the last atom */
+	if (arg->poseChain)
+		chainId = (arg->poseChain[0] == '-') ? ' ' : arg->poseChain[0];
+	else
+		chainId = view->chainId[pdb->nAtom - 1];
+	inPartner = arena_alloc(arena, pdb->nAtom * sizeof(char));
+	work.partnerAtom = arena_alloc(arena, pdb->nAtom * sizeof(int));
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		inPartner[i] = (view->chainId[i] == chainId);
+		if (inPartner[i])
+			work.partnerAtom[work.nPartnerAtom ++] = i;
+	}
+	if (work.nPartnerAtom == 0)
+		return POPS_ERR_INPUT;
+	pose->partnerChain = view->chainIndex[work.partnerAtom[0]];
+
+	/*____________________________________________________________________________*/
+	/* SASA of the isolated receptor and partner: interactions across the
+		interface are masked, bonded interactions are within chains */
+	interaction = arena_alloc(arena, (nInteraction + 1) * sizeof(int));
+	for (k = 0; k < nInteraction; ++ k) {
+		topol_interaction(topol, k, &a, &b);
+		if (inPartner[a] == inPartner[b])
+			interaction[nIso ++] = k;
+	}
+	init_sasa(pdb, view, &(work.isoSasa), arg, arena);
+	if ((ret = compute_sasa_subset(pdb, view, topol, &(result->type), &(work.isoSasa),
+			ctx->constant_sasa, arg, interaction, nIso)) != POPS_OK)
+		return ret;
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		if (inPartner[i])
+			pose->partnerSasa += work.isoSasa.atomSasa[i].sasa;
+		else
+			pose->receptorSasa += work.isoSasa.atomSasa[i].sasa;
+	}
+
+	receptor_grid(&(work.grid), view, inPartner, arg->rProbe, arena);
+
+	/*____________________________________________________________________________*/
+	/* poses on a thread pool */
+	pose->score = arena_alloc(arena, (pose->nPose + 1) * sizeof(PoseScore));
+
+	nThread = (arg->nThread > 0) ? arg->nThread : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThread > pose->nPose)
+		nThread = pose->nPose;
+	if (nThread < 1)
+		nThread = 1;
+
+	/* scratch memory is allocated before the threads start:
+		the arena is not shared between threads */
+	pt = arena_alloc(arena, nThread * sizeof(PoseThread));
+	for (i = 0; i < nThread; ++ i) {
+		pt[i].work = &work;
+		pt[i].view = *view;
+		pt[i].view.x = arena_alloc(arena, pdb->nAtom * sizeof(float));
+		pt[i].view.y = arena_alloc(arena, pdb->nAtom * sizeof(float));
+		pt[i].view.z = arena_alloc(arena, pdb->nAtom * sizeof(float));
+		memcpy(pt[i].view.x, view->x, pdb->nAtom * sizeof(float));
+		memcpy(pt[i].view.y, view->y, pdb->nAtom * sizeof(float));
+		memcpy(pt[i].view.z, view->z, pdb->nAtom * sizeof(float));
+		pt[i].factor = arena_alloc(arena, pdb->nAtom * sizeof(double));
+		pt[i].mark = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		pt[i].touched = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		for (k = 0; k < pdb->nAtom; ++ k)
+			pt[i].mark[k] = -1;
+	}
+
+	pthread_mutex_init(&(work.lock), 0);
+	if (nThread == 1) {
+		pose_thread(&(pt[0]));
+	} else {
+		thread = safe_malloc(nThread * sizeof(pthread_t));
+		for (i = 0; i < nThread; ++ i)
+			pthread_create(&(thread[i]), 0, pose_thread, &(pt[i]));
+		for (i = 0; i < nThread; ++ i)
+			pthread_join(thread[i], 0);
+		free(thread);
+	}
+	pthread_mutex_destroy(&(work.lock));
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** print the score of each pose: '--popsposeOut' or,
+	with '--rout', '<routPrefix>.rpopsPose' in the output directory */
+int pops_print_pose(Arg *arg, Str *pdb, PopsResult *result, PopsPose *pose)
+{
+	char poseOutFileName[1024];
+	unsigned int i;
+	PoseScore *score = 0;
+
+	if (arg->rout)
+		snprintf(poseOutFileName, sizeof(poseOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, "rpopsPose");
+	else
+		snprintf(poseOutFileName, sizeof(poseOutFileName), "%s", arg->poseOutFileName);
+
+	if (! arg->silent)
+		fprintf(stdout, "\t%d poses: %s\n", pose->nPose, poseOutFileName);
+
+	arg->poseOutFile = safe_open(poseOutFileName, "w");
+
+	if (! arg->noHeaderOut && ! arg->rout)
+		fprintf(arg->poseOutFile, "\n=== POSE SCORES: BURIED SASA AND SFE CHANGE ON BINDING ===\n"
+			"Receptor SASA/A^2: %.2f\nPartner SASA/A^2: %.2f\n\n",
+			pose->receptorSasa, pose->partnerSasa);
+	if (! arg->noHeaderOut || arg->rout)
+		fprintf(arg->poseOutFile, "Pose\tN(cont)\tN(clash)"
+			"\tbPhob/A^2\tbPhil/A^2\tbSASA/A^2\tdSFEt/(kJ/mol)\tdSFEg/(kJ/mol)\n");
+
+	for (i = 0; i < pose->nPose; ++ i) {
+		score = &(pose->score[i]);
+		fprintf(arg->poseOutFile, "%8d\t%6d\t%6d\t%10.2f\t%10.2f\t%10.2f\t%10.2f\t%10.2f\n",
+			i + 1,
+			score->nContact,
+			score->nClash,
+			score->phobicbSasa,
+			score->philicbSasa,
+			score->bSasa,
+			score->sfe_type,
+			score->sfe_group);
+	}
+
+	fclose(arg->poseOutFile);
+
+	return POPS_OK;
+}
+
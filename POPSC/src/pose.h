@@ -0,0 +1,56 @@
+/*==============================================================================
+pose.h : rigid-body pose rescoring of a partner chain against a receptor
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef POSE_H
+#define POSE_H
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "error.h"
+#include "libpops.h"
+#include "safe.h"
+#include "sasa.h"
+#include "sigma.h"
+#include "topol.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* interface of one pose */
+typedef struct {
+	int nContact; /* atoms with an overlap across the interface */
+	int nClash; /* atom pairs closer than 0.74 A across the interface */
+	double phobicbSasa; /* hydrophobic SASA buried in the interface */
+	double philicbSasa; /* hydrophilic SASA buried in the interface */
+	double bSasa; /* SASA buried in the interface */
+	double sfe_type; /* SFE change on binding, atom type sigmas */
+	double sfe_group; /* SFE change on binding, atom group sigmas */
+} PoseScore;
+
+/* poses of the partner chain; arrays are in the arena of the result */
+typedef struct {
+	int partnerChain; /* chain index of the partner */
+	int nPose;
+	float (*matrix)[12]; /* rotation (row-major) and translation of each pose */
+	PoseScore *score;
+	double receptorSasa; /* SASA of the isolated receptor */
+	double partnerSasa; /* SASA of the isolated partner */
+} PopsPose;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_pose(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsPose *pose);
+int pops_print_pose(Arg *arg, Str *pdb, PopsResult *result, PopsPose *pose);
+
+#endif
+
@@ -0,0 +1,186 @@
+/*==============================================================================
+probe.c : SASA at several probe radii
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "probe.h"
+
+/*____________________________________________________________________________*/
+/* The neighbour list of 'pops_compute' is built once for the largest probe
+	radius. An atom pair overlaps at a smaller radius only if it overlaps
+	at the largest radius, therefore the SASA of each radius follows from
+	the shared list: 'mod_atom_sasa' skips the pairs beyond the cutoff of
+	that radius, and the remaining pairs are processed in the same order as
+	in a run with that radius alone. */
+
+/*____________________________________________________________________________*/
+/** SASA at each probe radius of 'arg' from the topology of 'result';
+	the SASA of 'rProbe', the first radius, is that of 'result' */
+int pops_probe(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsProbe *probe)
+{
+	int i, ret;
+	Arg probeArg = *arg;
+
+	probe->nProbe = arg->nProbe;
+	probe->rProbe = arena_alloc(&(result->arena), arg->nProbe * sizeof(float));
+	probe->molSasa = arena_alloc(&(result->arena), arg->nProbe * sizeof(MolSasa));
+	memcpy(probe->rProbe, arg->probe, arg->nProbe * sizeof(float));
+
+	for (i = 0; i < arg->nProbe; ++ i) {
+		if (arg->probe[i] == arg->rProbe) {
+			probe->molSasa[i] = result->molSasa;
+			continue;
+		}
+		probeArg.rProbe = arg->probe[i];
+		init_sasa(pdb, &(result->view), &(probe->molSasa[i]), &probeArg, &(result->arena));
+		if ((ret = compute_sasa_probe(pdb, &(result->view), &(result->topol), \
+				&(result->type), &(probe->molSasa[i]), ctx->constant_sasa, \
+				ctx->res_sasa, &probeArg)) != POPS_OK)
+			return ret;
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** table header: section title and column names */
+static void print_probe_header(FILE *probeOutFile, Arg *arg, char *title, char *column)
+{
+	if (! arg->noHeaderOut && ! arg->rout)
+		fprintf(probeOutFile, "\n=== %s SASAs PER PROBE RADIUS ===\n", title);
+	if (! arg->noHeaderOut || arg->rout)
+		fprintf(probeOutFile, "rProbe/A\t%s\n", column);
+}
+
+/*____________________________________________________________________________*/
+/** print atom SASA at each probe radius */
+static void print_atom_probe(FILE *probeOutFile, Arg *arg, Str *pdb, PopsProbe *probe)
+{
+	unsigned int i, k;
+	MolSasa *molSasa = 0;
+
+	print_probe_header(probeOutFile, arg, "ATOM",
+		"AtomNr\tAtomNe\tResidNe\tChain\tResidNr\tiCode\tSASA/A^2\tN(overl)\tSurf/A^2");
+
+	for (k = 0; k < probe->nProbe; ++ k) {
+		molSasa = &(probe->molSasa[k]);
+		for (i = 0; i < pdb->nAtom; ++ i)
+			fprintf(probeOutFile, "%8.2f\t%8d\t%3s\t%3s\t%1s\t%6d\t%1s\t%10.2f\t%8d\t%10.2f\n",
+				probe->rProbe[k],
+				pdb->atom[i].atomNumber,
+				pdb->atom[i].atomName,
+				pdb->atom[i].residueName,
+				chain_identifier(&(pdb->atom[i])),
+				pdb->atom[i].residueNumber,
+				pdb->atom[i].icode,
+				molSasa->atomSasa[i].sasa,
+				molSasa->atomSasa[i].nOverlap,
+				molSasa->atomSasa[i].surface);
+	}
+}
+
+/*____________________________________________________________________________*/
+/** print residue SASA at each probe radius */
+static void print_residue_probe(FILE *probeOutFile, Arg *arg, Str *pdb, PopsProbe *probe)
+{
+	unsigned int i, k;
+	MolSasa *molSasa = 0;
+	Atom *atom = 0;
+
+	print_probe_header(probeOutFile, arg, "RESIDUE",
+		"ResidNe\tChain\tResidNr\tiCode\tPhob/A^2\tPhil/A^2\tSASA/A^2");
+
+	for (k = 0; k < probe->nProbe; ++ k) {
+		molSasa = &(probe->molSasa[k]);
+		for (i = 0; i < pdb->nAllResidue; ++ i) {
+			atom = &(pdb->atom[molSasa->resSasa[i].atomRef]);
+			fprintf(probeOutFile, "%8.2f\t%8s\t%3s\t%8d\t%1s\t%10.2f\t%10.2f\t%10.2f\n",
+				probe->rProbe[k],
+				atom->residueName,
+				chain_identifier(atom),
+				atom->residueNumber,
+				atom->icode,
+				molSasa->resSasa[i].phobicSasa,
+				molSasa->resSasa[i].philicSasa,
+				molSasa->resSasa[i].sasa);
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** print chain SASA at each probe radius */
+static void print_chain_probe(FILE *probeOutFile, Arg *arg, Str *pdb, PopsProbe *probe)
+{
+	unsigned int i, k;
+	MolSasa *molSasa = 0;
+
+	print_probe_header(probeOutFile, arg, "CHAIN",
+		"Chain\tId\tPhob/A^2\tPhil/A^2\tSASA/A^2");
+
+	for (k = 0; k < probe->nProbe; ++ k) {
+		molSasa = &(probe->molSasa[k]);
+		for (i = 0; i < pdb->nChain; ++ i)
+			fprintf(probeOutFile, "%8.2f\t%3d\t%3s\t%10.2f\t%10.2f\t%10.2f\n",
+				probe->rProbe[k],
+				i,
+				chain_identifier(&(pdb->atom[molSasa->chainSasa[i].first])),
+				molSasa->chainSasa[i].phobicSasa,
+				molSasa->chainSasa[i].philicSasa,
+				molSasa->chainSasa[i].sasa);
+	}
+}
+
+/*____________________________________________________________________________*/
+/** print molecule SASA at each probe radius */
+static void print_mol_probe(FILE *probeOutFile, Arg *arg, PopsProbe *probe)
+{
+	unsigned int k;
+
+	print_probe_header(probeOutFile, arg, "MOLECULE",
+		"Phob/A^2\tPhil/A^2\tSASA/A^2");
+
+	for (k = 0; k < probe->nProbe; ++ k)
+		fprintf(probeOutFile, "%8.2f\t%10.2f\t%10.2f\t%10.2f\n",
+			probe->rProbe[k],
+			probe->molSasa[k].phobicSasa,
+			probe->molSasa[k].philicSasa,
+			probe->molSasa[k].sasa);
+}
+
+/*____________________________________________________________________________*/
+/** print the SASA of all probe radii to one file: '--popsprobeOut' or,
+	with '--rout', '<routPrefix>.rpopsProbe' in the output directory;
+	the levels follow the '--atomOut', '--residueOut', '--chainOut'
+	and '--noTotalOut' options */
+int pops_print_probe(Arg *arg, Argpdb *argpdb, Str *pdb, PopsProbe *probe)
+{
+	char probeOutFileName[1024];
+
+	if (arg->rout)
+		snprintf(probeOutFileName, sizeof(probeOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, "rpopsProbe");
+	else
+		snprintf(probeOutFileName, sizeof(probeOutFileName), "%s", arg->probeOutFileName);
+
+	if (! arg->silent)
+		fprintf(stdout, "\tSASA at %d probe radii: %s\n", probe->nProbe, probeOutFileName);
+
+	arg->probeOutFile = safe_open(probeOutFileName, "w");
+
+	if (arg->atomOut && ! argpdb->coarse)
+		print_atom_probe(arg->probeOutFile, arg, pdb, probe);
+	if (arg->residueOut)
+		print_residue_probe(arg->probeOutFile, arg, pdb, probe);
+	if (arg->chainOut)
+		print_chain_probe(arg->probeOutFile, arg, pdb, probe);
+	if (! arg->noTotalOut)
+		print_mol_probe(arg->probeOutFile, arg, probe);
+
+	fclose(arg->probeOutFile);
+
+	return POPS_OK;
+}
+
@@ -0,0 +1,39 @@
+/*==============================================================================
+probe.h : SASA at several probe radii
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "putsasa.h"
+#include "safe.h"
+#include "sasa.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* SASA at the probe radii of 'arg'; arrays are in the arena of the result */
+typedef struct {
+	int nProbe;
+	float *rProbe; /* probe radius of each SASA */
+	MolSasa *molSasa; /* SASA of atoms, residues, chains and molecule */
+} PopsProbe;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_probe(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsProbe *probe);
+int pops_print_probe(Arg *arg, Argpdb *argpdb, Str *pdb, PopsProbe *probe);
+
+#endif
+
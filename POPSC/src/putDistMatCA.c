@@ -9,39 +9,34 @@ Read the COPYING file for license information.
 #include "topol.h"
 
 /*___________________________________________________________________________*/
-/** print Calpha distance matrix */
-void print_distMatCA(Arg *arg, Topol *topol)
+/** print sparse Calpha soft distances: one line per Calpha pair of
+	different chains, grouped by chain pair; POPS_ERR_OUTPUT if the output
+	file is not writable */
+int print_distMatCA(Arg *arg, Str *pdb, Topol *topol)
 {
-	int i, j;
+	int p, k;
+	CAPair *pair = 0;
+	Atom *atom1 = 0, *atom2 = 0;
 
-	arg->distMatCAOutFile = safe_open(arg->distMatCAOutFileName, "w");
+	if ((arg->distMatCAOutFile = safe_open_noexit(arg->distMatCAOutFileName, "w")) == NULL)
+		return POPS_ERR_OUTPUT;
 
-	/* print residue numbers as column names */
-	for (j = 0; j < topol->nCA2; ++ j) {
-		if (j > 0) {
-			fprintf(arg->distMatCAOutFile, " %d", topol->resCA2[j]);
-		} else {
-			fprintf(arg->distMatCAOutFile, "%d", topol->resCA2[j]);
+	fprintf(arg->distMatCAOutFile, "Chain1\tResidNr1\tChain2\tResidNr2\tSoftDist\n");
+
+	for (p = 0; p < topol->nCAPair; ++ p) {
+		pair = &(topol->caPair[p]);
+		for (k = 0; k < pair->nContact; ++ k) {
+			atom1 = &(pdb->atom[pair->ca1[k]]);
+			atom2 = &(pdb->atom[pair->ca2[k]]);
+			fprintf(arg->distMatCAOutFile, "%s\t%d\t%s\t%d\t%3.2f\n",
+				atom1->chainIdentifier, atom1->residueNumber,
+				atom2->chainIdentifier, atom2->residueNumber,
+				pair->softDistance[k]);
 		}
 	}
-    fprintf(arg->distMatCAOutFile, "\n");
-		
-	 for (i = 0; i < topol->nCA1; ++ i) {
-        if (i > 0) fprintf(arg->distMatCAOutFile, "\n");
-
-		/* print residue numbers as row names */
-		fprintf(arg->distMatCAOutFile, "%d ", topol->resCA1[i]);
-    	
-		for (j = 0; j < topol->nCA2; ++ j) {
-			if (j < topol->nCA2 - 1) {
-       			fprintf(arg->distMatCAOutFile, "%3.2f ", topol->distMatCA[i][j]);
-			} else {
-       			fprintf(arg->distMatCAOutFile, "%3.2f", topol->distMatCA[i][j]);
-			}
-       	}
-    }
-    fprintf(arg->distMatCAOutFile, "\n");
-	
+
 	fclose(arg->distMatCAOutFile);
+
+	return POPS_OK;
 }
 
@@ -14,7 +14,7 @@ Read the COPYING file for license information.
 #include "topol.h"
 
 /*____________________________________________________________________________*/
-/* print Calpha distance matrix */
-void print_distMatCA(Arg *arg, Topol *topol);
+/* print sparse Calpha distances of all chain pairs */
+int print_distMatCA(Arg *arg, Str *pdb, Topol *topol);
 
 #endif
@@ -134,22 +134,24 @@ void print_mol_bsasa(FILE *bsasaOutFile, Arg *arg, MolSasa *molSasa)
 }
 
 /*____________________________________________________________________________*/
-/** print bSASAs */
-void print_bsasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
+/** print bSASAs; POPS_ERR_OUTPUT if the output file is not writable */
+int print_bsasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 				MolSasa *molSasa, ConstantSasa *constant_sasa, int frame)
 {
-	char bsasatrajOutFileName[256];
+	char bsasatrajOutFileName[1024];
 
 	/* for single (reference) molecule */
 	if (frame < 0) {
-		if (! arg->silent) {
+		if (! arg->silent)
 			fprintf(stdout, "\tbSASA of reference molecule: %s\n", arg->bsasaOutFileName);
-			arg->bsasaOutFile = safe_open(arg->bsasaOutFileName, "w");
-		}
+		arg->bsasaOutFile = safe_open_noexit(arg->bsasaOutFileName, "w");
 	} else {
-			sprintf(&(bsasatrajOutFileName[0]), "%s.%d.%s", arg->bsasatrajOutFileName, frame, "out");
-			arg->bsasaOutFile = safe_open(bsasatrajOutFileName, "w");
+			snprintf(bsasatrajOutFileName, sizeof(bsasatrajOutFileName), "%s.%d.%s",
+				arg->bsasatrajOutFileName, frame, "out");
+			arg->bsasaOutFile = safe_open_noexit(bsasatrajOutFileName, "w");
 	}
+	if (! arg->bsasaOutFile)
+		return POPS_ERR_OUTPUT;
 
 	/* atom bSASA */
 	if (arg->atomOut && ! argpdb->coarse)
@@ -168,5 +170,7 @@ void print_bsasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 		print_mol_bsasa(arg->bsasaOutFile, arg, molSasa);
 
 	fclose(arg->bsasaOutFile);
+
+	return POPS_OK;
 }
 
@@ -18,7 +18,7 @@ Read the COPYING file for license information.
 #include "topol.h"
 #include "type.h"
 
-void print_bsasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
+int print_bsasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 				MolSasa *molSasa, ConstantSasa *constant_sasa, int frame);
 
 #endif
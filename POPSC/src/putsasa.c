@@ -6,6 +6,13 @@ Read the COPYING file for license information.
 
 #include "putsasa.h"
 
+/*____________________________________________________________________________*/
+/** replace empty chain identifier by '-', as in the SASA tables */
+char *chain_identifier(Atom *atom)
+{
+	return (strcmp(atom->chainIdentifier, " ") == 0) ? "-" : atom->chainIdentifier;
+}
+
 /*____________________________________________________________________________*/
 /** print molecule composition */
 static void print_composition(FILE *sasaOutFile, Arg *arg, Argpdb *argpdb, Str *pdb)
@@ -337,30 +344,46 @@ void print_interface(FILE *interfaceOutFile, Arg *arg, Str *pdb, Type *type, Top
 }
 
 /*____________________________________________________________________________*/
-/** print SASAs */
-void print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
+/** open the '--rout' table 'outDirName/routPrefix.suffix' */
+static FILE *open_rpops(Arg *arg, char *suffix, char *mode)
+{
+	char rpopsOutFileName[1024];
+
+	if (snprintf(rpopsOutFileName, sizeof(rpopsOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, suffix) >= sizeof(rpopsOutFileName)) {
+		fprintf(stderr, "Error: Output file name too long: '%s/%s.%s'\n",
+			arg->outDirName, arg->routPrefix, suffix);
+		return NULL;
+	}
+
+	return safe_open_noexit(rpopsOutFileName, mode);
+}
+
+/*____________________________________________________________________________*/
+/** print SASAs; POPS_ERR_OUTPUT if an output file is not writable */
+int print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 				MolSasa *molSasa, ConstantSasa *constant_sasa, int frame)
 {
-	char sasatrajOutFileName[256];
-	char rpopsOutFileName[256];
+	char sasatrajOutFileName[1024];
 	FILE *rpopsOutFile;
+	int ret = POPS_OK;
 
 	/* for single (reference) molecule */
 	if (frame < 0) {
-		if (! arg->silent) {
+		if (! arg->silent)
 			fprintf(stdout, "\tSASA of reference molecule: %s\n", arg->sasaOutFileName);
-			if (arg->rout) {
-				arg->sasaOutFile = NULL;
-			} else {
-				arg->sasaOutFile = safe_open(arg->sasaOutFileName, "w");
-			}
+		if (arg->rout) {
+			arg->sasaOutFile = NULL;
+		} else if ((arg->sasaOutFile = safe_open_noexit(arg->sasaOutFileName, "w")) == NULL) {
+			return POPS_ERR_OUTPUT;
 		}
 	} else {
-			sprintf(&(sasatrajOutFileName[0]), "%s.%d.%s", arg->sasatrajOutFileName, frame, "out");
-			if (! arg->rout) {
+			snprintf(sasatrajOutFileName, sizeof(sasatrajOutFileName), "%s.%d.%s",
+				arg->sasatrajOutFileName, frame, "out");
+			if (arg->rout) {
 				arg->sasaOutFile = NULL;
-			} else {
-				arg->sasaOutFile = safe_open(sasatrajOutFileName, "w");
+			} else if ((arg->sasaOutFile = safe_open_noexit(sasatrajOutFileName, "w")) == NULL) {
+				return POPS_ERR_OUTPUT;
 			}
 	}
 	/* composition */
@@ -379,11 +402,12 @@ void print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 	/* atom SASA */
 	if (arg->atomOut && ! argpdb->coarse) {
 		if (arg->rout) {
-			sprintf(rpopsOutFileName, "%s/%s.%s",
-				arg->outDirName, arg->routPrefix, "rpopsAtom");
-			rpopsOutFile = safe_open(rpopsOutFileName, "w");
-			print_atom_sasa(rpopsOutFile, arg, pdb, molSasa);
-			fclose(rpopsOutFile);
+			if ((rpopsOutFile = open_rpops(arg, "rpopsAtom", "w"))) {
+				print_atom_sasa(rpopsOutFile, arg, pdb, molSasa);
+				fclose(rpopsOutFile);
+			} else {
+				ret = POPS_ERR_OUTPUT;
+			}
 		} else {
 			print_atom_sasa(arg->sasaOutFile, arg, pdb, molSasa);
 		}
@@ -392,21 +416,23 @@ void print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 	/* print '0' to pops.out.rpopsAtom for Shiny reactive file reader
 	     when no atom SASAs are being computed under '--coarse' */
 	if (argpdb->coarse && arg->rout) {
-		sprintf(rpopsOutFileName, "%s/%s.%s",
-			arg->outDirName, arg->routPrefix, "rpopsAtom");
-		rpopsOutFile = safe_open(rpopsOutFileName, "w");
-		fprintf(rpopsOutFile, "%d\n", 0);
-		fclose(rpopsOutFile);
+		if ((rpopsOutFile = open_rpops(arg, "rpopsAtom", "w"))) {
+			fprintf(rpopsOutFile, "%d\n", 0);
+			fclose(rpopsOutFile);
+		} else {
+			ret = POPS_ERR_OUTPUT;
+		}
 	}
 
 	/* residue SASA */
 	if (arg->residueOut) {
 		if (arg->rout) {
-			sprintf(rpopsOutFileName, "%s/%s.%s",
-				arg->outDirName, arg->routPrefix, "rpopsResidue");
-			rpopsOutFile = safe_open(rpopsOutFileName, "w");
-			print_residue_sasa(rpopsOutFile, arg, pdb, molSasa);
-			fclose(rpopsOutFile);
+			if ((rpopsOutFile = open_rpops(arg, "rpopsResidue", "w"))) {
+				print_residue_sasa(rpopsOutFile, arg, pdb, molSasa);
+				fclose(rpopsOutFile);
+			} else {
+				ret = POPS_ERR_OUTPUT;
+			}
 		} else {
 			print_residue_sasa(arg->sasaOutFile, arg, pdb, molSasa);
 		}
@@ -415,11 +441,12 @@ void print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 	/* chain SASA */
 	if (arg->chainOut) {
 		if (arg->rout) {
-			sprintf(rpopsOutFileName, "%s/%s.%s",
-				arg->outDirName, arg->routPrefix, "rpopsChain");
-			rpopsOutFile = safe_open(rpopsOutFileName, "w");
-			print_chain_sasa(rpopsOutFile, arg, pdb, molSasa);
-			fclose(rpopsOutFile);
+			if ((rpopsOutFile = open_rpops(arg, "rpopsChain", "w"))) {
+				print_chain_sasa(rpopsOutFile, arg, pdb, molSasa);
+				fclose(rpopsOutFile);
+			} else {
+				ret = POPS_ERR_OUTPUT;
+			}
 		} else {
 			print_chain_sasa(arg->sasaOutFile, arg, pdb, molSasa);
 		}
@@ -428,11 +455,12 @@ void print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 	/* molecule SASA */
 	if (! arg->noTotalOut) {
 		if (arg->rout) {
-			sprintf(rpopsOutFileName, "%s/%s.%s",
-				arg->outDirName, arg->routPrefix, "rpopsMolecule");
-			rpopsOutFile = safe_open(rpopsOutFileName, "w");
-			print_mol_sasa(rpopsOutFile, arg, molSasa);
-			fclose(rpopsOutFile);
+			if ((rpopsOutFile = open_rpops(arg, "rpopsMolecule", "w"))) {
+				print_mol_sasa(rpopsOutFile, arg, molSasa);
+				fclose(rpopsOutFile);
+			} else {
+				ret = POPS_ERR_OUTPUT;
+			}
 		} else {
 			print_mol_sasa(arg->sasaOutFile, arg, molSasa);
 		}
@@ -445,58 +473,50 @@ void print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 	/* neighbour list */
 	if (arg->neighbourOut) {
 		if (arg->rout) {
-			sprintf(rpopsOutFileName, "%s/%s.%s",
-				arg->outDirName, arg->routPrefix, "neighbours.out");
-			if (frame < 0) {
-				rpopsOutFile = safe_open(rpopsOutFileName, "w");
+			if ((rpopsOutFile = open_rpops(arg, "neighbours.out", (frame < 0) ? "w" : "a"))) {
+				print_neighbour_list(rpopsOutFile, arg, pdb, topol);
+				fclose(rpopsOutFile);
 			} else {
-				rpopsOutFile = safe_open(rpopsOutFileName, "a");
-			}		
-			print_neighbour_list(rpopsOutFile, arg, pdb, topol);
-			fclose(rpopsOutFile);
+				ret = POPS_ERR_OUTPUT;
+			}
 		} else {
-			if (frame < 0) {
-				arg->neighbourOutFile = safe_open(arg->neighbourOutFileName, "w");
+			if ((arg->neighbourOutFile = safe_open_noexit(arg->neighbourOutFileName, (frame < 0) ? "w" : "a"))) {
+				print_neighbour_list(arg->neighbourOutFile, arg, pdb, topol);
+				fclose(arg->neighbourOutFile);
 			} else {
-				arg->neighbourOutFile = safe_open(arg->neighbourOutFileName, "a");
+				ret = POPS_ERR_OUTPUT;
 			}
-			print_neighbour_list(arg->neighbourOutFile, arg, pdb, topol);
-			fclose(arg->neighbourOutFile);
 		}
 	}
 
 	/* neighbour parameters (for benchmarking) */
 	if (arg->parameterOut) {
-		if (frame < 0)
-			arg->parameterOutFile = safe_open(arg->parameterOutFileName, "w");
-		else
-			arg->parameterOutFile = safe_open(arg->parameterOutFileName, "a");
-
-		print_neighbour_parameter(arg->parameterOutFile, pdb, type, topol, molSasa);
-		fclose(arg->parameterOutFile);
+		if ((arg->parameterOutFile = safe_open_noexit(arg->parameterOutFileName, (frame < 0) ? "w" : "a"))) {
+			print_neighbour_parameter(arg->parameterOutFile, pdb, type, topol, molSasa);
+			fclose(arg->parameterOutFile);
+		} else {
+			ret = POPS_ERR_OUTPUT;
+		}
 	}
 
 	/* interface residue pairs */
 	if (arg->interfaceOut) {
 		if (arg->rout) {
-			sprintf(rpopsOutFileName, "%s/%s.%s",
-				arg->outDirName, arg->routPrefix, "interface.out");
-			if (frame < 0) {
-				rpopsOutFile = safe_open(rpopsOutFileName, "w");
+			if ((rpopsOutFile = open_rpops(arg, "interface.out", (frame < 0) ? "w" : "a"))) {
+				print_interface(rpopsOutFile, arg, pdb, type, topol);
+				fclose(rpopsOutFile);
 			} else {
-				rpopsOutFile = safe_open(rpopsOutFileName, "a");
-			}		
-			print_interface(arg->interfaceOutFile, arg, pdb, type, topol);
-			fclose(rpopsOutFile);
+				ret = POPS_ERR_OUTPUT;
+			}
 		} else {
-			if (frame < 0) {
-				arg->interfaceOutFile = safe_open(arg->interfaceOutFileName, "w");
+			if ((arg->interfaceOutFile = safe_open_noexit(arg->interfaceOutFileName, (frame < 0) ? "w" : "a"))) {
+				print_interface(arg->interfaceOutFile, arg, pdb, type, topol);
+				fclose(arg->interfaceOutFile);
 			} else {
-				arg->interfaceOutFile = safe_open(arg->interfaceOutFileName, "a");
+				ret = POPS_ERR_OUTPUT;
 			}
-			print_interface(arg->interfaceOutFile, arg, pdb, type, topol);
-			fclose(arg->interfaceOutFile);
 		}
 	}
-}
 
+	return ret;
+}
@@ -18,7 +18,8 @@ Read the COPYING file for license information.
 #include "topol.h"
 #include "type.h"
 
-void print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
+char *chain_identifier(Atom *atom);
+int print_sasa(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 				MolSasa *molSasa, ConstantSasa *constant_sasa, int frame);
 
 #endif
@@ -109,15 +109,16 @@ void print_mol_sfe(FILE *sigmaOutFile, Arg *arg, MolSFE *molSFE)
 }
 
 /*____________________________________________________________________________*/
-/** print SFEs */
-void print_sfe(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
+/** print SFEs; POPS_ERR_OUTPUT if the output file is not writable */
+int print_sfe(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 				MolSFE *molSFE, ConstantSigma *constant_sigma, int frame)
 {
 	/* for single (reference) molecule */
 	if (frame < 0) {
 		if (! arg->silent)
 			fprintf(stdout, "\tSFE of input molecule: %s\n", arg->sigmaOutFileName);
-		arg->sigmaOutFile = safe_open(arg->sigmaOutFileName, "w");
+		if ((arg->sigmaOutFile = safe_open_noexit(arg->sigmaOutFileName, "w")) == NULL)
+			return POPS_ERR_OUTPUT;
 
 		/* atom SFE */
 		if (arg->atomOut)
@@ -143,5 +144,7 @@ void print_sfe(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 		fprintf(arg->sigmatrajOutFile, "%d\t%10.2f\t%10.2f\n",
 				(frame + 1), molSFE->sfe_type, molSFE->sfe_group);
 	}
+
+	return POPS_OK;
 }
 
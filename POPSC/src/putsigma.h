@@ -18,7 +18,7 @@ Read the COPYING file for license information.
 
 /*____________________________________________________________________________*/
 /* print sigma and Solvation Free Energy values */
-void print_sfe(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
+int print_sfe(Arg *arg, Argpdb *argpdb, Str *pdb, Type *type, Topol *topol, \
 				MolSFE *molSFE, ConstantSigma *constant_Sigma, int frame);
 
 #endif
@@ -0,0 +1,130 @@
+/*==============================================================================
+readsel.c : read-time selection of chains, residue ranges and residue classes
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "readsel.h"
+
+/*____________________________________________________________________________*/
+/* The readers test each ATOM record against the selection right after
+	the record fields are parsed: rejected atoms are not counted into
+	'nAtom', so they are never allocated, typed or entered into the
+	topology. They still count into 'nAllAtom', which keeps 'atomMap'
+	pointing at the original atom order for trajectories and assemblies.
+	Chains are a comma-separated list 'A,B' and residue ranges a list
+	'A:10-25,B:7' ('-' for a blank chain identifier); chains and ranges
+	must both match when both are given. HETATM records, and with them
+	water, are skipped by all readers already. */
+
+/* nucleic acid residue names of the SASA tables */
+static const char *nucleicName[] = {
+	"A", "C", "G", "I", "N", "T", "U",
+	"DA", "DC", "DG", "DI", "DN", "DT", "DU", 0};
+
+/*____________________________________________________________________________*/
+/** copy a chain identifier of at most 7 characters; returns 0 or -1 */
+static int copy_chain(char *chain, const char *text, size_t length)
+{
+	if ((length == 0) || (length > 7))
+		return -1;
+	memcpy(chain, text, length);
+	chain[length] = '\0';
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** parse the selection options of 'argpdb'; returns 0 or -1 if invalid */
+int init_read_selection(Argpdb *argpdb, ReadSelection *readsel)
+{
+	char list[1024];
+	char *token = 0;
+	char *save = 0;
+	char *colon = 0;
+	int n;
+
+	memset(readsel, 0, sizeof(ReadSelection));
+	readsel->noNucleic = argpdb->noNucleic;
+
+	if (argpdb->chains) {
+		if (strlen(argpdb->chains) >= sizeof(list))
+			return -1;
+		strcpy(list, argpdb->chains);
+		for (token = strtok_r(list, ",", &save); token; token = strtok_r(0, ",", &save)) {
+			if ((readsel->nChain == NREADCHAIN) ||
+				(copy_chain(readsel->chain[readsel->nChain ++], token, strlen(token)) != 0))
+				return -1;
+		}
+		if (readsel->nChain == 0)
+			return -1;
+	}
+
+	if (argpdb->residues) {
+		if (strlen(argpdb->residues) >= sizeof(list))
+			return -1;
+		strcpy(list, argpdb->residues);
+		for (token = strtok_r(list, ",", &save); token; token = strtok_r(0, ",", &save)) {
+			if ((readsel->nRange == NREADRANGE) || ((colon = strchr(token, ':')) == 0) ||
+				(copy_chain(readsel->rangeChain[readsel->nRange], token, colon - token) != 0))
+				return -1;
+			n = sscanf(colon + 1, "%d-%d", &(readsel->rangeFirst[readsel->nRange]),
+				&(readsel->rangeLast[readsel->nRange]));
+			if (n < 1)
+				return -1;
+			if (n == 1)
+				readsel->rangeLast[readsel->nRange] = readsel->rangeFirst[readsel->nRange];
+			if (readsel->rangeLast[readsel->nRange] < readsel->rangeFirst[readsel->nRange])
+				return -1;
+			++ readsel->nRange;
+		}
+		if (readsel->nRange == 0)
+			return -1;
+	}
+
+	readsel->active = (readsel->nChain > 0) || (readsel->nRange > 0) || readsel->noNucleic;
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** atom of the given chain and residue passes the selection */
+int read_selected(ReadSelection *readsel, char *chainIdentifier, \
+	int residueNumber, char *residueName)
+{
+	int i;
+	const char *chain = chainIdentifier;
+
+	if (! readsel->active)
+		return 1;
+
+	/* blank chain identifier */
+	if ((chain[0] == '\0') || (strcmp(chain, " ") == 0))
+		chain = "-";
+
+	if (readsel->noNucleic)
+		for (i = 0; nucleicName[i]; ++ i)
+			if (strcmp(residueName, nucleicName[i]) == 0)
+				return 0;
+
+	if (readsel->nChain > 0) {
+		for (i = 0; i < readsel->nChain; ++ i)
+			if (strcmp(chain, readsel->chain[i]) == 0)
+				break;
+		if (i == readsel->nChain)
+			return 0;
+	}
+
+	if (readsel->nRange > 0) {
+		for (i = 0; i < readsel->nRange; ++ i)
+			if ((strcmp(chain, readsel->rangeChain[i]) == 0) &&
+				(residueNumber >= readsel->rangeFirst[i]) &&
+				(residueNumber <= readsel->rangeLast[i]))
+				break;
+		if (i == readsel->nRange)
+			return 0;
+	}
+
+	return 1;
+}
+
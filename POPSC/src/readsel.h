@@ -0,0 +1,42 @@
+/*==============================================================================
+readsel.h : read-time selection of chains, residue ranges and residue classes
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef READSEL_H
+#define READSEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "argpdb.h"
+
+/*___________________________________________________________________________*/
+/* limits of the selection lists */
+#define NREADCHAIN 64
+#define NREADRANGE 64
+
+/*___________________________________________________________________________*/
+/* structures */
+/* selection applied by the readers to each ATOM record */
+typedef struct {
+	int active; /* any selection set */
+	int nChain; /* chains to read, 0 for all */
+	char chain[NREADCHAIN][8];
+	int nRange; /* residue ranges to read, 0 for all */
+	char rangeChain[NREADRANGE][8];
+	int rangeFirst[NREADRANGE];
+	int rangeLast[NREADRANGE];
+	int noNucleic; /* skip nucleic acid residues */
+} ReadSelection;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int init_read_selection(Argpdb *argpdb, ReadSelection *readsel);
+int read_selected(ReadSelection *readsel, char *chainIdentifier, \
+	int residueNumber, char *residueName);
+
+#endif
+
@@ -19,6 +19,16 @@ FILE *safe_open(const char *name, const char *mode)
 	}
 }
 
+/*___________________________________________________________________________*/
+/** file opening that reports failure to the caller, for library routines */
+FILE *safe_open_noexit(const char *name, const char *mode)
+{
+    FILE *file = fopen(name, mode);
+    if (! file)
+		fprintf(stderr, "Error: Failed accessing file '%s'\n", name);
+	return file;
+}
+
 /*___________________________________________________________________________*/
 /** safe memory allocation */
 void *check_non_null(void *ptr)
@@ -37,3 +47,13 @@ void *safe_realloc(void *ptr, size_t size)
     return check_non_null(realloc(ptr, size));
 }
 
+void *safe_memalign(size_t alignment, size_t size)
+{
+	void *ptr = 0;
+
+	if (posix_memalign(&ptr, alignment, (size > 0 ? size : alignment)) != 0)
+		ptr = 0;
+
+    return check_non_null(ptr);
+}
+
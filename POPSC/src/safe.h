@@ -14,12 +14,14 @@ Read the COPYING file for license information.
 /*___________________________________________________________________________*/
 /* file */
 FILE *safe_open(const char *name, const char *mode);
+FILE *safe_open_noexit(const char *name, const char *mode);
 
 /*___________________________________________________________________________*/
 /* allocation */
 void *check_non_null(void *ptr);
 void *safe_malloc(size_t size);
 void *safe_realloc(void *ptr, size_t size);
+void *safe_memalign(size_t alignment, size_t size);
 
 #endif
 
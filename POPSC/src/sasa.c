@@ -12,7 +12,7 @@ Read the COPYING file for license information.
 
 /*___________________________________________________________________________*/
 /** compute sphere surface */
-__inline__ static double sphere_surface(double atomRadius, float rSolvent)
+double sphere_surface(double atomRadius, float rSolvent)
 {
 	return (4. * PI * pow((atomRadius + rSolvent), 2));
 }
@@ -51,21 +51,20 @@ __inline__ static double atom_bsasa(MolSasa *molSasa, int k, double connectivity
 
 /*___________________________________________________________________________*/
 /** initialise all SASAs */
-int init_sasa(Str *pdb, Type *type, MolSasa *molSasa, ConstantSasa *constant_sasa, Arg *arg)
+int init_sasa(Str *pdb, View *view, MolSasa *molSasa, Arg *arg, Arena *arena)
 {
 	unsigned int i;
 
-	molSasa->atomSasa = safe_malloc(pdb->nAtom * sizeof(AtomSasa));
-	molSasa->resSasa = safe_malloc(pdb->nAllResidue * sizeof(ResSasa));
-	molSasa->chainSasa = safe_malloc(pdb->nChain * sizeof(ChainSasa));
+	/* released by resetting the arena */
+	molSasa->atomSasa = arena_alloc(arena, pdb->nAtom * sizeof(AtomSasa));
+	molSasa->resSasa = arena_alloc(arena, pdb->nAllResidue * sizeof(ResSasa));
+	molSasa->chainSasa = arena_alloc(arena, pdb->nChain * sizeof(ChainSasa));
 
 	for (i = 0; i < pdb->nAtom; ++ i) {
 		/*___________________________________________________________________________*/
 		/* initialise atom SASAs */
 		/* start value of atom SASA is surface of isolated atom */
-		sphere_surface(constant_sasa->atomDataSasa[type->residueType[i]][type->atomType[i]].radius, arg->rProbe);
-		molSasa->atomSasa[i].surface = \
-			sphere_surface(constant_sasa->atomDataSasa[type->residueType[i]][type->atomType[i]].radius, arg->rProbe);
+		molSasa->atomSasa[i].surface = sphere_surface(view->radius[i], arg->rProbe);
 		molSasa->atomSasa[i].sasa = molSasa->atomSasa[i].surface;
 		molSasa->atomSasa[i].nOverlap = 0; /* no overlaps yet (isolated atom) */
 		molSasa->atomSasa[i].phobicbSasa = 0.; /* hydrophobic buried SASA */
@@ -114,60 +113,45 @@ int init_sasa(Str *pdb, Type *type, MolSasa *molSasa, ConstantSasa *constant_sas
 }
 
 /*___________________________________________________________________________*/
-/** free SASAs */
-void free_sasa(MolSasa *molSasa)
-{
-	free(molSasa->atomSasa); /* atoms */
-	free(molSasa->resSasa); /* residues */
-	free(molSasa->chainSasa); /* chains */
-}
-
-/*___________________________________________________________________________*/
-/** atom SASA modification from one contact */
-__inline__ static int mod_atom_sasa(Str *pdb, Topol *topol, Type *type, \
-	MolSasa *molSasa, ConstantSasa *constant_sasa, double connectivityParameter, \
-	int i, int j, float rSolvent)
+/** atom SASA modification from one contact;
+	returns POPS_OK, also for atoms without overlap, or POPS_ERR_CONTACT */
+__inline__ static int mod_atom_sasa(Str *pdb, View *view, Topol *topol, Type *type, \
+	MolSasa *molSasa, double connectivityParameter, int i, int j, float rSolvent)
 {
     double atomRadius_i, atomRadius_j;
 	double atomParameter_i, atomParameter_j;
     double ci1, cj1, cc2, ci3, cj3, bij, bji;
 	float atomDistance = 0.;
 	float cutoffRadius = 0.;
-	char syscmd[128];
-	int syscmdstat = 0;
 
 	/*___________________________________________________________________________*/
 	/* safety check */   
 	if (i == j) {
-		sprintf(syscmd, "touch %s.json", pdb->pdbID); 
-		syscmdstat = system(syscmd);
-		fprintf(stderr, "Problem at atoms %d %d ; system exit = %d\n",
-			pdb->atom[i].atomNumber, pdb->atom[i+1].atomNumber, syscmdstat);
-		exit(0);
+		fprintf(stderr, "Problem at atoms %d %d\n",
+			pdb->atom[i].atomNumber, pdb->atom[i+1].atomNumber);
+		return POPS_ERR_CONTACT;
 	}
 
 	/*___________________________________________________________________________*/
 	/* initialise */   
 	/* atom specific radius */
-    atomRadius_i = constant_sasa->atomDataSasa[type->residueType[i]][type->atomType[i]].radius;
-    atomRadius_j = constant_sasa->atomDataSasa[type->residueType[j]][type->atomType[j]].radius;
+    atomRadius_i = view->radius[i];
+    atomRadius_j = view->radius[j];
 	/* atom specific parameter */
-    atomParameter_i = constant_sasa->atomDataSasa[type->residueType[i]][type->atomType[i]].parameter;
-    atomParameter_j = constant_sasa->atomDataSasa[type->residueType[j]][type->atomType[j]].parameter;
+    atomParameter_i = view->parameter[i];
+    atomParameter_j = view->parameter[j];
 
 	/*___________________________________________________________________________*/
 	/* skip overlap area computation if the two atoms i,j do not overlap */
-    if ((cutoffRadius = cutoff_radius(type, constant_sasa, i, j, rSolvent)) < \
-		 (atomDistance = atom_distance(pdb, i, j)))
-		return(1);
+    if ((cutoffRadius = cutoff_radius(view, i, j, rSolvent)) < \
+		 (atomDistance = view_distance(view, i, j)))
+		return POPS_OK;
 
 	/* shortest atomic bond length is .74 A in hydrogen molecule H_2 */
 	if (atomDistance < .74) {
-		sprintf(syscmd, "touch %s.json", pdb->pdbID); 
-		syscmdstat = system(syscmd);
-		fprintf(stderr, "Too short atom distance %d %d = %f A ; system exit = %d\n",
-			pdb->atom[i].atomNumber, pdb->atom[j].atomNumber, atomDistance, syscmdstat);
-		exit(0);
+		fprintf(stderr, "Too short atom distance %d %d = %f A\n",
+			pdb->atom[i].atomNumber, pdb->atom[j].atomNumber, atomDistance);
+		return POPS_ERR_CONTACT;
 	}
 
 	/*___________________________________________________________________________*/
@@ -204,18 +188,18 @@ __inline__ static int mod_atom_sasa(Str *pdb, Topol *topol, Type *type, \
 	/* compute atom bSASA for atoms i and j */
 	/* select side-chain (including CA) atoms and
 		determine polarity of neghbour (overlap) atom */
-	if (pdb->atom[i].residueNumber != pdb->atom[j].residueNumber) {
-		if (((type->atomType[i] == 1) || (type->atomType[i] > 3)) && (constant_sasa->atomDataSasa[type->residueType[j]][type->atomType[j]].polarity == 0)) {
+	if (view->residueNumber[i] != view->residueNumber[j]) {
+		if (((type->atomType[i] == 1) || (type->atomType[i] > 3)) && (view->polarity[j] == 0)) {
 			molSasa->atomSasa[i].phobicbSasa += atom_bsasa(molSasa, i, connectivityParameter, bij, atomParameter_i);
-		} else if (((type->atomType[i] == 1) || (type->atomType[i] > 3)) && (constant_sasa->atomDataSasa[type->residueType[j]][type->atomType[j]].polarity == 1)) {
+		} else if (((type->atomType[i] == 1) || (type->atomType[i] > 3)) && (view->polarity[j] == 1)) {
 			molSasa->atomSasa[i].philicbSasa += atom_bsasa(molSasa, i, connectivityParameter, bij, atomParameter_i);
 		} else {
 			molSasa->atomSasa[i].philicbSasa += 0.;
 		}
 
-		if ((type->atomType[j] > 3) && (constant_sasa->atomDataSasa[type->residueType[i]][type->atomType[i]].polarity == 0)) {
+		if ((type->atomType[j] > 3) && (view->polarity[i] == 0)) {
 			molSasa->atomSasa[j].phobicbSasa += atom_bsasa(molSasa, j, connectivityParameter, bij, atomParameter_j);
-		} else if ((type->atomType[j] > 3) && (constant_sasa->atomDataSasa[type->residueType[i]][type->atomType[i]].polarity == 1)) {
+		} else if ((type->atomType[j] > 3) && (view->polarity[i] == 1)) {
 			molSasa->atomSasa[j].philicbSasa += atom_bsasa(molSasa, j, connectivityParameter, bij, atomParameter_j);
 		} else {
 			molSasa->atomSasa[i].philicbSasa += 0.;
@@ -225,12 +209,14 @@ __inline__ static int mod_atom_sasa(Str *pdb, Topol *topol, Type *type, \
 	molSasa->atomSasa[i].bSasa = molSasa->atomSasa[i].phobicbSasa + molSasa->atomSasa[i].philicbSasa;
 	molSasa->atomSasa[j].bSasa = molSasa->atomSasa[j].phobicbSasa + molSasa->atomSasa[j].philicbSasa;
 
-	/* record parameters: increment neighbour index */
-	++ topol->neighbourPar[i][0];
-	++ topol->neighbourPar[j][0];
-	/* record parameter product 'p_ij * b_ij' */
-	topol->neighbourPar[i][(int)topol->neighbourPar[i][0]] = connectivityParameter * bij;
-	topol->neighbourPar[j][(int)topol->neighbourPar[j][0]] = connectivityParameter * bji;
+	/* record parameters (not for 'topol' 0): increment neighbour index */
+	if (topol) {
+		++ topol->neighbourPar[i][0];
+		++ topol->neighbourPar[j][0];
+		/* record parameter product 'p_ij * b_ij' */
+		topol->neighbourPar[i][(int)topol->neighbourPar[i][0]] = connectivityParameter * bij;
+		topol->neighbourPar[j][(int)topol->neighbourPar[j][0]] = connectivityParameter * bji;
+	}
 
 	return(0);
 }
@@ -239,11 +225,14 @@ __inline__ static int mod_atom_sasa(Str *pdb, Topol *topol, Type *type, \
 /** atomic SASA calculation:
 	modify initial atom SASA (=total surface) for each atom interaction; */
 /** atomic bSASA calculation (last subroutine):
-	compute buried SASA due to neighbour atoms */
-static int compute_atom_sasa(Str *pdb, Topol *topol, Type *type, MolSasa *molSasa, \
-	ConstantSasa *constant_sasa, Arg *arg)
+	compute buried SASA due to neighbour atoms;
+	neighbour parameters are recorded in 'topol' if 'record' is set */
+static int compute_atom_sasa(Str *pdb, View *view, Topol *topol, Type *type, \
+	MolSasa *molSasa, ConstantSasa *constant_sasa, Arg *arg, int record)
 {
 	unsigned int i;
+	int ret;
+	Topol *recordTopol = record ? topol : 0;
    
 	/*___________________________________________________________________________*/
 	/** 1-2 interactions along bonds 
@@ -253,9 +242,10 @@ static int compute_atom_sasa(Str *pdb, Topol *topol, Type *type, MolSasa *molSas
 	{
 	*/
 	for (i = 0; i < topol->nBond; ++ i) {
-        mod_atom_sasa(pdb, topol, type, molSasa, constant_sasa,
+        if ((ret = mod_atom_sasa(pdb, view, recordTopol, type, molSasa,
 			constant_sasa->connect_12_parameter,
-			topol->ib[i], topol->jb[i], arg->rProbe);
+			topol->ib[i], topol->jb[i], arg->rProbe)) != POPS_OK)
+			return ret;
 	}
 	/*}*/
 
@@ -266,9 +256,10 @@ static int compute_atom_sasa(Str *pdb, Topol *topol, Type *type, MolSasa *molSas
 	{
 	*/
     for (i = 0; i < topol->nAngle; ++ i) {
-        mod_atom_sasa(pdb, topol, type, molSasa, constant_sasa,
+        if ((ret = mod_atom_sasa(pdb, view, recordTopol, type, molSasa,
 			constant_sasa->connect_13_parameter,
-			topol->it[i], topol->kt[i], arg->rProbe);
+			topol->it[i], topol->kt[i], arg->rProbe)) != POPS_OK)
+			return ret;
 	}
 	/*}*/
 
@@ -279,9 +270,10 @@ static int compute_atom_sasa(Str *pdb, Topol *topol, Type *type, MolSasa *molSas
 	{
 	*/
     for (i = 0; i < topol->nTorsion; ++ i) {
-		mod_atom_sasa(pdb, topol, type, molSasa, constant_sasa,
+		if ((ret = mod_atom_sasa(pdb, view, recordTopol, type, molSasa,
 			constant_sasa->connect_14_parameter,
-			topol->ip[i], topol->lp[i], arg->rProbe);
+			topol->ip[i], topol->lp[i], arg->rProbe)) != POPS_OK)
+			return ret;
 	}
 	/*}*/
 
@@ -292,19 +284,219 @@ static int compute_atom_sasa(Str *pdb, Topol *topol, Type *type, MolSasa *molSas
 	{
 	*/
     for (i = 0; i < topol->nNonBonded; ++ i) {
-        mod_atom_sasa(pdb, topol, type, molSasa, constant_sasa,
+        if ((ret = mod_atom_sasa(pdb, view, recordTopol, type, molSasa,
 			constant_sasa->connect_15_parameter,
-			topol->in[i], topol->jn[i], arg->rProbe);
+			topol->in[i], topol->jn[i], arg->rProbe)) != POPS_OK)
+			return ret;
 	}
 	/*}*/
 
-	return(0);
+	return POPS_OK;
+}
+
+/*___________________________________________________________________________*/
+/** atomic SASA from the listed interactions only, in list order;
+	'interaction' indices as in 'topol_interaction';
+	neighbour parameters are not recorded */
+int compute_sasa_subset(Str *pdb, View *view, Topol *topol, Type *type, \
+	MolSasa *molSasa, ConstantSasa *constant_sasa, Arg *arg, \
+	int *interaction, int nInteraction)
+{
+	unsigned int k;
+	int i, j;
+	int ret;
+	double connectivityParameter;
+
+	for (k = 0; k < nInteraction; ++ k) {
+		switch (topol_interaction(topol, interaction[k], &i, &j)) {
+			case 2: connectivityParameter = constant_sasa->connect_12_parameter; break;
+			case 3: connectivityParameter = constant_sasa->connect_13_parameter; break;
+			case 4: connectivityParameter = constant_sasa->connect_14_parameter; break;
+			default: connectivityParameter = constant_sasa->connect_15_parameter; break;
+		}
+		if ((ret = mod_atom_sasa(pdb, view, 0, type, molSasa,
+				connectivityParameter, i, j, arg->rProbe)) != POPS_OK)
+			return ret;
+	}
+
+	return POPS_OK;
+}
+
+/*___________________________________________________________________________*/
+/** SASA of atom k from its own interactions, listed in the order of
+	'compute_sasa': the operations of 'mod_atom_sasa' on atom k only,
+	therefore the same values as a computation of the whole structure */
+int compute_sasa_atom(View *view, Type *type, MolSasa *molSasa, \
+	ConstantSasa *constant_sasa, float rSolvent, int k, \
+	AtomInteraction *interaction, int nInteraction)
+{
+	unsigned int n;
+	int i, j, p;
+	double atomRadius_i, atomRadius_j;
+	double atomParameter_k;
+	double ci1, cj1, cc2, ci3, cj3, bij, bkl;
+	double connectivityParameter;
+	float atomDistance = 0.;
+	float cutoffRadius = 0.;
+	AtomSasa *atomSasa = &(molSasa->atomSasa[k]);
+
+	atomSasa->sasa = atomSasa->surface;
+	atomSasa->nOverlap = 0;
+	atomSasa->phobicbSasa = 0.;
+	atomSasa->philicbSasa = 0.;
+	atomParameter_k = view->parameter[k];
+
+	for (n = 0; n < nInteraction; ++ n) {
+		/* pair in the order of the interaction list */
+		p = interaction[n].partner;
+		i = interaction[n].first ? k : p;
+		j = interaction[n].first ? p : k;
+
+		if ((cutoffRadius = cutoff_radius(view, i, j, rSolvent)) < \
+			 (atomDistance = view_distance(view, i, j)))
+			continue;
+
+		if (atomDistance < .74) {
+			fprintf(stderr, "Too short atom distance %d %d = %f A\n", i, j, atomDistance);
+			return POPS_ERR_CONTACT;
+		}
+
+		switch (interaction[n].connect) {
+			case 2: connectivityParameter = constant_sasa->connect_12_parameter; break;
+			case 3: connectivityParameter = constant_sasa->connect_13_parameter; break;
+			case 4: connectivityParameter = constant_sasa->connect_14_parameter; break;
+			default: connectivityParameter = constant_sasa->connect_15_parameter; break;
+		}
+
+		atomRadius_i = view->radius[i];
+		atomRadius_j = view->radius[j];
+		ci1 = compute_c1(atomRadius_i, rSolvent);
+		cj1 = compute_c1(atomRadius_j, rSolvent);
+		cc2 = cutoffRadius - atomDistance;
+		ci3 = compute_c3(atomRadius_j, atomRadius_i, atomDistance);
+		cj3 = compute_c3(atomRadius_i, atomRadius_j, atomDistance);
+		bij = ci1 * cc2 * ci3;
+		bkl = interaction[n].first ? bij : cj1 * cc2 * cj3;
+
+		/* the first atom of a pair counts its overlaps twice */
+		atomSasa->nOverlap += interaction[n].first ? 2 : 1;
+
+		atomSasa->sasa = atom_sasa(molSasa, k, connectivityParameter, bkl, atomParameter_k);
+
+		/* bSASA, with the conditions of the first and second atom of a pair;
+			both use 'bij' */
+		if (view->residueNumber[i] == view->residueNumber[j])
+			continue;
+		if (interaction[n].first) {
+			if (((type->atomType[k] == 1) || (type->atomType[k] > 3)) && (view->polarity[p] == 0))
+				atomSasa->phobicbSasa += atom_bsasa(molSasa, k, connectivityParameter, bij, atomParameter_k);
+			else if (((type->atomType[k] == 1) || (type->atomType[k] > 3)) && (view->polarity[p] == 1))
+				atomSasa->philicbSasa += atom_bsasa(molSasa, k, connectivityParameter, bij, atomParameter_k);
+		} else {
+			if ((type->atomType[k] > 3) && (view->polarity[p] == 0))
+				atomSasa->phobicbSasa += atom_bsasa(molSasa, k, connectivityParameter, bij, atomParameter_k);
+			else if ((type->atomType[k] > 3) && (view->polarity[p] == 1))
+				atomSasa->philicbSasa += atom_bsasa(molSasa, k, connectivityParameter, bij, atomParameter_k);
+		}
+	}
+
+	atomSasa->bSasa = atomSasa->phobicbSasa + atomSasa->philicbSasa;
+
+	return POPS_OK;
+}
+
+/*___________________________________________________________________________*/
+/** factors by which the overlap of atoms i and j scales their SASA,
+	as applied in 'mod_atom_sasa'; returns 0 if the atoms do not overlap */
+int overlap_factors(View *view, MolSasa *molSasa, double connectivityParameter, \
+	int i, int j, float rSolvent, double *factor_i, double *factor_j)
+{
+	double cc2, bij, bji;
+	float atomDistance = 0.;
+	float cutoffRadius = 0.;
+
+    if ((cutoffRadius = cutoff_radius(view, i, j, rSolvent)) < \
+		 (atomDistance = view_distance(view, i, j)))
+		return 0;
+
+	cc2 = cutoffRadius - atomDistance;
+	bij = compute_c1(view->radius[i], rSolvent) * cc2 * \
+		compute_c3(view->radius[j], view->radius[i], atomDistance);
+	bji = compute_c1(view->radius[j], rSolvent) * cc2 * \
+		compute_c3(view->radius[i], view->radius[j], atomDistance);
+
+	*factor_i = 1.0 - (connectivityParameter * bij * view->parameter[i] / molSasa->atomSasa[i].surface);
+	*factor_j = 1.0 - (connectivityParameter * bji * view->parameter[j] / molSasa->atomSasa[j].surface);
+
+	return 1;
+}
+
+/*___________________________________________________________________________*/
+/** parameter-free overlap terms of atoms i and j, b[ij] / S_i and b[ji] / S_j:
+	the factors of 'overlap_factors' are 1 - p_c P_i g_i and 1 - p_c P_j g_j;
+	returns 0 if the atoms do not overlap */
+int overlap_geometry(View *view, MolSasa *molSasa, int i, int j, float rSolvent, \
+	double *geometry_i, double *geometry_j)
+{
+	double cc2;
+	float atomDistance = 0.;
+	float cutoffRadius = 0.;
+
+    if ((cutoffRadius = cutoff_radius(view, i, j, rSolvent)) < \
+		 (atomDistance = view_distance(view, i, j)))
+		return 0;
+
+	cc2 = cutoffRadius - atomDistance;
+	*geometry_i = compute_c1(view->radius[i], rSolvent) * cc2 * \
+		compute_c3(view->radius[j], view->radius[i], atomDistance) / molSasa->atomSasa[i].surface;
+	*geometry_j = compute_c1(view->radius[j], rSolvent) * cc2 * \
+		compute_c3(view->radius[i], view->radius[j], atomDistance) / molSasa->atomSasa[j].surface;
+
+	return 1;
+}
+
+/*___________________________________________________________________________*/
+/** overlap factors of atoms i and j as in 'overlap_factors' and their
+	derivatives with respect to the atom distance, which is returned in
+	'distance'; returns 0 if the atoms do not overlap */
+int overlap_derivatives(View *view, MolSasa *molSasa, double connectivityParameter, \
+	int i, int j, float rSolvent, double *factor_i, double *factor_j, \
+	double *dfactor_i, double *dfactor_j, double *distance)
+{
+	double ci1, cj1, cc2, ci3, cj3;
+	double dbij, dbji; /* derivatives of b[ij,ji] */
+	float atomDistance = 0.;
+	float cutoffRadius = 0.;
+
+    if ((cutoffRadius = cutoff_radius(view, i, j, rSolvent)) < \
+		 (atomDistance = view_distance(view, i, j)))
+		return 0;
+
+	ci1 = compute_c1(view->radius[i], rSolvent);
+	cj1 = compute_c1(view->radius[j], rSolvent);
+	cc2 = cutoffRadius - atomDistance;
+	ci3 = compute_c3(view->radius[j], view->radius[i], atomDistance);
+	cj3 = compute_c3(view->radius[i], view->radius[j], atomDistance);
+
+	/* d(cc2)/dr = -1, d(c[ij]3)/dr = -(R_j - R_i) / r^2 */
+	dbij = -ci1 * (ci3 + cc2 * (view->radius[j] - view->radius[i]) / \
+		((double)atomDistance * atomDistance));
+	dbji = -cj1 * (cj3 + cc2 * (view->radius[i] - view->radius[j]) / \
+		((double)atomDistance * atomDistance));
+
+	*factor_i = 1.0 - (connectivityParameter * ci1 * cc2 * ci3 * view->parameter[i] / molSasa->atomSasa[i].surface);
+	*factor_j = 1.0 - (connectivityParameter * cj1 * cc2 * cj3 * view->parameter[j] / molSasa->atomSasa[j].surface);
+	*dfactor_i = -(connectivityParameter * dbij * view->parameter[i] / molSasa->atomSasa[i].surface);
+	*dfactor_j = -(connectivityParameter * dbji * view->parameter[j] / molSasa->atomSasa[j].surface);
+	*distance = atomDistance;
+
+	return 1;
 }
 
 /*___________________________________________________________________________*/
 /** residuic and molecular SASA calculation */
-static int compute_res_chain_mol_sasa(Str *pdb, Type *type, MolSasa *molSasa, \
-	ConstantSasa *constant_sasa, ConstantSasa *res_sasa)
+int compute_res_chain_mol_sasa(Str *pdb, View *view, Type *type, MolSasa *molSasa, \
+	ConstantSasa *res_sasa)
 {
     unsigned int i, j, k;
 
@@ -326,8 +518,7 @@ static int compute_res_chain_mol_sasa(Str *pdb, Type *type, MolSasa *molSasa, \
 		}
 		/*___________________________________________________________________________*/
 		/* increment residue index */
-		if (i > 0 && (pdb->atom[i].residueNumber != pdb->atom[i - 1].residueNumber ||
-				      strcmp(pdb->atom[i].icode, pdb->atom[i - 1].icode) != 0)) {
+		if (i > 0 && view->residueIndex[i] != view->residueIndex[i - 1]) {
 			++ j;
 			molSasa->resSasa[j].atomRef = i; /* assign atom reference */
 			/* set reference residue surface*/
@@ -335,7 +526,7 @@ static int compute_res_chain_mol_sasa(Str *pdb, Type *type, MolSasa *molSasa, \
 		}
 		/*___________________________________________________________________________*/
 		/* increment chain index */
-        	if (i > 0 && pdb->atom[i].chainIdentifier[0] != pdb->atom[i - 1].chainIdentifier[0]) {
+        	if (i > 0 && view->chainIndex[i] != view->chainIndex[i - 1]) {
 			++ k;
 			molSasa->chainSasa[k-1].last = i-1;
 			molSasa->chainSasa[k].first = i;
@@ -343,7 +534,7 @@ static int compute_res_chain_mol_sasa(Str *pdb, Type *type, MolSasa *molSasa, \
 
 		/*___________________________________________________________________________*/
 		/* sum atomic SASA to residue, chain and molecule SASA */
-		if (constant_sasa[0].atomDataSasa[type->residueType[i]][type->atomType[i]].polarity == 0) {
+		if (view->polarity[i] == 0) {
 			molSasa->resSasa[j].phobicSasa += molSasa->atomSasa[i].sasa;
 			molSasa->chainSasa[k].phobicSasa += molSasa->atomSasa[i].sasa;
 			molSasa->phobicSasa += molSasa->atomSasa[i].sasa;
@@ -384,10 +575,33 @@ static int compute_res_chain_mol_sasa(Str *pdb, Type *type, MolSasa *molSasa, \
 
 /*___________________________________________________________________________*/
 /** compute SASAs */
-void compute_sasa(Str *pdb, Topol *topol, Type *type, MolSasa *molSasa, \
+int compute_sasa(Str *pdb, View *view, Topol *topol, Type *type, MolSasa *molSasa, \
 	ConstantSasa *constant_sasa, ConstantSasa *res_sasa, Arg *arg)
 {
-    compute_atom_sasa(pdb, topol, type, molSasa, constant_sasa, arg); /* compute SASA per atom */
-	compute_res_chain_mol_sasa(pdb, type, molSasa, constant_sasa, res_sasa); /* sum up atom SASAs */
+	int ret;
+
+	/* compute SASA per atom */
+    if ((ret = compute_atom_sasa(pdb, view, topol, type, molSasa, constant_sasa, arg, 1)) != POPS_OK)
+		return ret;
+	compute_res_chain_mol_sasa(pdb, view, type, molSasa, res_sasa); /* sum up atom SASAs */
+
+	return POPS_OK;
+}
+
+/*___________________________________________________________________________*/
+/** compute SASAs at the probe radius 'arg->rProbe' over the interactions
+	of 'topol', which may be listed for a larger probe radius:
+	pairs beyond the cutoff of this radius do not overlap;
+	neighbour parameters are not recorded */
+int compute_sasa_probe(Str *pdb, View *view, Topol *topol, Type *type, MolSasa *molSasa, \
+	ConstantSasa *constant_sasa, ConstantSasa *res_sasa, Arg *arg)
+{
+	int ret;
+
+    if ((ret = compute_atom_sasa(pdb, view, topol, type, molSasa, constant_sasa, arg, 0)) != POPS_OK)
+		return ret;
+	compute_res_chain_mol_sasa(pdb, view, type, molSasa, res_sasa);
+
+	return POPS_OK;
 }
 
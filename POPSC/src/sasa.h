@@ -15,11 +15,13 @@ Read the COPYING file for license information.
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "arena.h"
 #include "arg.h"
 #include "topol.h"
 #include "type.h"
 #include "sasa_const.h"
 #include "vector.h"
+#include "view.h"
 
 /*___________________________________________________________________________*/
 /* structures */
@@ -76,11 +78,36 @@ typedef struct
     double bSasa; /* bSASA */
 } MolSasa;
 
+/* interaction of one atom with a partner atom */
+typedef struct
+{
+	int partner; /* partner atom */
+	char connect; /* 2: bond, 3: angle, 4: torsion, 5: non-bonded */
+	char first; /* the atom is the first atom of the interaction pair */
+} AtomInteraction;
+
 /*___________________________________________________________________________*/
 /* prototypes */
-int init_sasa(Str *pdb, Type *type, MolSasa *molSasa, ConstantSasa *constant_sasa, Arg *arg);
-void free_sasa(MolSasa *molSasa);
-void compute_sasa(Str *pdb, Topol *topol, Type *type, MolSasa *molSasa, \
+double sphere_surface(double atomRadius, float rSolvent);
+int init_sasa(Str *pdb, View *view, MolSasa *molSasa, Arg *arg, Arena *arena);
+int compute_sasa(Str *pdb, View *view, Topol *topol, Type *type, MolSasa *molSasa, \
+		ConstantSasa *constant_sasa, ConstantSasa *res_sasa, Arg *arg);
+int compute_sasa_probe(Str *pdb, View *view, Topol *topol, Type *type, MolSasa *molSasa, \
 		ConstantSasa *constant_sasa, ConstantSasa *res_sasa, Arg *arg);
+int compute_sasa_atom(View *view, Type *type, MolSasa *molSasa, \
+		ConstantSasa *constant_sasa, float rSolvent, int k, \
+		AtomInteraction *interaction, int nInteraction);
+int compute_sasa_subset(Str *pdb, View *view, Topol *topol, Type *type, \
+		MolSasa *molSasa, ConstantSasa *constant_sasa, Arg *arg, \
+		int *interaction, int nInteraction);
+int overlap_factors(View *view, MolSasa *molSasa, double connectivityParameter, \
+		int i, int j, float rSolvent, double *factor_i, double *factor_j);
+int overlap_geometry(View *view, MolSasa *molSasa, int i, int j, float rSolvent, \
+		double *geometry_i, double *geometry_j);
+int overlap_derivatives(View *view, MolSasa *molSasa, double connectivityParameter, \
+		int i, int j, float rSolvent, double *factor_i, double *factor_j, \
+		double *dfactor_i, double *dfactor_j, double *distance);
+int compute_res_chain_mol_sasa(Str *pdb, View *view, Type *type, MolSasa *molSasa, \
+		ConstantSasa *res_sasa);
 
 #endif
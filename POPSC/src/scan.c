@@ -0,0 +1,531 @@
+/*==============================================================================
+scan.c : in-silico alanine and glycine scanning
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "scan.h"
+
+/*____________________________________________________________________________*/
+/* A mutant of the scan differs from the wild type by the side-chain atoms
+	of one residue, which are deleted, and by the types of the remaining
+	atoms of that residue, which are those of the mutant residue (ALA or
+	GLY). Only the remaining atoms of the residue and the partners of all
+	its atoms change their interactions: their SASA is computed again with
+	'compute_sasa_atom' from the wild-type interactions without the deleted
+	atoms, plus the non-bonded pairs that a larger mutant radius adds.
+	The change of the molecular SASA and SFE follows from the changed
+	atoms alone. The wild-type topology and neighbour list are shared,
+	each thread holds the per-atom data that a mutation changes. */
+
+/* work of all threads */
+typedef struct {
+	PopsContext *ctx;
+	Arg *arg;
+	Str *pdb;
+	PopsResult *result;
+	PopsScan *scan;
+	PopsUpdate update; /* bonded interactions and cell grid, read-only */
+	float maxRadius; /* largest wild-type atom radius, covered by the grid */
+	int mutantResidue; /* residue type of the mutant */
+	int next; /* next mutation */
+	int ret; /* first error */
+	pthread_mutex_t lock;
+} ScanWork;
+
+/* scratch of one thread: per-atom data of the mutant */
+typedef struct {
+	ScanWork *work;
+	View view; /* wild-type view with its own radii, parameters and polarities */
+	Type type; /* atom and residue types */
+	MolSasa molSasa; /* atom SASAs */
+	char *deleted; /* atom deleted in the mutant */
+	char *affected; /* atom with changed interactions */
+	int *affectedAtom; /* list of affected atoms */
+	int nAffected;
+	int *candidate; /* atoms of the cells around one atom */
+	int *extra; /* atom pairs added by a larger mutant radius */
+	int nExtra;
+	int allocatedExtra;
+	int *partner; /* added partners of one atom */
+	int allocatedPartner;
+	AtomInteraction *interaction; /* interactions of one atom */
+	int allocatedInteraction;
+} ScanThread;
+
+/*____________________________________________________________________________*/
+/** mark atom 'a' as affected */
+__inline__ static void mark_affected(ScanThread *st, int a)
+{
+	if (! st->affected[a]) {
+		st->affected[a] = 1;
+		st->affectedAtom[st->nAffected ++] = a;
+	}
+}
+
+/*____________________________________________________________________________*/
+/** record the non-bonded pair 'a'-'j' added by the mutant radius of 'a' */
+static void add_extra(ScanThread *st, int a, int j)
+{
+	if (st->nExtra == st->allocatedExtra) {
+		st->allocatedExtra += 64;
+		st->extra = safe_realloc(st->extra, 2 * st->allocatedExtra * sizeof(int));
+	}
+	st->extra[2 * st->nExtra] = a;
+	st->extra[2 * st->nExtra + 1] = j;
+	++ st->nExtra;
+}
+
+/*____________________________________________________________________________*/
+/** non-bonded pairs of the grown atom 'a' beyond the wild-type cutoff;
+	'first' is the first atom of the mutated residue */
+static void extra_pairs(ScanThread *st, int a, int first)
+{
+	ScanWork *work = st->work;
+	View *wt = &(work->result->view);
+	View *view = &(st->view);
+	float rProbe = work->arg->rProbe;
+	float atomDistance;
+	int j, k, nCandidate;
+
+	/* the grid covers the cutoffs up to the largest wild-type radius */
+	if (view->radius[a] <= work->maxRadius) {
+		nCandidate = update_neighbours(&(work->update), a, st->candidate);
+	} else {
+		for (j = 0; j < view->nAtom; ++ j)
+			st->candidate[j] = j;
+		nCandidate = view->nAtom;
+	}
+
+	for (k = 0; k < nCandidate; ++ k) {
+		j = st->candidate[k];
+		if (j == a || st->deleted[j])
+			continue;
+		/* a pair of grown atoms is found from its lower atom */
+		if (j >= first && j < a && view->radius[j] > wt->radius[j])
+			continue;
+		atomDistance = view_distance(view, a, j);
+		if (atomDistance < cutoff_radius(view, a, j, rProbe) && \
+			! (atomDistance < cutoff_radius(wt, a, j, rProbe)) && \
+			! topol_bonded(&(work->result->topol), a, j)) {
+			add_extra(st, a, j);
+			mark_affected(st, j);
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** interactions of atom 'a' in the mutant, in the order of 'compute_sasa';
+	returns their number */
+static int mutant_interactions(ScanThread *st, int a)
+{
+	PopsUpdate *update = &(st->work->update);
+	int *row = st->work->result->topol.neighbourState[a];
+	int i, j, k, p;
+	int nPartner = 0;
+	int nInteraction = 0;
+
+	/* bonded, without deleted partners */
+	for (k = update->bondedFirst[a]; k < update->bondedFirst[a + 1]; ++ k)
+		if (! st->deleted[update->bonded[k].partner])
+			st->interaction[nInteraction ++] = update->bonded[k];
+
+	/* added non-bonded partners, ascending */
+	for (i = 0; i < st->nExtra; ++ i) {
+		if (st->extra[2 * i] == a)
+			p = st->extra[2 * i + 1];
+		else if (st->extra[2 * i + 1] == a)
+			p = st->extra[2 * i];
+		else
+			continue;
+		/* a grown residue atom may gain any number of partners */
+		if (nPartner == st->allocatedPartner) {
+			st->allocatedPartner += 64;
+			st->partner = safe_realloc(st->partner, st->allocatedPartner * sizeof(int));
+		}
+		for (j = nPartner; j > 0 && st->partner[j - 1] > p; -- j)
+			st->partner[j] = st->partner[j - 1];
+		st->partner[j] = p;
+		++ nPartner;
+	}
+
+	if (nInteraction + row[0] + nPartner > st->allocatedInteraction) {
+		st->allocatedInteraction = nInteraction + row[0] + nPartner;
+		st->interaction = safe_realloc(st->interaction, st->allocatedInteraction * sizeof(AtomInteraction));
+	}
+
+	/* non-bonded: wild-type and added partners merged in ascending order */
+	for (k = 1, i = 0; k <= row[0] || i < nPartner; ) {
+		if (i >= nPartner || (k <= row[0] && row[k] < st->partner[i]))
+			p = row[k ++];
+		else
+			p = st->partner[i ++];
+		if (st->deleted[p])
+			continue;
+		st->interaction[nInteraction].partner = p;
+		st->interaction[nInteraction].connect = 5;
+		st->interaction[nInteraction].first = (a < p);
+		++ nInteraction;
+	}
+
+	return nInteraction;
+}
+
+/*____________________________________________________________________________*/
+/** add the SASA and SFE of atom 'a' with sign 'sign' to the mutation */
+static void sum_mutation(Mutation *mutation, ConstantSigma *constant_sigma, \
+	View *view, Type *type, AtomSasa *atomSasa, int a, double sign)
+{
+	double sasa = sign * atomSasa[a].sasa;
+
+	if (view->polarity[a] == 0)
+		mutation->phobicSasa += sasa;
+	else
+		mutation->philicSasa += sasa;
+	mutation->sasa += sasa;
+	mutation->sfe_type += sasa / 100 * \
+		constant_sigma->atomDataSigma[type->residueType[a]][type->atomType[a]].sigma_type;
+	mutation->sfe_group += sasa / 100 * \
+		constant_sigma->atomDataSigma[type->residueType[a]][type->atomType[a]].sigma_group;
+}
+
+/*____________________________________________________________________________*/
+/** SASA and SFE change of the truncation of one residue */
+static int scan_residue(ScanThread *st, Mutation *mutation)
+{
+	ScanWork *work = st->work;
+	PopsContext *ctx = work->ctx;
+	PopsResult *result = work->result;
+	Str *pdb = work->pdb;
+	View *wt = &(result->view);
+	View *view = &(st->view);
+	Topol *topol = &(result->topol);
+	PopsUpdate *update = &(work->update);
+	AtomSasa *wtSasa = result->molSasa.atomSasa;
+	AtomdataSasa *atomData = 0;
+	TypeEntry *entry = 0;
+	char atomName[8] = "";
+	int first, last;
+	int a, i, k, nInteraction;
+	int ret = POPS_OK;
+
+	first = result->molSasa.resSasa[mutation->residue].atomRef;
+	for (last = first; last < pdb->nAtom && wt->residueIndex[last] == mutation->residue; ++ last)
+		;
+
+	st->nAffected = 0;
+	st->nExtra = 0;
+	mutation->nDeleted = 0;
+	mutation->phobicSasa = mutation->philicSasa = mutation->sasa = 0.;
+	mutation->sfe_type = mutation->sfe_group = 0.;
+
+	/*____________________________________________________________________________*/
+	/* atoms of the residue: mutant types or deleted */
+	for (a = first; a < last; ++ a) {
+		strip_char(pdb->atom[a].atomName, atomName);
+		entry = find_type(&(ctx->typeHash), type_key(work->scan->mutant, atomName));
+		if (entry && (entry->atomType >= 0)) {
+			st->type.residueType[a] = work->mutantResidue;
+			st->type.atomType[a] = entry->atomType;
+			atomData = &(ctx->constant_sasa->atomDataSasa[work->mutantResidue][entry->atomType]);
+			view->radius[a] = atomData->radius;
+			view->parameter[a] = atomData->parameter;
+			view->polarity[a] = (char)atomData->polarity;
+			st->molSasa.atomSasa[a].surface = sphere_surface(view->radius[a], work->arg->rProbe);
+			mark_affected(st, a);
+		} else if (result->type.residueType[a] == ctx->typeHash.anyResidue) {
+			/* terminal atoms keep their type */
+			mark_affected(st, a);
+		} else {
+			st->deleted[a] = 1;
+			++ mutation->nDeleted;
+		}
+	}
+
+	/* partners of the residue atoms */
+	for (a = first; a < last; ++ a) {
+		for (k = update->bondedFirst[a]; k < update->bondedFirst[a + 1]; ++ k)
+			if (! st->deleted[update->bonded[k].partner])
+				mark_affected(st, update->bonded[k].partner);
+		for (k = 1; k <= topol->neighbourState[a][0]; ++ k)
+			if (! st->deleted[topol->neighbourState[a][k]])
+				mark_affected(st, topol->neighbourState[a][k]);
+	}
+
+	/* non-bonded pairs added by larger mutant radii */
+	for (a = first; a < last; ++ a)
+		if (! st->deleted[a] && view->radius[a] > wt->radius[a])
+			extra_pairs(st, a, first);
+
+	/*____________________________________________________________________________*/
+	/* SASA of the affected atoms in the mutant */
+	for (i = 0; i < st->nAffected; ++ i) {
+		a = st->affectedAtom[i];
+		nInteraction = mutant_interactions(st, a);
+		if ((ret = compute_sasa_atom(view, &(st->type), &(st->molSasa), ctx->constant_sasa, \
+				work->arg->rProbe, a, st->interaction, nInteraction)) != POPS_OK)
+			break;
+		sum_mutation(mutation, ctx->constant_sigma, view, &(st->type), st->molSasa.atomSasa, a, 1.);
+		sum_mutation(mutation, ctx->constant_sigma, wt, &(result->type), wtSasa, a, -1.);
+	}
+	for (a = first; a < last; ++ a)
+		if (st->deleted[a])
+			sum_mutation(mutation, ctx->constant_sigma, wt, &(result->type), wtSasa, a, -1.);
+	mutation->nAffected = st->nAffected;
+
+	/*____________________________________________________________________________*/
+	/* restore the wild type */
+	for (i = 0; i < st->nAffected; ++ i) {
+		st->molSasa.atomSasa[st->affectedAtom[i]] = wtSasa[st->affectedAtom[i]];
+		st->affected[st->affectedAtom[i]] = 0;
+	}
+	for (a = first; a < last; ++ a) {
+		st->type.residueType[a] = result->type.residueType[a];
+		st->type.atomType[a] = result->type.atomType[a];
+		view->radius[a] = wt->radius[a];
+		view->parameter[a] = wt->parameter[a];
+		view->polarity[a] = wt->polarity[a];
+		st->molSasa.atomSasa[a] = wtSasa[a];
+		st->deleted[a] = 0;
+	}
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** thread: take mutations until all are done */
+static void *scan_thread(void *data)
+{
+	ScanThread *st = (ScanThread *)data;
+	ScanWork *work = st->work;
+	int m;
+	int ret;
+
+	for (;;) {
+		pthread_mutex_lock(&(work->lock));
+		m = (work->next < work->scan->nMutation) ? work->next ++ : -1;
+		pthread_mutex_unlock(&(work->lock));
+		if (m < 0)
+			break;
+
+		if ((ret = scan_residue(st, &(work->scan->mutation[m]))) != POPS_OK) {
+			pthread_mutex_lock(&(work->lock));
+			if (work->ret == POPS_OK)
+				work->ret = ret;
+			pthread_mutex_unlock(&(work->lock));
+		}
+	}
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** residue listed in '--scanResidues' as 'chain:number';
+	-1 if the list is too long */
+static int listed(char *scanResidues, Atom *atom)
+{
+	char list[1024];
+	char *token = 0;
+	char *save = 0;
+	char chain;
+	int residueNumber;
+
+	if (snprintf(list, sizeof(list), "%s", scanResidues) >= sizeof(list))
+		return -1;
+	for (token = strtok_r(list, ",", &save); token; token = strtok_r(0, ",", &save)) {
+		if (sscanf(token, "%c:%d", &chain, &residueNumber) != 2)
+			continue;
+		if (chain == '-')
+			chain = ' ';
+		if (chain == atom->chainIdentifier[0] && residueNumber == atom->residueNumber)
+			return 1;
+	}
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** truncate each amino acid residue, or each residue of '--scanResidues',
+	to the residue '--scan' and compute the change of the molecular
+	SASA and SFE from the wild-type topology of 'result' */
+int pops_scan(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsScan *scan)
+{
+	Arena *arena = &(result->arena);
+	View *view = &(result->view);
+	ScanWork work;
+	ScanThread *st = 0;
+	pthread_t *thread = 0;
+	TypeEntry *entry = 0;
+	Atom *atom = 0;
+	char residueName[8] = "";
+	int nResidue = (pdb->nAtom > 0) ? view->residueIndex[pdb->nAtom - 1] + 1 : 0;
+	int maxResidueAtom = 0;
+	int nThread;
+	int i, r;
+
+	memset(&work, 0, sizeof(ScanWork));
+	work.ctx = ctx;
+	work.arg = arg;
+	work.pdb = pdb;
+	work.result = result;
+	work.scan = scan;
+
+	snprintf(scan->mutant, sizeof(scan->mutant), "%s", arg->scan);
+	if (((entry = find_type(&(ctx->typeHash), type_key(scan->mutant, ""))) == 0) || \
+			(entry->residueType < 0))
+		return POPS_ERR_TYPE;
+	work.mutantResidue = entry->residueType;
+
+	/*____________________________________________________________________________*/
+	/* amino acids other than the mutant, GLY is not scanned to ALA */
+	scan->mutation = arena_alloc(arena, (nResidue + 1) * sizeof(Mutation));
+	scan->nMutation = 0;
+	for (r = 0; r < nResidue; ++ r) {
+		atom = &(pdb->atom[result->molSasa.resSasa[r].atomRef]);
+		strip_char(atom->residueName, residueName);
+		if ((strcmp(residueName, scan->mutant) == 0) || \
+			((strcmp(scan->mutant, "ALA") == 0) && (strcmp(residueName, "GLY") == 0)))
+			continue;
+		if (((entry = find_type(&(ctx->typeHash), type_key(residueName, "CA"))) == 0) || \
+				(entry->atomType < 0))
+			continue;
+		if (arg->scanResidues) {
+			if ((i = listed(arg->scanResidues, atom)) < 0)
+				return POPS_ERR_INPUT;
+			if (i == 0)
+				continue;
+		}
+		scan->mutation[scan->nMutation ++].residue = r;
+	}
+
+	for (i = 0, r = 0; i < pdb->nAtom; ++ i) {
+		r = (i > 0 && view->residueIndex[i] == view->residueIndex[i - 1]) ? r + 1 : 1;
+		if (r > maxResidueAtom)
+			maxResidueAtom = r;
+		if (view->radius[i] > work.maxRadius)
+			work.maxRadius = view->radius[i];
+	}
+
+	if (scan->nMutation == 0)
+		return POPS_OK;
+
+	/* bonded interactions per atom and cell grid of the wild type */
+	pops_init_update(arg, pdb, result, &(work.update));
+
+	/*____________________________________________________________________________*/
+	/* mutations on a thread pool */
+	nThread = (arg->nThread > 0) ? arg->nThread : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThread > scan->nMutation)
+		nThread = scan->nMutation;
+	if (nThread < 1)
+		nThread = 1;
+
+	/* scratch memory is allocated before the threads start:
+		the arena is not shared between threads */
+	st = arena_alloc(arena, nThread * sizeof(ScanThread));
+	for (i = 0; i < nThread; ++ i) {
+		memset(&(st[i]), 0, sizeof(ScanThread));
+		st[i].work = &work;
+		st[i].view = *view;
+		st[i].view.radius = arena_alloc(arena, pdb->nAtom * sizeof(float));
+		st[i].view.parameter = arena_alloc(arena, pdb->nAtom * sizeof(float));
+		st[i].view.polarity = arena_alloc(arena, pdb->nAtom * sizeof(char));
+		memcpy(st[i].view.radius, view->radius, pdb->nAtom * sizeof(float));
+		memcpy(st[i].view.parameter, view->parameter, pdb->nAtom * sizeof(float));
+		memcpy(st[i].view.polarity, view->polarity, pdb->nAtom * sizeof(char));
+		st[i].type.residueType = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		st[i].type.atomType = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		memcpy(st[i].type.residueType, result->type.residueType, pdb->nAtom * sizeof(int));
+		memcpy(st[i].type.atomType, result->type.atomType, pdb->nAtom * sizeof(int));
+		st[i].molSasa.atomSasa = arena_alloc(arena, pdb->nAtom * sizeof(AtomSasa));
+		memcpy(st[i].molSasa.atomSasa, result->molSasa.atomSasa, pdb->nAtom * sizeof(AtomSasa));
+		st[i].deleted = arena_alloc(arena, pdb->nAtom * sizeof(char));
+		st[i].affected = arena_alloc(arena, pdb->nAtom * sizeof(char));
+		memset(st[i].deleted, 0, pdb->nAtom * sizeof(char));
+		memset(st[i].affected, 0, pdb->nAtom * sizeof(char));
+		st[i].affectedAtom = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		st[i].candidate = arena_alloc(arena, pdb->nAtom * sizeof(int));
+		/* grown by 'mutant_interactions' if needed */
+		st[i].allocatedPartner = maxResidueAtom + 1;
+		st[i].partner = safe_malloc(st[i].allocatedPartner * sizeof(int));
+		st[i].allocatedInteraction = work.update.allocatedInteraction + maxResidueAtom;
+		st[i].interaction = safe_malloc(st[i].allocatedInteraction * sizeof(AtomInteraction));
+	}
+
+	work.ret = POPS_OK;
+	pthread_mutex_init(&(work.lock), 0);
+	if (nThread == 1) {
+		scan_thread(&(st[0]));
+	} else {
+		thread = safe_malloc(nThread * sizeof(pthread_t));
+		for (i = 0; i < nThread; ++ i)
+			pthread_create(&(thread[i]), 0, scan_thread, &(st[i]));
+		for (i = 0; i < nThread; ++ i)
+			pthread_join(thread[i], 0);
+		free(thread);
+	}
+	pthread_mutex_destroy(&(work.lock));
+
+	for (i = 0; i < nThread; ++ i) {
+		free(st[i].extra);
+		free(st[i].partner);
+		free(st[i].interaction);
+	}
+	pops_free_update(&(work.update));
+
+	return work.ret;
+}
+
+/*____________________________________________________________________________*/
+/** print the SASA and SFE change of each mutation: '--popsscanOut' or,
+	with '--rout', '<routPrefix>.rpopsScan' in the output directory */
+int pops_print_scan(Arg *arg, Str *pdb, PopsResult *result, PopsScan *scan)
+{
+	char scanOutFileName[1024];
+	unsigned int i;
+	Atom *atom = 0;
+	Mutation *mutation = 0;
+
+	if (arg->rout)
+		snprintf(scanOutFileName, sizeof(scanOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, "rpopsScan");
+	else
+		snprintf(scanOutFileName, sizeof(scanOutFileName), "%s", arg->scanOutFileName);
+
+	if (! arg->silent)
+		fprintf(stdout, "\t%d residues truncated to %s: %s\n",
+			scan->nMutation, scan->mutant, scanOutFileName);
+
+	arg->scanOutFile = safe_open(scanOutFileName, "w");
+
+	if (! arg->noHeaderOut && ! arg->rout)
+		fprintf(arg->scanOutFile, "\n=== %s SCAN: SASA AND SFE CHANGES ===\n",
+			(strcmp(scan->mutant, "GLY") == 0) ? "GLYCINE" : "ALANINE");
+	if (! arg->noHeaderOut || arg->rout)
+		fprintf(arg->scanOutFile, "ResidNe\tChain\tResidNr\tiCode\tMutant\tN(del)"
+			"\tdPhob/A^2\tdPhil/A^2\tdSASA/A^2\tdSFEt/(kJ/mol)\tdSFEg/(kJ/mol)\n");
+
+	for (i = 0; i < scan->nMutation; ++ i) {
+		mutation = &(scan->mutation[i]);
+		atom = &(pdb->atom[result->molSasa.resSasa[mutation->residue].atomRef]);
+		fprintf(arg->scanOutFile, "%8s\t%3s\t%8d\t%1s\t%3s\t%6d\t%10.2f\t%10.2f\t%10.2f\t%10.2f\t%10.2f\n",
+			atom->residueName,
+			chain_identifier(atom),
+			atom->residueNumber,
+			atom->icode,
+			scan->mutant,
+			mutation->nDeleted,
+			mutation->phobicSasa,
+			mutation->philicSasa,
+			mutation->sasa,
+			mutation->sfe_type,
+			mutation->sfe_group);
+	}
+
+	fclose(arg->scanOutFile);
+
+	return POPS_OK;
+}
+
@@ -0,0 +1,57 @@
+/*==============================================================================
+scan.h : in-silico alanine and glycine scanning
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "modstring.h"
+#include "putsasa.h"
+#include "safe.h"
+#include "sasa.h"
+#include "topol.h"
+#include "typehash.h"
+#include "update.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* truncation of one residue to the mutant residue */
+typedef struct {
+	int residue; /* residue index */
+	int nDeleted; /* deleted side-chain atoms */
+	int nAffected; /* atoms with changed SASA */
+	double phobicSasa; /* change of the molecular hydrophobic SASA */
+	double philicSasa; /* change of the molecular hydrophilic SASA */
+	double sasa; /* change of the molecular SASA */
+	double sfe_type; /* change of the molecular SFE, atom type sigmas */
+	double sfe_group; /* change of the molecular SFE, atom group sigmas */
+} Mutation;
+
+/* scan of the residues of a structure; arrays are in the arena of the result */
+typedef struct {
+	char mutant[4]; /* mutant residue name: ALA or GLY */
+	int nMutation;
+	Mutation *mutation;
+} PopsScan;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_scan(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsScan *scan);
+int pops_print_scan(Arg *arg, Str *pdb, PopsResult *result, PopsScan *scan);
+
+#endif
+
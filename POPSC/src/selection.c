@@ -0,0 +1,385 @@
+/*==============================================================================
+selection.c : SASA of selected atoms in their environment
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "selection.h"
+
+/*____________________________________________________________________________*/
+/* The SASA of an atom depends only on the atoms within its non-bonded
+	cutoff, at most twice the largest radius of the parameter table plus
+	twice the probe radius. The region of a selection is the bounding box
+	of the selected atoms, enlarged by that cutoff: the types, the cell
+	grid and the bonded topology are derived for the region atoms only,
+	the non-bonded partners are searched for the selected atoms only, and
+	only the selected atoms are computed with 'compute_sasa_atom', in the
+	order of a full computation and therefore with the same values.
+	Environment atoms contribute overlaps, their own SASA is not computed.
+	A selection is a comma-separated list of chains 'A', residues 'A:12'
+	or residue ranges 'A:10-25' of a chain ('-' for a blank chain
+	identifier) and atoms '@120' or atom ranges '@120-180'. */
+
+/* item of a selection */
+typedef struct {
+	char kind; /* 'c' chain, 'r' residue range, 'a' atom range */
+	char chain;
+	int first;
+	int last;
+} SelectionItem;
+
+/* scratch of the selection */
+typedef struct {
+	SelectionItem *item;
+	int nItem;
+	Atom *atom; /* atoms of the region */
+	int *regionIndex; /* region index of each selected atom */
+	int *partner; /* non-bonded partners of one atom */
+	Str region; /* structure of the region atoms */
+	PopsResult result; /* types, topology and SASA of the region */
+	PopsUpdate update; /* bonded interactions and cell grid of the region */
+} SelectionWork;
+
+/*____________________________________________________________________________*/
+/** items of the selection text; returns their number or -1 */
+static int parse_selection(char *text, SelectionItem **item)
+{
+	char list[1024];
+	char *token = 0;
+	char *save = 0;
+	int nItem = 0;
+	int n;
+	SelectionItem *it = 0;
+
+	if (strlen(text) >= sizeof(list))
+		return -1;
+	strcpy(list, text);
+
+	*item = safe_malloc((strlen(text) / 2 + 2) * sizeof(SelectionItem));
+	for (token = strtok_r(list, ",", &save); token; token = strtok_r(0, ",", &save)) {
+		it = &((*item)[nItem ++]);
+		if (token[0] == '@') {
+			it->kind = 'a';
+			n = sscanf(&(token[1]), "%d-%d", &(it->first), &(it->last));
+		} else if (strlen(token) == 1) {
+			it->kind = 'c';
+			it->chain = token[0];
+			n = 2;
+		} else {
+			it->kind = 'r';
+			n = sscanf(token, "%c:%d-%d", &(it->chain), &(it->first), &(it->last)) - 1;
+		}
+		if (n < 1)
+			return -1;
+		if (n == 1)
+			it->last = it->first;
+	}
+
+	return nItem;
+}
+
+/*____________________________________________________________________________*/
+/** atom in a selection item */
+static int selected(SelectionItem *item, int nItem, Atom *atom)
+{
+	int k;
+	char chain = (atom->chainIdentifier[0] == ' ') ? '-' : atom->chainIdentifier[0];
+
+	for (k = 0; k < nItem; ++ k) {
+		switch (item[k].kind) {
+			case 'a':
+				if ((atom->atomNumber >= item[k].first) && (atom->atomNumber <= item[k].last))
+					return 1;
+				break;
+			case 'c':
+				if (chain == item[k].chain)
+					return 1;
+				break;
+			default:
+				if ((chain == item[k].chain) && \
+					(atom->residueNumber >= item[k].first) && (atom->residueNumber <= item[k].last))
+					return 1;
+				break;
+		}
+	}
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** compare atom indices */
+static int compare_index(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+/*____________________________________________________________________________*/
+/** SASA of the selected atoms in the scratch 'work' */
+static int selection_sasa(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsSelection *selection, SelectionWork *work)
+{
+	unsigned int i;
+	int d, k, a, j, s;
+	int nCandidate, nPartner, nInteraction;
+	int ret;
+	float low[3], high[3], pos[3];
+	float maxRadius = 0.;
+	float cutoff;
+	Arg regionArg = *arg;
+	View *view = &(work->result.view);
+	Topol *topol = &(work->result.topol);
+	MolSasa *molSasa = &(work->result.molSasa);
+	PopsUpdate *update = &(work->update);
+	AtomInteraction *interaction = 0;
+
+	if ((work->nItem = parse_selection(arg->selection, &(work->item))) < 0) {
+		fprintf(stderr, "Invalid selection '%s'\n", arg->selection);
+		return POPS_ERR_INPUT;
+	}
+
+	/*____________________________________________________________________________*/
+	/* selected atoms and their bounding box */
+	selection->atom = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	for (d = 0; d < 3; ++ d) {
+		low[d] = FLT_MAX;
+		high[d] = -FLT_MAX;
+	}
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		if (! selected(work->item, work->nItem, &(pdb->atom[i])))
+			continue;
+		selection->atom[selection->nAtom ++] = i;
+		pos[0] = pdb->atom[i].pos.x; pos[1] = pdb->atom[i].pos.y; pos[2] = pdb->atom[i].pos.z;
+		for (d = 0; d < 3; ++ d) {
+			if (pos[d] < low[d]) low[d] = pos[d];
+			if (pos[d] > high[d]) high[d] = pos[d];
+		}
+	}
+	if (selection->nAtom == 0) {
+		fprintf(stderr, "No atoms selected by '%s'\n", arg->selection);
+		return POPS_ERR_INPUT;
+	}
+
+	/*____________________________________________________________________________*/
+	/* region: atoms within the cutoff of the bounding box */
+	for (i = 0; i < 64; ++ i)
+		for (k = 0; k < 64; ++ k)
+			if (ctx->constant_sasa->atomDataSasa[i][k].radius > maxRadius)
+				maxRadius = ctx->constant_sasa->atomDataSasa[i][k].radius;
+	cutoff = 2. * (maxRadius + arg->rProbe) + 0.01;
+
+	work->atom = safe_malloc((pdb->nAtom + 1) * sizeof(Atom));
+	work->regionIndex = safe_malloc(selection->nAtom * sizeof(int));
+	for (i = 0, s = 0; i < pdb->nAtom; ++ i) {
+		if ((pdb->atom[i].pos.x < low[0] - cutoff) || (pdb->atom[i].pos.x > high[0] + cutoff) ||
+			(pdb->atom[i].pos.y < low[1] - cutoff) || (pdb->atom[i].pos.y > high[1] + cutoff) ||
+			(pdb->atom[i].pos.z < low[2] - cutoff) || (pdb->atom[i].pos.z > high[2] + cutoff))
+			continue;
+		if ((s < selection->nAtom) && (selection->atom[s] == i))
+			work->regionIndex[s ++] = selection->nRegion;
+		work->atom[selection->nRegion ++] = pdb->atom[i];
+	}
+
+	if ((ret = pops_structure(&(work->region), pdb->pdbID, work->atom, selection->nRegion)) != POPS_OK)
+		return ret;
+
+	/*____________________________________________________________________________*/
+	/* types, cell grid and bonded topology of the region */
+	if ((ret = get_types(&(work->region), &(work->result.type), &(ctx->typeHash))) != POPS_OK)
+		return ret;
+	init_view(&(work->region), &(work->result.type), ctx->constant_sasa, view);
+	morton_view(view, arg->rProbe);
+
+	regionArg.silent = 1;
+	init_topology(&regionArg, &(work->region), topol, &(work->result.arena));
+	if ((ret = get_bonded_topology(&(work->region), view, topol, argpdb)) != POPS_OK)
+		return ret;
+
+	init_sasa(&(work->region), view, molSasa, arg, &(work->result.arena));
+	pops_init_update(arg, &(work->region), &(work->result), update);
+	interaction = update->interaction;
+	work->partner = safe_malloc((selection->nRegion + 1) * sizeof(int));
+
+	/*____________________________________________________________________________*/
+	/* SASA of the selected atoms: bonded interactions in the order of
+		'compute_sasa', then the non-bonded partners in ascending order */
+	selection->atomSasa = safe_malloc(selection->nAtom * sizeof(AtomSasa));
+	selection->polarity = safe_malloc(selection->nAtom * sizeof(char));
+	for (s = 0; s < selection->nAtom; ++ s) {
+		a = work->regionIndex[s];
+
+		nInteraction = 0;
+		for (k = update->bondedFirst[a]; k < update->bondedFirst[a + 1]; ++ k)
+			interaction[nInteraction ++] = update->bonded[k];
+
+		nCandidate = update_neighbours(update, a, update->candidate);
+		for (k = 0, nPartner = 0; k < nCandidate; ++ k) {
+			j = update->candidate[k];
+			if ((j != a) && (view_distance(view, a, j) < cutoff_radius(view, a, j, arg->rProbe)) && \
+				! topol_bonded(topol, a, j))
+				work->partner[nPartner ++] = j;
+		}
+		qsort(work->partner, nPartner, sizeof(int), compare_index);
+		assert(nPartner < 1024);
+		for (k = 0; k < nPartner; ++ k) {
+			interaction[nInteraction].partner = work->partner[k];
+			interaction[nInteraction].connect = 5;
+			interaction[nInteraction].first = (a < work->partner[k]);
+			++ nInteraction;
+		}
+
+		if ((ret = compute_sasa_atom(view, &(work->result.type), molSasa, ctx->constant_sasa, \
+				arg->rProbe, a, interaction, nInteraction)) != POPS_OK)
+			return ret;
+
+		selection->atomSasa[s] = molSasa->atomSasa[a];
+		selection->polarity[s] = view->polarity[a];
+		if (view->polarity[a] == 0)
+			selection->phobicSasa += molSasa->atomSasa[a].sasa;
+		else
+			selection->philicSasa += molSasa->atomSasa[a].sasa;
+		selection->sasa += molSasa->atomSasa[a].sasa;
+	}
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** SASA of the atoms selected by '--select', computed from the atoms
+	within the non-bonded cutoff of the selection only */
+int pops_selection(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsSelection *selection)
+{
+	int ret;
+	SelectionWork work;
+
+	memset(selection, 0, sizeof(PopsSelection));
+	memset(&work, 0, sizeof(SelectionWork));
+	pops_init_result(&(work.result));
+
+	ret = selection_sasa(ctx, arg, argpdb, pdb, selection, &work);
+
+	free(work.item);
+	free(work.atom);
+	free(work.regionIndex);
+	free(work.partner);
+	pops_free_update(&(work.update));
+	pops_free_result(&(work.result));
+	pops_free_structure(&(work.region));
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** print the SASA of the selected atoms, their residues and the selection:
+	'--popsselectOut' or, with '--rout', the atom SASAs to
+	'<routPrefix>.rpopsSelect' in the output directory */
+int pops_print_selection(Arg *arg, Str *pdb, PopsSelection *selection)
+{
+	char selectOutFileName[1024];
+	unsigned int s, t;
+	int nResAtom;
+	double phobicSasa, philicSasa;
+	Atom *atom = 0;
+	AtomSasa *atomSasa = 0;
+
+	if (arg->rout)
+		snprintf(selectOutFileName, sizeof(selectOutFileName), "%s/%s.%s",
+			arg->outDirName, arg->routPrefix, "rpopsSelect");
+	else
+		snprintf(selectOutFileName, sizeof(selectOutFileName), "%s", arg->selectOutFileName);
+
+	if (! arg->silent)
+		fprintf(stdout, "\t%d atoms selected, %d atoms in region, %d atoms in structure: %s\n",
+			selection->nAtom, selection->nRegion, pdb->nAtom, selectOutFileName);
+
+	arg->selectOutFile = safe_open(selectOutFileName, "w");
+
+	/*____________________________________________________________________________*/
+	/* atoms */
+	if (! arg->noHeaderOut && ! arg->rout)
+		fprintf(arg->selectOutFile, "\n=== SELECTION ATOM SASAs ===\n");
+	if (! arg->noHeaderOut || arg->rout)
+		fprintf(arg->selectOutFile, "AtomNr\tAtomNe\tResidNe\tChain\tResidNr\tiCode"
+			"\tSASA/A^2\tQ(SASA)\tN(overl)\tSurf/A^2\n");
+
+	for (s = 0; s < selection->nAtom; ++ s) {
+		atom = &(pdb->atom[selection->atom[s]]);
+		atomSasa = &(selection->atomSasa[s]);
+		fprintf(arg->selectOutFile, "%8d\t%3s\t%3s\t%1s\t%6d\t%1s\t%10.2f\t%10.4f\t%8d\t%10.2f\n",
+			atom->atomNumber,
+			atom->atomName,
+			atom->residueName,
+			chain_identifier(atom),
+			atom->residueNumber,
+			atom->icode,
+			atomSasa->sasa,
+			(atomSasa->surface > 0.) ? atomSasa->sasa / atomSasa->surface : NAN,
+			atomSasa->nOverlap,
+			atomSasa->surface);
+	}
+
+	if (arg->rout) {
+		fclose(arg->selectOutFile);
+		return POPS_OK;
+	}
+
+	/*____________________________________________________________________________*/
+	/* residues of the selected atoms */
+	if (! arg->noHeaderOut)
+		fprintf(arg->selectOutFile, "\n=== SELECTION RESIDUE SASAs ===\n"
+			"ResidNe\tChain\tResidNr\tiCode\tPhob/A^2\tPhil/A^2\tSASA/A^2\tN(atom)\n");
+
+	for (s = 0; s < selection->nAtom; s = t) {
+		atom = &(pdb->atom[selection->atom[s]]);
+		phobicSasa = philicSasa = 0.;
+		for (t = s, nResAtom = 0; t < selection->nAtom; ++ t, ++ nResAtom) {
+			if ((pdb->atom[selection->atom[t]].residueNumber != atom->residueNumber) || \
+				(strcmp(pdb->atom[selection->atom[t]].icode, atom->icode) != 0) || \
+				(pdb->atom[selection->atom[t]].chainIdentifier[0] != atom->chainIdentifier[0]))
+				break;
+			if (selection->polarity[t] == 0)
+				phobicSasa += selection->atomSasa[t].sasa;
+			else
+				philicSasa += selection->atomSasa[t].sasa;
+		}
+		fprintf(arg->selectOutFile, "%8s\t%3s\t%8d\t%1s\t%10.2f\t%10.2f\t%10.2f\t%8d\n",
+			atom->residueName,
+			chain_identifier(atom),
+			atom->residueNumber,
+			atom->icode,
+			phobicSasa,
+			philicSasa,
+			phobicSasa + philicSasa,
+			nResAtom);
+	}
+
+	/*____________________________________________________________________________*/
+	/* selection */
+	if (! arg->noHeaderOut)
+		fprintf(arg->selectOutFile, "\n=== SELECTION SASA ===\n"
+			"Phob/A^2\tPhil/A^2\tSASA/A^2\tN(atom)\tN(region)\n");
+	fprintf(arg->selectOutFile, "%10.2f\t%10.2f\t%10.2f\t%8d\t%8d\n",
+		selection->phobicSasa,
+		selection->philicSasa,
+		selection->sasa,
+		selection->nAtom,
+		selection->nRegion);
+
+	fclose(arg->selectOutFile);
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** free selection */
+void pops_free_selection(PopsSelection *selection)
+{
+	free(selection->atom);
+	free(selection->atomSasa);
+	free(selection->polarity);
+	selection->atom = 0;
+	selection->atomSasa = 0;
+	selection->polarity = 0;
+}
+
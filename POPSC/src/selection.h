@@ -0,0 +1,51 @@
+/*==============================================================================
+selection.h : SASA of selected atoms in their environment
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "putsasa.h"
+#include "safe.h"
+#include "sasa.h"
+#include "topol.h"
+#include "type.h"
+#include "update.h"
+#include "view.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* SASA of the selected atoms */
+typedef struct {
+	int nAtom; /* selected atoms */
+	int nRegion; /* atoms of the region: selection and environment */
+	int *atom; /* structure index of each selected atom */
+	AtomSasa *atomSasa; /* SASA of each selected atom */
+	char *polarity; /* hydrophobic = 0, hydrophilic = 1 */
+	double phobicSasa; /* hydrophobic SASA of the selection */
+	double philicSasa; /* hydrophilic SASA of the selection */
+	double sasa; /* SASA of the selection */
+} PopsSelection;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int pops_selection(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsSelection *selection);
+int pops_print_selection(Arg *arg, Str *pdb, PopsSelection *selection);
+void pops_free_selection(PopsSelection *selection);
+
+#endif
+
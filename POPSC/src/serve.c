@@ -0,0 +1,403 @@
+/*==============================================================================
+serve.c : persistent server mode on a Unix socket
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+/* The server keeps the parameter tables of the atomic and coarse-grained
+	models resident and answers requests on a Unix socket. Each client
+	connection is served by its own thread, which reuses the arena of its
+	result for one request after the other; requests of different
+	connections run concurrently.
+	Requests and responses are JSON objects, one per line:
+	request: {"id": ..., "path": "<structure file>", "format": "pdb|pdbml|mmcif",
+		"atoms": [{"atom": "CA", "residue": "ALA", "chain": "A",
+			"number": 1, "x": 0., "y": 0., "z": 0.}, ...],
+		"coarse": false, "hydrogens": false, "partOcc": false,
+		"multiModel": false, "rProbe": 1.4,
+		"level": "molecule|chain|residue|atom"}
+	with either 'path' or 'atoms'; 'format' defaults to the file extension,
+	'level' to "residue", the options to those of the command line.
+	response: {"id": ..., "status": "ok", "pdbID": ..., "molecule": {...},
+		"chains": [...], "residues": [...], "atoms": [...]}
+	or {"id": ..., "status": "error", "error": "<message>"}.
+	{"command": "quit"} closes the connection,
+	{"command": "shutdown"} stops the server. */
+
+#include "serve.h"
+
+/*____________________________________________________________________________*/
+/* socket file, removed on termination */
+static char *socketFileName = 0;
+
+/*____________________________________________________________________________*/
+/** remove socket file on termination signal */
+static void terminate_server(int sig)
+{
+	if (socketFileName)
+		unlink(socketFileName);
+	_exit(0);
+}
+
+/*____________________________________________________________________________*/
+/** boolean request option, 'value' if absent */
+__inline__ static int request_bool(cJSON *request, char *name, int value)
+{
+	cJSON *item = cJSON_GetObjectItemCaseSensitive(request, name);
+
+	return cJSON_IsBool(item) ? cJSON_IsTrue(item) : value;
+}
+
+/*____________________________________________________________________________*/
+/** string value of object item, 'value' if absent */
+__inline__ static char *item_string(cJSON *object, char *name, char *value)
+{
+	cJSON *item = cJSON_GetObjectItemCaseSensitive(object, name);
+
+	return cJSON_IsString(item) ? item->valuestring : value;
+}
+
+/*____________________________________________________________________________*/
+/** number value of object item, 'value' if absent */
+__inline__ static double item_number(cJSON *object, char *name, double value)
+{
+	cJSON *item = cJSON_GetObjectItemCaseSensitive(object, name);
+
+	return cJSON_IsNumber(item) ? item->valuedouble : value;
+}
+
+/*____________________________________________________________________________*/
+/** structure from inline atoms of request */
+static int request_atoms(cJSON *atoms, Str *pdb)
+{
+	int nAtom = cJSON_GetArraySize(atoms);
+	int i = 0;
+	int ret;
+	Atom *atom = 0;
+	cJSON *item = 0;
+
+	if (nAtom < 1)
+		return POPS_ERR_INPUT;
+
+	atom = safe_malloc(nAtom * sizeof(Atom));
+	memset(atom, 0, nAtom * sizeof(Atom));
+
+	cJSON_ArrayForEach(item, atoms) {
+		strcpy(atom[i].recordName, "ATOM");
+		strncpy(atom[i].atomName, item_string(item, "atom", ""), sizeof(atom[i].atomName) - 1);
+		strncpy(atom[i].residueName, item_string(item, "residue", ""), sizeof(atom[i].residueName) - 1);
+		/* single-character chain identifier, as read from PDB input */
+		atom[i].chainIdentifier[0] = item_string(item, "chain", " ")[0];
+		atom[i].chainIdentifier[1] = '\0';
+		atom[i].residueNumber = (int)item_number(item, "number", 0);
+		atom[i].atomNumber = i + 1;
+		atom[i].pos.x = (float)item_number(item, "x", 0.);
+		atom[i].pos.y = (float)item_number(item, "y", 0.);
+		atom[i].pos.z = (float)item_number(item, "z", 0.);
+		atom[i].occupancy = 1.;
+		atom[i].modelNumber = 1;
+		++ i;
+	}
+
+	ret = pops_structure(pdb, "inline", atom, nAtom);
+	free(atom);
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** SASA and SFE of result at levels up to 'level'
+	(0 molecule, 1 chain, 2 residue, 3 atom) */
+static void result_json(cJSON *response, Str *pdb, PopsResult *result, int level, int coarse)
+{
+	unsigned int i;
+	Atom *atom = 0;
+	MolSasa *molSasa = &(result->molSasa);
+	cJSON *molecule = cJSON_AddObjectToObject(response, "molecule");
+	cJSON *array = 0;
+	cJSON *item = 0;
+
+	cJSON_AddStringToObject(response, "pdbID", pdb->pdbID);
+
+	/* molecule */
+	cJSON_AddNumberToObject(molecule, "sasa", molSasa->sasa);
+	cJSON_AddNumberToObject(molecule, "phobicSasa", molSasa->phobicSasa);
+	cJSON_AddNumberToObject(molecule, "philicSasa", molSasa->philicSasa);
+	if (! coarse) {
+		cJSON_AddNumberToObject(molecule, "sfeType", result->molSFE.sfe_type);
+		cJSON_AddNumberToObject(molecule, "sfeGroup", result->molSFE.sfe_group);
+	}
+
+	/* chains */
+	if (level >= 1) {
+		array = cJSON_AddArrayToObject(response, "chains");
+		for (i = 0; i < pdb->nChain; ++ i) {
+			item = cJSON_CreateObject();
+			cJSON_AddItemToArray(array, item);
+			cJSON_AddStringToObject(item, "chain", pdb->atom[molSasa->chainSasa[i].first].chainIdentifier);
+			cJSON_AddNumberToObject(item, "sasa", molSasa->chainSasa[i].sasa);
+			cJSON_AddNumberToObject(item, "phobicSasa", molSasa->chainSasa[i].phobicSasa);
+			cJSON_AddNumberToObject(item, "philicSasa", molSasa->chainSasa[i].philicSasa);
+		}
+	}
+
+	/* residues */
+	if (level >= 2) {
+		array = cJSON_AddArrayToObject(response, "residues");
+		for (i = 0; i < pdb->nAllResidue; ++ i) {
+			atom = &(pdb->atom[molSasa->resSasa[i].atomRef]);
+			item = cJSON_CreateObject();
+			cJSON_AddItemToArray(array, item);
+			cJSON_AddStringToObject(item, "chain", atom->chainIdentifier);
+			cJSON_AddStringToObject(item, "residue", atom->residueName);
+			cJSON_AddNumberToObject(item, "number", atom->residueNumber);
+			cJSON_AddStringToObject(item, "icode", atom->icode);
+			cJSON_AddNumberToObject(item, "sasa", molSasa->resSasa[i].sasa);
+			cJSON_AddNumberToObject(item, "phobicSasa", molSasa->resSasa[i].phobicSasa);
+			cJSON_AddNumberToObject(item, "philicSasa", molSasa->resSasa[i].philicSasa);
+			cJSON_AddNumberToObject(item, "surface", molSasa->resSasa[i].surface);
+		}
+	}
+
+	/* atoms: not in the coarse-grained model, as in the atom output */
+	if ((level >= 3) && ! coarse) {
+		array = cJSON_AddArrayToObject(response, "atoms");
+		for (i = 0; i < pdb->nAtom; ++ i) {
+			atom = &(pdb->atom[i]);
+			item = cJSON_CreateObject();
+			cJSON_AddItemToArray(array, item);
+			cJSON_AddNumberToObject(item, "number", atom->atomNumber);
+			cJSON_AddStringToObject(item, "atom", atom->atomName);
+			cJSON_AddStringToObject(item, "residue", atom->residueName);
+			cJSON_AddStringToObject(item, "chain", atom->chainIdentifier);
+			cJSON_AddNumberToObject(item, "residueNumber", atom->residueNumber);
+			cJSON_AddNumberToObject(item, "sasa", molSasa->atomSasa[i].sasa);
+			cJSON_AddNumberToObject(item, "surface", molSasa->atomSasa[i].surface);
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+/** compute request with its own copy of the options; returns response */
+static cJSON *compute_request(Server *server, cJSON *request, PopsResult *result)
+{
+	Arg arg = *(server->arg);
+	Argpdb argpdb = *(server->argpdb);
+	Str pdb;
+	Pack pack = {0, 0, 0, 0, 0, 0};
+	cJSON *response = cJSON_CreateObject();
+	cJSON *atoms = cJSON_GetObjectItemCaseSensitive(request, "atoms");
+	char *path = item_string(request, "path", 0);
+	char *format = item_string(request, "format", 0);
+	char *level = item_string(request, "level", "residue");
+	char *id = 0;
+	int inFormat, zipped;
+	int ret = POPS_OK;
+	int nLevel;
+
+	if (cJSON_GetObjectItemCaseSensitive(request, "id"))
+		cJSON_AddItemToObject(response, "id",
+			cJSON_Duplicate(cJSON_GetObjectItemCaseSensitive(request, "id"), 1));
+
+	/*____________________________________________________________________________*/
+	/* options; connections run concurrently, each on one thread */
+	arg.silent = 1;
+	arg.nThread = 1;
+	argpdb.coarse = request_bool(request, "coarse", argpdb.coarse);
+	argpdb.hydrogens = request_bool(request, "hydrogens", argpdb.hydrogens);
+	argpdb.partOcc = request_bool(request, "partOcc", argpdb.partOcc);
+	argpdb.multiModel = request_bool(request, "multiModel", argpdb.multiModel);
+	arg.rProbe = (float)item_number(request, "rProbe", arg.rProbe);
+
+	if (strcmp(level, "molecule") == 0)
+		nLevel = 0;
+	else if (strcmp(level, "chain") == 0)
+		nLevel = 1;
+	else if (strcmp(level, "atom") == 0)
+		nLevel = 3;
+	else
+		nLevel = 2;
+
+	if (arg.rProbe <= 0.) {
+		cJSON_AddStringToObject(response, "status", "error");
+		cJSON_AddStringToObject(response, "error", "invalid probe radius");
+		return response;
+	}
+
+	/*____________________________________________________________________________*/
+	/* structure: input file or inline atoms */
+	strcpy(pdb.pdbID, "");
+	if (path) {
+		inFormat = pops_input_format(path, &id, &zipped);
+		if (format)
+			inFormat = (strcmp(format, "pdb") == 0) ? 0 :
+				(strcmp(format, "pdbml") == 0) ? 1 :
+				(strcmp(format, "mmcif") == 0) ? 2 : -1;
+		arg.pdbIn = id;
+		if ((ret = pops_set_input(&arg, path, inFormat, zipped)) == POPS_OK) {
+			if (arg.packDirName && (load_pack(&arg, &argpdb, &pack, &pdb, &(result->type)) == 0)) {
+				/* parsed and typed structure plus bonded topology from pack */
+			} else {
+				ret = pops_read(&arg, &argpdb, &pdb);
+			}
+		}
+		if ((ret == POPS_OK) && (strlen(pdb.pdbID) == 0))
+			snprintf(pdb.pdbID, sizeof(pdb.pdbID), "%s", id);
+	} else if (cJSON_IsArray(atoms)) {
+		arg.mmcif = arg.pdb = arg.pdbml = 0;
+		ret = request_atoms(atoms, &pdb);
+	} else {
+		ret = POPS_ERR_INPUT;
+	}
+
+	/*____________________________________________________________________________*/
+	/* compute */
+	if (ret == POPS_OK) {
+		/* inline atoms have no input file to key a pack */
+		if ((ret = pops_compute(&(server->ctx[argpdb.coarse]), &arg, &argpdb, &pdb, \
+				path ? &pack : 0, result)) == POPS_OK) {
+			cJSON_AddStringToObject(response, "status", "ok");
+			result_json(response, &pdb, result, nLevel, argpdb.coarse);
+		}
+		if (path)
+			pops_free_input(&arg, &pdb, &pack, result);
+		else
+			pops_free_structure(&pdb);
+	} else {
+		free_pack(&pack);
+	}
+
+	if (ret != POPS_OK) {
+		cJSON_AddStringToObject(response, "status", "error");
+		cJSON_AddStringToObject(response, "error", pops_strerror(ret));
+	}
+
+	free(id);
+
+	return response;
+}
+
+/*____________________________________________________________________________*/
+/** connection thread: answer requests until the client closes */
+static void *serve_connection(void *connectionArg)
+{
+	Connection *connection = (Connection *)connectionArg;
+	Server *server = connection->server;
+	FILE *in = fdopen(connection->fd, "r");
+	FILE *out = fdopen(dup(connection->fd), "w");
+	PopsResult result;
+	cJSON *request = 0;
+	cJSON *response = 0;
+	char *line = 0;
+	char *command = 0;
+	char *responseString = 0;
+	size_t lineSize = 0;
+
+	pops_init_result(&result);
+
+	while (in && out && (getline(&line, &lineSize, in) > 0)) {
+		if ((request = cJSON_Parse(line)) == 0) {
+			response = cJSON_CreateObject();
+			cJSON_AddStringToObject(response, "status", "error");
+			cJSON_AddStringToObject(response, "error", "invalid JSON request");
+		} else if ((command = item_string(request, "command", 0)) != 0) {
+			if (strcmp(command, "shutdown") == 0)
+				shutdown(server->listenFd, SHUT_RDWR);
+			cJSON_Delete(request);
+			break;
+		} else {
+			response = compute_request(server, request, &result);
+			cJSON_Delete(request);
+		}
+
+		responseString = cJSON_PrintUnformatted(response);
+		fprintf(out, "%s\n", responseString);
+		fflush(out);
+		free(responseString);
+		cJSON_Delete(response);
+	}
+
+	pops_free_result(&result);
+	free(line);
+	if (in) fclose(in); else close(connection->fd);
+	if (out) fclose(out);
+	free(connection);
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** serve requests on the Unix socket 'arg->serveName' until shutdown */
+int run_server(Arg *arg, Argpdb *argpdb)
+{
+	Server server;
+	Connection *connection = 0;
+	struct sockaddr_un address;
+	pthread_t thread;
+	pthread_attr_t threadAttr;
+	int fd;
+
+	server.arg = arg;
+	server.argpdb = argpdb;
+
+	/*____________________________________________________________________________*/
+	/* resident parameter tables of both models */
+	if ((pops_init(&(server.ctx[0]), 0) != POPS_OK) ||
+		(pops_init(&(server.ctx[1]), 1) != POPS_OK))
+		return 1;
+
+	/*____________________________________________________________________________*/
+	/* socket */
+	if (strlen(arg->serveName) >= sizeof(address.sun_path)) {
+		ErrorSpecNoexit("Socket name too long", arg->serveName);
+		return 1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, arg->serveName);
+
+	if (((server.listenFd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) ||
+		(bind(server.listenFd, (struct sockaddr *)&address, sizeof(address)) != 0) ||
+		(listen(server.listenFd, 64) != 0)) {
+		ErrorSpecNoexit("Cannot listen on socket", arg->serveName);
+		return 1;
+	}
+
+	socketFileName = arg->serveName;
+	signal(SIGINT, terminate_server);
+	signal(SIGTERM, terminate_server);
+	/* a client closing early must not terminate the server */
+	signal(SIGPIPE, SIG_IGN);
+
+	if (! arg->silent)
+		fprintf(stdout, "Serving on socket %s\n", arg->serveName);
+	fflush(stdout);
+
+	/*____________________________________________________________________________*/
+	/* one detached thread per connection */
+	pthread_attr_init(&threadAttr);
+	pthread_attr_setdetachstate(&threadAttr, PTHREAD_CREATE_DETACHED);
+
+	while ((fd = accept(server.listenFd, 0, 0)) >= 0 || errno == EINTR) {
+		if (fd < 0)
+			continue;
+		connection = safe_malloc(sizeof(Connection));
+		connection->server = &server;
+		connection->fd = fd;
+		if (pthread_create(&thread, &threadAttr, serve_connection, connection) != 0) {
+			close(fd);
+			free(connection);
+		}
+	}
+
+	/*____________________________________________________________________________*/
+	/* shutdown: connections still open are closed at program termination,
+		therefore the parameter tables are not freed */
+	pthread_attr_destroy(&threadAttr);
+	close(server.listenFd);
+	unlink(arg->serveName);
+	socketFileName = 0;
+
+	return 0;
+}
+
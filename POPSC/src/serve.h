@@ -0,0 +1,50 @@
+/*==============================================================================
+serve.h : persistent server mode on a Unix socket
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef SERVE_H
+#define SERVE_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "arg.h"
+#include "argpdb.h"
+#include "cJSON.h"
+#include "error.h"
+#include "libpops.h"
+#include "pack.h"
+#include "safe.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* server shared by all connections */
+typedef struct {
+	PopsContext ctx[2]; /* parameter tables: atomic, coarse-grained */
+	Arg *arg; /* options, copied per request */
+	Argpdb *argpdb;
+	int listenFd; /* listening socket */
+} Server;
+
+/* connection of one client */
+typedef struct {
+	Server *server;
+	int fd;
+} Connection;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int run_server(Arg *arg, Argpdb *argpdb);
+
+#endif
+
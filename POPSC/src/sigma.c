@@ -10,13 +10,14 @@ Read the COPYING file for license information.
 
 /*___________________________________________________________________________*/
 /** initialise all SFEs */
-int init_sfe(Str *pdb, Type *type, MolSFE *molSFE, ConstantSigma *constant_sigma, Arg *arg)
+int init_sfe(Str *pdb, Type *type, MolSFE *molSFE, ConstantSigma *constant_sigma, Arg *arg, Arena *arena)
 {
 	unsigned int i;
 
-	molSFE->atomSFE = safe_malloc(pdb->nAtom * sizeof(AtomSFE));
-	molSFE->resSFE = safe_malloc(pdb->nAllResidue * sizeof(ResSFE));
-	molSFE->chainSFE = safe_malloc(pdb->nChain * sizeof(ChainSFE));
+	/* released by resetting the arena */
+	molSFE->atomSFE = arena_alloc(arena, pdb->nAtom * sizeof(AtomSFE));
+	molSFE->resSFE = arena_alloc(arena, pdb->nAllResidue * sizeof(ResSFE));
+	molSFE->chainSFE = arena_alloc(arena, pdb->nChain * sizeof(ChainSFE));
 
 	for (i = 0; i < pdb->nAtom; ++ i) {
 		/*___________________________________________________________________________*/
@@ -72,15 +73,6 @@ int init_sfe(Str *pdb, Type *type, MolSFE *molSFE, ConstantSigma *constant_sigma
 	return 0;
 }
 
-/*___________________________________________________________________________*/
-/** free SFEs */
-void free_sfe(MolSFE *molSFE)
-{
-	free(molSFE->atomSFE); /* atoms */
-	free(molSFE->resSFE); /* residues */
-	free(molSFE->chainSFE); /* chains */
-}
-
 /*___________________________________________________________________________*/
 /** atomic SFE calculation */
 /* scale SASA from Angstrom to nm (factor 1/100) */
@@ -101,7 +93,7 @@ static int compute_atom_sfe(Str *pdb, Type *type, MolSasa *molSasa,\
 
 /*___________________________________________________________________________*/
 /** residuic and molecular SFE calculation */
-static int compute_res_chain_mol_sfe(Str *pdb, Type *type, MolSFE *molSFE)
+static int compute_res_chain_mol_sfe(Str *pdb, View *view, MolSFE *molSFE)
 {
     unsigned int i, j, k;
 
@@ -121,15 +113,14 @@ static int compute_res_chain_mol_sfe(Str *pdb, Type *type, MolSFE *molSFE)
 		/*___________________________________________________________________________*/
 		/* increment residue index */
 		/* first atom of each residue is reference for residue type */
-		if (i > 0 && (pdb->atom[i].residueNumber != pdb->atom[i - 1].residueNumber || 
-					 strcmp(pdb->atom[i].icode, pdb->atom[i - 1].icode) != 0)) {
+		if (i > 0 && view->residueIndex[i] != view->residueIndex[i - 1]) {
 			++ j; /* increment residue index */
 			molSFE->resSFE[j].atomRef = i; /* assign atom reference */
 		}
 
 		/*___________________________________________________________________________*/
 		/* increment chain index */
-        if (i > 0 && pdb->atom[i].chainIdentifier[0] != pdb->atom[i - 1].chainIdentifier[0]) {
+        if (i > 0 && view->chainIndex[i] != view->chainIndex[i - 1]) {
 			++ k;
 			molSFE->chainSFE[k-1].last = i-1;
 			molSFE->chainSFE[k].first = i;
@@ -154,10 +145,10 @@ static int compute_res_chain_mol_sfe(Str *pdb, Type *type, MolSFE *molSFE)
 
 /*___________________________________________________________________________*/
 /** compute SFEs */
-void compute_sfe(Str *pdb, Type *type, MolSasa *molSasa, \
+void compute_sfe(Str *pdb, View *view, Type *type, MolSasa *molSasa, \
 	MolSFE *molSFE, ConstantSigma *constant_sigma, Arg *arg)
 {
 	compute_atom_sfe(pdb, type, molSasa, molSFE, constant_sigma, arg); /* compute SFE per atom */
-	compute_res_chain_mol_sfe(pdb, type, molSFE); /* sum up atom SFEs */
+	compute_res_chain_mol_sfe(pdb, view, molSFE); /* sum up atom SFEs */
 }
 
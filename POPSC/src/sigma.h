@@ -57,8 +57,7 @@ typedef struct
 
 /*___________________________________________________________________________*/
 /* prototypes */
-int init_sfe(Str *pdb, Type *type, MolSFE *molSigma, ConstantSigma *constant_sigma, Arg *arg);
-void free_sfe(MolSFE *molSFE);
-void compute_sfe(Str *pdb, Type *type, MolSasa *molSasa, MolSFE *molSFE, ConstantSigma *constant_sigma, Arg *arg);
+int init_sfe(Str *pdb, Type *type, MolSFE *molSigma, ConstantSigma *constant_sigma, Arg *arg, Arena *arena);
+void compute_sfe(Str *pdb, View *view, Type *type, MolSasa *molSasa, MolSFE *molSFE, ConstantSigma *constant_sigma, Arg *arg);
 
 #endif
@@ -41,50 +41,27 @@ __inline__ static void print_torsion(Str *pdb, int t1, int t2, int t3, int t4)
 }
 
 /*___________________________________________________________________________*/
-/** init topology */
-void init_topology(Arg *arg, Str *pdb, Topol *topol)
+/** init topology; all topology arrays are allocated in 'arena',
+	which the caller resets after the structure or frame */
+void init_topology(Arg *arg, Str *pdb, Topol *topol, Arena *arena)
 {
-	unsigned int i, j;
-	int *nCA = NULL;
-	char *chain1 = NULL;
+	unsigned int i;
+
+	topol->arena = arena;
 	/* assuming an upper limit of 63 bonded interactions per atom */
-	topol->bondState = alloc_mat2D_int(topol->bondState, pdb->nAtom, 64);
+	topol->bondState = arena_mat2D(arena, pdb->nAtom, 64, sizeof(int));
 	/* assuming an upper limit of 255 non-bonded interactions per atom */
-	topol->neighbourState = alloc_mat2D_int(topol->neighbourState, pdb->nAtom, 1024);
+	topol->neighbourState = arena_mat2D(arena, pdb->nAtom, 1024, sizeof(int));
 	/* assuming an upper limit of 255 neighbours per atom */
-	topol->neighbourPar = alloc_mat2D_float(topol->neighbourPar, pdb->nAtom, 1024);
+	topol->neighbourPar = arena_mat2D(arena, pdb->nAtom, 1024, sizeof(float));
 
 	/* maximally one interface nearest neighbour per atom */
-	topol->interfaceNn = safe_malloc(pdb->nAtom * sizeof(int));
-	topol->interfaceNnDist = safe_malloc(pdb->nAtom * sizeof(float));
-
-	/* between-chain or between domain Calpha distance matrix */
-	/* determine number of Calpha atoms per chain or domain */
-	nCA = &(topol->nCA1);
-	for (i = 0, topol->nCA1 = 0, topol->nCA2 = 0; i < pdb->nAtom; ++ i) {
-		if (strcmp(pdb->atom[i].atomName, "CA") == 0) {
-			if ((*nCA) == 0) {
-				chain1 = &(pdb->atom[i].chainIdentifier[0]);
-			}
-			if ((*nCA) > 0 && strcmp(pdb->atom[i].chainIdentifier, chain1) != 0) {
-				nCA = &(topol->nCA2);
-			}			
-			++ (*nCA);
-		}
-	}
-	printf("CA distance matrix has dimensions %d x %d \n", topol->nCA1, topol->nCA2);
-	/* allocate Calpha distance matrix */
-	topol->distMatCA = alloc_mat2D_float(topol->distMatCA, topol->nCA1, topol->nCA2);
-	init_mat2D_float(topol->distMatCA, topol->nCA1, topol->nCA2, 0.);
-	/* array of residue numbers for each chain */
-	topol->resCA1 = safe_malloc(topol->nCA1 * sizeof(int));
-	for (i = 0; i < topol->nCA1; ++ i) {
-		topol->resCA1[i] = -999;
-	}
-	topol->resCA2 = safe_malloc(topol->nCA2 * sizeof(int));
-	for (j = 0; j < topol->nCA2; ++ j) {
-		topol->resCA2[j] = -999;
-	}
+	topol->interfaceNn = arena_alloc(arena, pdb->nAtom * sizeof(int));
+	topol->interfaceNnDist = arena_alloc(arena, pdb->nAtom * sizeof(float));
+
+	/* sparse between-chain Calpha distances, set by 'calpha_distances' */
+	topol->nCAPair = 0;
+	topol->caPair = 0;
 
 	for (i = 0; i < pdb->nAtom; ++ i) {
 		topol->bondState[i][0] = 0; /* no bonded pairs recorded */
@@ -95,35 +72,6 @@ void init_topology(Arg *arg, Str *pdb, Topol *topol)
 	}
 }
 
-/*___________________________________________________________________________*/
-/** free topology */
-void free_topology(Str *pdb, Topol *topol)
-{
-	int dimMat2D = pdb->nAtom;
-
-	/* topol */
-	free(topol->ib); /* bond */
-	free(topol->jb);
-	free(topol->it); /* angle */
-	free(topol->jt);
-	free(topol->kt);
-	free(topol->ip); /* torsion */
-	free(topol->jp);
-	free(topol->kp);
-	free(topol->lp);
-	free(topol->in); /* non-bonded */
-	free(topol->jn);
-
-	free_mat2D_int(topol->bondState, dimMat2D); /* bond status of atom pairs */
-	free_mat2D_int(topol->neighbourState, dimMat2D); /* neighbour status of atom pairs */
-	free_mat2D_float(topol->neighbourPar, dimMat2D); /* POPS parameters of neighbours */
-	free(topol->interfaceNn);
-	free(topol->interfaceNnDist);
-	free_mat2D_float(topol->distMatCA, topol->nCA1);
-	free(topol->resCA1);
-	free(topol->resCA2);
-}
-
 /*___________________________________________________________________________*/
 /** print bond state */
 void print_bondState(Str *pdb, Topol *topol)
@@ -149,11 +97,9 @@ float atom_distance(Str *pdb, int i, int j)
 
 /*____________________________________________________________________________*/
 /** cutoff radius for non-bonded interaction */
-float cutoff_radius(Type *type, ConstantSasa *constant_sasa, int i, int j, float rSolvent)
+float cutoff_radius(View *view, int i, int j, float rSolvent)
 {
-	return (constant_sasa[0].atomDataSasa[type->residueType[i]][type->atomType[i]].radius + \
-		    constant_sasa[0].atomDataSasa[type->residueType[j]][type->atomType[j]].radius + \
-			(2. * rSolvent));
+	return (view->radius[i] + view->radius[j] + (2. * rSolvent));
 }
 
 /*____________________________________________________________________________*/
@@ -176,18 +122,19 @@ __inline__ static int get_bondState(Topol *topol, int i, int j)
 
 /*____________________________________________________________________________*/
 /** calculate bonds */
-int get_bonds(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, Argpdb *argpdb)
+int get_bonds(Str *pdb, View *view, Topol *topol, Argpdb *argpdb)
 {
-	unsigned int allocated = 64;
+	unsigned int allocated = (topol->allocatedBond > 64) ? topol->allocatedBond : 64;
 	float atomDistance; /*atom distance */
 	float cutoffRadius; /* cutoff radius for bonded state */
 	float cutoffFactor; /* pre-factor for cutoff radius calculation */
 
 	/*___________________________________________________________________________*/
-	unsigned int i, j;
+	unsigned int i, j, k;
+	int nCandidate;
 	/* allocate memory */
-	topol->ib = safe_malloc(allocated * sizeof(int));
-	topol->jb = safe_malloc(allocated * sizeof(int));
+	topol->ib = arena_alloc(topol->arena, allocated * sizeof(int));
+	topol->jb = arena_alloc(topol->arena, allocated * sizeof(int));
 	topol->nBond = 0;
 
 	/* for all pairwise atom combinations */
@@ -197,19 +144,20 @@ int get_bonds(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, A
 			cutoffFactor = 0.7;
 		else
 			cutoffFactor = 0.5;
-		for (j = i + 1; j < pdb->nAtom; ++ j) {
+		/* all following atoms or the spatial neighbours from the cell grid */
+		nCandidate = view->order ? view_neighbours(view, i) : (pdb->nAtom - i - 1);
+		for (k = 0; k < nCandidate; ++ k) {
+			j = view->order ? view->candidate[k] : (i + 1 + k);
 
 			/* if atoms i,j in the same or proximate residue */
-			if (((pdb->atom[j].residueNumber == pdb->atom[i].residueNumber) || \
-				(pdb->atom[j].residueNumber == pdb->atom[i].residueNumber + 1)) && \
-				 strcmp(pdb->atom[j].chainIdentifier, pdb->atom[i].chainIdentifier) == 0) {
+			if (((view->residueNumber[j] == view->residueNumber[i]) || \
+				(view->residueNumber[j] == view->residueNumber[i] + 1)) && \
+				 view->chainId[j] == view->chainId[i]) {
 
 				/* add bond if atom distance shorter than cutoff */
 				/* atoms bonded if dist =< 0.5 * (atomRadius_i + atomRadius_j) */
-				atomDistance = atom_distance(pdb, i, j);
-				cutoffRadius = (cutoffFactor * \
-								(constant_sasa[0].atomDataSasa[type->residueType[i]][type->atomType[i]].radius + \
-					             constant_sasa[0].atomDataSasa[type->residueType[j]][type->atomType[j]].radius));
+				atomDistance = view_distance(view, i, j);
+				cutoffRadius = (cutoffFactor * (view->radius[i] + view->radius[j]));
 
 				if (atomDistance < cutoffRadius) {
 					/* assign arrays of bonded atoms ib-jb */
@@ -232,9 +180,9 @@ int get_bonds(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, A
 
 					/* add memory if needed */ 
 					if (topol->nBond == allocated) {
-						allocated += 64;
-						topol->ib = safe_realloc(topol->ib, allocated * sizeof(int));
-						topol->jb = safe_realloc(topol->jb, allocated * sizeof(int));
+						allocated *= 2;
+						topol->ib = arena_grow(topol->arena, topol->ib, topol->nBond * sizeof(int), allocated * sizeof(int));
+						topol->jb = arena_grow(topol->arena, topol->jb, topol->nBond * sizeof(int), allocated * sizeof(int));
 					}
 
 					/* warn if atoms too close */
@@ -244,6 +192,8 @@ int get_bonds(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, A
 			}
         }
     }
+	topol->allocatedBond = allocated;
+
 	return(0);
 }
 
@@ -255,12 +205,12 @@ int get_bonds(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, A
 int get_angles(Str *pdb, Topol *topol)
 {
 	unsigned int i, j;
-	unsigned int allocated = 64;
+	unsigned int allocated = (topol->allocatedAngle > 64) ? topol->allocatedAngle : 64;
 
 	/* allocate memory */
-	topol->it = safe_malloc(allocated * sizeof(int));
-	topol->jt = safe_malloc(allocated * sizeof(int));
-	topol->kt = safe_malloc(allocated * sizeof(int));
+	topol->it = arena_alloc(topol->arena, allocated * sizeof(int));
+	topol->jt = arena_alloc(topol->arena, allocated * sizeof(int));
+	topol->kt = arena_alloc(topol->arena, allocated * sizeof(int));
 
     topol->nAngle = 0;
 
@@ -269,10 +219,10 @@ int get_angles(Str *pdb, Topol *topol)
         for (j = i + 1; j < topol->nBond; ++ j) {
 			/* add memory if needed */ 
 			if (topol->nAngle == allocated) {
-				allocated += 64;
-				topol->it = safe_realloc(topol->it, allocated * sizeof(int));
-				topol->jt = safe_realloc(topol->jt, allocated * sizeof(int));
-				topol->kt = safe_realloc(topol->kt, allocated * sizeof(int));
+				allocated *= 2;
+				topol->it = arena_grow(topol->arena, topol->it, topol->nAngle * sizeof(int), allocated * sizeof(int));
+				topol->jt = arena_grow(topol->arena, topol->jt, topol->nAngle * sizeof(int), allocated * sizeof(int));
+				topol->kt = arena_grow(topol->arena, topol->kt, topol->nAngle * sizeof(int), allocated * sizeof(int));
 			}
 
 			/*____________________________________________________________________________*/
@@ -356,6 +306,7 @@ int get_angles(Str *pdb, Topol *topol)
             }
         }
     }
+	topol->allocatedAngle = allocated;
 
 	return(0);
 }
@@ -377,33 +328,29 @@ int get_angles(Str *pdb, Topol *topol)
  * Therefore, this program gives slightly different (but correct) results
  * if compared to older POPS versions.
  * The redundancy check should be performed for all HET residues. */
-int get_torsions(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa)
+int get_torsions(Str *pdb, View *view, Topol *topol)
 {
 	unsigned int i, j/*, k*/;
-	unsigned int allocated = 64;
+	unsigned int allocated = (topol->allocatedTorsion > 64) ? topol->allocatedTorsion : 64;
 	/*int angle_redundancy, torsion_redundancy;*/
 	int ring_i, ring_j;
 	
 	/* allocate memory */
-	topol->ip = safe_malloc(allocated * sizeof(int));
-	topol->jp = safe_malloc(allocated * sizeof(int));
-	topol->kp = safe_malloc(allocated * sizeof(int));
-	topol->lp = safe_malloc(allocated * sizeof(int));
+	topol->ip = arena_alloc(topol->arena, allocated * sizeof(int));
+	topol->jp = arena_alloc(topol->arena, allocated * sizeof(int));
+	topol->kp = arena_alloc(topol->arena, allocated * sizeof(int));
+	topol->lp = arena_alloc(topol->arena, allocated * sizeof(int));
 
     topol->nTorsion = 0;
 	
 	/* for all angle pair combinations */
 	for (i = 0; i < topol->nAngle - 1; ++ i) {
 		/* ring status of angle 'i' */
-		ring_i = constant_sasa[0].atomDataSasa[type->residueType[topol->it[i]]][type->atomType[topol->it[i]]].ring + \
-				 constant_sasa[0].atomDataSasa[type->residueType[topol->jt[i]]][type->atomType[topol->jt[i]]].ring + \
-				 constant_sasa[0].atomDataSasa[type->residueType[topol->kt[i]]][type->atomType[topol->kt[i]]].ring;
+		ring_i = view->ring[topol->it[i]] + view->ring[topol->jt[i]] + view->ring[topol->kt[i]];
 
 		for (j = i + 1; j < topol->nAngle; ++ j) {
 			/* ring status of angle 'j' */
-			ring_j = constant_sasa[0].atomDataSasa[type->residueType[topol->it[j]]][type->atomType[topol->it[j]]].ring + \
-					 constant_sasa[0].atomDataSasa[type->residueType[topol->jt[j]]][type->atomType[topol->jt[j]]].ring + \
-					 constant_sasa[0].atomDataSasa[type->residueType[topol->kt[j]]][type->atomType[topol->kt[j]]].ring;
+			ring_j = view->ring[topol->it[j]] + view->ring[topol->jt[j]] + view->ring[topol->kt[j]];
 
 
 			/* if angles 'i' and 'j' entirely in ring, skip torsion assignment */
@@ -412,11 +359,11 @@ int get_torsions(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa
 
 			/* add memory if needed */ 
 			if (topol->nTorsion == allocated) {
-				allocated += 64;
-				topol->ip = safe_realloc(topol->ip, allocated * sizeof(int));
-				topol->jp = safe_realloc(topol->jp, allocated * sizeof(int));
-				topol->kp = safe_realloc(topol->kp, allocated * sizeof(int));
-				topol->lp = safe_realloc(topol->lp, allocated * sizeof(int));
+				allocated *= 2;
+				topol->ip = arena_grow(topol->arena, topol->ip, topol->nTorsion * sizeof(int), allocated * sizeof(int));
+				topol->jp = arena_grow(topol->arena, topol->jp, topol->nTorsion * sizeof(int), allocated * sizeof(int));
+				topol->kp = arena_grow(topol->arena, topol->kp, topol->nTorsion * sizeof(int), allocated * sizeof(int));
+				topol->lp = arena_grow(topol->arena, topol->lp, topol->nTorsion * sizeof(int), allocated * sizeof(int));
 			}
 
 			/*____________________________________________________________________________*/
@@ -524,6 +471,7 @@ int get_torsions(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa
 			}
         }
     }
+	topol->allocatedTorsion = allocated;
 
 	return(0);
 }
@@ -531,25 +479,29 @@ int get_torsions(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa
 /*___________________________________________________________________________*/
 /** calculate non-bonded overlapping atoms */ 
 /** atoms overlapping if dist < RADATM(i) + RADATM(j) + 2*RSOLV */
-int nonbonded_overlaps(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, Arg *arg)
+int nonbonded_overlaps(Str *pdb, View *view, Topol *topol, Arg *arg)
 {
-	unsigned int i, j;
-	unsigned int allocated = 64;
+	unsigned int i, j, k;
+	unsigned int allocated = (topol->allocatedNonBonded > 64) ? topol->allocatedNonBonded : 64;
 	float atomDistance;
 	float cutoffRadius;
 	int bondState;
+	int nCandidate;
 
 	/* allocate memory */
-	topol->in = safe_malloc(allocated * sizeof(int));
-	topol->jn = safe_malloc(allocated * sizeof(int));
+	topol->in = arena_alloc(topol->arena, allocated * sizeof(int));
+	topol->jn = arena_alloc(topol->arena, allocated * sizeof(int));
 
     topol->nNonBonded = 0;
 
 	/* for all atom pair combinations */
     for (i = 0; i < pdb->nAtom - 1; ++ i) {
-		for (j = i + 1; j < pdb->nAtom; ++ j) {
-			atomDistance = atom_distance(pdb, i, j);
-			cutoffRadius = cutoff_radius(type, constant_sasa, i, j, arg->rProbe);
+		/* all following atoms or the spatial neighbours from the cell grid */
+		nCandidate = view->order ? view_neighbours(view, i) : (pdb->nAtom - i - 1);
+		for (k = 0; k < nCandidate; ++ k) {
+			j = view->order ? view->candidate[k] : (i + 1 + k);
+			atomDistance = view_distance(view, i, j);
+			cutoffRadius = cutoff_radius(view, i, j, arg->rProbe);
 			bondState = get_bondState(topol, i, j);
 
 			/* if atoms closer than non-bonded cutoff and not bonded */
@@ -584,29 +536,26 @@ int nonbonded_overlaps(Str *pdb, Type *type, Topol *topol, ConstantSasa *constan
 				/*___________________________________________________________________________*/
 				/* add memory if needed */ 
 				if (topol->nNonBonded == allocated) {
-					allocated += 64;
-					topol->in = safe_realloc(topol->in, allocated * sizeof(int));
-					topol->jn = safe_realloc(topol->jn, allocated * sizeof(int));
+					allocated *= 2;
+					topol->in = arena_grow(topol->arena, topol->in, topol->nNonBonded * sizeof(int), allocated * sizeof(int));
+					topol->jn = arena_grow(topol->arena, topol->jn, topol->nNonBonded * sizeof(int), allocated * sizeof(int));
 				}
 			}
 		}
 	}
+	topol->allocatedNonBonded = allocated;
 
 	return(0);
 }
 
 /*____________________________________________________________________________*/
-/** derive molecular topology */
-int get_topology(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, Argpdb *argpdb, Arg *arg)
+/** derive bonded molecular topology: bonds, angles, torsions;
+	returns POPS_OK or the error code of a too small topology */
+int get_bonded_topology(Str *pdb, View *view, Topol *topol, Argpdb *argpdb)
 {
-	char syscmd[128];
-	int syscmdstat = 0;
-
 	if (pdb->nAtom < 2) {
-		sprintf(syscmd, "touch %s.json", pdb->pdbID); 
-		syscmdstat = system(syscmd);
-		fprintf(stderr, "< 2 atoms: try '--coarse' switch ; system exit = %d\n",
-			syscmdstat);
+		fprintf(stderr, "< 2 atoms: try '--coarse' switch\n");
+		return POPS_ERR_ATOM;
 	}
 
 	/* the bondState matrix records, which atom pairs are bonded 
@@ -617,16 +566,13 @@ int get_topology(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa
 	fprintf(stderr, "%s:%d: nAtom = %d\n", __FILE__, __LINE__, pdb->nAtom);
 #endif
 
-	get_bonds(pdb, type, topol, constant_sasa, argpdb); /* calculate bonds (from atoms) */
+	get_bonds(pdb, view, topol, argpdb); /* calculate bonds (from atoms) */
 #if DEBUG>1
 	fprintf(stderr, "%s:%d: nBond = %d\n", __FILE__, __LINE__, topol->nBond);
 #endif
 	if (topol->nBond < 2) {
-		sprintf(syscmd, "touch %s.json", pdb->pdbID); 
-		syscmdstat = system(syscmd);
-		fprintf(stderr, "< 2 bonds: try '--coarse' switch ; system exit = %d\n",
-			syscmdstat);
-		exit(0);
+		fprintf(stderr, "< 2 bonds: try '--coarse' switch\n");
+		return POPS_ERR_BOND;
 	}
 
 	get_angles(pdb, topol); /* calculate angles (from bonds) */
@@ -634,119 +580,380 @@ int get_topology(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa
 	fprintf(stderr, "%s:%d: nAngle = %d\n", __FILE__, __LINE__, topol->nAngle);
 #endif
 	if (topol->nAngle < 2) {
-		sprintf(syscmd, "touch %s.json", pdb->pdbID); 
-		syscmdstat = system(syscmd);
-		fprintf(stderr, "< 2 angles: try '--coarse' switch ; system exit = %d\n",
-			syscmdstat);
-		exit(0);
+		fprintf(stderr, "< 2 angles: try '--coarse' switch\n");
+		return POPS_ERR_ANGLE;
 	}
 
-	get_torsions(pdb, type, topol, constant_sasa); /* calculate torsions (from angles) */
+	get_torsions(pdb, view, topol); /* calculate torsions (from angles) */
 #if DEBUG>1
 	fprintf(stderr, "%s:%d: nTorsion = %d\n", __FILE__, __LINE__, topol->nTorsion);
 #endif
 	if (topol->nTorsion < 2) {
-		sprintf(syscmd, "touch %s.json", pdb->pdbID); 
-		syscmdstat = system(syscmd);
-		fprintf(stderr, "< 2 torsions: try '--coarse' switch ; system exit = %d\n",
-			syscmdstat);
-		exit(0);
+		fprintf(stderr, "< 2 torsions: try '--coarse' switch\n");
+		return POPS_ERR_TORSION;
 	}
 
-	nonbonded_overlaps(pdb, type, topol, constant_sasa, arg); /* calculate overlapping atoms */
+	/*print_bondState(pdb, topol);*/
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** derive molecular topology */
+int get_topology(Str *pdb, View *view, Topol *topol, Argpdb *argpdb, Arg *arg)
+{
+	int ret;
+
+	if ((ret = get_bonded_topology(pdb, view, topol, argpdb)) != POPS_OK)
+		return ret;
+
+	nonbonded_overlaps(pdb, view, topol, arg); /* calculate overlapping atoms */
 #if DEBUG>1
 	fprintf(stderr, "%s:%d: nNonBonded = %d\n", __FILE__, __LINE__, topol->nNonBonded);
 #endif
 
-	/*print_bondState(pdb, topol);*/
+	return POPS_OK;
+}
 
-	return 0;
+/*____________________________________________________________________________*/
+/** atoms 'i', 'j' of interaction 'k', counted over bonds, angles, torsions
+	and non-bonded overlaps in this order; returns the bond separation
+	of the atoms: 2, 3, 4, or 5 for non-bonded atoms */
+int topol_interaction(Topol *topol, int k, int *i, int *j)
+{
+	if (k < topol->nBond) {
+		*i = topol->ib[k]; *j = topol->jb[k];
+		return 2;
+	}
+	k -= topol->nBond;
+	if (k < topol->nAngle) {
+		*i = topol->it[k]; *j = topol->kt[k];
+		return 3;
+	}
+	k -= topol->nAngle;
+	if (k < topol->nTorsion) {
+		*i = topol->ip[k]; *j = topol->lp[k];
+		return 4;
+	}
+	k -= topol->nTorsion;
+	*i = topol->in[k]; *j = topol->jn[k];
+	return 5;
+}
+
+/*____________________________________________________________________________*/
+/** atoms 'i', 'j' in 1-2, 1-3 or 1-4 relation, as excluded from
+	the non-bonded overlaps */
+int topol_bonded(Topol *topol, int i, int j)
+{
+	return get_bondState(topol, i, j);
 }
 
 /*____________________________________________________________________________*/
 /** Calpha distances between different chains */
-/** The raw distances are converted in residue-size-weighted soft distances */
-int calpha_distances(Arg *arg, Str *pdb, Topol *topol, ConstantSasa *res_sasa) {
-	unsigned int i, j, k;
-	int n_cai, n_caj;
-	char chain1 = '\0';
-	float distance = 0.;
-	float soft_distance = 0.;
-	int found_CA1 = 0;
-	int found_CA2 = 0;
-	float r_CA1 = 0.;
-	float r_CA2 = 0.;
-	float soft_distance_norm = 0.;
-
-	n_cai = 0;
-
-	/* find first CA chain */
-	for (i = 0; i < pdb->nAtom; ++i) {
-    	if (strcmp(pdb->atom[i].atomName, "CA") == 0) {
-       		chain1 = pdb->atom[i].chainIdentifier[0];
-       		break;
-    	}
-	}
+/** The raw distances are converted in residue-size-weighted soft distances
+	1 / (1 + exp((d - 8) / 0.5)) * sqrt(r_i r_j) / 4.35 with the coarse
+	residue radii r. All chain pairs are evaluated: the radii are looked up
+	once per Calpha atom, Calpha pairs are found on a cell grid with the
+	distance beyond which the soft distance stays below 'SOFTDISTMIN' as
+	cell size, and chunks of Calpha atoms are processed on a thread pool.
+	The soft distances of at least 'SOFTDISTMIN' are stored per chain pair,
+	sorted by atom. */
+
+/* smallest stored soft distance, printed with two decimals as 0.01 */
+#define SOFTDISTMIN 0.005
+/* Calpha atoms per work item */
+#define CACHUNK 256
+
+/* Calpha pair of different chains */
+typedef struct {
+	int chain1; /* chain of 'ca1', lower than that of 'ca2' */
+	int chain2;
+	int ca1; /* Calpha atom indices */
+	int ca2;
+	float softDistance;
+} CAContact;
+
+/* Calpha atoms, cell grid and work items */
+typedef struct {
+	Str *pdb;
+	int nCA;
+	int *caAtom; /* atom of each Calpha */
+	int *caChain; /* chain index of each Calpha */
+	float *caRadius; /* coarse residue radius of each Calpha */
+	float cutoff; /* distance of soft distance 'SOFTDISTMIN' */
+	float origin[3]; /* grid origin */
+	int nCell[3]; /* grid dimensions */
+	int *cellHead; /* first Calpha of each cell, -1 if empty */
+	int *cellNext; /* next Calpha of the same cell */
+	int next; /* first Calpha of the next work item */
+	pthread_mutex_t lock;
+} CAWork;
+
+/* contacts found by one thread */
+typedef struct {
+	CAWork *work;
+	CAContact *contact;
+	int nContact;
+	int allocatedContact;
+} CAThread;
 
-	for (i = 0; i < pdb->nAtom; ++i) {
-    	if (strcmp(pdb->atom[i].atomName, "CA") != 0)
-        	continue;
-
-    	/* only rows from chain 1 */
-    	if (pdb->atom[i].chainIdentifier[0] != chain1)
-        	continue;
-
-    	n_caj = 0;
-
-    	for (j = 0; j < pdb->nAtom; ++j) {
-			if (strcmp(pdb->atom[j].atomName, "CA") != 0)
-            	continue;
-
-        	/* only columns from other chain(s) */
-        	if (pdb->atom[j].chainIdentifier[0] == chain1)
-            	continue;
-
-			distance = atom_distance(pdb, i, j);
-			soft_distance = 1 / (1 + exp((distance - 8) / 0.5));
-			
-			/* get residue radius (coarse grained) */
-			found_CA1 = found_CA2 = 0;
-			r_CA1 = r_CA2 = 0.;
-			for (k = 0; k < res_sasa->nResidueType; ++ k) {
-        		/* found residue of atom i at index k */
-				r_CA1 = res_sasa->atomDataSasa[k][0].radius;
-				++ found_CA1;
-
- 				if (strcmp(pdb->atom[j].residueName, res_sasa->atomDataSasa[k][0].residueName) == 0) {
-        			/* found residue of atom j at index k */
-					r_CA2 = res_sasa->atomDataSasa[k][0].radius;
-					++ found_CA2;
-        		}
-			
-				if (found_CA1 && found_CA2) {
-					break;
-    			}
-			}
+/*____________________________________________________________________________*/
+/** coarse residue radius of the residue name, the mean radius if unknown */
+static float ca_radius(ConstantSasa *res_sasa, char *residueName)
+{
+	int k;
 
-			/* the mean radius across 20 amino acids is 4.35 */
-			soft_distance_norm = soft_distance *  (sqrt(r_CA1 * r_CA2) / 4.35);
-        	topol->distMatCA[n_cai][n_caj] = soft_distance_norm;
-			
-			topol->resCA1[n_cai] = pdb->atom[i].residueNumber;
-			topol->resCA2[n_caj] = pdb->atom[j].residueNumber;		
+	for (k = 0; k < res_sasa->nResidueType; ++ k)
+		if (strcmp(residueName, res_sasa->atomDataSasa[k][0].residueName) == 0)
+			return res_sasa->atomDataSasa[k][0].radius;
 
-        	++n_caj;
-    	}
+	/* the mean radius across 20 amino acids is 4.35 */
+	return 4.35;
+}
 
-    	++n_cai;
-	}
+/*____________________________________________________________________________*/
+/** grid cell coordinate of a Calpha along dimension 'd' */
+__inline__ static int ca_cell(CAWork *work, int c, int d)
+{
+	Atom *atom = &(work->pdb->atom[work->caAtom[c]]);
+	float pos = (d == 0) ? atom->pos.x : ((d == 1) ? atom->pos.y : atom->pos.z);
 
-	assert(n_cai == topol->nCA1);
-	assert(n_caj == topol->nCA2);
+	return (int)((pos - work->origin[d]) / work->cutoff);
+}
 
-	return(0);
+/*____________________________________________________________________________*/
+/** compare contacts by chain pair and atoms */
+static int compare_contact(const void *a, const void *b)
+{
+	const CAContact *ca = (const CAContact *)a;
+	const CAContact *cb = (const CAContact *)b;
+
+	if (ca->chain1 != cb->chain1)
+		return ca->chain1 - cb->chain1;
+	if (ca->chain2 != cb->chain2)
+		return ca->chain2 - cb->chain2;
+	if (ca->ca1 != cb->ca1)
+		return ca->ca1 - cb->ca1;
+	return ca->ca2 - cb->ca2;
 }
 
 /*____________________________________________________________________________*/
+/** thread: soft distances of the Calpha atoms of the work items it takes
+	to the Calpha atoms of later chains in the 27 surrounding cells */
+static void *ca_thread(void *data)
+{
+	CAThread *ct = (CAThread *)data;
+	CAWork *work = ct->work;
+	int first, a, b, c, d;
+	int cell[3], next[3];
+	float distance, softDistance;
+
+	for (;;) {
+		pthread_mutex_lock(&(work->lock));
+		first = work->next;
+		work->next += CACHUNK;
+		pthread_mutex_unlock(&(work->lock));
+		if (first >= work->nCA)
+			break;
+
+		for (a = first; (a < first + CACHUNK) && (a < work->nCA); ++ a) {
+			for (d = 0; d < 3; ++ d)
+				cell[d] = ca_cell(work, a, d);
+			for (c = 0; c < 27; ++ c) {
+				next[0] = cell[0] + c / 9 - 1;
+				next[1] = cell[1] + (c / 3) % 3 - 1;
+				next[2] = cell[2] + c % 3 - 1;
+				if ((next[0] < 0) || (next[0] >= work->nCell[0]) ||
+					(next[1] < 0) || (next[1] >= work->nCell[1]) ||
+					(next[2] < 0) || (next[2] >= work->nCell[2]))
+					continue;
+				for (b = work->cellHead[(next[0] * work->nCell[1] + next[1]) * work->nCell[2] + next[2]];
+					b >= 0; b = work->cellNext[b]) {
+					/* each pair of chains once, in chain order */
+					if (work->caChain[b] <= work->caChain[a])
+						continue;
+					if ((distance = atom_distance(work->pdb, work->caAtom[a], work->caAtom[b])) > work->cutoff)
+						continue;
+					softDistance = 1 / (1 + exp((distance - 8) / 0.5)) * \
+						(sqrt(work->caRadius[a] * work->caRadius[b]) / 4.35);
+					if (softDistance < SOFTDISTMIN)
+						continue;
+					if (ct->nContact == ct->allocatedContact) {
+						ct->allocatedContact += 1024;
+						ct->contact = safe_realloc(ct->contact, ct->allocatedContact * sizeof(CAContact));
+					}
+					ct->contact[ct->nContact].chain1 = work->caChain[a];
+					ct->contact[ct->nContact].chain2 = work->caChain[b];
+					ct->contact[ct->nContact].ca1 = work->caAtom[a];
+					ct->contact[ct->nContact].ca2 = work->caAtom[b];
+					ct->contact[ct->nContact].softDistance = softDistance;
+					++ ct->nContact;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
 /*____________________________________________________________________________*/
+/** sparse soft Calpha distances of all chain pairs, allocated in the
+	arena of 'topol'; on 'nThread' threads, 0 for all processors */
+int calpha_distances(Arg *arg, Str *pdb, Topol *topol, ConstantSasa *res_sasa, int nThread) {
+	unsigned int i;
+	int c, d, k, p, t;
+	int nStarted, nContact;
+	int chain = 0;
+	float high[3], pos[3];
+	float maxRadius = 0.;
+	size_t nGrid;
+	CAWork work;
+	CAThread *ct = 0;
+	CAContact *contact = 0;
+	CAPair *pair = 0;
+	pthread_t *thread = 0;
+
+	topol->nCAPair = 0;
+	topol->caPair = 0;
+
+	memset(&work, 0, sizeof(CAWork));
+	work.pdb = pdb;
+	work.caAtom = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	work.caChain = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	work.caRadius = safe_malloc((pdb->nAtom + 1) * sizeof(float));
+
+	/*____________________________________________________________________________*/
+	/* Calpha atoms with their chain and radius */
+	for (d = 0; d < 3; ++ d) {
+		work.origin[d] = FLT_MAX;
+		high[d] = -FLT_MAX;
+	}
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		if ((i > 0) && (pdb->atom[i].chainIdentifier[0] != pdb->atom[i - 1].chainIdentifier[0]))
+			++ chain;
+		if (strcmp(pdb->atom[i].atomName, "CA") != 0)
+			continue;
+		work.caAtom[work.nCA] = i;
+		work.caChain[work.nCA] = chain;
+		work.caRadius[work.nCA] = ca_radius(res_sasa, pdb->atom[i].residueName);
+		if (work.caRadius[work.nCA] > maxRadius)
+			maxRadius = work.caRadius[work.nCA];
+		++ work.nCA;
+
+		pos[0] = pdb->atom[i].pos.x; pos[1] = pdb->atom[i].pos.y; pos[2] = pdb->atom[i].pos.z;
+		for (d = 0; d < 3; ++ d) {
+			if (pos[d] < work.origin[d]) work.origin[d] = pos[d];
+			if (pos[d] > high[d]) high[d] = pos[d];
+		}
+	}
+
+	/* no pairs of chains or no soft distance reaches 'SOFTDISTMIN' */
+	if ((chain == 0) || (work.nCA == 0) || (maxRadius / 4.35 <= SOFTDISTMIN)) {
+		free(work.caAtom);
+		free(work.caChain);
+		free(work.caRadius);
+		return(0);
+	}
+
+	/*____________________________________________________________________________*/
+	/* cell grid: the soft distance of the largest residues is 'SOFTDISTMIN'
+		at the cutoff */
+	work.cutoff = 8 + 0.5 * log((maxRadius / 4.35) / SOFTDISTMIN - 1);
+	for (d = 0; d < 3; ++ d)
+		work.nCell[d] = (int)((high[d] - work.origin[d]) / work.cutoff) + 1;
+	nGrid = (size_t)work.nCell[0] * work.nCell[1] * work.nCell[2];
+	work.cellHead = safe_malloc(nGrid * sizeof(int));
+	work.cellNext = safe_malloc(work.nCA * sizeof(int));
+	for (k = 0; k < nGrid; ++ k)
+		work.cellHead[k] = -1;
+	for (c = work.nCA - 1; c >= 0; -- c) {
+		k = (ca_cell(&work, c, 0) * work.nCell[1] + ca_cell(&work, c, 1)) * work.nCell[2] + \
+			ca_cell(&work, c, 2);
+		work.cellNext[c] = work.cellHead[k];
+		work.cellHead[k] = c;
+	}
+
+	/*____________________________________________________________________________*/
+	/* chunks of Calpha atoms on a thread pool */
+	if (nThread <= 0)
+		nThread = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThread > (work.nCA + CACHUNK - 1) / CACHUNK)
+		nThread = (work.nCA + CACHUNK - 1) / CACHUNK;
+	if (nThread < 1)
+		nThread = 1;
+
+	ct = safe_malloc(nThread * sizeof(CAThread));
+	memset(ct, 0, nThread * sizeof(CAThread));
+	for (t = 0; t < nThread; ++ t)
+		ct[t].work = &work;
+
+	pthread_mutex_init(&(work.lock), 0);
+	if (nThread == 1) {
+		ca_thread(&(ct[0]));
+	} else {
+		/* chunks are taken from the shared counter: if a thread cannot
+			be started, the calling thread computes the remaining chunks */
+		thread = safe_malloc(nThread * sizeof(pthread_t));
+		for (nStarted = 0; nStarted < nThread; ++ nStarted)
+			if (pthread_create(&(thread[nStarted]), 0, ca_thread, &(ct[nStarted])) != 0)
+				break;
+		if (nStarted < nThread)
+			ca_thread(&(ct[nStarted]));
+		for (t = 0; t < nStarted; ++ t)
+			pthread_join(thread[t], 0);
+		free(thread);
+	}
+	pthread_mutex_destroy(&(work.lock));
+
+	/*____________________________________________________________________________*/
+	/* contacts of all threads, sorted by chain pair and atoms */
+	for (t = 0, nContact = 0; t < nThread; ++ t)
+		nContact += ct[t].nContact;
+	contact = safe_malloc((nContact + 1) * sizeof(CAContact));
+	for (t = 0, k = 0; t < nThread; ++ t) {
+		if (ct[t].nContact > 0)
+			memcpy(&(contact[k]), ct[t].contact, ct[t].nContact * sizeof(CAContact));
+		k += ct[t].nContact;
+		free(ct[t].contact);
+	}
+	free(ct);
+	qsort(contact, nContact, sizeof(CAContact), compare_contact);
+
+	/* sparse soft distances of each chain pair */
+	for (k = 0; k < nContact; ++ k)
+		if ((k == 0) || (contact[k].chain1 != contact[k - 1].chain1) ||
+			(contact[k].chain2 != contact[k - 1].chain2))
+			++ topol->nCAPair;
+	topol->caPair = arena_alloc(topol->arena, (topol->nCAPair + 1) * sizeof(CAPair));
+	for (k = 0, p = -1; k < nContact; ++ k) {
+		if ((k == 0) || (contact[k].chain1 != contact[k - 1].chain1) ||
+			(contact[k].chain2 != contact[k - 1].chain2)) {
+			pair = &(topol->caPair[++ p]);
+			pair->chain[0] = contact[k].chain1;
+			pair->chain[1] = contact[k].chain2;
+			for (c = k; (c < nContact) && (contact[c].chain1 == pair->chain[0]) &&
+				(contact[c].chain2 == pair->chain[1]); ++ c);
+			pair->nContact = 0;
+			pair->ca1 = arena_alloc(topol->arena, (c - k) * sizeof(int));
+			pair->ca2 = arena_alloc(topol->arena, (c - k) * sizeof(int));
+			pair->softDistance = arena_alloc(topol->arena, (c - k) * sizeof(float));
+		}
+		pair->ca1[pair->nContact] = contact[k].ca1;
+		pair->ca2[pair->nContact] = contact[k].ca2;
+		pair->softDistance[pair->nContact] = contact[k].softDistance;
+		++ pair->nContact;
+	}
+
+	if (! arg->silent)
+		printf("CA soft distances: %d Calpha atoms, %d chain pairs, %d Calpha pairs\n",
+			work.nCA, topol->nCAPair, nContact);
+
+	free(contact);
+	free(work.caAtom);
+	free(work.caChain);
+	free(work.caRadius);
+	free(work.cellHead);
+	free(work.cellNext);
 
+	return(0);
+}
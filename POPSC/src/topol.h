@@ -12,19 +12,39 @@ Read the COPYING file for license information.
 
 #include <assert.h>
 #include <float.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
 
+#include "arena.h"
+#include "error.h"
 #include "getpdb.h"
 #include "matrix.h"
 #include "sasa_const.h"
 #include "type.h"
+#include "view.h"
 
 /*____________________________________________________________________________*/
 /* structures */
+/* soft Calpha distances of a chain pair, only those of at least 'SOFTDISTMIN' */
+typedef struct
+{
+	int chain[2]; /* chain indices, chain[0] < chain[1] */
+	int nContact; /* Calpha pairs */
+	int *ca1; /* Calpha atom of chain[0] */
+	int *ca2; /* Calpha atom of chain[1] */
+	float *softDistance; /* residue-size-weighted soft distance */
+} CAPair;
+
 /* topology */
 typedef struct  
 {
+	Arena *arena; /* scratch memory of the structure or frame */
+	unsigned int allocatedBond; /* list capacities, kept as hints for the next frame */
+	unsigned int allocatedAngle;
+	unsigned int allocatedTorsion;
+	unsigned int allocatedNonBonded;
 	int nMol; /* number of molecules */
 	int nResidue; /* number of residues */
 	int nBond; /* number of bonds */
@@ -48,25 +68,24 @@ typedef struct
 	float **neighbourPar; /* records the POPS parameters 'p_ij * b_ij' of neighbours */
 	int *interfaceNn; /* nearest neighbour on separate chain */
 	float *interfaceNnDist; /* distance to nearest neighbour on separate chain */
-	int nCA1; /* number of Calpha atoms in chain or domain 1 */
-	int nCA2; /* number of Calpha atoms in chain or domain 2 */
-	float **distMatCA; /* Calpha distance matrix */
-	int *resCA1; /* array of residue numbers of chain or domain 1 */
-	int *resCA2; /* array of residue numbers of chain or domain 2 */
+	int nCAPair; /* chain pairs with Calpha soft distances */
+	CAPair *caPair; /* sparse soft distances of each chain pair */
 } Topol;
 
 /*____________________________________________________________________________*/
 /* prototypes */
 float atom_distance(Str *pdb, int i, int j);
-float cutoff_radius(Type *type, ConstantSasa *constant_sasa, int i, int j, float rSolvent);
-int get_bonds(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, Argpdb *argpdb); /* calculate bonds (from atoms) */
+float cutoff_radius(View *view, int i, int j, float rSolvent);
+int get_bonds(Str *pdb, View *view, Topol *topol, Argpdb *argpdb); /* calculate bonds (from atoms) */
 int get_angles(Str *pdb, Topol *topol); /* calculate angles (from bonds) */
-int get_torsions(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa); /* calculate torsions (from angles) */
-int nonbonded_overlaps(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, Arg *arg); /* calculate overlapping atoms */
-void init_topology(Arg *arg, Str *pdb, Topol *topol);
-void free_topology(Str *pdb, Topol *topol);
-int get_topology(Str *pdb, Type *type, Topol *topol, ConstantSasa *constant_sasa, Argpdb *argpdb, Arg *arg); /* call topology routines */
-int calpha_distances(Arg *arg, Str *pdb, Topol *topol, ConstantSasa *constant_sasa);
+int get_torsions(Str *pdb, View *view, Topol *topol); /* calculate torsions (from angles) */
+int nonbonded_overlaps(Str *pdb, View *view, Topol *topol, Arg *arg); /* calculate overlapping atoms */
+void init_topology(Arg *arg, Str *pdb, Topol *topol, Arena *arena);
+int get_bonded_topology(Str *pdb, View *view, Topol *topol, Argpdb *argpdb); /* bonds, angles, torsions */
+int get_topology(Str *pdb, View *view, Topol *topol, Argpdb *argpdb, Arg *arg); /* call topology routines */
+int topol_interaction(Topol *topol, int k, int *i, int *j); /* atoms of k-th interaction */
+int topol_bonded(Topol *topol, int i, int j); /* 1-2, 1-3 or 1-4 atoms */
+int calpha_distances(Arg *arg, Str *pdb, Topol *topol, ConstantSasa *constant_sasa, int nThread);
 
 #endif
 
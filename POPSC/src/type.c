@@ -10,105 +10,77 @@ Read the COPYING file for license information.
 #include "type.h"
 
 /*____________________________________________________________________________*/
-/** get atom and residue types */
-int get_types(Str *pdb, Type *type, ConstantSasa *constant_sasa)
+/** get atom and residue types (SASA and SIGMA) and atom groups in one pass;
+	returns POPS_ERR_TYPE for an atom without parametrisation */
+int get_types(Str *pdb, Type *type, TypeHash *typeHash)
 {
-	unsigned int i, j;
-	char p_residue[8] = "";
-	char p_atom[4] = "";
-	int found_residue = 0;
-	int found_atom = 0;
+	unsigned int i;
+	TypeEntry *residue = 0; /* residue entry */
+	TypeEntry *atom = 0; /* (residue, atom) entry */
+	TypeEntry *any = 0; /* ('ANY', atom) entry */
+	int residueType = 0;
 
 	type->atomType = safe_malloc(pdb->nAtom * sizeof(int));
 	type->residueType = safe_malloc(pdb->nAtom * sizeof(int));
 
 	/*____________________________________________________________________________*/
 	for (i = 0; i < pdb->nAtom; ++ i) {
-		found_residue = 0;
-		found_atom = 0;
-
 		/*____________________________________________________________________________*/
 		/* residue */
-		strip_char(pdb->atom[i].residueName, p_residue); /* remove spaces */
-		/* ... match its residue type to the ones in constant SASA */
-		for (j = 0, found_residue = 0; j < constant_sasa->nResidueType; ++ j) {
-			/* if matched, assign residue type 'j' to atom 'i' */
-			if (strcmp(p_residue, constant_sasa->atomDataSasa[j][0].residueName) == 0) {
-				type->residueType[i] = j;
-				++ found_residue; /* flag up match */
-				break;
-			}
-		}
+		/* residue types change only at residue boundaries;
+			'type_key' skips spaces, the names are used as read */
+		if ((i == 0) || (strcmp(pdb->atom[i].residueName, pdb->atom[i - 1].residueName) != 0)) {
+			residue = find_type(typeHash, type_key(pdb->atom[i].residueName, ""));
 
-		/* if no match is found for this residue name */
-		if (! found_residue) {
-			strip_char(pdb->atom[i].residueName, p_residue); /* remove spaces */
-			fprintf(stderr, "Warning: Unknown residue name '%s' -> '%s' of residue number %d\n"
-							"Setting residue type to UNK (for unknown polymer residues)\n",
-				pdb->atom[i].residueName, p_residue, pdb->atom[i].residueNumber);
-			type->residueType[i] = 37; /* UNK is residue number 37 in 'sasa_data.h' */
-			++ found_residue; /* flag up match */
-			break;
+			/* if no match is found for this residue name */
+			if ((residue == 0) || (residue->residueType < 0)) {
+				fprintf(stderr, "Warning: Unknown residue name '%s' of residue number %d\n"
+								"Setting residue type to UNK (for unknown polymer residues)\n",
+					pdb->atom[i].residueName, pdb->atom[i].residueNumber);
+				residue = 0;
+			}
 		}
+		residueType = residue ? residue->residueType : typeHash->unkResidue;
 
 		/*____________________________________________________________________________*/
 		/* atom */
-		/* ... match its atom type to the ones in constant SASA */
-		strip_char(pdb->atom[i].atomName, p_atom); /* remove spaces */
-		for (j = 0, found_atom = 0; j < constant_sasa->nAtomResidue[type->residueType[i]]; ++ j) {
-			/* if matched, assign atom type 'j' to atom 'i' */
-			if (strcmp(p_atom, constant_sasa->atomDataSasa[type->residueType[i]][j].atomName) == 0) {
-				type->atomType[i] = j;
-				++ found_atom; /* flag up match */
-				break;
-			}
-		}
-
-		/* OXT is special because it is not residue-specific */
-		if (! found_atom) {
-			/* 'OXT' has variable residue names, but is assigned to 
-				residue 'ANY' = 20 and atom 'OXT' = 0 */
-			if (strcmp(p_atom, constant_sasa->atomDataSasa[20][0].atomName) == 0) {
-				type->residueType[i] = 20;
-				type->atomType[i] = 0;
-				++ found_atom; /* flag up match */
-				continue;
-			}
-		}
+		atom = find_type(typeHash, type_key(residue ? pdb->atom[i].residueName : "UNK",
+			pdb->atom[i].atomName));
+		/* 'OXT' is special because it is not residue-specific;
+			'O1' and 'O2' are not PDB format, but frequently used in MD and graphics programs:
+			these atoms have variable residue names, but are assigned to residue 'ANY' */
+		any = find_type(typeHash, type_key("ANY", pdb->atom[i].atomName));
 
-		/* O1 is special because it is not residue-specific;
-			not PDB format, but frequently used in MD and graphics programs */
-		if (! found_atom) {
-			/* 'O1' has variable residue names, but is assigned to 
-				residue 'ANY' = 20 and atom 'O1' = 1 */
-			if (strcmp(p_atom, constant_sasa->atomDataSasa[20][1].atomName) == 0) {
-				type->residueType[i] = 20;
-				type->atomType[i] = 1;
-				++ found_atom; /* flag up match */
-				continue;
-			}
+		/* SASA and SIGMA type */
+		if (atom && (atom->atomType >= 0)) {
+			type->residueType[i] = residueType;
+			type->atomType[i] = atom->atomType;
+		} else if (any && (any->atomType >= 0)) {
+			type->residueType[i] = typeHash->anyResidue;
+			type->atomType[i] = any->atomType;
+		} else {
+			/* unknown atom means unknown parametrisation */
+			ErrorSpecNoexit("Unknown type of atom", pdb->atom[i].atomName);
+			free(type->atomType);
+			free(type->residueType);
+			type->atomType = type->residueType = 0;
+			return POPS_ERR_TYPE;
 		}
 
-		/* O2 is special because it is not residue-specific;
-			not PDB format, but frequently used in MD and graphics programs */
-		if (! found_atom) {
-			/* 'O2' has variable residue names, but is assigned to 
-				residue 'ANY' = 20 and atom 'O2' = 2 */
-			if (strcmp(p_atom, constant_sasa->atomDataSasa[20][2].atomName) == 0) {
-				type->residueType[i] = 20;
-				type->atomType[i] = 2;
-				++ found_atom; /* flag up match */
-				continue;
-			}
+		/* atom group: GROMOS atom type and group ID number */
+		if (atom && (atom->groupAtomType >= 0)) {
+			pdb->atom[i].atomType = atom->groupAtomType;
+			pdb->atom[i].groupID = atom->groupID;
+		} else if (any && (any->groupAtomType >= 0)) {
+			pdb->atom[i].atomType = any->groupAtomType;
+			pdb->atom[i].groupID = any->groupID;
+		} else {
+			WarningSpec("Unknown group of atom", pdb->atom[i].atomName);
+			pdb->atom[i].atomType = 0; /* default atom group ID */
+			pdb->atom[i].groupID = 0; /* default atom group ID */
 		}
-
-
-		/*____________________________________________________________________________*/
-		/* unknown atom means unknown parametrisation: exit */
-		if (! found_atom)
-			ErrorSpec("Unknown type of atom", pdb->atom[i].atomName);
 	}
 
-	return 0;
+	return POPS_OK;
 }
 
@@ -15,9 +15,11 @@ Read the COPYING file for license information.
 #include <stdlib.h>
 #include <string.h>
 
+#include "error.h"
 #include "getpdb.h"
 #include "modstring.h"
 #include "sasa_const.h"
+#include "typehash.h"
 
 /*____________________________________________________________________________*/
 /* structures */
@@ -28,7 +30,7 @@ typedef struct {
 
 /*____________________________________________________________________________*/
 /* prototypes */
-int get_types(Str *pdb, Type *type, ConstantSasa *constant_sasa);
+int get_types(Str *pdb, Type *type, TypeHash *typeHash);
 
 #endif
 
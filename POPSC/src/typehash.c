@@ -0,0 +1,267 @@
+/*==============================================================================
+typehash.c : perfect hash of (residue, atom) names to parameter types
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "typehash.h"
+
+/*____________________________________________________________________________*/
+/* The table is generated once per parameter set from the data headers
+	'sasa_data.h' and 'atomgroup_data.h' (hash and displace):
+	keys are distributed over buckets, then the buckets are placed in
+	order of decreasing size, each with the first displacement that maps
+	all of its keys to free slots. A lookup is therefore one hash
+	evaluation and one key comparison. */
+
+/*____________________________________________________________________________*/
+/** 64-bit finaliser (splitmix64) */
+__inline__ static uint64_t mix64(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+
+	return x;
+}
+
+/*____________________________________________________________________________*/
+/** bucket and slot of key */
+__inline__ static unsigned int key_bucket(TypeHash *typeHash, uint64_t key)
+{
+	return (unsigned int)(mix64(key) >> 32) & (typeHash->nBucket - 1);
+}
+
+__inline__ static unsigned int key_slot(TypeHash *typeHash, uint64_t key, unsigned int displace)
+{
+	return (unsigned int)mix64(key ^ ((uint64_t)(displace + 1) * 0x9e3779b97f4a7c15ULL)) & (typeHash->nSlot - 1);
+}
+
+/*____________________________________________________________________________*/
+/** pack residue and atom name (max. 4 characters each, spaces removed)
+	into one key; 0 if a name is too long to be a parameterised name */
+uint64_t type_key(const char *residueName, const char *atomName)
+{
+	unsigned int i, j;
+	uint64_t key = 0;
+
+	for (i = 0, j = 0; residueName[i] != '\0'; ++ i) {
+		if (residueName[i] == ' ') continue;
+		if (j == 4) return 0;
+		key |= (uint64_t)(unsigned char)residueName[i] << (8 * j ++);
+	}
+	for (i = 0, j = 4; atomName[i] != '\0'; ++ i) {
+		if (atomName[i] == ' ') continue;
+		if (j == 8) return 0;
+		key |= (uint64_t)(unsigned char)atomName[i] << (8 * j ++);
+	}
+
+	return key;
+}
+
+/*____________________________________________________________________________*/
+/** find entry of key in list, append if new */
+static TypeEntry *list_entry(TypeEntry **entry, unsigned int *nEntry,
+	unsigned int *allocated, uint64_t key)
+{
+	unsigned int i;
+
+	for (i = 0; i < *nEntry; ++ i)
+		if ((*entry)[i].key == key)
+			return &((*entry)[i]);
+
+	if (*nEntry == *allocated) {
+		*allocated += 64;
+		*entry = safe_realloc(*entry, *allocated * sizeof(TypeEntry));
+	}
+
+	(*entry)[*nEntry].key = key;
+	(*entry)[*nEntry].residueType = -1;
+	(*entry)[*nEntry].atomType = -1;
+	(*entry)[*nEntry].groupResidue = -1;
+	(*entry)[*nEntry].groupAtomType = -1;
+	(*entry)[*nEntry].groupID = 0;
+
+	return &((*entry)[(*nEntry) ++]);
+}
+
+/*____________________________________________________________________________*/
+/** collect all keys of the parameter tables */
+static TypeEntry *collect_entries(ConstantSasa *constant_sasa, Atomgroup *atomGroup,
+	unsigned int *nEntry)
+{
+	unsigned int i, j;
+	unsigned int allocated = 64;
+	uint64_t key;
+	TypeEntry *entry = safe_malloc(allocated * sizeof(TypeEntry));
+	TypeEntry *e;
+
+	*nEntry = 0;
+
+	/* SASA and SIGMA types; the first match in table order is kept */
+	for (i = 0; i < constant_sasa->nResidueType; ++ i) {
+		key = type_key(constant_sasa->atomDataSasa[i][0].residueName, "");
+		if ((key == 0) || ((e = list_entry(&entry, nEntry, &allocated, key))->residueType >= 0))
+			continue;
+		e->residueType = i;
+		for (j = 0; j < constant_sasa->nAtomResidue[i]; ++ j) {
+			key = type_key(constant_sasa->atomDataSasa[i][0].residueName,
+							constant_sasa->atomDataSasa[i][j].atomName);
+			if ((key == 0) || ((e = list_entry(&entry, nEntry, &allocated, key))->atomType >= 0))
+				continue;
+			e->residueType = i;
+			e->atomType = j;
+		}
+	}
+
+	/* atom groups */
+	for (i = 0; i < atomGroup->nResidueType; ++ i) {
+		key = type_key(atomGroup->atomDataGroup[i][0].residueName, "");
+		if ((key == 0) || ((e = list_entry(&entry, nEntry, &allocated, key))->groupResidue >= 0))
+			continue;
+		e->groupResidue = i;
+		for (j = 0; j < atomGroup->nAtomResidue[i]; ++ j) {
+			key = type_key(atomGroup->atomDataGroup[i][0].residueName,
+							atomGroup->atomDataGroup[i][j].atomName);
+			if ((key == 0) || ((e = list_entry(&entry, nEntry, &allocated, key))->groupAtomType >= 0))
+				continue;
+			e->groupResidue = i;
+			e->groupAtomType = atomGroup->atomDataGroup[i][j].atomType;
+			e->groupID = atomGroup->atomDataGroup[i][j].groupID;
+		}
+	}
+
+	return entry;
+}
+
+/*____________________________________________________________________________*/
+/** place keys: returns 0 on success, 1 if a bucket could not be placed */
+static int place_entries(TypeHash *typeHash, TypeEntry *entry, unsigned int nEntry)
+{
+	unsigned int i, j, k, b;
+	unsigned int displace;
+	unsigned int maxDisplace = 1 << 16;
+	unsigned int *bucketSize = safe_malloc(typeHash->nBucket * sizeof(unsigned int));
+	unsigned int *bucketOrder = safe_malloc(typeHash->nBucket * sizeof(unsigned int));
+	unsigned int *member = safe_malloc(nEntry * sizeof(unsigned int));
+	unsigned int *slotTrial = safe_malloc(nEntry * sizeof(unsigned int));
+	unsigned int nMember, tmp;
+	int collision;
+
+	/* bucket sizes and bucket order by decreasing size */
+	memset(bucketSize, 0, typeHash->nBucket * sizeof(unsigned int));
+	for (i = 0; i < nEntry; ++ i)
+		++ bucketSize[key_bucket(typeHash, entry[i].key)];
+	for (b = 0; b < typeHash->nBucket; ++ b)
+		bucketOrder[b] = b;
+	for (i = 1; i < typeHash->nBucket; ++ i) {
+		tmp = bucketOrder[i];
+		for (j = i; (j > 0) && (bucketSize[bucketOrder[j - 1]] < bucketSize[tmp]); -- j)
+			bucketOrder[j] = bucketOrder[j - 1];
+		bucketOrder[j] = tmp;
+	}
+
+	for (b = 0; b < typeHash->nBucket; ++ b) {
+		typeHash->displace[bucketOrder[b]] = 0;
+		if (bucketSize[bucketOrder[b]] == 0)
+			break;
+
+		/* keys of this bucket */
+		for (i = 0, nMember = 0; i < nEntry; ++ i)
+			if (key_bucket(typeHash, entry[i].key) == bucketOrder[b])
+				member[nMember ++] = i;
+
+		/* first displacement without collisions */
+		for (displace = 0; displace < maxDisplace; ++ displace) {
+			collision = 0;
+			for (k = 0; (k < nMember) && (! collision); ++ k) {
+				slotTrial[k] = key_slot(typeHash, entry[member[k]].key, displace);
+				if (typeHash->slot[slotTrial[k]].key != 0)
+					collision = 1;
+				for (j = 0; (j < k) && (! collision); ++ j)
+					if (slotTrial[j] == slotTrial[k])
+						collision = 1;
+			}
+			if (! collision)
+				break;
+		}
+
+		if (displace == maxDisplace)
+			break;
+
+		typeHash->displace[bucketOrder[b]] = displace;
+		for (k = 0; k < nMember; ++ k)
+			typeHash->slot[slotTrial[k]] = entry[member[k]];
+	}
+
+	collision = ((b < typeHash->nBucket) && (bucketSize[bucketOrder[b]] != 0));
+
+	free(bucketSize);
+	free(bucketOrder);
+	free(member);
+	free(slotTrial);
+
+	return collision;
+}
+
+/*____________________________________________________________________________*/
+/** generate perfect hash of the SASA/SIGMA and atom group parameter tables */
+int init_typehash(TypeHash *typeHash, ConstantSasa *constant_sasa, Atomgroup *atomGroup)
+{
+	unsigned int nEntry = 0;
+	TypeEntry *entry = collect_entries(constant_sasa, atomGroup, &nEntry);
+	TypeEntry *e;
+
+	typeHash->nEntry = nEntry;
+	typeHash->slot = 0;
+	typeHash->displace = 0;
+
+	/* grow the table until all buckets can be placed */
+	for (typeHash->nSlot = 64; typeHash->nSlot < nEntry + nEntry / 4; typeHash->nSlot <<= 1);
+	for (;;) {
+		typeHash->nBucket = typeHash->nSlot >> 2;
+		typeHash->slot = safe_realloc(typeHash->slot, typeHash->nSlot * sizeof(TypeEntry));
+		typeHash->displace = safe_realloc(typeHash->displace, typeHash->nBucket * sizeof(unsigned int));
+		memset(typeHash->slot, 0, typeHash->nSlot * sizeof(TypeEntry));
+		memset(typeHash->displace, 0, typeHash->nBucket * sizeof(unsigned int));
+		if (place_entries(typeHash, entry, nEntry) == 0)
+			break;
+		typeHash->nSlot <<= 1;
+	}
+
+	free(entry);
+
+	/* residue types of fallback residues */
+	typeHash->anyResidue = ((e = find_type(typeHash, type_key("ANY", ""))) != 0) ? e->residueType : -1;
+	typeHash->unkResidue = ((e = find_type(typeHash, type_key("UNK", ""))) != 0) ? e->residueType : -1;
+	if (typeHash->unkResidue < 0)
+		Error("Parameter set lacks residue type 'UNK'");
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/** lookup of key, 0 if not a parameterised name */
+TypeEntry *find_type(TypeHash *typeHash, uint64_t key)
+{
+	TypeEntry *e;
+
+	if (key == 0)
+		return 0;
+
+	e = &(typeHash->slot[key_slot(typeHash, key,
+			typeHash->displace[key_bucket(typeHash, key)])]);
+
+	return (e->key == key) ? e : 0;
+}
+
+/*____________________________________________________________________________*/
+/** free perfect hash */
+void free_typehash(TypeHash *typeHash)
+{
+	free(typeHash->slot);
+	free(typeHash->displace);
+}
+
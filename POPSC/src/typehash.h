@@ -0,0 +1,53 @@
+/*==============================================================================
+typehash.h : perfect hash of (residue, atom) names to parameter types
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef TYPEHASH_H
+#define TYPEHASH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atomgroup.h"
+#include "error.h"
+#include "safe.h"
+#include "sasa_const.h"
+
+/*___________________________________________________________________________*/
+/* data structures */
+/* type entry of a (residue, atom) name pair;
+	entries with an empty atom name hold the residue types */
+typedef struct {
+	uint64_t key; /* packed residue and atom name */
+	int residueType; /* SASA/SIGMA residue type, -1 if undefined */
+	int atomType; /* SASA/SIGMA atom type, -1 if undefined */
+	int groupResidue; /* atom group residue type, -1 if undefined */
+	int groupAtomType; /* GROMOS atom type, -1 if undefined */
+	int groupID; /* atom group ID */
+} TypeEntry;
+
+/* perfect hash: the bucket of a key selects a displacement
+	that maps all keys of the bucket to distinct, unused slots */
+typedef struct {
+	unsigned int nEntry; /* number of entries */
+	unsigned int nSlot; /* number of slots (power of 2) */
+	unsigned int nBucket; /* number of buckets (power of 2) */
+	unsigned int *displace; /* displacement per bucket */
+	TypeEntry *slot; /* hash slots, empty slots have key 0 */
+	int anyResidue; /* residue type of 'ANY' (OXT, O1, O2) */
+	int unkResidue; /* residue type of 'UNK' (unknown polymer residues) */
+} TypeHash;
+
+/*____________________________________________________________________________*/
+/* prototypes */
+uint64_t type_key(const char *residueName, const char *atomName);
+int init_typehash(TypeHash *typeHash, ConstantSasa *constant_sasa, Atomgroup *atomGroup);
+TypeEntry *find_type(TypeHash *typeHash, uint64_t key);
+void free_typehash(TypeHash *typeHash);
+
+#endif
+
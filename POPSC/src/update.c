@@ -0,0 +1,484 @@
+/*==============================================================================
+update.c : incremental SASA update after local coordinate changes
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "config.h"
+#include "update.h"
+
+/*____________________________________________________________________________*/
+/* The SASA of an atom depends only on its own interactions, which
+	'compute_sasa' processes in a fixed order: bonds, angles, torsions,
+	then the non-bonded pairs (i < j) in ascending order of i and j.
+	When atoms move, only the moved atoms, their bonded partners and their
+	old and new non-bonded partners change their interactions. The update
+	moves the atoms in a cell grid, replaces their non-bonded pairs in
+	'topol->neighbourState' (rows in ascending order) and recomputes
+	the affected atoms with 'compute_sasa_atom' in the order of a full
+	computation. Residue SASAs of affected atoms are summed again,
+	chain and molecule SASAs are corrected by the change of the atom SASAs.
+	The bonded topology is kept from the last full computation; the lists
+	'topol->in/jn', the neighbour parameters, the interface neighbours
+	and the SFE are not updated. */
+
+#define MAXCELL 64 /* grid cells per dimension */
+
+/*____________________________________________________________________________*/
+/** grid cell of a position; positions outside the grid of the
+	initial coordinates are assigned to the border cells */
+static int grid_cell(PopsUpdate *update, float x, float y, float z)
+{
+	int d, c[3];
+	float pos[3];
+
+	pos[0] = x; pos[1] = y; pos[2] = z;
+	for (d = 0; d < 3; ++ d) {
+		c[d] = (int)floor((pos[d] - update->origin[d]) / update->cellSize);
+		if (c[d] < 0) c[d] = 0;
+		if (c[d] >= update->nCell[d]) c[d] = update->nCell[d] - 1;
+	}
+
+	return (c[2] * update->nCell[1] + c[1]) * update->nCell[0] + c[0];
+}
+
+/*____________________________________________________________________________*/
+/** insert atom 'a' into cell 'c' */
+static void cell_insert(PopsUpdate *update, int a, int c)
+{
+	update->cell[a] = c;
+	update->cellPrev[a] = -1;
+	update->cellNext[a] = update->cellHead[c];
+	if (update->cellHead[c] >= 0)
+		update->cellPrev[update->cellHead[c]] = a;
+	update->cellHead[c] = a;
+}
+
+/*____________________________________________________________________________*/
+/** remove atom 'a' from its cell */
+static void cell_remove(PopsUpdate *update, int a)
+{
+	if (update->cellPrev[a] >= 0)
+		update->cellNext[update->cellPrev[a]] = update->cellNext[a];
+	else
+		update->cellHead[update->cell[a]] = update->cellNext[a];
+	if (update->cellNext[a] >= 0)
+		update->cellPrev[update->cellNext[a]] = update->cellPrev[a];
+}
+
+/*____________________________________________________________________________*/
+/** atoms in the 27 cells around the cell of atom 'a', written to 'candidate'
+	(size of the number of atoms); returns the number of atoms */
+int update_neighbours(PopsUpdate *update, int a, int *candidate)
+{
+	int j, c, cx, cy, cz;
+	int nCandidate = 0;
+	int c0 = update->cell[a] % update->nCell[0];
+	int c1 = (update->cell[a] / update->nCell[0]) % update->nCell[1];
+	int c2 = update->cell[a] / (update->nCell[0] * update->nCell[1]);
+
+	for (cz = c2 - 1; cz <= c2 + 1; ++ cz) {
+		if (cz < 0 || cz >= update->nCell[2]) continue;
+		for (cy = c1 - 1; cy <= c1 + 1; ++ cy) {
+			if (cy < 0 || cy >= update->nCell[1]) continue;
+			for (cx = c0 - 1; cx <= c0 + 1; ++ cx) {
+				if (cx < 0 || cx >= update->nCell[0]) continue;
+				c = (cz * update->nCell[1] + cy) * update->nCell[0] + cx;
+				for (j = update->cellHead[c]; j >= 0; j = update->cellNext[j])
+					candidate[nCandidate ++] = j;
+			}
+		}
+	}
+
+	return nCandidate;
+}
+
+/*____________________________________________________________________________*/
+/** insert neighbour 'j' into the ascending neighbour row of atom 'i' */
+static void insert_neighbour(Topol *topol, int i, int j)
+{
+	int k;
+	int *row = topol->neighbourState[i];
+
+	++ row[0];
+	assert(row[0] < 1024);
+	for (k = row[0]; k > 1 && row[k - 1] > j; -- k)
+		row[k] = row[k - 1];
+	row[k] = j;
+}
+
+/*____________________________________________________________________________*/
+/** remove neighbour 'j' from the neighbour row of atom 'i' */
+static void remove_neighbour(Topol *topol, int i, int j)
+{
+	int k;
+	int *row = topol->neighbourState[i];
+
+	for (k = 1; k <= row[0] && row[k] != j; ++ k)
+		;
+	for (; k < row[0]; ++ k)
+		row[k] = row[k + 1];
+	if (k == row[0])
+		-- row[0];
+}
+
+/*____________________________________________________________________________*/
+/** add (sign 1) or subtract (sign -1) the SASA of atom 'a'
+	to or from its chain and the molecule */
+static void sum_atom(MolSasa *molSasa, View *view, int a, double sign)
+{
+	AtomSasa *atomSasa = &(molSasa->atomSasa[a]);
+	ChainSasa *chainSasa = &(molSasa->chainSasa[view->chainIndex[a]]);
+
+	if (view->polarity[a] == 0) {
+		chainSasa->phobicSasa += sign * atomSasa->sasa;
+		molSasa->phobicSasa += sign * atomSasa->sasa;
+	} else {
+		chainSasa->philicSasa += sign * atomSasa->sasa;
+		molSasa->philicSasa += sign * atomSasa->sasa;
+	}
+	chainSasa->sasa += sign * atomSasa->sasa;
+	molSasa->sasa += sign * atomSasa->sasa;
+
+	chainSasa->phobicbSasa += sign * atomSasa->phobicbSasa;
+	chainSasa->philicbSasa += sign * atomSasa->philicbSasa;
+	chainSasa->bSasa += sign * (atomSasa->phobicbSasa + atomSasa->philicbSasa);
+	molSasa->phobicbSasa += sign * atomSasa->phobicbSasa;
+	molSasa->philicbSasa += sign * atomSasa->philicbSasa;
+	molSasa->bSasa += sign * (atomSasa->phobicbSasa + atomSasa->philicbSasa);
+}
+
+/*____________________________________________________________________________*/
+/** sum the atom SASAs of residue 'r', as in 'compute_res_chain_mol_sasa' */
+static void sum_residue(MolSasa *molSasa, View *view, int r)
+{
+	int i;
+	ResSasa *resSasa = &(molSasa->resSasa[r]);
+
+	resSasa->phobicSasa = 0.;
+	resSasa->philicSasa = 0.;
+	resSasa->sasa = 0.;
+	resSasa->nOverlap = 0;
+	resSasa->phobicbSasa = 0.;
+	resSasa->philicbSasa = 0.;
+	resSasa->bSasa = 0.;
+
+	for (i = resSasa->atomRef; i < view->nAtom && view->residueIndex[i] == r; ++ i) {
+		if (view->polarity[i] == 0)
+			resSasa->phobicSasa += molSasa->atomSasa[i].sasa;
+		else
+			resSasa->philicSasa += molSasa->atomSasa[i].sasa;
+		resSasa->sasa += molSasa->atomSasa[i].sasa;
+		resSasa->nOverlap += molSasa->atomSasa[i].nOverlap;
+		resSasa->phobicbSasa += molSasa->atomSasa[i].phobicbSasa;
+		resSasa->philicbSasa += molSasa->atomSasa[i].philicbSasa;
+		resSasa->bSasa += molSasa->atomSasa[i].phobicbSasa + molSasa->atomSasa[i].philicbSasa;
+	}
+}
+
+/*____________________________________________________________________________*/
+/** mark atom 'a' as affected */
+__inline__ static void mark_affected(PopsUpdate *update, int a)
+{
+	if (! update->affected[a]) {
+		update->affected[a] = 1;
+		update->affectedAtom[update->nAffected ++] = a;
+	}
+}
+
+/*____________________________________________________________________________*/
+/** add the interactions 'i'-'j' of separation 'connect' to the bonded lists */
+static void add_bonded(PopsUpdate *update, int *fill, int i, int j, char connect)
+{
+	AtomInteraction *interaction = 0;
+
+	interaction = &(update->bonded[update->bondedFirst[i] + fill[i] ++]);
+	interaction->partner = j;
+	interaction->connect = connect;
+	interaction->first = 1;
+
+	interaction = &(update->bonded[update->bondedFirst[j] + fill[j] ++]);
+	interaction->partner = i;
+	interaction->connect = connect;
+	interaction->first = 0;
+}
+
+/*____________________________________________________________________________*/
+/** initialise the update state of the SASA computed in 'result' */
+void pops_init_update(Arg *arg, Str *pdb, PopsResult *result, PopsUpdate *update)
+{
+	int i, d, nCell;
+	int maxBonded = 0;
+	int *fill = 0;
+	float maxRadius = 0.;
+	float extent = 0.;
+	float low[3], high[3];
+	View *view = &(result->view);
+	Topol *topol = &(result->topol);
+
+	update->nAtom = pdb->nAtom;
+	update->nResidue = (pdb->nAtom > 0) ? view->residueIndex[pdb->nAtom - 1] + 1 : 0;
+	update->nAffected = 0;
+	update->nUpdate = 0;
+	update->nFull = 0;
+
+	/*____________________________________________________________________________*/
+	/* bonded interactions of each atom in the order of 'compute_sasa' */
+	update->bondedFirst = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	fill = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	memset(fill, 0, (pdb->nAtom + 1) * sizeof(int));
+	for (i = 0; i < topol->nBond; ++ i) {
+		++ fill[topol->ib[i]]; ++ fill[topol->jb[i]];
+	}
+	for (i = 0; i < topol->nAngle; ++ i) {
+		++ fill[topol->it[i]]; ++ fill[topol->kt[i]];
+	}
+	for (i = 0; i < topol->nTorsion; ++ i) {
+		++ fill[topol->ip[i]]; ++ fill[topol->lp[i]];
+	}
+	update->bondedFirst[0] = 0;
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		update->bondedFirst[i + 1] = update->bondedFirst[i] + fill[i];
+		if (fill[i] > maxBonded)
+			maxBonded = fill[i];
+		fill[i] = 0;
+	}
+	update->bonded = safe_malloc((update->bondedFirst[pdb->nAtom] + 1) * sizeof(AtomInteraction));
+	for (i = 0; i < topol->nBond; ++ i)
+		add_bonded(update, fill, topol->ib[i], topol->jb[i], 2);
+	for (i = 0; i < topol->nAngle; ++ i)
+		add_bonded(update, fill, topol->it[i], topol->kt[i], 3);
+	for (i = 0; i < topol->nTorsion; ++ i)
+		add_bonded(update, fill, topol->ip[i], topol->lp[i], 4);
+	free(fill);
+
+	/* bonded and at most 1023 non-bonded interactions per atom */
+	update->allocatedInteraction = maxBonded + 1024;
+	update->interaction = safe_malloc(update->allocatedInteraction * sizeof(AtomInteraction));
+
+	/*____________________________________________________________________________*/
+	/* cell grid over the initial coordinates;
+		the cell size covers the largest non-bonded cutoff */
+	for (d = 0; d < 3; ++ d) {
+		low[d] = FLT_MAX;
+		high[d] = -FLT_MAX;
+	}
+	for (i = 0; i < pdb->nAtom; ++ i) {
+		if (view->radius[i] > maxRadius) maxRadius = view->radius[i];
+		if (view->x[i] < low[0]) low[0] = view->x[i];
+		if (view->x[i] > high[0]) high[0] = view->x[i];
+		if (view->y[i] < low[1]) low[1] = view->y[i];
+		if (view->y[i] > high[1]) high[1] = view->y[i];
+		if (view->z[i] < low[2]) low[2] = view->z[i];
+		if (view->z[i] > high[2]) high[2] = view->z[i];
+	}
+	update->cellSize = 2. * maxRadius + 2. * arg->rProbe + 0.01;
+	for (d = 0; d < 3; ++ d) {
+		update->origin[d] = (pdb->nAtom > 0) ? low[d] : 0.;
+		if (pdb->nAtom > 0 && (high[d] - low[d]) > extent)
+			extent = high[d] - low[d];
+	}
+	if (extent / update->cellSize >= MAXCELL)
+		update->cellSize = extent / (MAXCELL - 1);
+	for (d = 0, nCell = 1; d < 3; ++ d) {
+		update->nCell[d] = (pdb->nAtom > 0) ? \
+			(int)((high[d] - low[d]) / update->cellSize) + 1 : 1;
+		nCell *= update->nCell[d];
+	}
+
+	update->cell = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	update->cellNext = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	update->cellPrev = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	update->cellHead = safe_malloc(nCell * sizeof(int));
+	for (i = 0; i < nCell; ++ i)
+		update->cellHead[i] = -1;
+	/* descending, so that each cell lists its atoms in ascending order */
+	for (i = pdb->nAtom - 1; i >= 0; -- i)
+		cell_insert(update, i, grid_cell(update, view->x[i], view->y[i], view->z[i]));
+
+	/*____________________________________________________________________________*/
+	/* scratch of one update */
+	update->moved = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	update->affectedAtom = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	update->candidate = safe_malloc((pdb->nAtom + 1) * sizeof(int));
+	update->dirtyResidue = safe_malloc((update->nResidue + 1) * sizeof(int));
+	update->moving = safe_malloc(pdb->nAtom + 1);
+	update->affected = safe_malloc(pdb->nAtom + 1);
+	update->dirty = safe_malloc(update->nResidue + 1);
+	memset(update->moving, 0, pdb->nAtom + 1);
+	memset(update->affected, 0, pdb->nAtom + 1);
+	memset(update->dirty, 0, update->nResidue + 1);
+}
+
+/*____________________________________________________________________________*/
+/** update the SASA of 'result' after moving the atoms 'moved' to their
+	coordinates in 'pdb'; returns POPS_OK or POPS_ERR_CONTACT;
+	after POPS_ERR_CONTACT the residue, chain and molecule SASAs are the
+	sums of the atom SASAs, but the atoms not yet recomputed keep their
+	previous SASA: the result is invalid until recomputed, for example
+	with 'pops_compute_frame' */
+int pops_update(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsUpdate *update, int *moved, int nMoved)
+{
+	int i, j, k, m, a, cell;
+	int nInteraction, nDirty, nCandidate;
+	int ret = POPS_OK;
+	View *view = &(result->view);
+	Topol *topol = &(result->topol);
+	MolSasa *molSasa = &(result->molSasa);
+	int *row = 0;
+	AtomSasa previous;
+
+	update->nAffected = 0;
+	for (i = 0; i < nMoved; ++ i)
+		update->moving[moved[i]] = 1;
+
+	/*____________________________________________________________________________*/
+	/* new positions; the moved atoms, their bonded partners and
+		their previous non-bonded partners are affected */
+	for (i = 0; i < nMoved; ++ i) {
+		m = moved[i];
+		view->x[m] = pdb->atom[m].pos.x;
+		view->y[m] = pdb->atom[m].pos.y;
+		view->z[m] = pdb->atom[m].pos.z;
+		if ((cell = grid_cell(update, view->x[m], view->y[m], view->z[m])) != update->cell[m]) {
+			cell_remove(update, m);
+			cell_insert(update, m, cell);
+		}
+
+		mark_affected(update, m);
+		for (k = update->bondedFirst[m]; k < update->bondedFirst[m + 1]; ++ k)
+			mark_affected(update, update->bonded[k].partner);
+		row = topol->neighbourState[m];
+		for (k = 1; k <= row[0]; ++ k) {
+			mark_affected(update, row[k]);
+			if (! update->moving[row[k]])
+				remove_neighbour(topol, row[k], m);
+		}
+	}
+	for (i = 0; i < nMoved; ++ i)
+		topol->neighbourState[moved[i]][0] = 0;
+
+	/*____________________________________________________________________________*/
+	/* new non-bonded partners from the 27 cells around each moved atom;
+		a pair of moved atoms is found from its lower atom */
+	for (i = 0; i < nMoved; ++ i) {
+		m = moved[i];
+		nCandidate = update_neighbours(update, m, update->candidate);
+		for (k = 0; k < nCandidate; ++ k) {
+			j = update->candidate[k];
+			if (j == m || (update->moving[j] && j < m))
+				continue;
+			if (view_distance(view, m, j) < cutoff_radius(view, m, j, arg->rProbe) && \
+				! topol_bonded(topol, m, j)) {
+				insert_neighbour(topol, m, j);
+				insert_neighbour(topol, j, m);
+				mark_affected(update, j);
+			}
+		}
+	}
+
+	/*____________________________________________________________________________*/
+	/* SASA of the affected atoms from their bonded and non-bonded interactions */
+	for (i = 0, nDirty = 0; i < update->nAffected; ++ i) {
+		a = update->affectedAtom[i];
+
+		nInteraction = 0;
+		for (k = update->bondedFirst[a]; k < update->bondedFirst[a + 1]; ++ k)
+			update->interaction[nInteraction ++] = update->bonded[k];
+		row = topol->neighbourState[a];
+		for (k = 1; k <= row[0]; ++ k) {
+			update->interaction[nInteraction].partner = row[k];
+			update->interaction[nInteraction].connect = 5;
+			update->interaction[nInteraction].first = (a < row[k]);
+			++ nInteraction;
+		}
+		assert(nInteraction <= update->allocatedInteraction);
+
+		previous = molSasa->atomSasa[a];
+		sum_atom(molSasa, view, a, -1.);
+		if ((ret = compute_sasa_atom(view, &(result->type), molSasa, ctx->constant_sasa, \
+				arg->rProbe, a, update->interaction, nInteraction)) != POPS_OK) {
+			/* the previous SASA of the atom, partially overwritten */
+			molSasa->atomSasa[a] = previous;
+			sum_atom(molSasa, view, a, 1.);
+			break;
+		}
+		sum_atom(molSasa, view, a, 1.);
+
+		if (! update->dirty[view->residueIndex[a]]) {
+			update->dirty[view->residueIndex[a]] = 1;
+			update->dirtyResidue[nDirty ++] = view->residueIndex[a];
+		}
+	}
+
+	/* residue SASAs of the recomputed atoms */
+	for (i = 0; i < nDirty; ++ i) {
+		sum_residue(molSasa, view, update->dirtyResidue[i]);
+		update->dirty[update->dirtyResidue[i]] = 0;
+	}
+
+	/* clear scratch */
+	for (i = 0; i < update->nAffected; ++ i)
+		update->affected[update->affectedAtom[i]] = 0;
+	for (i = 0; i < nMoved; ++ i)
+		update->moving[moved[i]] = 0;
+
+	return ret;
+}
+
+/*____________________________________________________________________________*/
+/** SASA of the current coordinates of 'pdb', e.g. of a trajectory frame:
+	updated incrementally if at most a quarter of the atoms moved,
+	otherwise computed anew with 'pops_compute_frame' */
+int pops_update_frame(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result, PopsUpdate *update)
+{
+	int i, ret;
+	int nMoved = 0;
+	int nUpdate = update->nUpdate;
+	int nFull = update->nFull;
+	View *view = &(result->view);
+
+	for (i = 0; i < pdb->nAtom; ++ i)
+		if (view->x[i] != pdb->atom[i].pos.x || \
+			view->y[i] != pdb->atom[i].pos.y || \
+			view->z[i] != pdb->atom[i].pos.z)
+			update->moved[nMoved ++] = i;
+
+	if (nMoved <= pdb->nAtom / 4) {
+		++ update->nUpdate;
+		return pops_update(ctx, arg, pdb, result, update, update->moved, nMoved);
+	}
+
+	/* new topology and grid */
+	if ((ret = pops_compute_frame(ctx, arg, argpdb, pdb, result)) != POPS_OK)
+		return ret;
+	pops_free_update(update);
+	pops_init_update(arg, pdb, result, update);
+	update->nUpdate = nUpdate;
+	update->nFull = nFull + 1;
+
+	return POPS_OK;
+}
+
+/*____________________________________________________________________________*/
+/** free update state */
+void pops_free_update(PopsUpdate *update)
+{
+	free(update->bondedFirst);
+	free(update->bonded);
+	free(update->interaction);
+	free(update->cell);
+	free(update->cellHead);
+	free(update->cellNext);
+	free(update->cellPrev);
+	free(update->moved);
+	free(update->affectedAtom);
+	free(update->candidate);
+	free(update->dirtyResidue);
+	free(update->moving);
+	free(update->affected);
+	free(update->dirty);
+}
+
@@ -0,0 +1,69 @@
+/*==============================================================================
+update.h : incremental SASA update after local coordinate changes
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "arg.h"
+#include "argpdb.h"
+#include "error.h"
+#include "libpops.h"
+#include "safe.h"
+#include "sasa.h"
+#include "topol.h"
+#include "view.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* state of the incremental update of a result; the bonded topology and
+	the cell grid persist between updates, the non-bonded neighbours are
+	those of 'result->topol' */
+typedef struct {
+	int nAtom;
+	int nResidue;
+	int *bondedFirst; /* first bonded interaction of each atom, nAtom + 1 */
+	AtomInteraction *bonded; /* bonds, angles and torsions of each atom */
+	int nCell[3]; /* grid dimensions */
+	float origin[3]; /* grid origin */
+	float cellSize; /* cell edge length, at least the non-bonded cutoff */
+	int *cell; /* cell of each atom */
+	int *cellHead; /* first atom of each cell, -1 if empty */
+	int *cellNext; /* next and previous atom of the same cell */
+	int *cellPrev;
+	int *moved; /* moved atoms of a frame */
+	char *moving; /* atom moved in this update */
+	char *affected; /* atom with changed interactions */
+	char *dirty; /* residue with changed atoms */
+	int *affectedAtom; /* list of affected atoms */
+	int *candidate; /* atoms of the cells around one atom */
+	int *dirtyResidue; /* list of dirty residues */
+	AtomInteraction *interaction; /* interactions of one atom */
+	int allocatedInteraction;
+	int nAffected; /* atoms recomputed in the last update */
+	int nUpdate; /* incremental updates */
+	int nFull; /* full recomputations */
+} PopsUpdate;
+
+/*___________________________________________________________________________*/
+/* prototypes */
+int update_neighbours(PopsUpdate *update, int a, int *candidate);
+void pops_init_update(Arg *arg, Str *pdb, PopsResult *result, PopsUpdate *update);
+/* after POPS_ERR_CONTACT the result is invalid and must be recomputed */
+int pops_update(PopsContext *ctx, Arg *arg, Str *pdb, PopsResult *result, \
+	PopsUpdate *update, int *moved, int nMoved);
+int pops_update_frame(PopsContext *ctx, Arg *arg, Argpdb *argpdb, Str *pdb, \
+	PopsResult *result, PopsUpdate *update);
+void pops_free_update(PopsUpdate *update);
+
+#endif
+
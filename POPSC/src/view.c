@@ -0,0 +1,300 @@
+/*==============================================================================
+view.c : compact compute view of the atoms of a structure
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#include "view.h"
+
+/*____________________________________________________________________________*/
+/* Morton sort key */
+typedef struct {
+	uint64_t code; /* Morton code of atom cell */
+	int atom; /* atom index */
+} MortonKey;
+
+/*____________________________________________________________________________*/
+/** spread the lower 21 bits of 'v' to every third bit */
+__inline__ static uint64_t spread_bits(uint64_t v)
+{
+	v &= 0x1fffff;
+	v = (v | (v << 32)) & 0x1f00000000ffffULL;
+	v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+	v = (v | (v << 8)) & 0x100f00f00f00f00fULL;
+	v = (v | (v << 4)) & 0x10c30c30c30c30c3ULL;
+	v = (v | (v << 2)) & 0x1249249249249249ULL;
+	return v;
+}
+
+/*____________________________________________________________________________*/
+/** Morton (Z-curve) code of cell (cx, cy, cz) */
+__inline__ static uint64_t morton_code(int cx, int cy, int cz)
+{
+	return spread_bits(cx) | (spread_bits(cy) << 1) | (spread_bits(cz) << 2);
+}
+
+/*____________________________________________________________________________*/
+/** compare Morton keys: by code, then by atom index */
+static int compare_morton_key(const void *a, const void *b)
+{
+	const MortonKey *ka = (const MortonKey *)a;
+	const MortonKey *kb = (const MortonKey *)b;
+
+	if (ka->code != kb->code)
+		return (ka->code < kb->code) ? -1 : 1;
+	return (ka->atom - kb->atom);
+}
+
+/*____________________________________________________________________________*/
+/** grid cell of coordinate 'v' in dimension 'd' */
+__inline__ static int grid_cell(View *view, float v, int d)
+{
+	int c = (int)((v - view->origin[d]) / view->cellSize);
+
+	if (c < 0)
+		return 0;
+	if (c >= view->nCell[d])
+		return view->nCell[d] - 1;
+	return c;
+}
+
+/*____________________________________________________________________________*/
+/** free cell grid */
+static void free_grid(View *view)
+{
+	if (view->order) {
+		free(view->order);
+		free(view->mx);
+		free(view->cellFirst);
+		free(view->cellCount);
+		free(view->candidate);
+	}
+	view->order = 0;
+	view->mx = view->my = view->mz = 0;
+	view->cellFirst = view->cellCount = 0;
+	view->candidate = 0;
+	view->allocatedCandidate = 0;
+}
+
+/*____________________________________________________________________________*/
+/** create the compute view from typed atoms */
+void init_view(Str *pdb, Type *type, ConstantSasa *constant_sasa, View *view)
+{
+	unsigned int i;
+	int n = pdb->nAtom;
+	int residueIndex = 0;
+	int chainIndex = 0;
+	AtomdataSasa *atomData = 0;
+
+	/* one block: 5 float arrays, 3 int arrays, 3 char arrays */
+	view->nAtom = n;
+	view->block = safe_malloc((n > 0 ? n : 1) * \
+		(5 * sizeof(float) + 3 * sizeof(int) + 3 * sizeof(char)));
+
+	view->x = (float *)view->block;
+	view->y = view->x + n;
+	view->z = view->y + n;
+	view->radius = view->z + n;
+	view->parameter = view->radius + n;
+	view->residueNumber = (int *)(view->parameter + n);
+	view->residueIndex = view->residueNumber + n;
+	view->chainIndex = view->residueIndex + n;
+	view->chainId = (char *)(view->chainIndex + n);
+	view->polarity = view->chainId + n;
+	view->ring = view->polarity + n;
+
+	view->order = 0; /* no cell grid */
+
+	view_coordinates(pdb, view);
+
+	for (i = 0; i < n; ++ i) {
+		atomData = &(constant_sasa->atomDataSasa[type->residueType[i]][type->atomType[i]]);
+		view->radius[i] = atomData->radius;
+		view->parameter[i] = atomData->parameter;
+		view->polarity[i] = (char)atomData->polarity;
+		view->ring[i] = (char)atomData->ring;
+
+		/* residue and chain boundaries as used for SASA/SFE summation */
+		if (i > 0 && (pdb->atom[i].residueNumber != pdb->atom[i - 1].residueNumber ||
+				      strcmp(pdb->atom[i].icode, pdb->atom[i - 1].icode) != 0))
+			++ residueIndex;
+		if (i > 0 && pdb->atom[i].chainIdentifier[0] != pdb->atom[i - 1].chainIdentifier[0])
+			++ chainIndex;
+
+		view->residueNumber[i] = pdb->atom[i].residueNumber;
+		view->residueIndex[i] = residueIndex;
+		view->chainIndex[i] = chainIndex;
+		view->chainId[i] = pdb->atom[i].chainIdentifier[0];
+	}
+}
+
+/*____________________________________________________________________________*/
+/** (re)load coordinates, e.g. after copying a trajectory frame */
+void view_coordinates(Str *pdb, View *view)
+{
+	unsigned int i;
+
+	for (i = 0; i < view->nAtom; ++ i) {
+		view->x[i] = pdb->atom[i].pos.x;
+		view->y[i] = pdb->atom[i].pos.y;
+		view->z[i] = pdb->atom[i].pos.z;
+	}
+}
+
+/*____________________________________________________________________________*/
+/** sort atoms along a Morton curve over a cell grid;
+	the cell size is at least the largest non-bonded cutoff,
+	which also covers the (shorter) bond cutoffs;
+	coordinates change per trajectory frame, so call again after
+	'view_coordinates' */
+void morton_view(View *view, float rProbe)
+{
+	unsigned int i;
+	int d, cell;
+	int n = view->nAtom;
+	float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+	float maxRadius = 0.;
+	float pos[3];
+	double nCellTotal;
+	MortonKey *key = 0;
+
+	free_grid(view);
+
+	/*____________________________________________________________________________*/
+	/* bounding box and cutoff */
+	for (i = 0; i < n; ++ i) {
+		pos[0] = view->x[i]; pos[1] = view->y[i]; pos[2] = view->z[i];
+		for (d = 0; d < 3; ++ d) {
+			if (pos[d] < min[d]) min[d] = pos[d];
+			if (pos[d] > max[d]) max[d] = pos[d];
+		}
+		if (view->radius[i] > maxRadius)
+			maxRadius = view->radius[i];
+	}
+	if (n == 0) {
+		for (d = 0; d < 3; ++ d)
+			min[d] = max[d] = 0.;
+	}
+
+	view->cutoff = 2. * maxRadius + 2. * rProbe;
+	/* the margin keeps all pairs below the padded cutoff in adjacent cells */
+	view->cellSize = view->cutoff + 0.01;
+
+	/* limit the number of (mostly empty) cells of sparse structures */
+	do {
+		for (d = 0, nCellTotal = 1.; d < 3; ++ d) {
+			view->origin[d] = min[d];
+			view->nCell[d] = (int)((max[d] - min[d]) / view->cellSize) + 1;
+			nCellTotal *= view->nCell[d];
+		}
+		if (nCellTotal > (8. * n + 64.))
+			view->cellSize *= 1.25;
+	} while (nCellTotal > (8. * n + 64.));
+
+	/*____________________________________________________________________________*/
+	/* sort atoms by Morton code of their cell */
+	key = safe_malloc((n > 0 ? n : 1) * sizeof(MortonKey));
+	for (i = 0; i < n; ++ i) {
+		key[i].code = morton_code(grid_cell(view, view->x[i], 0),
+								  grid_cell(view, view->y[i], 1),
+								  grid_cell(view, view->z[i], 2));
+		key[i].atom = i;
+	}
+	qsort(key, n, sizeof(MortonKey), compare_morton_key);
+
+	/*____________________________________________________________________________*/
+	/* Morton-ordered coordinates and cell ranges */
+	view->order = safe_malloc((n > 0 ? n : 1) * sizeof(int));
+	view->mx = safe_malloc((n > 0 ? n : 1) * 3 * sizeof(float));
+	view->my = view->mx + n;
+	view->mz = view->my + n;
+	view->cellFirst = safe_malloc((int)nCellTotal * sizeof(int));
+	view->cellCount = safe_malloc((int)nCellTotal * sizeof(int));
+	memset(view->cellCount, 0, (int)nCellTotal * sizeof(int));
+
+	for (i = 0; i < n; ++ i) {
+		view->order[i] = key[i].atom;
+		view->mx[i] = view->x[key[i].atom];
+		view->my[i] = view->y[key[i].atom];
+		view->mz[i] = view->z[key[i].atom];
+
+		cell = (grid_cell(view, view->mz[i], 2) * view->nCell[1] + \
+				grid_cell(view, view->my[i], 1)) * view->nCell[0] + \
+				grid_cell(view, view->mx[i], 0);
+		if (view->cellCount[cell] == 0)
+			view->cellFirst[cell] = i;
+		++ view->cellCount[cell];
+	}
+
+	view->allocatedCandidate = 64;
+	view->candidate = safe_malloc(view->allocatedCandidate * sizeof(int));
+
+	free(key);
+}
+
+/*____________________________________________________________________________*/
+/** neighbour candidates of atom i: atoms j > i closer than the cutoff,
+	in ascending order, such that callers visit pairs in file order;
+	returns the number of candidates in 'view->candidate' */
+int view_neighbours(View *view, int i)
+{
+	int j, k, l, m, c[3], cx, cy, cz, cell;
+	int nCandidate = 0;
+	float dx, dy, dz;
+	float limit = (view->cutoff + 0.01) * (view->cutoff + 0.01);
+
+	c[0] = grid_cell(view, view->x[i], 0);
+	c[1] = grid_cell(view, view->y[i], 1);
+	c[2] = grid_cell(view, view->z[i], 2);
+
+	/* 27 adjacent cells; atoms of a cell are contiguous in Morton order */
+	for (cz = c[2] - 1; cz <= c[2] + 1; ++ cz) {
+		if (cz < 0 || cz >= view->nCell[2]) continue;
+		for (cy = c[1] - 1; cy <= c[1] + 1; ++ cy) {
+			if (cy < 0 || cy >= view->nCell[1]) continue;
+			for (cx = c[0] - 1; cx <= c[0] + 1; ++ cx) {
+				if (cx < 0 || cx >= view->nCell[0]) continue;
+				cell = (cz * view->nCell[1] + cy) * view->nCell[0] + cx;
+
+				for (k = view->cellFirst[cell], l = 0; l < view->cellCount[cell]; ++ k, ++ l) {
+					if (view->order[k] <= i)
+						continue;
+					dx = view->mx[k] - view->x[i];
+					dy = view->my[k] - view->y[i];
+					dz = view->mz[k] - view->z[i];
+					if ((dx * dx + dy * dy + dz * dz) >= limit)
+						continue;
+
+					/* add memory if needed */
+					if (nCandidate == view->allocatedCandidate) {
+						view->allocatedCandidate += 64;
+						view->candidate = safe_realloc(view->candidate, \
+							view->allocatedCandidate * sizeof(int));
+					}
+					view->candidate[nCandidate ++] = view->order[k];
+				}
+			}
+		}
+	}
+
+	/* insertion sort into file order */
+	for (k = 1; k < nCandidate; ++ k) {
+		j = view->candidate[k];
+		for (m = k - 1; m >= 0 && view->candidate[m] > j; -- m)
+			view->candidate[m + 1] = view->candidate[m];
+		view->candidate[m + 1] = j;
+	}
+
+	return nCandidate;
+}
+
+/*____________________________________________________________________________*/
+/** free compute view */
+void free_view(View *view)
+{
+	free_grid(view);
+	free(view->block);
+	view->block = 0;
+}
+
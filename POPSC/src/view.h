@@ -0,0 +1,73 @@
+/*==============================================================================
+view.h : compact compute view of the atoms of a structure
+Copyright (C) 2026 Jens Kleinjung
+Read the COPYING file for license information.
+==============================================================================*/
+
+#ifndef VIEW_H
+#define VIEW_H
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pdb_structure.h"
+#include "safe.h"
+#include "sasa_const.h"
+#include "type.h"
+
+/*___________________________________________________________________________*/
+/* structures */
+/* The 'Atom' records are large and hold mostly output strings;
+	the topology and SASA kernels read only the fields below,
+	stored as contiguous arrays (structure of arrays) in a single block. */
+typedef struct {
+	int nAtom; /* number of atoms */
+	float *x, *y, *z; /* coordinates */
+	float *radius; /* SASA atom radius */
+	float *parameter; /* SASA atom parameter */
+	int *residueNumber; /* PDB residue number */
+	int *residueIndex; /* consecutive residue index */
+	int *chainIndex; /* consecutive chain index */
+	char *chainId; /* chain identifier */
+	char *polarity; /* hydrophobic = 0, hydrophilic = 1 */
+	char *ring; /* not in ring = 0, in ring = 1 */
+	void *block; /* memory block of all arrays */
+	/* optional cell grid in Morton (Z-curve) order for the neighbour search;
+		'order' is 0 if the atoms are searched in file order */
+	int *order; /* atom index at each Morton rank */
+	float *mx, *my, *mz; /* coordinates in Morton order */
+	int *cellFirst; /* first Morton rank of each cell */
+	int *cellCount; /* number of atoms of each cell */
+	int nCell[3]; /* grid dimensions */
+	float origin[3]; /* grid origin */
+	float cellSize; /* cell edge length */
+	float cutoff; /* neighbour cutoff */
+	int *candidate; /* neighbour candidates of one atom */
+	int allocatedCandidate;
+} View;
+
+/*___________________________________________________________________________*/
+/** distance between atoms i and j; same arithmetic as 'v_rmsd' */
+__inline__ static float view_distance(View *view, int i, int j)
+{
+	float dx = view->x[i] - view->x[j];
+	float dy = view->y[i] - view->y[j];
+	float dz = view->z[i] - view->z[j];
+
+	return sqrt((double)dx * dx + (double)dy * dy + (double)dz * dz);
+}
+
+/*___________________________________________________________________________*/
+/* prototypes */
+void init_view(Str *pdb, Type *type, ConstantSasa *constant_sasa, View *view);
+void view_coordinates(Str *pdb, View *view);
+void morton_view(View *view, float rProbe);
+int view_neighbours(View *view, int i);
+void free_view(View *view);
+
+#endif
+
@@ -6,3 +6,7 @@ echo "--------------------------------------------------------------"
 
 ../src/pops --pdb 5lff.pdb --jsonOut || exit 1
 
+# residue names of PDB input are plain text
+grep '"aa_type"' .json > /dev/null || exit 1
+grep '"aa_type"' .json | grep -v '"aa_type":[[:space:]]*"[A-Z0-9]*"' && exit 1
+exit 0
@@ -0,0 +1,22 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test6a                                                       "
+echo "--------------------------------------------------------------"
+
+# the first run writes the structure pack, the second run loads it
+mkdir -p packs
+../src/pops --pdb 1f3r.pdb --packDir packs --popsOut pack1.out --atomOut --residueOut || exit 1
+../src/pops --pdb 1f3r.pdb --packDir packs --popsOut pack2.out --atomOut --residueOut || exit 1
+diff -I '^date:' pack1.out pack2.out || exit 1
+
+# a pack that cannot be renamed into place leaves no temporary file
+rm -rf packs_ro && mkdir packs_ro
+../src/pops --pdb 1f3r.pdb --packDir packs_ro --popsOut pack3.out > /dev/null || exit 1
+packFile=`ls packs_ro/*.popspack` || exit 1
+rm -f $packFile && mkdir $packFile
+../src/pops --pdb 1f3r.pdb --packDir packs_ro --popsOut pack3.out > /dev/null 2> pack3.err || exit 1
+grep -q "Cannot write structure pack" pack3.err || exit 1
+ls packs_ro | grep -q "\.tmp$" && exit 1
+rm -rf packs_ro pack3.out pack3.err
+exit 0
@@ -0,0 +1,13 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test6b                                                       "
+echo "--------------------------------------------------------------"
+
+# the Morton-ordered cell grid finds the same topology as the all-pair search
+../src/pops --pdb 1f3r.pdb --popsOut all.out --atomOut --residueOut --neighbourOut || exit 1
+mv neighbours.out all.neighbours.out
+../src/pops --pdb 1f3r.pdb --morton --popsOut morton.out --atomOut --residueOut --neighbourOut || exit 1
+diff -I '^date:' all.out morton.out || exit 1
+diff all.neighbours.out neighbours.out || exit 1
+
@@ -0,0 +1,14 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test6c                                                       "
+echo "--------------------------------------------------------------"
+
+# a structure without computable topology terminates regularly
+# with an empty JSON file
+grep -m 1 "^ATOM" 1f3r.pdb > one_atom.pdb
+rm -f .json
+../src/pops --pdb one_atom.pdb || exit 1
+test -f .json || exit 1
+test -s .json && exit 1
+rm -f .json one_atom.pdb
@@ -0,0 +1,24 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test7a                                                       "
+echo "--------------------------------------------------------------"
+
+# batch of a list file on 2 threads: per-entry outputs and a summary,
+# an unreadable entry is reported as failed
+rm -rf batch_out && mkdir batch_out
+printf "1f3r.pdb\n5lff.xml.gz\n# comment\nmissing.pdb\n" > batch.list
+../src/pops --batch batch.list --nThread 2 --outDirName batch_out > batch.log
+test $? -eq 1 || exit 1
+grep -q "3 entries, 2 computed, 0 current, 0 empty, 1 failed" batch.log || exit 1
+test -s batch_out/1f3r.pops.out || exit 1
+test -s batch_out/5lff.pops.out || exit 1
+# an entry whose output is not writable fails without stopping the batch
+rm -rf batch_out && mkdir batch_out && mkdir batch_out/5lff.pops.out
+printf "5lff.xml.gz\n1f3r.pdb\n" > batch.list
+../src/pops --batch batch.list --nThread 1 --outDirName batch_out > batch.log
+test $? -eq 1 || exit 1
+grep -q "2 entries, 1 computed, 0 current, 0 empty, 1 failed" batch.log || exit 1
+grep -q "output not writable" batch.log || exit 1
+test -s batch_out/1f3r.pops.out || exit 1
+rm -rf batch_out batch.list batch.log
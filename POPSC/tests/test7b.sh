@@ -0,0 +1,20 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test7b                                                       "
+echo "--------------------------------------------------------------"
+
+# the manifest skips entries with current output and recomputes
+# entries with changed options
+rm -rf manifest_out manifest.txt && mkdir manifest_out
+cp 1f3r.pdb manifest_out/a.pdb
+cp 1f3r.pdb manifest_out/b.pdb
+../src/pops --batch manifest_out --outDirName manifest_out --manifest manifest.txt > manifest.log || exit 1
+grep -q "2 entries, 2 computed, 0 current" manifest.log || exit 1
+../src/pops --batch manifest_out --outDirName manifest_out --manifest manifest.txt > manifest.log || exit 1
+grep -q "2 entries, 0 computed, 2 current" manifest.log || exit 1
+../src/pops --batch manifest_out --outDirName manifest_out --manifest manifest.txt --atomOut > manifest.log || exit 1
+grep -q "2 entries, 2 computed, 0 current" manifest.log || exit 1
+test `grep -c -v "^#" manifest.txt` -eq 2 || exit 1
+../src/pops --pdb manifest_out/a.pdb --manifest manifest.txt --atomOut --popsOut manifest_out/a.pops.out | grep -q "Output is current" || exit 1
+rm -rf manifest_out manifest.txt manifest.log
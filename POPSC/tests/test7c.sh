@@ -0,0 +1,37 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test7c                                                       "
+echo "--------------------------------------------------------------"
+
+# server mode: a structure file and inline atoms on one connection,
+# then shutdown; the client needs python3
+command -v python3 > /dev/null || exit 77
+rm -f pops.sock
+../src/pops --serve pops.sock --silent > /dev/null &
+i=0
+while [ ! -S pops.sock ] && [ $i -lt 50 ]; do sleep 0.1; i=$((i + 1)); done
+python3 - <<'PYEOF' || exit 1
+import json, socket
+s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+s.connect("pops.sock")
+f = s.makefile("rw")
+def request(r):
+    f.write(json.dumps(r) + "\n"); f.flush()
+    return json.loads(f.readline())
+r = request({"id": 1, "path": "1f3r.pdb", "level": "chain"})
+assert r["id"] == 1 and r["status"] == "ok", r
+assert r["molecule"]["sasa"] > 0 and len(r["chains"]) == 2
+atoms = [{"atom": a, "residue": "GLY", "chain": "A", "number": n,
+          "x": x + 3.8 * n, "y": y, "z": 0.}
+         for n in range(1, 4)
+         for (a, x, y) in (("N", 0., 0.), ("CA", 1.45, 0.), ("C", 2.0, 1.4), ("O", 1.3, 2.4))]
+r = request({"id": "inline", "atoms": atoms, "level": "atom"})
+assert r["status"] == "ok" and len(r["atoms"]) == 12, r
+r = request({"id": 3, "path": "missing.pdb"})
+assert r["status"] == "error", r
+f.write(json.dumps({"command": "shutdown"}) + "\n"); f.flush()
+PYEOF
+wait
+test -S pops.sock && exit 1
+exit 0
@@ -0,0 +1,25 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test8a                                                       "
+echo "--------------------------------------------------------------"
+
+# POPSCOMP of a 2-chain complex: isolated-chain SASA equals the SASA
+# of the chains computed separately, the buried SASA of the pair equals
+# the isolated-chain SASA minus the complex SASA
+rm -rf popscomp_out && mkdir popscomp_out
+../src/pops --pdb 1f3r.pdb --popscomp --rout --chainOut --nThread 2 \
+	--outDirName popscomp_out > /dev/null || exit 1
+test -s popscomp_out/deltaSASA.rpopsChain || exit 1
+for c in A B; do
+	awk -v c=$c '$1 == "ATOM" && substr($0, 22, 1) == c' 1f3r.pdb > popscomp_out/chain$c.pdb
+	../src/pops --pdb popscomp_out/chain$c.pdb --rout --routPrefix chain$c \
+		--outDirName popscomp_out > /dev/null || exit 1
+	grep -q "`tail -n 1 popscomp_out/chain$c.rpopsMolecule`" popscomp_out/isoSASA.rpopsChain || exit 1
+done
+awk 'FNR == 2 { s[FILENAME] = $NF } END {
+	d = s["popscomp_out/isoSASA.rpopsMolecule"] - s["popscomp_out/id.rpopsMolecule"] \
+		- s["popscomp_out/deltaSASA.rpopsMolecule"];
+	exit (d > 0.02 || d < -0.02) }' popscomp_out/isoSASA.rpopsMolecule \
+	popscomp_out/id.rpopsMolecule popscomp_out/deltaSASA.rpopsMolecule || exit 1
+rm -rf popscomp_out
@@ -0,0 +1,22 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test8b                                                       "
+echo "--------------------------------------------------------------"
+
+# POPSCOMP of 1f3r plus a rotated and translated copy (chains C, D):
+# the copies fall into the classes of chains A and B and
+# receive their isolated-chain SASA
+rm -rf popscomp_out && mkdir popscomp_out
+awk '$1 == "ATOM" { print }
+	$1 == "ATOM" { x = substr($0, 31, 8); y = substr($0, 39, 8);
+		c = (substr($0, 22, 1) == "A") ? "C" : "D";
+		copy[++ n] = sprintf("%s%s%s%8.3f%8.3f%s", substr($0, 1, 21), c,
+			substr($0, 23, 8), -y + 100., x, substr($0, 47)) }
+	END { for (i = 1; i <= n; ++ i) print copy[i] }' 1f3r.pdb > popscomp_out/dimer.pdb
+../src/pops --pdb popscomp_out/dimer.pdb --popscomp --rout --chainOut \
+	--outDirName popscomp_out > popscomp_out/log || exit 1
+grep -q "4 chains in 2 classes" popscomp_out/log || exit 1
+test "`awk '$2 == "A" || $2 == "C" { print $5, $6, $7 }' popscomp_out/isoSASA.rpopsChain | uniq | wc -l`" -eq 1 || exit 1
+test "`awk 'NR > 1 { print $2, $3, $4 }' popscomp_out/deltaSASA.rpopsMolecule | uniq | wc -l`" -eq 1 || exit 1
+rm -rf popscomp_out
@@ -0,0 +1,54 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9a                                                       "
+echo "--------------------------------------------------------------"
+
+# biological assembly of 1f3r chain B: a ring of four copies around
+# an axis parallel to z, given as REMARK 350 BIOMT records; all copies
+# have the same environment, only one is evaluated, and the result
+# equals that of the explicitly generated ring
+rm -rf assembly_out && mkdir assembly_out
+awk 'BEGIN {
+		print "REMARK 350 BIOMOLECULE: 1"
+		print "REMARK 350 APPLY THE FOLLOWING TO CHAINS: B"
+		split("1 0 -1 0", c, " "); split("0 1 0 -1", s, " ")
+		split("0 30 70 40", tx, " "); split("0 -40 -10 30", ty, " ")
+		for (k = 1; k <= 4; ++ k) {
+			printf("REMARK 350   BIOMT1 %3d %9.6f %9.6f %9.6f %14.5f\n", k, c[k], -s[k], 0, tx[k])
+			printf("REMARK 350   BIOMT2 %3d %9.6f %9.6f %9.6f %14.5f\n", k, s[k], c[k], 0, ty[k])
+			printf("REMARK 350   BIOMT3 %3d %9.6f %9.6f %9.6f %14.5f\n", k, 0, 0, 1, 0)
+		}
+	}
+	$1 == "ATOM" && substr($0, 22, 1) == "B" { print }' 1f3r.pdb > assembly_out/au.pdb
+awk 'BEGIN { split("1 0 -1 0", c, " "); split("0 1 0 -1", s, " ");
+		split("0 30 70 40", tx, " "); split("0 -40 -10 30", ty, " ");
+		split("A B C D", chain, " ") }
+	$1 == "ATOM" && substr($0, 22, 1) == "B" { line[++ n] = $0 }
+	END { for (k = 1; k <= 4; ++ k) for (i = 1; i <= n; ++ i) {
+		x = substr(line[i], 31, 8); y = substr(line[i], 39, 8)
+		printf("%s%s%s%8.3f%8.3f%s\n", substr(line[i], 1, 21), chain[k],
+			substr(line[i], 23, 8), c[k] * x - s[k] * y + tx[k],
+			s[k] * x + c[k] * y + ty[k], substr(line[i], 47)) } }' 1f3r.pdb > assembly_out/ring.pdb
+../src/pops --pdb assembly_out/au.pdb --assembly 1 --rout --routPrefix au --chainOut \
+	--outDirName assembly_out > assembly_out/log || exit 1
+grep -q "4 copies in 1 environment classes" assembly_out/log || exit 1
+../src/pops --pdb assembly_out/ring.pdb --rout --routPrefix ring --chainOut \
+	--outDirName assembly_out > /dev/null || exit 1
+cmp assembly_out/au.rpopsChain assembly_out/ring.rpopsChain || exit 1
+cmp assembly_out/au.rpopsMolecule assembly_out/ring.rpopsMolecule || exit 1
+# chains are named by single characters: more than 62 chains are rejected
+awk 'BEGIN {
+		print "REMARK 350 BIOMOLECULE: 1"
+		print "REMARK 350 APPLY THE FOLLOWING TO CHAINS: B"
+		for (k = 1; k <= 63; ++ k) {
+			printf("REMARK 350   BIOMT1 %3d %9.6f %9.6f %9.6f %14.5f\n", k, 1, 0, 0, 200 * k)
+			printf("REMARK 350   BIOMT2 %3d %9.6f %9.6f %9.6f %14.5f\n", k, 0, 1, 0, 0)
+			printf("REMARK 350   BIOMT3 %3d %9.6f %9.6f %9.6f %14.5f\n", k, 0, 0, 1, 0)
+		}
+	}
+	$1 == "ATOM" && substr($0, 22, 1) == "B" { print }' 1f3r.pdb > assembly_out/line.pdb
+../src/pops --pdb assembly_out/line.pdb --assembly 1 --outDirName assembly_out \
+	> /dev/null 2> assembly_out/err && exit 1
+grep -q "more than 62 chains" assembly_out/err || exit 1
+rm -rf assembly_out
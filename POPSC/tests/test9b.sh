@@ -0,0 +1,23 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9b                                                       "
+echo "--------------------------------------------------------------"
+
+# SASA at three probe radii from one neighbour list:
+# residue SASAs (8 columns) agree with those of a run at each radius alone
+rm -rf probe_out && mkdir probe_out
+../src/pops --pdb 1f3r.pdb --rProbe 1.0:2.0:0.5 --rout --residueOut \
+	--routPrefix probe --outDirName probe_out > probe_out/log || exit 1
+grep -q "SASA at 3 probe radii" probe_out/log || exit 1
+for r in 1.00 1.50 2.00; do
+	../src/pops --pdb 1f3r.pdb --rProbe $r --rout --residueOut \
+		--routPrefix single --outDirName probe_out --silent > /dev/null || exit 1
+	awk -F '\t' 'NR > 1 { print $1, $2, $3, $4, $5, $6, $7 }' \
+		probe_out/single.rpopsResidue > probe_out/single.txt
+	awk -F '\t' -v r=$r 'NF == 8 && $1 + 0 == r + 0 { print $2, $3, $4, $5, $6, $7, $8 }' \
+		probe_out/probe.rpopsProbe > probe_out/probe.txt
+	test -s probe_out/single.txt || exit 1
+	cmp -s probe_out/single.txt probe_out/probe.txt || exit 1
+done
+rm -rf probe_out
@@ -0,0 +1,20 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9c                                                       "
+echo "--------------------------------------------------------------"
+
+# atomic and coarse-grained SASA from one parse:
+# the outputs equal those of separate atomic and '--coarse' runs
+rm -rf dual_out && mkdir dual_out
+../src/pops --pdb 1f3r.pdb --dual --rout --residueOut --chainOut \
+	--outDirName dual_out > /dev/null || exit 1
+../src/pops --pdb 1f3r.pdb --rout --residueOut --chainOut \
+	--routPrefix atomic --outDirName dual_out > /dev/null || exit 1
+../src/pops --pdb 1f3r.pdb --coarse --rout --residueOut --chainOut \
+	--routPrefix coarse --outDirName dual_out > /dev/null || exit 1
+for level in Residue Chain Molecule; do
+	cmp -s dual_out/id.rpops$level dual_out/atomic.rpops$level || exit 1
+	cmp -s dual_out/coarse.id.rpops$level dual_out/coarse.rpops$level || exit 1
+done
+rm -rf dual_out coarse.distMatCA.dat
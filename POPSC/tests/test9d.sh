@@ -0,0 +1,37 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9d                                                       "
+echo "--------------------------------------------------------------"
+
+# incremental SASA update of trajectory frames:
+# frames with one moved residue equal the frames computed anew
+rm -rf update_out && mkdir update_out
+awk '$1 == "ATOM" && (substr($0, 17, 1) == " " || substr($0, 17, 1) == "A")' \
+	1f3r.pdb > update_out/ref.pdb
+# frame 0: reference; frames 1-3: one residue of chain B shifted
+awk 'function frame(res, dx) {
+		print "POSITIONRED";
+		for (i = 1; i <= n; ++ i)
+			printf("%15.9f%15.9f%15.9f\n",
+				(x[i] + ((num[i] == res) ? dx : 0)) / 10, y[i] / 10, z[i] / 10);
+		print "END";
+	}
+	{ ++ n; x[n] = substr($0, 31, 8); y[n] = substr($0, 39, 8);
+	  z[n] = substr($0, 47, 8); num[n] = substr($0, 23, 4) + 0; }
+	END { frame(0, 0); frame(40, 0.2); frame(41, -0.3); frame(41, 0.5); }' \
+	update_out/ref.pdb > update_out/ref.trc
+cd update_out
+../../src/pops --pdb ref.pdb --traj ref.trc --residueOut --chainOut \
+	--popstrajOut full > /dev/null || exit 1
+../../src/pops --pdb ref.pdb --traj ref.trc --residueOut --chainOut \
+	--popstrajOut incremental --incremental > /dev/null || exit 1
+for frame in 0 1 2 3; do
+	paste -d '\n' full.$frame.out incremental.$frame.out | awk '
+		NR % 2 == 1 { n = split($0, a, " "); next }
+		{ m = split($0, b, " "); if (m != n) exit 1;
+		  for (i = 1; i <= n; ++ i)
+			if (a[i] != b[i] && (a[i] - b[i] > 0.011 || b[i] - a[i] > 0.011)) exit 1 }' \
+		|| exit 1
+done
+cd .. && rm -rf update_out
@@ -0,0 +1,31 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9e                                                       "
+echo "--------------------------------------------------------------"
+
+# alanine scan: the SASA change of a scanned residue equals
+# the SASA difference between the mutant and the wild-type structure
+rm -rf scan_out && mkdir scan_out
+awk '$1 == "ATOM" && (substr($0, 17, 1) == " " || substr($0, 17, 1) == "A")' \
+	1f3r.pdb > scan_out/wt.pdb
+cd scan_out
+../../src/pops --pdb wt.pdb --popsOut wt.out > /dev/null || exit 1
+for residue in A:67 B:40; do
+	chain=${residue%:*}; number=${residue#*:}
+	# mutant: side chain truncated after CB
+	awk -v chain=$chain -v number=$number '
+		substr($0, 22, 1) == chain && substr($0, 23, 4) + 0 == number {
+			atom = substr($0, 13, 4); gsub(/ /, "", atom);
+			if (atom != "N" && atom != "CA" && atom != "C" && atom != "O" && atom != "CB") next;
+			$0 = substr($0, 1, 17) "ALA" substr($0, 21) }
+		{ print }' wt.pdb > mut.pdb
+	../../src/pops --pdb mut.pdb --popsOut mut.out > /dev/null || exit 1
+	../../src/pops --pdb wt.pdb --scan ALA --scanResidues $residue \
+		--popsscanOut scan.out > /dev/null || exit 1
+	wt=`grep -A 2 "MOLECULE" wt.out | tail -1 | awk '{ print $3 }'`
+	mut=`grep -A 2 "MOLECULE" mut.out | tail -1 | awk '{ print $3 }'`
+	tail -1 scan.out | awk -v wt=$wt -v mut=$mut '
+		{ d = mut - wt - $9; if (d > 0.011 || d < -0.011) exit 1 }' || exit 1
+done
+cd .. && rm -rf scan_out
@@ -0,0 +1,37 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9f                                                       "
+echo "--------------------------------------------------------------"
+
+# analytical SASA gradients: central finite differences of the molecular
+# SASA (step 0.1 A, SASA printed to 0.01 A^2) and zero net gradient
+rm -rf gradient_out && mkdir gradient_out
+awk '$1 == "ATOM" && (substr($0, 17, 1) == " " || substr($0, 17, 1) == "A")' \
+	1f3r.pdb > gradient_out/ref.pdb
+cd gradient_out
+../../src/pops --pdb ref.pdb --gradientOut > /dev/null || exit 1
+# translation invariance: the gradients of all atoms sum to zero
+awk 'NF == 15 && $1 + 0 > 0 { for (d = 7; d <= 15; ++ d) sum[d] += $d }
+	END { for (d = 7; d <= 15; ++ d) if (sum[d] > 0.01 || sum[d] < -0.01) exit 1 }' \
+	popsgradient.out || exit 1
+for atom in 10 33 2000; do
+	for column in 31 39 47; do
+		for step in 0.1 -0.1; do
+			awk -v atom=$atom -v column=$column -v step=$step '
+				substr($0, 7, 5) + 0 == atom {
+					x = substr($0, column, 8) + step;
+					$0 = substr($0, 1, column - 1) sprintf("%8.3f", x) substr($0, column + 8) }
+				{ print }' ref.pdb > shifted.pdb
+			../../src/pops --pdb shifted.pdb --popsOut shifted$step.out > /dev/null || exit 1
+		done
+		plus=`grep -A 2 "MOLECULE" shifted0.1.out | tail -1 | awk '{ print $3 }'`
+		minus=`grep -A 2 "MOLECULE" shifted-0.1.out | tail -1 | awk '{ print $3 }'`
+		awk -v atom=$atom -v column=$column -v plus=$plus -v minus=$minus '
+			$1 == atom { d = (plus - minus) / 0.2 - $(7 + (column - 31) / 8);
+				if (d > 0.25 || d < -0.25) exit 1 }' popsgradient.out || exit 1
+	done
+done
+# the topology of an assembly is not built
+../../src/pops --pdb ref.pdb --assembly 1 --gradientOut > /dev/null 2>&1 && exit 1
+cd .. && rm -rf gradient_out
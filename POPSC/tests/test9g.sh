@@ -0,0 +1,47 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9g                                                       "
+echo "--------------------------------------------------------------"
+
+# pose rescoring: the SASA of the isolated receptor and partner minus the
+# SASA buried in a pose equals the SASA of the transformed structure
+rm -rf pose_out && mkdir pose_out
+awk '$1 == "ATOM" && (substr($0, 17, 1) == " " || substr($0, 17, 1) == "A")' \
+	1f3r.pdb > pose_out/ref.pdb
+cd pose_out
+cat > poses.txt << END
+# rotation (row-major) and translation of chain A
+1 0 0 0 1 0 0 0 1 0 0 0
+1 0 0 0 1 0 0 0 1 100 0 0
+1 0 0 0 1 0 0 0 1 0.8 -0.5 0.3
+0.9950042 -0.0998334 0 0.0998334 0.9950042 0 0 0 1 0 0 0
+END
+../../src/pops --pdb ref.pdb --poses poses.txt --poseChain A --nThread 1 \
+	--popsposeOut pose1.out > /dev/null || exit 1
+../../src/pops --pdb ref.pdb --poses poses.txt --poseChain A --nThread 4 \
+	--popsposeOut pose4.out > /dev/null || exit 1
+cmp pose1.out pose4.out || exit 1
+isolated=`awk '/SASA\/A\^2:/ { sum += $3 } END { print sum }' pose1.out`
+# the pose far away buries nothing
+awk '$1 == 2 && $6 != 0.00 { exit 1 }' pose1.out || exit 1
+for pose in 1 3 4; do
+	matrix=`grep -v '^#' poses.txt | sed -n ${pose}p`
+	awk -v matrix="$matrix" 'BEGIN { split(matrix, m, " ") }
+		substr($0, 22, 1) == "A" {
+			x = substr($0, 31, 8); y = substr($0, 39, 8); z = substr($0, 47, 8);
+			$0 = substr($0, 1, 30) sprintf("%8.3f%8.3f%8.3f",
+				m[1] * x + m[2] * y + m[3] * z + m[10],
+				m[4] * x + m[5] * y + m[6] * z + m[11],
+				m[7] * x + m[8] * y + m[9] * z + m[12]) substr($0, 55) }
+		{ print }' ref.pdb > moved.pdb
+	../../src/pops --pdb moved.pdb --popsOut moved.out > /dev/null || exit 1
+	complex=`grep -A 2 "MOLECULE" moved.out | tail -1 | awk '{ print $3 }'`
+	awk -v pose=$pose -v isolated=$isolated -v complex=$complex '
+		$1 == pose { d = isolated - $6 - complex; if (d > 0.05 || d < -0.05) exit 1 }' \
+		pose1.out || exit 1
+done
+# the topology of an assembly or of the POPSCOMP components is not built
+../../src/pops --pdb ref.pdb --assembly 1 --poses poses.txt > /dev/null 2>&1 && exit 1
+../../src/pops --pdb ref.pdb --popscomp --poses poses.txt > /dev/null 2>&1 && exit 1
+cd .. && rm -rf pose_out
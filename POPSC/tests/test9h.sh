@@ -0,0 +1,25 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9h                                                       "
+echo "--------------------------------------------------------------"
+
+# parameter fit: the cached overlap terms reproduce the SASA of the
+# parameter tables; fitting to scaled reference SASA reduces the RMSD
+rm -rf fit_out && mkdir fit_out
+cd fit_out
+for structure in 1f3r 5lff; do
+	../../src/pops --pdb ../$structure.pdb --atomOut --popsOut $structure.out > /dev/null || exit 1
+	awk '/^=== ATOM SASAs/ { atom = 1; next } /^===/ { atom = 0 }
+		atom && $1 ~ /^[0-9]+$/ { print $1, $7 }' $structure.out > $structure.ref
+	awk '{ print $1, 0.9 * $2 }' $structure.ref > $structure.scaled
+done
+printf "# structure reference\n../1f3r.pdb 1f3r.ref\n../5lff.pdb 5lff.ref\n" > fit.list
+printf "../1f3r.pdb 1f3r.scaled\n../5lff.pdb 5lff.scaled\n" > scaled.list
+../../src/pops --fit fit.list --fitIterations 0 --popsfitOut fit.out > /dev/null || exit 1
+awk '/^RMSD\/A\^2 initial:/ { found = 1; if ($3 > 0.01) exit 1 }
+	END { if (! found) exit 1 }' fit.out || exit 1
+../../src/pops --fit scaled.list --popsfitOut scaled.out > /dev/null || exit 1
+awk '/^RMSD\/A\^2 initial:/ { initial = $3 } /^RMSD\/A\^2 fitted:/ { fitted = $3 }
+	END { if (fitted >= 0.5 * initial) exit 1 }' scaled.out || exit 1
+cd .. && rm -rf fit_out
@@ -0,0 +1,35 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9i                                                       "
+echo "--------------------------------------------------------------"
+
+# selection SASA: the atom SASAs of a selection, computed from the atoms
+# within the cutoff of the selection, equal those of the full computation
+rm -rf select_out && mkdir select_out
+cd select_out
+../../src/pops --pdb ../1f3r.pdb --atomOut --popsOut full.out > /dev/null || exit 1
+for selection in A B:100-120,@1-30 A:70; do
+	../../src/pops --pdb ../1f3r.pdb --select $selection --popsselectOut select.out \
+		> /dev/null || exit 1
+	awk 'NR == FNR { if (/^=== ATOM SASAs/) atom = 1; else if (/^===/) atom = 0;
+			if (atom && $1 ~ /^[0-9]+$/) sasa[$1] = $7; next }
+		/^=== SELECTION ATOM SASAs/ { atom = 1; next } /^===/ { atom = 0 }
+		atom && $1 ~ /^[0-9]+$/ { ++ n; if (sasa[$1] != $7) exit 1 }
+		END { if (n == 0) exit 1 }' full.out select.out || exit 1
+done
+# the selection total is the sum of its atoms
+awk '/^=== SELECTION ATOM SASAs/ { atom = 1; next } /^=== SELECTION SASA ===/ { total = 1 }
+	/^===/ { atom = 0 }
+	atom && $1 ~ /^[0-9]+$/ { sum += $7 }
+	total && $1 ~ /^[0-9.]+$/ { d = sum - $3; if (d > 0.05 || d < -0.05) exit 1; found = 1 }
+	END { if (! found) exit 1 }' select.out || exit 1
+# a selection of a structure loaded from its pack is the same
+mkdir packs
+../../src/pops --pdb ../1f3r.pdb --packDir packs > /dev/null || exit 1
+../../src/pops --pdb ../1f3r.pdb --packDir packs --select A:70 --popsselectOut pack.out \
+	> /dev/null || exit 1
+diff -I '^date:' select.out pack.out > /dev/null || exit 1
+# an empty selection is an error
+../../src/pops --pdb ../1f3r.pdb --select Z > /dev/null 2>&1 && exit 1
+cd .. && rm -rf select_out
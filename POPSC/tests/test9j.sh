@@ -0,0 +1,38 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9j                                                       "
+echo "--------------------------------------------------------------"
+
+# read-time selection: chains and residue ranges selected by the readers
+# give the results of an input file holding only the selected atoms
+rm -rf readsel_out && mkdir readsel_out
+cd readsel_out
+awk '! /^ATOM/ || substr($0, 22, 1) == "A"' ../1f3r.pdb > chainA.pdb
+awk '! /^ATOM/ || (substr($0, 22, 1) == "B" &&
+	substr($0, 23, 4) + 0 >= 100 && substr($0, 23, 4) + 0 <= 120)' ../1f3r.pdb > rangeB.pdb
+../../src/pops --pdb chainA.pdb --atomOut --residueOut --popsOut chainA.out > /dev/null || exit 1
+../../src/pops --pdb ../1f3r.pdb --chains A --atomOut --residueOut --popsOut chains.out \
+	> /dev/null || exit 1
+cmp -s chainA.out chains.out || exit 1
+../../src/pops --pdb rangeB.pdb --atomOut --popsOut rangeB.out > /dev/null || exit 1
+../../src/pops --pdb ../1f3r.pdb --residues B:100-120 --atomOut --popsOut residues.out \
+	> /dev/null || exit 1
+cmp -s rangeB.out residues.out || exit 1
+# chains and ranges must both match
+../../src/pops --pdb ../1f3r.pdb --chains A,B --residues B:100-120 --atomOut \
+	--popsOut both.out > /dev/null || exit 1
+cmp -s rangeB.out both.out || exit 1
+# the PDBML reader selects the same atoms
+../../src/pops --pdbml ../1f3r.xml --chains A --atomOut --popsOut xml.out > /dev/null || exit 1
+awk '/^=== ATOM SASAs/ { atom = 1; next } /^===/ { atom = 0 }
+	atom && $1 ~ /^[0-9]+$/ { if (NR == FNR) ++ n; else ++ m }
+	END { if (m == 0 || m != n) exit 1 }' chainA.out xml.out || exit 1
+# protein input is unchanged without nucleic acids
+../../src/pops --pdb ../1f3r.pdb --chains A --noNucleic --atomOut --residueOut \
+	--popsOut protein.out > /dev/null || exit 1
+cmp -s chainA.out protein.out || exit 1
+# invalid residue ranges and empty selections are errors
+../../src/pops --pdb ../1f3r.pdb --residues 100-120 > /dev/null 2>&1 && exit 1
+../../src/pops --pdb ../1f3r.pdb --chains Z > /dev/null 2>&1 && exit 1
+cd .. && rm -rf readsel_out
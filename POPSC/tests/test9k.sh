@@ -0,0 +1,36 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9k                                                       "
+echo "--------------------------------------------------------------"
+
+# interface mode: the atom SASAs of the interface residues equal those of
+# the full computation and their buried SASA that of POPSCOMP
+rm -rf interface_out && mkdir interface_out
+cd interface_out
+../../src/pops --pdb ../1f3r.pdb --atomOut --popsOut full.out > /dev/null || exit 1
+../../src/pops --pdb ../1f3r.pdb --interfaceMode --popsinterfaceOut interface.out \
+	> /dev/null || exit 1
+awk 'NR == FNR { if (/^=== ATOM SASAs/) atom = 1; else if (/^===/) atom = 0;
+		if (atom && $1 ~ /^[0-9]+$/) sasa[$1] = $7; next }
+	/^=== INTERFACE ATOM SASAs/ { atom = 1; next } /^===/ { atom = 0 }
+	atom && $1 ~ /^[0-9]+$/ { ++ n; if (sasa[$1] != $7) exit 1 }
+	END { if (n == 0) exit 1 }' full.out interface.out || exit 1
+# a radius covering all contacts buries the SASA of POPSCOMP
+../../src/pops --pdb ../1f3r.pdb --popscomp --popsOut comp.out > /dev/null || exit 1
+../../src/pops --pdb ../1f3r.pdb --interfaceMode --interfaceRadius 20 \
+	--popsinterfaceOut interface20.out > /dev/null || exit 1
+awk 'NR == FNR { if ($1 == "A-B") comp = $4; next }
+	/^=== INTERFACE bSASA ===/ { total = 1; next }
+	total && $1 ~ /^[0-9.]+$/ { d = comp - $3; if (d > 0.05 || d < -0.05) exit 1; found = 1 }
+	END { if (! found) exit 1 }' deltaSASA.rpopsMolecule interface20.out || exit 1
+# interface mode on a structure loaded from its pack is the same
+mkdir packs
+../../src/pops --pdb ../1f3r.pdb --packDir packs > /dev/null || exit 1
+../../src/pops --pdb ../1f3r.pdb --packDir packs --interfaceMode --popsinterfaceOut pack.out \
+	> /dev/null || exit 1
+diff -I '^date:' interface.out pack.out > /dev/null || exit 1
+# a single chain has no interface
+awk '! /^ATOM/ || substr($0, 22, 1) == "A"' ../1f3r.pdb > chainA.pdb
+../../src/pops --pdb chainA.pdb --interfaceMode > /dev/null 2>&1 && exit 1
+cd .. && rm -rf interface_out
@@ -0,0 +1,27 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9l                                                       "
+echo "--------------------------------------------------------------"
+
+# sparse Calpha soft distances of all chain pairs: two chains give one pair,
+# relabelling part of chain B as chain C splits its contacts without changing
+# them and adds the B-C pair; the result is independent of the thread count
+rm -rf distmat_out && mkdir distmat_out
+cd distmat_out
+../../src/pops --pdb ../1f3r.pdb --distMatCAOut ab.dat > /dev/null || exit 1
+awk 'NR > 1 { ++ n; if ($1 != "A" || $3 != "B" || $5 <= 0 || $5 > 1.2) exit 1 }
+	END { if (n == 0) exit 1 }' ab.dat || exit 1
+awk '! /^ATOM/ || substr($0, 22, 1) != "B" || substr($0, 23, 4) + 0 < 100 { print; next }
+	{ print substr($0, 1, 21) "C" substr($0, 23) }' ../1f3r.pdb > abc.pdb
+../../src/pops --pdb abc.pdb --nThread 1 --distMatCAOut abc1.dat > /dev/null || exit 1
+../../src/pops --pdb abc.pdb --nThread 3 --distMatCAOut abc3.dat > /dev/null || exit 1
+cmp -s abc1.dat abc3.dat || exit 1
+for pair in A-B A-C B-C; do
+	awk -v pair=$pair 'NR > 1 && $1 "-" $3 == pair { found = 1 }
+		END { if (! found) exit 1 }' abc1.dat || exit 1
+done
+awk 'NR > 1 && $1 == "A" { print $1, $2, $4, $5 }' abc1.dat | sort > abc.ab
+awk 'NR > 1 { print $1, $2, $4, $5 }' ab.dat | sort > ab.ab
+cmp -s ab.ab abc.ab || exit 1
+cd .. && rm -rf distmat_out
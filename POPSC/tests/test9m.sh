@@ -0,0 +1,53 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo " test9m                                                       "
+echo "--------------------------------------------------------------"
+
+# biological assembly of mmCIF input: the identity assembly 1 of 1F3R
+# equals the asymmetric unit, and assembly 2 is a ring of four copies of
+# chain B given as '_pdbx_struct_assembly_gen' and '_pdbx_struct_oper_list'
+# loops, of which only one copy is evaluated
+rm -rf assembly_cif_out && mkdir assembly_cif_out
+awk '/^_pdbx_struct_assembly\.id/ { skip = 1
+		print "loop_"
+		print "_pdbx_struct_assembly.id"
+		print "_pdbx_struct_assembly.details"
+		print "1 author_defined_assembly"
+		print "2 ring"
+		print "#"
+		print "loop_"
+		print "_pdbx_struct_assembly_gen.assembly_id"
+		print "_pdbx_struct_assembly_gen.oper_expression"
+		print "_pdbx_struct_assembly_gen.asym_id_list"
+		print "1 1 A,B"
+		print "2 (1-4) B"
+		print "#"
+		print "loop_"
+		print "_pdbx_struct_oper_list.id"
+		print "_pdbx_struct_oper_list.type"
+		for (r = 1; r <= 3; ++ r) {
+			for (c = 1; c <= 3; ++ c)
+				printf("_pdbx_struct_oper_list.matrix[%d][%d]\n", r, c)
+			printf("_pdbx_struct_oper_list.vector[%d]\n", r)
+		}
+		split("1 0 -1 0", co, " "); split("0 1 0 -1", si, " ")
+		split("0 30 70 40", tx, " "); split("0 -40 -10 30", ty, " ")
+		for (k = 1; k <= 4; ++ k)
+			printf("%d \"point symmetry operation\" %d %d 0 %d %d %d 0 %d 0 0 1 0\n",
+				k, co[k], -si[k], tx[k], si[k], co[k], ty[k])
+		print "#"
+	}
+	/^_struct_biol\./ { skip = 0 }
+	! skip { print }' 1F3R.cif > assembly_cif_out/asm.cif
+../src/pops --mmcif 1F3R.cif --rout --routPrefix au --chainOut \
+	--outDirName assembly_cif_out > /dev/null || exit 1
+../src/pops --mmcif assembly_cif_out/asm.cif --assembly 1 --rout --routPrefix identity \
+	--chainOut --outDirName assembly_cif_out > /dev/null || exit 1
+cmp assembly_cif_out/au.rpopsChain assembly_cif_out/identity.rpopsChain || exit 1
+cmp assembly_cif_out/au.rpopsMolecule assembly_cif_out/identity.rpopsMolecule || exit 1
+../src/pops --mmcif assembly_cif_out/asm.cif --assembly 2 --rout --routPrefix ring \
+	--chainOut --outDirName assembly_cif_out > assembly_cif_out/log || exit 1
+grep -q "4 copies in 1 environment classes" assembly_cif_out/log || exit 1
+test `awk 'NR > 1' assembly_cif_out/ring.rpopsChain | wc -l` -eq 4 || exit 1
+rm -rf assembly_cif_out